@@ -0,0 +1,804 @@
+// ##############################################################
+//  MNMAccuracy.m
+//  Magic Number Machine
+//
+//  Standalone accuracy-versus-speed harness for the BigFloat transcendentals.
+// ##############################################################
+
+//
+// About MNMAccuracy
+//
+// A command line tool that measures how many correct digits the BigFloat functions
+// really deliver. Each function is fed random arguments over its domain and a set of
+// adversarial ones (cancellation near 1, arguments near multiples of π, tiny and huge
+// magnitudes, perfect powers) at radices 2, 8, 10 and 16. Every result is compared
+// with MPFR evaluated on the exact same argument at more than twice the working
+// precision, so the reference is correct to far below one unit in the last place.
+//
+// The error of each result is measured in units in the last place (ulps) of a
+// mantissa of BF_num_values limbs in the result's radix. For every function, radix
+// and input set the tool reports the maximum, mean and 50th/90th/99th percentile ulp
+// error, the fraction of results within half and within one ulp, the fewest correct
+// digits seen (with the argument that produced them) and the time per call, as JSON
+// with sorted keys so that two runs can be diffed directly.
+//
+// Build it from the project folder with MPFR installed (e.g. "brew install mpfr"):
+//
+//	clang -fobjc-arc -O2 -DBF_statistics=1 -framework Cocoa -include "Magic Number Machine_Prefix.pch" -I. \
+//		-I/opt/homebrew/include -L/opt/homebrew/lib -lmpfr -lgmp \
+//		-o mnmaccuracy Benchmarks/MNMAccuracy.m $(ls *.m | grep -v '^main.m$')
+//
+// adding -DBF_num_values=8 (or any other width) to measure a different working
+// precision. Options are read from the argument domain of the user defaults:
+//
+//	-filter <text>		only run cases whose name contains text
+//	-samples <n>		random arguments per case (default 200)
+//	-seed <n>			seed for the random arguments (default 1)
+//	-output <path>		write the JSON there instead of to standard output
+//	-baseline <path>	compare with an earlier output and fail on regressions
+//	-tolerance <ulps>	allowed growth of a case's maximum error (default 1)
+//	-maxulps <ulps>		fail any case whose maximum error exceeds this (default off)
+//
+// With -baseline or -maxulps the tool exits with status 1 when a case got worse (or
+// disappeared), listing the offenders on stderr. It isn't part of any target (it needs
+// MPFR, which the app doesn't) and no baseline is kept in the repository, since it
+// depends on BF_num_values and the machine. To check a change, record a baseline
+// before it and compare after:
+//
+//	./mnmaccuracy -output /tmp/accuracy-before.json
+//	./mnmaccuracy -baseline /tmp/accuracy-before.json
+//
+
+#import <Cocoa/Cocoa.h>
+#import <time.h>
+#import <mpfr.h>
+
+#import "BigFloat.h"
+
+// Bits of precision used by MPFR for the reference results (per bit of BigFloat)
+#define MNM_accuracy_oracle_factor		2
+
+// Extra reference bits on top of that, to cover the cancellation in the error
+#define MNM_accuracy_oracle_guard		64
+
+// Adversarial arguments are sampled this many times with small perturbations
+#define MNM_accuracy_adversarial_count	8
+
+// Exponent used for raiseToPower (exact in every radix)
+#define MNM_accuracy_power				2.5
+
+typedef void (^MNMAccuracyOp)(BigFloat *value);
+typedef int (^MNMAccuracyReference)(mpfr_t result, mpfr_t argument);
+typedef BigFloat *(^MNMAccuracyInput)(unsigned short radix, int index);
+
+#pragma mark
+#pragma mark ### Exact Conversion ###
+
+//
+// About BigFloat (MNMAccuracy)
+//
+// Reads the exact value of a BigFloat straight from its limbs. Going through a string
+// would round, and the point of the exercise is to compare MPFR and BigFloat on
+// exactly the same argument.
+//
+@interface BigFloat (MNMAccuracy)
+- (void)getExactValue:(mpfr_t)result;
+@end
+
+@implementation BigFloat (MNMAccuracy)
+
+//
+// getExactValue
+//
+// Sets result (which must have at least 16 bits per limb of precision) to the value
+// of the receiver: the limbs, as an integer in radix bf_value_limit, scaled by the
+// radix to the power of the exponent less the user point. NaN if invalid.
+//
+- (void)getExactValue:(mpfr_t)result
+{
+	mpz_t	mantissa;
+	mpfr_t	scale;
+	int		i;
+
+	if (bf_is_valid == NO)
+	{
+		mpfr_set_nan(result);
+		return;
+	}
+
+	mpz_init(mantissa);
+	for (i = BF_num_values - 1; i >= 0; i--)
+	{
+		mpz_mul_ui(mantissa, mantissa, bf_value_limit);
+		mpz_add_ui(mantissa, mantissa, bf_array[i]);
+	}
+	mpfr_set_z(result, mantissa, MPFR_RNDN);
+	mpz_clear(mantissa);
+
+	mpfr_init2(scale, mpfr_get_prec(result));
+	mpfr_set_ui(scale, bf_radix, MPFR_RNDN);
+	mpfr_pow_si(scale, scale, (long)bf_exponent - (long)bf_user_point, MPFR_RNDN);
+	mpfr_mul(result, result, scale, MPFR_RNDN);
+	mpfr_clear(scale);
+
+	if (bf_is_negative)
+		mpfr_neg(result, result, MPFR_RNDN);
+}
+
+@end
+
+#pragma mark
+#pragma mark ### Harness ###
+
+static NSMutableArray	*MNMAccuracyResults;
+static NSString			*MNMAccuracyFilter;
+static int				MNMAccuracySamples;
+static uint64_t			MNMAccuracyState;
+static mpfr_prec_t		MNMAccuracyPrecision;
+
+//
+// MNMAccuracyRandom
+//
+// A uniformly distributed double in [0, 1) from a seeded xorshift64* generator, so
+// runs with the same seed test the same arguments.
+//
+static double
+MNMAccuracyRandom(void)
+{
+	MNMAccuracyState ^= MNMAccuracyState >> 12;
+	MNMAccuracyState ^= MNMAccuracyState << 25;
+	MNMAccuracyState ^= MNMAccuracyState >> 27;
+
+	return (double)((MNMAccuracyState * 0x2545F4914F6CDD1DULL) >> 11) / (double)(1ULL << 53);
+}
+
+//
+// MNMAccuracyUniform
+//
+// A random double between low and high.
+//
+static double
+MNMAccuracyUniform(double low, double high)
+{
+	return low + (high - low) * MNMAccuracyRandom();
+}
+
+//
+// MNMAccuracyValue
+//
+// A BigFloat close to value with a full length mantissa. Multiplying by a ratio of two
+// random integers near one fills every digit, so the functions are not just tested on
+// arguments that happen to be short doubles.
+//
+static BigFloat *
+MNMAccuracyValue(double value, unsigned short radix)
+{
+	BigFloat	*result = [BigFloat bigFloatWithDouble:value radix:radix];
+	int			numerator = 1000000 + (int)(MNMAccuracyRandom() * 1000000);
+	int			denominator = numerator + 1 + (int)(MNMAccuracyRandom() * 1000);
+
+	[result multiplyBy:[BigFloat bigFloatWithInt:numerator radix:radix]];
+	[result divideBy:[BigFloat bigFloatWithInt:denominator radix:radix]];
+
+	return result;
+}
+
+//
+// MNMAccuracyNear
+//
+// base plus a random full length offset of about offset, computed in BigFloat. Used for
+// the adversarial arguments that sit right next to a point where the function cancels.
+//
+static BigFloat *
+MNMAccuracyNear(BigFloat *base, double offset)
+{
+	BigFloat *result = [base duplicate];
+
+	[result add:MNMAccuracyValue(offset * MNMAccuracyUniform(-1.0, 1.0), [base radix])];
+
+	return result;
+}
+
+//
+// MNMAccuracyUlps
+//
+// The error of computed against the reference in ulps of a precision digit mantissa
+// in the given radix. Infinite when the result is invalid but the reference is not.
+//
+static double
+MNMAccuracyUlps(mpfr_t computed, mpfr_t reference, unsigned short radix, int precision)
+{
+	mpfr_t	error, scale;
+	double	ulps;
+	long	magnitude;
+
+	if (mpfr_nan_p(reference))
+		return mpfr_nan_p(computed) ? 0.0 : INFINITY;
+	if (mpfr_nan_p(computed) || mpfr_inf_p(computed) || mpfr_inf_p(reference))
+		return mpfr_equal_p(computed, reference) ? 0.0 : INFINITY;
+	if (mpfr_zero_p(reference))
+		return mpfr_zero_p(computed) ? 0.0 : INFINITY;
+
+	mpfr_inits2(MNMAccuracyPrecision, error, scale, (mpfr_ptr)0);
+
+	// magnitude = floor(log_radix |reference|)
+	mpfr_abs(scale, reference, MPFR_RNDN);
+	mpfr_log2(scale, scale, MPFR_RNDN);
+	magnitude = (long)floor(mpfr_get_d(scale, MPFR_RNDN) / log2(radix));
+
+	// ulps = |computed - reference| * radix^(precision - 1 - magnitude)
+	mpfr_sub(error, computed, reference, MPFR_RNDN);
+	mpfr_abs(error, error, MPFR_RNDN);
+	mpfr_set_ui(scale, radix, MPFR_RNDN);
+	mpfr_pow_si(scale, scale, precision - 1 - magnitude, MPFR_RNDN);
+	mpfr_mul(error, error, scale, MPFR_RNDN);
+	ulps = mpfr_get_d(error, MPFR_RNDN);
+
+	mpfr_clears(error, scale, (mpfr_ptr)0);
+
+	return ulps;
+}
+
+//
+// MNMAccuracyPercentile
+//
+// The value below which the given fraction of the (sorted) errors fall.
+//
+static double
+MNMAccuracyPercentile(NSArray *sorted, double fraction)
+{
+	NSUInteger index = (NSUInteger)ceil(fraction * [sorted count]);
+
+	return [sorted[MIN(MAX(index, 1), [sorted count]) - 1] doubleValue];
+}
+
+//
+// MNMAccuracyJSONNumber
+//
+// JSON has no infinity, so results that failed outright are reported as -1.
+//
+static NSNumber *
+MNMAccuracyJSONNumber(double value)
+{
+	return isfinite(value) ? @(value) : @(-1);
+}
+
+//
+// MNMAccuracyRun
+//
+// Evaluates op on count arguments from input, times it and compares every result with
+// the MPFR reference. The error in ulps is measured in the radix of the result
+// (resultRadix, or the argument's radix when 0).
+//
+static void
+MNMAccuracyRun(NSString *function, NSString *inputs, unsigned short radix, unsigned short resultRadix, int count,
+	MNMAccuracyInput input, MNMAccuracyOp op, MNMAccuracyReference reference)
+{
+	NSString			*name = [NSString stringWithFormat:@"%@/%@/radix=%d", function, inputs, radix];
+	NSMutableArray		*arguments = [NSMutableArray arrayWithCapacity:count];
+	NSMutableArray		*errors = [NSMutableArray arrayWithCapacity:count];
+	NSMutableDictionary	*record;
+	BigFloat			*scratch = [BigFloat bigFloatWithInt:0 radix:radix];
+	BigFloat			*worst = nil;
+	mpfr_t				exact, computed, expected;
+	uint64_t			start, elapsed;
+	double				sum = 0.0, worstUlps = -1.0;
+	int					withinHalf = 0, withinOne = 0;
+	int					precision;
+	int					i;
+
+	if (resultRadix != 0 && resultRadix != radix)
+		name = [name stringByAppendingFormat:@"/to=%d", resultRadix];
+	if ([MNMAccuracyFilter length] && [name rangeOfString:MNMAccuracyFilter].location == NSNotFound)
+		return;
+
+	fprintf(stderr, "%s\n", [name UTF8String]);
+
+	for (i = 0; i < count; i++)
+	{
+		[arguments addObject:input(radix, i)];
+	}
+
+	// Warm up, then time the whole set
+	[scratch assign:arguments[0]];
+	op(scratch);
+	start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+	for (BigFloat *argument in arguments)
+	{
+		[scratch assign:argument];
+		op(scratch);
+	}
+	elapsed = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start;
+
+	mpfr_inits2(MNMAccuracyPrecision, exact, computed, expected, (mpfr_ptr)0);
+	for (BigFloat *argument in arguments)
+	{
+		double ulps;
+
+		[scratch assign:argument];
+		op(scratch);
+		precision = [scratch precisionDigits];
+
+		[argument getExactValue:exact];
+		[scratch getExactValue:computed];
+		reference(expected, exact);
+
+		ulps = MNMAccuracyUlps(computed, expected, resultRadix ? resultRadix : radix, precision);
+		[errors addObject:@(ulps)];
+		sum += ulps;
+		if (ulps <= 0.5) withinHalf++;
+		if (ulps <= 1.0) withinOne++;
+		if (ulps > worstUlps)
+		{
+			worstUlps = ulps;
+			worst = argument;
+		}
+	}
+	mpfr_clears(exact, computed, expected, (mpfr_ptr)0);
+
+	[errors sortUsingSelector:@selector(compare:)];
+	precision = [[BigFloat bigFloatWithInt:0 radix:resultRadix ? resultRadix : radix] precisionDigits];
+
+	record = [NSMutableDictionary dictionary];
+	record[@"name"] = name;
+	record[@"function"] = function;
+	record[@"inputs"] = inputs;
+	record[@"radix"] = @(radix);
+	record[@"result_radix"] = @(resultRadix ? resultRadix : radix);
+	record[@"samples"] = @(count);
+	record[@"precision_digits"] = @(precision);
+	record[@"ns_per_call"] = @((double)elapsed / count);
+	record[@"ulps_max"] = MNMAccuracyJSONNumber(worstUlps);
+	record[@"ulps_mean"] = MNMAccuracyJSONNumber(sum / count);
+	record[@"ulps_p50"] = MNMAccuracyJSONNumber(MNMAccuracyPercentile(errors, 0.50));
+	record[@"ulps_p90"] = MNMAccuracyJSONNumber(MNMAccuracyPercentile(errors, 0.90));
+	record[@"ulps_p99"] = MNMAccuracyJSONNumber(MNMAccuracyPercentile(errors, 0.99));
+	record[@"within_half_ulp"] = @((double)withinHalf / count);
+	record[@"within_one_ulp"] = @((double)withinOne / count);
+	record[@"min_correct_digits"] = MNMAccuracyJSONNumber(worstUlps > 0.0 ? precision - 1 - log(worstUlps) / log(resultRadix ? resultRadix : radix) : precision);
+	record[@"worst_argument"] = worst ? [worst toString] : @"";
+	[MNMAccuracyResults addObject:record];
+}
+
+//
+// MNMAccuracyFunction
+//
+// Runs one function at every radix on random arguments from random() and on the
+// adversarial arguments from adversarial() (each perturbed several times).
+//
+static void
+MNMAccuracyFunction(NSString *function, MNMAccuracyOp op, MNMAccuracyReference reference,
+	BigFloat *(^random)(unsigned short radix), NSArray *(^adversarial)(unsigned short radix))
+{
+	for (NSNumber *radixNumber in @[@2, @8, @10, @16])
+	{
+		unsigned short	radix = [radixNumber unsignedShortValue];
+		NSArray			*points = adversarial ? adversarial(radix) : @[];
+
+		MNMAccuracyRun(function, @"random", radix, 0, MNMAccuracySamples, ^BigFloat *(unsigned short r, int index) {
+			return random(r);
+		}, op, reference);
+
+		if ([points count])
+		{
+			MNMAccuracyRun(function, @"adversarial", radix, 0, (int)[points count], ^BigFloat *(unsigned short r, int index) {
+				return points[index];
+			}, op, reference);
+		}
+	}
+}
+
+//
+// MNMAccuracyPerturbed
+//
+// Each point, plus MNM_accuracy_adversarial_count arguments a few ulps either side.
+//
+static NSArray *
+MNMAccuracyPerturbed(NSArray *points)
+{
+	NSMutableArray *result = [NSMutableArray array];
+
+	for (BigFloat *point in points)
+	{
+		int i;
+
+		[result addObject:point];
+		for (i = 0; i < MNM_accuracy_adversarial_count; i++)
+		{
+			BigFloat	*offset = [point duplicate];
+			BigFloat	*scale = [BigFloat bigFloatWithInt:[point radix] radix:[point radix]];
+
+			// A relative offset of a few hundred ulps
+			[scale raiseToIntPower:-([point precisionDigits] - 3)];
+			[offset multiplyBy:scale];
+			[offset multiplyBy:MNMAccuracyValue(MNMAccuracyUniform(-1.0, 1.0), [point radix])];
+			[offset add:point];
+			[result addObject:offset];
+		}
+	}
+
+	return result;
+}
+
+#pragma mark
+#pragma mark ### Functions ###
+
+//
+// MNMAccuracyMultiplesOfPi
+//
+// The BigFloat approximations of kπ/divisor for a few k: arguments where the trig
+// functions (or their derivatives) vanish and the argument reduction has to be exact.
+//
+static NSArray *
+MNMAccuracyMultiplesOfPi(unsigned short radix, int divisor)
+{
+	NSMutableArray *result = [NSMutableArray array];
+
+	for (NSNumber *k in @[@1, @2, @3, @7, @100, @-5, @1000001])
+	{
+		BigFloat *value = [BigFloat piWithRadix:radix];
+
+		[value multiplyBy:[BigFloat bigFloatWithInt:[k intValue] radix:radix]];
+		[value divideBy:[BigFloat bigFloatWithInt:divisor radix:radix]];
+		[result addObject:value];
+	}
+
+	return result;
+}
+
+//
+// MNMAccuracyExponentials
+//
+// powerOfE, ln and raiseToPower.
+//
+static void
+MNMAccuracyExponentials(void)
+{
+	MNMAccuracyFunction(@"powerOfE", ^(BigFloat *value) {
+		[value powerOfE];
+	}, ^int(mpfr_t result, mpfr_t argument) {
+		return mpfr_exp(result, argument, MPFR_RNDN);
+	}, ^BigFloat *(unsigned short radix) {
+		return MNMAccuracyValue(MNMAccuracyUniform(-100.0, 100.0), radix);
+	}, ^NSArray *(unsigned short radix) {
+		BigFloat *ln2 = [BigFloat bigFloatWithInt:2 radix:radix];
+
+		[ln2 ln];
+		return [MNMAccuracyPerturbed(@[ln2, MNMAccuracyValue(1.0e-30, radix), MNMAccuracyValue(-1.0e-5, radix),
+			MNMAccuracyValue(700.0, radix), MNMAccuracyValue(-700.0, radix), MNMAccuracyValue(5000.0, radix)])
+			arrayByAddingObject:[BigFloat bigFloatWithInt:1 radix:radix]];
+	});
+
+	MNMAccuracyFunction(@"ln", ^(BigFloat *value) {
+		[value ln];
+	}, ^int(mpfr_t result, mpfr_t argument) {
+		return mpfr_log(result, argument, MPFR_RNDN);
+	}, ^BigFloat *(unsigned short radix) {
+		return MNMAccuracyValue(pow(10.0, MNMAccuracyUniform(-50.0, 50.0)), radix);
+	}, ^NSArray *(unsigned short radix) {
+		BigFloat *one = [BigFloat bigFloatWithInt:1 radix:radix];
+
+		// Cancellation just either side of 1
+		return [MNMAccuracyPerturbed(@[MNMAccuracyNear(one, 1.0e-20), MNMAccuracyNear(one, 1.0e-8), MNMAccuracyNear(one, 1.0e-3),
+			MNMAccuracyValue(1.0e-300, radix), MNMAccuracyValue(1.0e300, radix)])
+			arrayByAddingObjectsFromArray:@[one, [BigFloat bigFloatWithInt:radix radix:radix]]];
+	});
+
+	MNMAccuracyFunction(@"raiseToPower", ^(BigFloat *value) {
+		[value raiseToPower:[BigFloat bigFloatWithDouble:MNM_accuracy_power radix:[value radix]]];
+	}, ^int(mpfr_t result, mpfr_t argument) {
+		mpfr_t	power;
+		int		inexact;
+
+		mpfr_init2(power, MNMAccuracyPrecision);
+		mpfr_set_d(power, MNM_accuracy_power, MPFR_RNDN);
+		inexact = mpfr_pow(result, argument, power, MPFR_RNDN);
+		mpfr_clear(power);
+		return inexact;
+	}, ^BigFloat *(unsigned short radix) {
+		return MNMAccuracyValue(pow(10.0, MNMAccuracyUniform(-20.0, 20.0)), radix);
+	}, ^NSArray *(unsigned short radix) {
+		BigFloat *one = [BigFloat bigFloatWithInt:1 radix:radix];
+
+		return MNMAccuracyPerturbed(@[MNMAccuracyNear(one, 1.0e-15), MNMAccuracyValue(1.0e100, radix), MNMAccuracyValue(1.0e-100, radix)]);
+	});
+}
+
+//
+// The circular and hyperbolic functions, their MPFR references and the range of the
+// random arguments (inside each domain)
+//
+typedef struct
+{
+	const char	*name;
+	BOOL		inverse;
+	BOOL		hyperbolic;
+	int			(*reference)(mpfr_ptr result, mpfr_srcptr argument, mpfr_rnd_t rounding);
+	double		low;
+	double		high;
+} MNMAccuracyTrigFunction;
+
+static const MNMAccuracyTrigFunction MNMAccuracyTrigFunctions[] =
+{
+	{"sin",		NO,		NO,		mpfr_sin,	-10.0,	10.0},
+	{"cos",		NO,		NO,		mpfr_cos,	-10.0,	10.0},
+	{"tan",		NO,		NO,		mpfr_tan,	-10.0,	10.0},
+	{"arcsin",	YES,	NO,		mpfr_asin,	-1.0,	1.0},
+	{"arccos",	YES,	NO,		mpfr_acos,	-1.0,	1.0},
+	{"arctan",	YES,	NO,		mpfr_atan,	-1000.0, 1000.0},
+	{"sinh",	NO,		YES,	mpfr_sinh,	-10.0,	10.0},
+	{"cosh",	NO,		YES,	mpfr_cosh,	-10.0,	10.0},
+	{"tanh",	NO,		YES,	mpfr_tanh,	-10.0,	10.0},
+	{"arcsinh",	YES,	YES,	mpfr_asinh,	-1000.0, 1000.0},
+	{"arccosh",	YES,	YES,	mpfr_acosh,	1.0,	1000.0},
+	{"arctanh",	YES,	YES,	mpfr_atanh,	-1.0,	1.0},
+};
+
+//
+// MNMAccuracyTrig
+//
+// The circular and hyperbolic functions and their inverses, in radians.
+//
+static void
+MNMAccuracyTrig(void)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(MNMAccuracyTrigFunctions) / sizeof(MNMAccuracyTrigFunctions[0]); i++)
+	{
+		MNMAccuracyTrigFunction	entry = MNMAccuracyTrigFunctions[i];
+		NSString				*function = @(entry.name);
+
+		MNMAccuracyFunction(function, ^(BigFloat *value) {
+			if ([function hasPrefix:@"sin"] || [function hasPrefix:@"arcsin"])
+				[value sinWithTrigMode:BF_radians inv:entry.inverse hyp:entry.hyperbolic];
+			else if ([function hasPrefix:@"cos"] || [function hasPrefix:@"arccos"])
+				[value cosWithTrigMode:BF_radians inv:entry.inverse hyp:entry.hyperbolic];
+			else
+				[value tanWithTrigMode:BF_radians inv:entry.inverse hyp:entry.hyperbolic];
+		}, ^int(mpfr_t result, mpfr_t argument) {
+			return entry.reference(result, argument, MPFR_RNDN);
+		}, ^BigFloat *(unsigned short radix) {
+			return MNMAccuracyValue(MNMAccuracyUniform(entry.low, entry.high), radix);
+		}, ^NSArray *(unsigned short radix) {
+			BigFloat	*one = [BigFloat bigFloatWithInt:1 radix:radix];
+			NSArray		*points = @[MNMAccuracyValue(1.0e-25, radix), MNMAccuracyValue(-1.0e-8, radix)];
+
+			if ([function isEqualToString:@"arccosh"])
+			{
+				points = @[MNMAccuracyNear(one, 1.0e-12), MNMAccuracyValue(1.0e30, radix)];
+			}
+			else if (entry.low == -1.0 && entry.high == 1.0)
+			{
+				// The singularities at ±1
+				points = [points arrayByAddingObject:MNMAccuracyNear(one, 1.0e-12)];
+			}
+			else if (!entry.inverse && !entry.hyperbolic)
+			{
+				// Argument reduction: near multiples of π/2 and very large arguments
+				points = [points arrayByAddingObjectsFromArray:MNMAccuracyMultiplesOfPi(radix, 2)];
+				points = [points arrayByAddingObjectsFromArray:@[MNMAccuracyValue(1.0e22, radix), MNMAccuracyValue(-3.0e9, radix)]];
+			}
+			else if (!entry.inverse)
+			{
+				points = [points arrayByAddingObject:MNMAccuracyValue(200.0, radix)];
+			}
+
+			return [MNMAccuracyPerturbed(points) arrayByAddingObject:one];
+		});
+	}
+}
+
+//
+// MNMAccuracyRoots
+//
+// nRoot for a few orders, including perfect powers whose roots should come out exact.
+//
+static void
+MNMAccuracyRoots(void)
+{
+	for (NSNumber *order in @[@2, @3, @5, @7])
+	{
+		NSUInteger n = [order unsignedIntegerValue];
+
+		MNMAccuracyFunction([NSString stringWithFormat:@"nRoot%lu", (unsigned long)n], ^(BigFloat *value) {
+			[value nRoot:n];
+		}, ^int(mpfr_t result, mpfr_t argument) {
+			return mpfr_rootn_ui(result, argument, n, MPFR_RNDN);
+		}, ^BigFloat *(unsigned short radix) {
+			return MNMAccuracyValue(pow(10.0, MNMAccuracyUniform(-60.0, 60.0)), radix);
+		}, ^NSArray *(unsigned short radix) {
+			NSMutableArray *points = [NSMutableArray array];
+
+			for (NSNumber *base in @[@2, @3, @10, @12345])
+			{
+				BigFloat *power = [BigFloat bigFloatWithInt:[base intValue] radix:radix];
+
+				[power raiseToIntPower:n];
+				[points addObject:power];
+			}
+			[points addObjectsFromArray:MNMAccuracyPerturbed(@[MNMAccuracyValue(1.0e-200, radix), MNMAccuracyValue(1.0e200, radix)])];
+
+			return points;
+		});
+	}
+}
+
+//
+// MNMAccuracyConversions
+//
+// convertToRadix between every pair of radices. The conversion should preserve the
+// value, so the reference is the argument itself, rounded in the target radix.
+//
+static void
+MNMAccuracyConversions(void)
+{
+	NSArray *radices = @[@2, @8, @10, @16];
+
+	for (NSNumber *from in radices)
+	{
+		for (NSNumber *to in radices)
+		{
+			unsigned short	target = [to unsignedShortValue];
+			NSMutableArray	*points;
+
+			if ([from isEqual:to])
+				continue;
+
+			points = [NSMutableArray array];
+			for (NSNumber *value in @[@0.1, @(1.0 / 3.0), @1.0e-30, @1.0e30, @123456789.0])
+			{
+				[points addObject:MNMAccuracyValue([value doubleValue], [from unsignedShortValue])];
+			}
+
+			MNMAccuracyRun(@"convertToRadix", @"random", [from unsignedShortValue], target, MNMAccuracySamples, ^BigFloat *(unsigned short radix, int index) {
+				return MNMAccuracyValue(pow(10.0, MNMAccuracyUniform(-40.0, 40.0)) * (MNMAccuracyRandom() < 0.5 ? -1 : 1), radix);
+			}, ^(BigFloat *value) {
+				[value convertToRadix:target];
+			}, ^int(mpfr_t result, mpfr_t argument) {
+				return mpfr_set(result, argument, MPFR_RNDN);
+			});
+
+			MNMAccuracyRun(@"convertToRadix", @"adversarial", [from unsignedShortValue], target, (int)[points count], ^BigFloat *(unsigned short radix, int index) {
+				return points[index];
+			}, ^(BigFloat *value) {
+				[value convertToRadix:target];
+			}, ^int(mpfr_t result, mpfr_t argument) {
+				return mpfr_set(result, argument, MPFR_RNDN);
+			});
+		}
+	}
+}
+
+#pragma mark
+#pragma mark ### Regression Check ###
+
+//
+// MNMAccuracyRegressions
+//
+// The cases that are worse than in the baseline by more than tolerance ulps, went
+// missing, or exceed maxUlps (when it is positive).
+//
+static NSArray *
+MNMAccuracyRegressions(NSArray *baseline, double tolerance, double maxUlps)
+{
+	NSMutableArray		*regressions = [NSMutableArray array];
+	NSMutableDictionary	*current = [NSMutableDictionary dictionary];
+
+	for (NSDictionary *record in MNMAccuracyResults)
+	{
+		double ulps = [record[@"ulps_max"] doubleValue];
+
+		current[record[@"name"]] = record;
+		if (ulps < 0.0 || (maxUlps > 0.0 && ulps > maxUlps))
+			[regressions addObject:[NSString stringWithFormat:@"%@: %g ulps (limit %g)", record[@"name"], ulps, maxUlps]];
+	}
+
+	for (NSDictionary *old in baseline)
+	{
+		NSDictionary	*record = current[old[@"name"]];
+		double			oldUlps = [old[@"ulps_max"] doubleValue];
+		double			ulps = [record[@"ulps_max"] doubleValue];
+
+		// Cases left out by -filter are not regressions
+		if ([MNMAccuracyFilter length] && [old[@"name"] rangeOfString:MNMAccuracyFilter].location == NSNotFound)
+			continue;
+
+		if (record == nil)
+			[regressions addObject:[NSString stringWithFormat:@"%@: missing", old[@"name"]]];
+		else if (oldUlps >= 0.0 && ulps >= 0.0 && ulps > oldUlps + tolerance)
+			[regressions addObject:[NSString stringWithFormat:@"%@: %g ulps (was %g)", old[@"name"], ulps, oldUlps]];
+	}
+
+	return regressions;
+}
+
+#pragma mark
+#pragma mark ### Main ###
+
+int main(int argc, const char *argv[])
+{
+	@autoreleasepool
+	{
+		NSUserDefaults	*arguments = [NSUserDefaults standardUserDefaults];
+		NSString		*output = [arguments stringForKey:@"output"];
+		NSString		*baselinePath = [arguments stringForKey:@"baseline"];
+		double			tolerance = [arguments objectForKey:@"tolerance"] ? [arguments doubleForKey:@"tolerance"] : 1.0;
+		double			maxUlps = [arguments doubleForKey:@"maxulps"];
+		NSArray			*regressions = @[];
+		NSDictionary	*report;
+		NSData			*json;
+		NSError			*error = nil;
+
+		MNMAccuracyFilter = [arguments stringForKey:@"filter"];
+		MNMAccuracySamples = [arguments integerForKey:@"samples"] > 0 ? (int)[arguments integerForKey:@"samples"] : 200;
+		MNMAccuracyState = [arguments integerForKey:@"seed"] ? (uint64_t)[arguments integerForKey:@"seed"] : 1;
+		MNMAccuracyPrecision = MNM_accuracy_oracle_factor * BF_num_values * 16 + MNM_accuracy_oracle_guard;
+		MNMAccuracyResults = [NSMutableArray array];
+
+		// Every call must really be computed, not found in the cache
+		[BigFloat setCacheCapacity:0];
+		mpfr_set_emin(mpfr_get_emin_min());
+		mpfr_set_emax(mpfr_get_emax_max());
+
+		MNMAccuracyExponentials();
+		MNMAccuracyTrig();
+		MNMAccuracyRoots();
+		MNMAccuracyConversions();
+
+		if (baselinePath || maxUlps > 0.0)
+		{
+			NSData			*baselineData = baselinePath ? [NSData dataWithContentsOfFile:baselinePath] : nil;
+			NSDictionary	*baseline = baselineData ? [NSJSONSerialization JSONObjectWithData:baselineData options:0 error:&error] : nil;
+
+			if (baselinePath && baseline == nil)
+			{
+				fprintf(stderr, "mnmaccuracy: can't read baseline %s\n", [baselinePath UTF8String]);
+				return 1;
+			}
+			regressions = MNMAccuracyRegressions(baseline[@"results"], tolerance, maxUlps);
+		}
+
+		report = @{
+			@"suite": @"mnmaccuracy",
+			@"format": @1,
+			@"date": [[[NSISO8601DateFormatter alloc] init] stringFromDate:[NSDate date]],
+			@"host": [[NSProcessInfo processInfo] hostName],
+			@"bf_num_values": @(BF_num_values),
+			@"mpfr": @(mpfr_get_version()),
+			@"oracle_bits": @(MNMAccuracyPrecision),
+			@"samples": @(MNMAccuracySamples),
+			@"regressions": regressions,
+			@"results": MNMAccuracyResults,
+		};
+
+		json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys error:&error];
+		if (json == nil)
+		{
+			fprintf(stderr, "mnmaccuracy: %s\n", [[error localizedDescription] UTF8String]);
+			return 1;
+		}
+
+		if (output)
+		{
+			if (![json writeToFile:output options:NSDataWritingAtomic error:&error])
+			{
+				fprintf(stderr, "mnmaccuracy: %s\n", [[error localizedDescription] UTF8String]);
+				return 1;
+			}
+		}
+		else
+		{
+			fwrite([json bytes], 1, [json length], stdout);
+			fputc('\n', stdout);
+		}
+
+		for (NSString *regression in regressions)
+		{
+			fprintf(stderr, "mnmaccuracy: regression: %s\n", [regression UTF8String]);
+		}
+		if ([regressions count])
+			return 1;
+	}
+	return 0;
+}
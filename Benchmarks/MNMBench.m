@@ -0,0 +1,819 @@
+// ##############################################################
+//  MNMBench.m
+//  Magic Number Machine
+//
+//  Standalone benchmark for the BigFloat core and the expression engine.
+// ##############################################################
+
+//
+// About MNMBench
+//
+// A command line tool that times the public BigFloat/BigCFloat operations across
+// radices (2, 8, 10, 16) and magnitudes, the display conversion at several display
+// precisions, the exact BigInteger arithmetic and number theory, and end-to-end workloads: typing and evaluating representative
+// expressions, the data drawer functions over 10^4 values and 20x20 matrix solves.
+//
+// Every benchmark reports nanoseconds per operation (the median of several timed
+// runs), heap allocations per operation (counted by hooking the default malloc
+// zone), the BigFloat operation statistics per operation and the value it
+// computed, all as JSON with sorted keys so that two runs can be diffed directly.
+//
+// Build it from the project folder with
+//
+//	clang -fobjc-arc -O2 -DBF_statistics=1 -framework Cocoa -include "Magic Number Machine_Prefix.pch" -I. \
+//		-o mnmbench Benchmarks/MNMBench.m $(ls *.m | grep -v '^main.m$')
+//
+// adding -DBF_num_values=8 (or any other width) to measure a different working
+// precision. Options are read from the argument domain of the user defaults:
+//
+//	-filter <text>		only run benchmarks whose name contains text
+//	-time <ms>			target duration of each timed run (default 20)
+//	-repeats <n>		timed runs per benchmark (default 5)
+//	-output <path>		write the JSON there instead of to standard output
+//	-statistics YES		print the operation statistics of the last benchmark to stderr
+//
+// Operations that mutate their receiver are timed together with the assign that
+// resets it; the "assign" benchmark gives that baseline. The BigFloat result cache
+// is disabled while timing so that repeated operations are really computed.
+//
+
+#import <Cocoa/Cocoa.h>
+#import <malloc/malloc.h>
+#import <mach/mach.h>
+#import <stdatomic.h>
+#import <time.h>
+
+#import "BigCFloat.h"
+#import "BigInteger.h"
+#import "BigMatrix.h"
+#import "DataFunctions.h"
+#import "DataManager.h"
+#import "DrawerManager.h"
+#import "Expression.h"
+#import "History.h"
+#import "NSObject+NSPerformSelector.h"
+#import "OpEnumerations.h"
+
+// Benchmarks on the data drawer functions use this many values
+#define MNM_bench_data_count		10000
+
+// Size of the matrices in the linear algebra benchmarks
+#define MNM_bench_matrix_size		20
+
+// Significant digits used for the "result" of each benchmark
+#define MNM_bench_result_digits		30
+
+typedef void (^MNMBenchOp)(BigCFloat *scratch, BigCFloat *x, BigCFloat *y);
+
+#pragma mark
+#pragma mark ### Allocation Counting ###
+
+static _Atomic unsigned long long	MNMBenchAllocations;
+static void *(*MNMBenchZoneMalloc)(struct _malloc_zone_t *zone, size_t size);
+static void *(*MNMBenchZoneCalloc)(struct _malloc_zone_t *zone, size_t count, size_t size);
+static void *(*MNMBenchZoneRealloc)(struct _malloc_zone_t *zone, void *pointer, size_t size);
+
+static void *
+MNMBenchCountingMalloc(struct _malloc_zone_t *zone, size_t size)
+{
+	atomic_fetch_add_explicit(&MNMBenchAllocations, 1, memory_order_relaxed);
+	return MNMBenchZoneMalloc(zone, size);
+}
+
+static void *
+MNMBenchCountingCalloc(struct _malloc_zone_t *zone, size_t count, size_t size)
+{
+	atomic_fetch_add_explicit(&MNMBenchAllocations, 1, memory_order_relaxed);
+	return MNMBenchZoneCalloc(zone, count, size);
+}
+
+static void *
+MNMBenchCountingRealloc(struct _malloc_zone_t *zone, void *pointer, size_t size)
+{
+	atomic_fetch_add_explicit(&MNMBenchAllocations, 1, memory_order_relaxed);
+	return MNMBenchZoneRealloc(zone, pointer, size);
+}
+
+//
+// MNMBenchHookAllocations
+//
+// Routes the default zone's allocation functions through the counters above. The
+// zone structure is read-only so it is unprotected just long enough to patch it.
+//
+static void
+MNMBenchHookAllocations(void)
+{
+	malloc_zone_t *zone = malloc_default_zone();
+
+	vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(malloc_zone_t), 0, VM_PROT_READ | VM_PROT_WRITE);
+	MNMBenchZoneMalloc = zone->malloc;
+	MNMBenchZoneCalloc = zone->calloc;
+	MNMBenchZoneRealloc = zone->realloc;
+	zone->malloc = MNMBenchCountingMalloc;
+	zone->calloc = MNMBenchCountingCalloc;
+	zone->realloc = MNMBenchCountingRealloc;
+	vm_protect(mach_task_self(), (vm_address_t)zone, sizeof(malloc_zone_t), 0, VM_PROT_READ);
+}
+
+#pragma mark
+#pragma mark ### Harness ###
+
+static NSMutableArray	*MNMBenchResults;
+static NSString			*MNMBenchFilter;
+static double			MNMBenchTargetNanoseconds;
+static int				MNMBenchRepeats;
+
+//
+// MNMBenchTime
+//
+// Runs body iterations times and returns the elapsed nanoseconds.
+//
+static uint64_t
+MNMBenchTime(void (^body)(void), uint64_t iterations)
+{
+	uint64_t start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+	uint64_t i;
+
+	for (i = 0; i < iterations; i++)
+	{
+		@autoreleasepool
+		{
+			body();
+		}
+	}
+
+	return clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - start;
+}
+
+//
+// MNMBenchString
+//
+// The value as it would be displayed to MNM_bench_result_digits digits.
+//
+static NSString *
+MNMBenchString(BigCFloat *value)
+{
+	NSString	*mantissa, *exponent, *imaginaryMantissa, *imaginaryExponent;
+	NSString	*string;
+
+	if (value == nil)
+		return @"nil";
+
+	[value limitedString:MNM_bench_result_digits fixedPlaces:0 fillLimit:NO complement:0 mantissa:&mantissa exponent:&exponent imaginaryMantissa:&imaginaryMantissa imaginaryExponent:&imaginaryExponent];
+
+	string = [exponent length] ? [NSString stringWithFormat:@"%@e%@", mantissa, exponent] : mantissa;
+	if ([value hasImaginary])
+	{
+		string = [string stringByAppendingFormat:@"%@%@%@i", [imaginaryMantissa hasPrefix:@"-"] ? @"" : @"+", imaginaryMantissa,
+			[imaginaryExponent length] ? [@"e" stringByAppendingString:imaginaryExponent] : @""];
+	}
+
+	return string;
+}
+
+//
+// MNMBenchRun
+//
+// Times body and records the result. The iteration count doubles until one run takes
+// the target time; the reported time is the median over the repeated runs and the
+// allocations are counted over one further run.
+//
+static void
+MNMBenchRun(NSString *group, NSString *name, NSDictionary *parameters, void (^body)(void), NSString *(^result)(void))
+{
+	NSMutableDictionary	*record;
+	NSMutableArray		*times;
+	NSString			*fullName = [group stringByAppendingFormat:@"/%@", name];
+	uint64_t			iterations = 1;
+	uint64_t			elapsed;
+	unsigned long long	allocations;
+	NSDictionary		*statistics;
+	NSMutableDictionary	*countsPerOp;
+	int					repeat;
+
+	for (NSString *key in [[parameters allKeys] sortedArrayUsingSelector:@selector(compare:)])
+	{
+		fullName = [fullName stringByAppendingFormat:@"/%@=%@", key, parameters[key]];
+	}
+	if ([MNMBenchFilter length] && [fullName rangeOfString:MNMBenchFilter].location == NSNotFound)
+		return;
+
+	fprintf(stderr, "%s\n", [fullName UTF8String]);
+
+	// Warm up, then find an iteration count that takes the target time
+	MNMBenchTime(body, 1);
+	while ((elapsed = MNMBenchTime(body, iterations)) < MNMBenchTargetNanoseconds && iterations < (1ULL << 30))
+	{
+		iterations = (elapsed == 0) ? iterations * 16 : MAX(iterations * 2, (uint64_t)(iterations * MNMBenchTargetNanoseconds / elapsed));
+	}
+
+	times = [NSMutableArray arrayWithCapacity:MNMBenchRepeats];
+	for (repeat = 0; repeat < MNMBenchRepeats; repeat++)
+	{
+		[times addObject:@((double)MNMBenchTime(body, iterations) / iterations)];
+	}
+	[times sortUsingSelector:@selector(compare:)];
+
+	[BigFloat resetStatistics];
+	allocations = atomic_load(&MNMBenchAllocations);
+	MNMBenchTime(body, iterations);
+	allocations = atomic_load(&MNMBenchAllocations) - allocations;
+	statistics = [BigFloat statistics];
+
+	record = [NSMutableDictionary dictionaryWithDictionary:parameters];
+	record[@"group"] = group;
+	record[@"name"] = fullName;
+	record[@"iterations"] = @(iterations);
+	record[@"ns_per_op"] = times[[times count] / 2];
+	record[@"ns_per_op_min"] = times[0];
+	record[@"allocations_per_op"] = @((double)allocations / iterations);
+	record[@"result"] = result ? result() : @"";
+	
+	// Kernel calls and loop iterations per operation, from the allocation counting run
+	countsPerOp = [NSMutableDictionary dictionaryWithCapacity:[statistics count]];
+	for (NSString *statistic in statistics)
+	{
+		countsPerOp[statistic] = @([statistics[statistic][@"count"] doubleValue] / iterations);
+	}
+	record[@"counts_per_op"] = countsPerOp;
+	[MNMBenchResults addObject:record];
+}
+
+//
+// MNMBenchRunOp
+//
+// Times one BigCFloat operation applied to a copy of x (with operand y).
+//
+static void
+MNMBenchRunOp(NSString *group, NSString *name, NSDictionary *parameters, BigCFloat *x, BigCFloat *y, MNMBenchOp op)
+{
+	BigCFloat *scratch = [x copy];
+
+	MNMBenchRun(group, name, parameters, ^{
+		[scratch assign:x];
+		op(scratch, x, y);
+	}, ^NSString *{
+		[scratch assign:x];
+		op(scratch, x, y);
+		return MNMBenchString(scratch);
+	});
+}
+
+#pragma mark
+#pragma mark ### BigFloat Benchmarks ###
+
+//
+// MNMBenchArithmetic
+//
+// The operations that apply to any value, at every radix and magnitude.
+//
+static void
+MNMBenchArithmetic(void)
+{
+	NSDictionary	*ops = @{
+		@"assign":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) {},
+		@"add":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s add:y]; },
+		@"subtract":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s subtract:y]; },
+		@"multiplyBy":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s multiplyBy:y]; },
+		@"divideBy":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s divideBy:y]; },
+		@"moduloBy":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s moduloBy:y]; },
+		@"addProductOf":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s addProductOf:x and:y]; },
+		@"compareWith":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s compareWith:y]; },
+		@"abs":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s abs]; },
+		@"sqrt":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s sqrt]; },
+		@"cbrt":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s cbrt]; },
+		@"inverse":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s inverse]; },
+		@"ln":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s ln]; },
+		@"logOfBase":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s logOfBase:y]; },
+		@"raiseToPower":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s raiseToPower:y]; },
+		@"sin":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s sinWithTrigMode:BF_radians inv:NO hyp:NO]; },
+		@"cos":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s cosWithTrigMode:BF_radians inv:NO hyp:NO]; },
+		@"tan":				^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s tanWithTrigMode:BF_radians inv:NO hyp:NO]; },
+		@"wholePart":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s wholePart]; },
+		@"fractionalPart":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s fractionalPart]; },
+		@"exp3Up":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s exp3Up]; },
+		@"exp3Down":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s exp3Down:12]; },
+		@"convertToRadix":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s convertToRadix:([x radix] == 10) ? 16 : 10]; },
+	};
+	NSDictionary	*magnitudes = @{@"small": @1.0e-40, @"unit": @0.333, @"large": @1.0e40};
+	NSArray			*radices = @[@2, @8, @10, @16];
+
+	for (NSNumber *radix in radices)
+	{
+		BigCFloat *pi = [BigCFloat piWithRadix:[radix unsignedShortValue]];
+
+		for (NSString *magnitude in [[magnitudes allKeys] sortedArrayUsingSelector:@selector(compare:)])
+		{
+			BigCFloat *x = [BigCFloat bigFloatWithDouble:[magnitudes[magnitude] doubleValue] radix:[radix unsignedShortValue]];
+			BigCFloat *y = [BigCFloat bigFloatWithDouble:1.0 / 7.0 radix:[radix unsignedShortValue]];
+
+			// Give both operands full length mantissas
+			[x multiplyBy:pi];
+			[y add:pi];
+
+			for (NSString *name in [[ops allKeys] sortedArrayUsingSelector:@selector(compare:)])
+			{
+				MNMBenchRunOp(@"bigfloat", name, @{@"radix": radix, @"magnitude": magnitude}, x, y, ops[name]);
+			}
+
+			// The exponential only makes sense where it does not overflow
+			if (![magnitude isEqualToString:@"large"])
+			{
+				MNMBenchRunOp(@"bigfloat", @"powerOfE", @{@"radix": radix, @"magnitude": magnitude}, x, y, ^(BigCFloat *s, BigCFloat *x, BigCFloat *y) {
+					[s powerOfE];
+				});
+				MNMBenchRunOp(@"bigfloat", @"sinh", @{@"radix": radix, @"magnitude": magnitude}, x, y, ^(BigCFloat *s, BigCFloat *x, BigCFloat *y) {
+					[s sinWithTrigMode:BF_radians inv:NO hyp:YES];
+				});
+			}
+
+			// Inverse trig functions need an argument in [-1, 1]
+			if (![magnitude isEqualToString:@"large"])
+			{
+				MNMBenchRunOp(@"bigfloat", @"arcsin", @{@"radix": radix, @"magnitude": magnitude}, x, y, ^(BigCFloat *s, BigCFloat *x, BigCFloat *y) {
+					[s sinWithTrigMode:BF_radians inv:YES hyp:NO];
+				});
+				MNMBenchRunOp(@"bigfloat", @"arctan", @{@"radix": radix, @"magnitude": magnitude}, x, y, ^(BigCFloat *s, BigCFloat *x, BigCFloat *y) {
+					[s tanWithTrigMode:BF_radians inv:YES hyp:NO];
+				});
+			}
+		}
+	}
+}
+
+//
+// MNMBenchIntegers
+//
+// Operations defined on integers: factorials, combinatorics and the bitwise logic.
+//
+static void
+MNMBenchIntegers(void)
+{
+	NSDictionary	*ops = @{
+		@"factorial":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s factorial]; },
+		@"sum":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s sum]; },
+		@"nPr":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s nPr:y]; },
+		@"nCr":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s nCr:y]; },
+		@"bitnot":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s bitnotWithComplement:32]; },
+		@"and":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s andWith:y usingComplement:32]; },
+		@"or":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s orWith:y usingComplement:32]; },
+		@"xor":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s xorWith:y usingComplement:32]; },
+		@"nand":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s nandWith:y usingComplement:32]; },
+		@"nor":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s norWith:y usingComplement:32]; },
+		@"xnor":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s xnorWith:y usingComplement:32]; },
+	};
+
+	for (NSNumber *radix in @[@2, @8, @10, @16])
+	{
+		BigCFloat *x = [BigCFloat bigFloatWithInt:57 radix:[radix unsignedShortValue]];
+		BigCFloat *y = [BigCFloat bigFloatWithInt:7 radix:[radix unsignedShortValue]];
+
+		for (NSString *name in [[ops allKeys] sortedArrayUsingSelector:@selector(compare:)])
+		{
+			MNMBenchRunOp(@"bigfloat", name, @{@"radix": radix, @"magnitude": @"integer"}, x, y, ops[name]);
+		}
+	}
+}
+
+//
+// MNMBenchBigIntegers
+//
+// The exact integer arithmetic at a few sizes (either side of the Karatsuba threshold)
+// and the number theory functions on numbers around 100 bits.
+//
+static void
+MNMBenchBigIntegers(void)
+{
+	for (NSNumber *bits in @[@256, @4096, @65536])
+	{
+		NSUInteger	n = [bits unsignedIntegerValue];
+		BigInteger	*x = [[[BigInteger integerWithLong:3] raiseToIntPower:(NSUInteger)(n / 1.585)] subtract:[BigInteger one]];
+		BigInteger	*y = [[[BigInteger integerWithLong:7] raiseToIntPower:(NSUInteger)(n / 2.807 / 2)] add:[BigInteger one]];
+		__block BigInteger *result = nil;
+		
+		MNMBenchRun(@"biginteger", @"multiplyBy", @{@"bits": bits}, ^{
+			result = [x multiplyBy:x];
+		}, ^NSString *{
+			return [@([result bitLength]) stringValue];
+		});
+		MNMBenchRun(@"biginteger", @"divideBy", @{@"bits": bits}, ^{
+			result = [x divideBy:y];
+		}, ^NSString *{
+			return [@([result bitLength]) stringValue];
+		});
+		MNMBenchRun(@"biginteger", @"gcdWith", @{@"bits": bits}, ^{
+			result = [x gcdWith:y];
+		}, ^NSString *{
+			return [result stringWithRadix:10];
+		});
+		MNMBenchRun(@"biginteger", @"stringWithRadix", @{@"bits": bits}, ^{
+			(void)[x stringWithRadix:10];
+		}, nil);
+	}
+	
+	for (NSNumber *n in @[@100, @1000, @10000])
+	{
+		BigInteger			*number = [BigInteger integerWithLong:[n longLongValue]];
+		__block BigInteger	*result = nil;
+		
+		MNMBenchRun(@"biginteger", @"factorial", @{@"n": n}, ^{
+			result = [number factorial];
+		}, ^NSString *{
+			return [@([result bitLength]) stringValue];
+		});
+		MNMBenchRun(@"biginteger", @"nCr", @{@"n": n}, ^{
+			result = [number nCr:[BigInteger integerWithLong:[n longLongValue] / 3]];
+		}, ^NSString *{
+			return [@([result bitLength]) stringValue];
+		});
+	}
+	
+	{
+		// 2^127 - 1 is prime, the semiprime has two 40 bit factors (within the rho budget)
+		BigInteger			*prime = [[[BigInteger integerWithLong:2] raiseToIntPower:127] subtract:[BigInteger one]];
+		BigInteger			*semiprime = [[BigInteger integerWithLong:1099511627689LL] multiplyBy:[BigInteger integerWithLong:1099511627791LL]];
+		BigInteger			*modulus = [[[BigInteger integerWithLong:10] raiseToIntPower:300] add:[BigInteger integerWithLong:7]];
+		__block BigInteger	*result = nil;
+		__block BOOL		isPrime = NO;
+		
+		MNMBenchRun(@"biginteger", @"powerModulo", @{@"bits": @([modulus bitLength])}, ^{
+			result = [prime raiseToPower:modulus modulo:modulus];
+		}, ^NSString *{
+			return [@([result bitLength]) stringValue];
+		});
+		MNMBenchRun(@"biginteger", @"isProbablePrime", @{@"bits": @127}, ^{
+			isPrime = [prime isProbablePrime];
+		}, ^NSString *{
+			return isPrime ? @"YES" : @"NO";
+		});
+		MNMBenchRun(@"biginteger", @"smallestPrimeFactor", @{@"bits": @([semiprime bitLength])}, ^{
+			result = [semiprime smallestPrimeFactor];
+		}, ^NSString *{
+			return [result stringWithRadix:10];
+		});
+	}
+}
+
+//
+// MNMBenchComplex
+//
+// The operations whose complex paths differ from the real ones.
+//
+static void
+MNMBenchComplex(void)
+{
+	NSDictionary	*ops = @{
+		@"add":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s add:y]; },
+		@"multiplyBy":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s multiplyBy:y]; },
+		@"divideBy":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s divideBy:y]; },
+		@"abs":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s abs]; },
+		@"sqrt":		^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s sqrt]; },
+		@"ln":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s ln]; },
+		@"powerOfE":	^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s powerOfE]; },
+		@"raiseToPower":^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s raiseToPower:y]; },
+		@"sin":			^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s sinWithTrigMode:BF_radians inv:NO hyp:NO]; },
+		@"addProductOf":^(BigCFloat *s, BigCFloat *x, BigCFloat *y) { [s addProductOf:x and:y]; },
+	};
+
+	for (NSNumber *radix in @[@2, @8, @10, @16])
+	{
+		unsigned short	base = [radix unsignedShortValue];
+		BigCFloat		*x = [BigCFloat bigFloatWithReal:[BigFloat bigFloatWithDouble:0.75 radix:base] imaginary:[BigFloat piWithRadix:base]];
+		BigCFloat		*y = [BigCFloat bigFloatWithReal:[BigFloat bigFloatWithDouble:1.0 / 3.0 radix:base] imaginary:[BigFloat bigFloatWithDouble:-2.5 radix:base]];
+
+		for (NSString *name in [[ops allKeys] sortedArrayUsingSelector:@selector(compare:)])
+		{
+			MNMBenchRunOp(@"bigcfloat", name, @{@"radix": radix, @"magnitude": @"complex"}, x, y, ops[name]);
+		}
+	}
+}
+
+//
+// MNMBenchConversions
+//
+// Parsing, digit entry and the display conversion at several display precisions.
+//
+static void
+MNMBenchConversions(void)
+{
+	for (NSNumber *radix in @[@2, @8, @10, @16])
+	{
+		unsigned short	base = [radix unsignedShortValue];
+		BigCFloat		*value = [BigCFloat piWithRadix:base];
+		NSString		*text = [value toShortString:0];
+
+		[value multiplyBy:[BigCFloat bigFloatWithDouble:1.0e10 radix:base]];
+
+		for (NSNumber *precision in @[@12, @30, @50])
+		{
+			unsigned int digits = [precision unsignedIntValue];
+
+			MNMBenchRun(@"bigfloat", @"limitedString", @{@"radix": radix, @"precision": precision}, ^{
+				NSString *mantissa, *exponent, *imaginaryMantissa, *imaginaryExponent;
+				[value limitedString:digits fixedPlaces:0 fillLimit:NO complement:0 mantissa:&mantissa exponent:&exponent imaginaryMantissa:&imaginaryMantissa imaginaryExponent:&imaginaryExponent];
+			}, ^NSString *{
+				return MNMBenchString(value);
+			});
+		}
+
+		MNMBenchRun(@"bigfloat", @"initWithString", @{@"radix": radix}, ^{
+			(void)[[BigCFloat alloc] initWithString:text radix:base];
+		}, ^NSString *{
+			return MNMBenchString([BigCFloat bigFloatWithString:text radix:base]);
+		});
+
+		MNMBenchRun(@"bigfloat", @"appendDigit", @{@"radix": radix, @"digits": @20}, ^{
+			BigCFloat *entered = [BigCFloat bigFloatWithInt:0 radix:base];
+			for (int i = 0; i < 20; i++)
+				[entered appendDigit:(short)((i * 7 + 3) % base) useComplement:0];
+		}, nil);
+	}
+}
+
+#pragma mark
+#pragma mark ### Engine Benchmarks ###
+
+//
+// MNMBenchDataManager
+//
+// A DataManager whose history is kept in memory rather than in the user's log.
+//
+@interface MNMBenchDataManager : DataManager
+- (History *)getHistoryDataFromPref;
+@end
+
+@implementation MNMBenchDataManager
+- (History *)getHistoryDataFromPref
+{
+	return [[History alloc] init];
+}
+@end
+
+//
+// MNMBenchEnter
+//
+// Types a space separated script into the manager's expression as the buttons would
+// and returns the value of the result. Numbers are typed digit by digit.
+//
+static BigCFloat *
+MNMBenchEnter(DataManager *manager, NSArray *script)
+{
+	NSDictionary	*binaryOps = @{@"+": @(plusOp), @"-": @(minusOp), @"*": @(multiplyOp), @"/": @(divisionOp), @"^": @(powerOp), @"%": @(modOp)};
+	NSDictionary	*preOps = @{@"sin": @(sinOp), @"cos": @(cosOp), @"tan": @(tanOp), @"ln": @(lnOp), @"log": @(logOp), @"sqrt": @(sqrtOp)};
+	NSDictionary	*postOps = @{@"!": @(factorialOp), @"sq": @(squaredOp), @"inv": @(invOp)};
+	NSUInteger		i;
+
+	[manager clearExpression];
+
+	for (NSString *token in script)
+	{
+		unichar first = [token characterAtIndex:0];
+
+		if ((first >= '0' && first <= '9') || first == '.')
+		{
+			for (i = 0; i < [token length]; i++)
+			{
+				unichar character = [token characterAtIndex:i];
+
+				[manager ensureInputWithValue:(character == '.')];
+				if (character == '.')
+					[[manager getInputPoint] userPointPressed];
+				else
+					[[manager getInputPoint] appendDigit:character - '0'];
+			}
+			continue;
+		}
+
+		[manager ensureInputWithValue:YES];
+		if ([token isEqualToString:@"("])
+			[[manager getInputPoint] bracketPressed];
+		else if ([token isEqualToString:@")"])
+			[[manager getInputPoint] closeBracketPressed];
+		else if (binaryOps[token])
+			[[manager getInputPoint] binaryOpPressed:[binaryOps[token] intValue]];
+		else if (preOps[token])
+			[[manager getInputPoint] preOpPressed:[preOps[token] intValue]];
+		else if (postOps[token])
+			[[manager getInputPoint] postOpPressed:[postOps[token] intValue]];
+		else
+			NSCAssert(NO, @"Unknown benchmark token %@", token);
+	}
+
+	return [[manager getCurrentExpression] getValue];
+}
+
+//
+// MNMBenchExpressions
+//
+// Typing and evaluating representative expressions end to end.
+//
+static void
+MNMBenchExpressions(void)
+{
+	DataManager		*manager = [[MNMBenchDataManager alloc] init];
+	NSDictionary	*scripts = @{
+		@"arithmetic":		@"123.456 + 789.012 * 3.14159 / 2.71828 - 99.5",
+		@"nested":			@"( ( 1.5 + 2.25 ) * ( 3.125 - 0.5 ) ) / ( 7 + ( 8 / 3 ) )",
+		@"transcendental":	@"sin 0.5 + ln 2.5 * sqrt 3 ^ 1.5",
+		@"combinatorial":	@"25 ! / ( 5 ! * 20 ! )",
+		@"powers":			@"1.0001 ^ 10000 - 2.5 sq inv",
+	};
+
+	for (NSString *name in [[scripts allKeys] sortedArrayUsingSelector:@selector(compare:)])
+	{
+		NSArray *script = [scripts[name] componentsSeparatedByString:@" "];
+
+		MNMBenchRun(@"expression", name, @{@"radix": @([manager getRadix])}, ^{
+			MNMBenchEnter(manager, script);
+		}, ^NSString *{
+			return MNMBenchString(MNMBenchEnter(manager, script));
+		});
+	}
+}
+
+//
+// MNMBenchData
+//
+// The data drawer functions over MNM_bench_data_count values. "cold" runs on a new
+// DataFunctions each time, so nothing is reused from its caches; "warm" reuses one.
+//
+static void
+MNMBenchData(void)
+{
+	DataManager		*manager = [[MNMBenchDataManager alloc] init];
+	DrawerManager	*drawers = [[DrawerManager alloc] init];
+	DataFunctions	*warmFunctions = [[DataFunctions alloc] init];
+	NSMutableArray	*values = [NSMutableArray arrayWithCapacity:MNM_bench_data_count];
+	NSMutableArray	*pairs = [NSMutableArray arrayWithCapacity:MNM_bench_data_count * 2];
+	NSArray			*functions = @[@"sum:", @"mean:", @"variance:", @"stddev:", @"median:", @"mode:", @"percentile10:", @"interquartilerange:"];
+	NSArray			*functions2D = @[@"mfromrankregressionony:", @"bfromrankregressionony:", @"correlation:"];
+	short			radix = [manager getRadix];
+	int				i;
+
+	[warmFunctions setValue:manager forKey:@"dataManager"];
+	[warmFunctions setValue:drawers forKey:@"drawerManager"];
+
+	// A deterministic, rounded spread of values (some repeated, for the mode)
+	for (i = 0; i < MNM_bench_data_count; i++)
+	{
+		double x = (double)((i * 7919) % 1009) / 8.0;
+
+		[values addObject:[BigCFloat bigFloatWithDouble:x radix:radix]];
+		[pairs addObject:[BigCFloat bigFloatWithDouble:i radix:radix]];
+		[pairs addObject:[BigCFloat bigFloatWithDouble:3.0 * i + x radix:radix]];
+	}
+
+	for (NSString *function in [functions arrayByAddingObjectsFromArray:functions2D])
+	{
+		SEL				selector = NSSelectorFromString(function);
+		NSMutableArray	*data = [functions2D containsObject:function] ? pairs : values;
+		NSString		*name = [function substringToIndex:[function length] - 1];
+		DataFunctions	*(^coldFunctions)(void) = ^DataFunctions *{
+			DataFunctions *cold = [[DataFunctions alloc] init];
+			[cold setValue:manager forKey:@"dataManager"];
+			[cold setValue:drawers forKey:@"drawerManager"];
+			return cold;
+		};
+
+		MNMBenchRun(@"data", name, @{@"count": @([data count]), @"cache": @"cold"}, ^{
+			[NSObject target:coldFunctions() performSelector:selector withObject:data];
+		}, ^NSString *{
+			return MNMBenchString([NSObject target:coldFunctions() performSelector:selector withObject:data]);
+		});
+		MNMBenchRun(@"data", name, @{@"count": @([data count]), @"cache": @"warm"}, ^{
+			[NSObject target:warmFunctions performSelector:selector withObject:data];
+		}, nil);
+	}
+
+	MNMBenchRun(@"data", @"sumOf", @{@"count": @([values count])}, ^{
+		[DataFunctions sumOf:values radix:radix];
+	}, ^NSString *{
+		return MNMBenchString([DataFunctions sumOf:values radix:radix]);
+	});
+}
+
+//
+// MNMBenchMatrix
+//
+// Linear algebra on a well conditioned MNM_bench_matrix_size square matrix. Each run
+// builds a new BigMatrix since factorising replaces the elements; "construct" is that
+// baseline.
+//
+static void
+MNMBenchMatrix(void)
+{
+	unsigned short	radix = 10;
+	int				n = MNM_bench_matrix_size;
+	NSMutableArray	*elements = [NSMutableArray arrayWithCapacity:n * n];
+	NSMutableArray	*column = [NSMutableArray arrayWithCapacity:n];
+	NSDictionary	*parameters = @{@"size": @(n)};
+	BigMatrix		*rhs;
+	BigMatrix		*other;
+	int				i, j;
+
+	for (i = 0; i < n; i++)
+	{
+		for (j = 0; j < n; j++)
+		{
+			[elements addObject:[BigCFloat bigFloatWithDouble:(i == j) ? n + 1.0 : 1.0 / (i + j + 1) radix:radix]];
+		}
+		[column addObject:[BigCFloat bigFloatWithInt:i + 1 radix:radix]];
+	}
+	rhs = [[BigMatrix alloc] initWithArray:column rows:n columns:1 radix:radix];
+	other = [[BigMatrix alloc] initWithArray:elements rows:n columns:n radix:radix];
+
+	BigMatrix *(^matrix)(void) = ^BigMatrix *{
+		return [[BigMatrix alloc] initWithArray:elements rows:n columns:n radix:radix];
+	};
+
+	MNMBenchRun(@"matrix", @"construct", parameters, ^{ matrix(); }, nil);
+	MNMBenchRun(@"matrix", @"solve", parameters, ^{ [matrix() solve:rhs]; }, ^NSString *{
+		return MNMBenchString([[matrix() solve:rhs] elementAtRow:0 column:0]);
+	});
+	MNMBenchRun(@"matrix", @"refinedSolve", parameters, ^{ [matrix() refinedSolve:rhs]; }, ^NSString *{
+		return MNMBenchString([[matrix() refinedSolve:rhs] elementAtRow:0 column:0]);
+	});
+	MNMBenchRun(@"matrix", @"determinant", parameters, ^{ [matrix() determinant]; }, ^NSString *{
+		return MNMBenchString([matrix() determinant]);
+	});
+	MNMBenchRun(@"matrix", @"inverse", parameters, ^{ [matrix() inverse]; }, ^NSString *{
+		return MNMBenchString([[matrix() inverse] elementAtRow:0 column:0]);
+	});
+	MNMBenchRun(@"matrix", @"multiplyBy", parameters, ^{ [matrix() multiplyBy:other]; }, ^NSString *{
+		return MNMBenchString([[matrix() multiplyBy:other] elementAtRow:0 column:0]);
+	});
+	MNMBenchRun(@"matrix", @"power", @{@"size": @(n), @"exponent": @5}, ^{ [matrix() power:5]; }, ^NSString *{
+		return MNMBenchString([[matrix() power:5] elementAtRow:0 column:0]);
+	});
+}
+
+#pragma mark
+#pragma mark ### Main ###
+
+int main(int argc, const char *argv[])
+{
+	@autoreleasepool
+	{
+		NSUserDefaults	*arguments = [NSUserDefaults standardUserDefaults];
+		NSString		*output = [arguments stringForKey:@"output"];
+		NSDictionary	*report;
+		NSData			*json;
+		NSError			*error = nil;
+
+		MNMBenchFilter = [arguments stringForKey:@"filter"];
+		MNMBenchTargetNanoseconds = 1.0e6 * ([arguments doubleForKey:@"time"] > 0 ? [arguments doubleForKey:@"time"] : 20.0);
+		MNMBenchRepeats = [arguments integerForKey:@"repeats"] > 0 ? (int)[arguments integerForKey:@"repeats"] : 5;
+		MNMBenchResults = [NSMutableArray array];
+
+		MNMBenchHookAllocations();
+		[BigFloat setCacheCapacity:0];
+
+		MNMBenchArithmetic();
+		MNMBenchIntegers();
+		MNMBenchBigIntegers();
+		MNMBenchComplex();
+		MNMBenchConversions();
+		MNMBenchExpressions();
+		MNMBenchData();
+		MNMBenchMatrix();
+		
+		// The statistics are reset for each benchmark, so this covers the last one
+		if ([arguments boolForKey:@"statistics"])
+			fprintf(stderr, "%s", [[BigFloat statisticsReport] UTF8String]);
+
+		report = @{
+			@"suite": @"mnmbench",
+			@"format": @1,
+			@"date": [[[NSISO8601DateFormatter alloc] init] stringFromDate:[NSDate date]],
+			@"host": [[NSProcessInfo processInfo] hostName],
+			@"os": [[NSProcessInfo processInfo] operatingSystemVersionString],
+			@"cpus": @([[NSProcessInfo processInfo] activeProcessorCount]),
+			@"bf_num_values": @(BF_num_values),
+			@"target_ms": @(MNMBenchTargetNanoseconds / 1.0e6),
+			@"repeats": @(MNMBenchRepeats),
+			@"results": MNMBenchResults,
+		};
+
+		json = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys error:&error];
+		if (json == nil)
+		{
+			fprintf(stderr, "mnmbench: %s\n", [[error localizedDescription] UTF8String]);
+			return 1;
+		}
+
+		if (output)
+		{
+			if (![json writeToFile:output options:NSDataWritingAtomic error:&error])
+			{
+				fprintf(stderr, "mnmbench: %s\n", [[error localizedDescription] UTF8String]);
+				return 1;
+			}
+		}
+		else
+		{
+			fwrite([json bytes], 1, [json length], stdout);
+			fputc('\n', stdout);
+		}
+	}
+	return 0;
+}
@@ -35,6 +35,8 @@
 
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder;
+- (void)appendEncodingTo:(NSMutableData *)data;
 - (id)copyWithZone:(NSZone*)zone;
 
 + (BigCFloat*)bigFloatWithReal:(BigFloat *)realPart imaginary:(BigFloat *)imaginaryPart;
@@ -43,6 +45,8 @@
 + (BigCFloat*)bigFloatWithDouble:(double)newValue radix:(unsigned short)newRadix;
 + (BigCFloat*)bigFloatWithString:(NSString *)newValue radix:(unsigned short)newRadix;
 + (BigCFloat*)piWithRadix:(unsigned short)newRadix;
++ (BigCFloat*)bigFloatWithData:(NSData *)data;
++ (BigCFloat*)bigFloatWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix;
 
 + (BigCFloat *)one;
 + (BigCFloat *)zero;
@@ -109,6 +113,8 @@
 - (void)xnorWith:(BigFloat*)num usingComplement:(int)complement;
 
 // Accessor Functions
+@property (nonatomic, readonly, copy) NSData *encodedData;
+@property (nonatomic, readonly, strong) BigInteger *bigIntegerValue;
 @property (nonatomic, readonly, copy) NSString *imaginaryMantissaString;
 @property (nonatomic, readonly, copy) NSString *imaginaryExponentString;
 @property (nonatomic, readonly, copy) NSString *toString;
@@ -254,6 +254,44 @@
     [coder encodeBool:bcf_has_imaginary forKey:@"BCFHasImaginary"];
 }
 
+//
+// initWithEncoding
+//
+// Wrapper that adds complex number support around the base class. The imaginary part
+// is only present in the encoding when it is non-zero.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder
+{
+    uint8_t flags;
+    
+    self = [super initWithEncoding:decoder];
+    if (self)
+    {
+        flags = BF_DecodeByte(decoder);
+        bcf_has_imaginary = (flags & 1) != 0;
+        if (flags & 2)
+            bcf_imaginary = [[BigFloat alloc] initWithEncoding:decoder];
+        else
+            bcf_imaginary = [[BigFloat alloc] initWithInt:0 radix:bf_radix];
+    }
+    return self;
+}
+
+//
+// appendEncodingTo
+//
+// Wrapper that adds complex number support around the base class
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+    BOOL hasImaginaryValue = bcf_imaginary != nil && ![bcf_imaginary isZero];
+    
+    [super appendEncodingTo:data];
+    BF_EncodeByte(data, (bcf_has_imaginary ? 1 : 0) | (hasImaginaryValue ? 2 : 0));
+    if (hasImaginaryValue)
+        [bcf_imaginary appendEncodingTo:data];
+}
+
 //
 // copyWithZone
 //
@@ -301,6 +339,16 @@
     return [[BigCFloat alloc] initWithInt:newValue radix:newRadix];
 }
 
+//
+// bigFloatWithBigInteger
+//
+// Wrapper that adds complex number support around the base class
+//
++ (BigCFloat*)bigFloatWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix
+{
+    return [[BigCFloat alloc] initWithBigInteger:integer radix:newRadix];
+}
+
 //
 // bigFloatWithDouble
 //
@@ -330,6 +378,35 @@
     return [[BigCFloat alloc] initPiWithRadix:newRadix];
 }
 
+//
+// bigFloatWithData
+//
+// Reads a number from encodedData, or from a keyed archive written by older versions.
+// Returns nil if the data is neither.
+//
++ (BigCFloat*)bigFloatWithData:(NSData *)data
+{
+    const char  magic[4] = {'M', 'N', 'M', 'V'};
+    BFDecoder   decoder;
+    BigCFloat   *result;
+    
+    if ([data length] > sizeof(magic) && memcmp([data bytes], magic, sizeof(magic)) == 0)
+    {
+        decoder = BF_DecoderForData(data, sizeof(magic));
+        if (BF_DecodeByte(&decoder) > BF_encoding_version)
+            return nil;
+        
+        result = [[BigCFloat alloc] initWithEncoding:&decoder];
+        return decoder.failed ? nil : result;
+    }
+    
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    result = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+#pragma GCC diagnostic pop
+    return [result isKindOfClass:[BigCFloat class]] ? result : nil;
+}
+
 + (BigCFloat *)one {
     return [BigCFloat bigFloatWithInt:1 radix:10];
 }
@@ -517,6 +594,20 @@
 
 #pragma mark
 #pragma mark ### Public Utility Functions ###
+
+//
+// appendCacheKeyTo
+//
+// Wrapper that adds the imaginary part to the base class's cache key
+//
+- (void)appendCacheKeyTo:(NSMutableData *)key
+{
+    [super appendCacheKeyTo:key];
+
+    [key appendBytes:&bcf_has_imaginary length:sizeof(bcf_has_imaginary)];
+    [bcf_imaginary appendCacheKeyTo:key];
+}
+
 //
 // appendDigit
 //
@@ -970,14 +1061,88 @@
     
 }
 
+//
+// accumulateProductsOf
+//
+// Wrapper that adds complex number support around the base class. Every complex
+// product (a + bi)(c + di) = (ac - bd) + (ad + bc)i is split into real products, so the
+// real and imaginary parts are each summed in one fused accumulation.
+//
+- (void)accumulateProductsOf:(NSArray *)first and:(NSArray *)second signs:(const signed char *)signs
+{
+    NSUInteger      count = [first count];
+    NSMutableArray  *realFirst = [NSMutableArray arrayWithCapacity:count * 2];
+    NSMutableArray  *realSecond = [NSMutableArray arrayWithCapacity:count * 2];
+    NSMutableArray  *imaginaryFirst = [NSMutableArray arrayWithCapacity:count * 2];
+    NSMutableArray  *imaginarySecond = [NSMutableArray arrayWithCapacity:count * 2];
+    NSMutableData   *realSigns = [NSMutableData dataWithCapacity:count * 2];
+    NSMutableData   *imaginarySigns = [NSMutableData dataWithCapacity:count * 2];
+    BOOL            complexTerms = NO;
+    BigFloat        *real;
+    NSUInteger      i;
+    
+    for (i = 0; i < count && !complexTerms; i++)
+    {
+        complexTerms =
+            ([first[i] isKindOfClass:[BigCFloat class]] && [(BigCFloat *)first[i] hasImaginary]) ||
+            ([second[i] isKindOfClass:[BigCFloat class]] && [(BigCFloat *)second[i] hasImaginary]);
+    }
+    
+    if (!complexTerms)
+    {
+        // if there are no imaginary parts then just do the super's work
+        [super accumulateProductsOf:first and:second signs:signs];
+        return;
+    }
+    
+    for (i = 0; i < count; i++)
+    {
+        BigFloat        *a = [first[i] isKindOfClass:[BigCFloat class]] ? [(BigCFloat *)first[i] realPartCopy] : first[i];
+        BigFloat        *b = [first[i] isKindOfClass:[BigCFloat class]] ? ((BigCFloat *)first[i])->bcf_imaginary : nil;
+        BigFloat        *c = [second[i] isKindOfClass:[BigCFloat class]] ? [(BigCFloat *)second[i] realPartCopy] : second[i];
+        BigFloat        *d = [second[i] isKindOfClass:[BigCFloat class]] ? ((BigCFloat *)second[i])->bcf_imaginary : nil;
+        signed char     sign = (signs != NULL && signs[i] < 0) ? -1 : 1;
+        signed char     negated = -sign;
+        
+        [realFirst addObject:a];
+        [realSecond addObject:c];
+        [realSigns appendBytes:&sign length:1];
+        if (b != nil && d != nil)
+        {
+            [realFirst addObject:b];
+            [realSecond addObject:d];
+            [realSigns appendBytes:&negated length:1];
+        }
+        if (d != nil)
+        {
+            [imaginaryFirst addObject:a];
+            [imaginarySecond addObject:d];
+            [imaginarySigns appendBytes:&sign length:1];
+        }
+        if (b != nil)
+        {
+            [imaginaryFirst addObject:b];
+            [imaginarySecond addObject:c];
+            [imaginarySigns appendBytes:&sign length:1];
+        }
+    }
+    
+    real = [self realPartCopy];
+    [real accumulateProductsOf:realFirst and:realSecond signs:[realSigns bytes]];
+    [bcf_imaginary accumulateProductsOf:imaginaryFirst and:imaginarySecond signs:[imaginarySigns bytes]];
+    [super assign:real];
+    
+    bcf_has_imaginary = ![bcf_imaginary isZero];
+}
+
 #pragma mark
 #pragma mark ### Extended Mathematics Functions ###
 //
-// powerOfE
+// computePowerOfE
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)powerOfE
+- (void)computePowerOfE
 {
     BigFloat *realPart;
     BigFloat *cosPart;
@@ -1005,15 +1170,15 @@
         return;
     }
     
-    [super powerOfE];
+    [super computePowerOfE];
 }
 
 //
-// ln
+// computeLn
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)ln
+- (void)computeLn
 {
     BigFloat *r;
     BigFloat *theta;
@@ -1023,7 +1188,7 @@
     
     if (!bcf_has_imaginary && !bf_is_negative)
     {
-        [super ln];
+        [super computeLn];
         return;
     }
     
@@ -1038,11 +1203,11 @@
 }
 
 //
-// raiseToPower
+// computeRaiseToPower
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)raiseToPower:(BigFloat*)num
+- (void)computeRaiseToPower:(BigFloat*)num
 {
     BigCFloat    *cnum;
 
@@ -1051,7 +1216,7 @@
     cnum = (BigCFloat*)num;
     if (!bcf_has_imaginary && !cnum->bcf_has_imaginary)
     {
-        [super raiseToPower:num];
+        [super computeRaiseToPower:num];
         return;
     }
     
@@ -1145,18 +1310,18 @@
 }
 
 //
-// logOfBase
+// computeLogOfBase
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)logOfBase:(BigFloat *)base
+- (void)computeLogOfBase:(BigFloat *)base
 {
     if (!bf_is_valid)
     {
         return;
     }
     
-    [super logOfBase:base];
+    [super computeLogOfBase:base];
 }
 
 - (void)convertToMode:(BFTrigMode)mode {
@@ -1198,11 +1363,11 @@
 }
 
 //
-// sinWithTrigMode
+// computeSinWithTrigMode
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)sinWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
+- (void)computeSinWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
 {
     BigCFloat    *firstTerm;
     BigCFloat    *secondTerm;
@@ -1231,7 +1396,7 @@
         (!(useInverse && !useHyp) || (result == NSOrderedAscending || result == NSOrderedSame))
     )
     {
-        [super sinWithTrigMode:mode inv:useInverse hyp:useHyp];
+        [super computeSinWithTrigMode:mode inv:useInverse hyp:useHyp];
         return;
     }
     
@@ -1292,11 +1457,11 @@
 }
 
 //
-// cosWithTrigMode
+// computeCosWithTrigMode
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)cosWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
+- (void)computeCosWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
 {
     BigCFloat    *firstTerm;
     BigCFloat    *secondTerm;
@@ -1325,7 +1490,7 @@
         (!(useInverse && !useHyp) || (result == NSOrderedAscending || result == NSOrderedSame))
     )
     {
-        [super cosWithTrigMode:mode inv:useInverse hyp:useHyp];
+        [super computeCosWithTrigMode:mode inv:useInverse hyp:useHyp];
         return;
     }
     
@@ -1391,11 +1556,11 @@
 }
 
 //
-// tanWithTrigMode
+// computeTanWithTrigMode
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)tanWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
+- (void)computeTanWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
 {
     BigCFloat    *firstTerm;
     BigCFloat    *secondTerm;
@@ -1411,7 +1576,7 @@
     
     if ((useHyp || !bcf_has_imaginary) && !useInverse)
     {
-        [super tanWithTrigMode:mode inv:useInverse hyp:useHyp];
+        [super computeTanWithTrigMode:mode inv:useInverse hyp:useHyp];
         return;
     }
     
@@ -1485,11 +1650,11 @@
 }
 
 //
-// factorial
+// computeFactorial
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)factorial
+- (void)computeFactorial
 {
     if (!bf_is_valid)
     {
@@ -1502,7 +1667,7 @@
     // doesn't really make sense for a complex number so throw away the complex part
     [self abs];
 
-    [super factorial];
+    [super computeFactorial];
 }
 
 //
@@ -1524,11 +1689,11 @@
 }
 
 //
-// nPr
+// computeNPr
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)nPr: (BigFloat*)r
+- (void)computeNPr: (BigFloat*)r
 {
     if (!bf_is_valid)
     {
@@ -1538,15 +1703,15 @@
     // doesn't really make sense for a complex number so throw away the complex part
     [self abs];
     
-    [super nPr:r];
+    [super computeNPr:r];
 }
 
 //
-// nCr
+// computeNCr
 //
 // Wrapper that adds complex number support around the base class
 //
-- (void)nCr: (BigFloat*)r
+- (void)computeNCr: (BigFloat*)r
 {
     if (!bf_is_valid)
     {
@@ -1556,7 +1721,7 @@
     // doesn't really make sense for a complex number so throw away the complex part
     [self abs];
     
-    [super nCr:r];
+    [super computeNCr:r];
 }
 
 //
@@ -1818,6 +1983,37 @@
 
 #pragma mark
 #pragma mark ### Accessor Functions ###
+
+//
+// encodedData
+//
+// The number in the compact encoding, behind a magic number and version. Used for the
+// pasteboard; read it back with bigFloatWithData:.
+//
+- (NSData *)encodedData
+{
+    const char      magic[4] = {'M', 'N', 'M', 'V'};
+    NSMutableData   *data = [NSMutableData dataWithBytes:magic length:sizeof(magic)];
+    
+    BF_EncodeByte(data, BF_encoding_version);
+    [self appendEncodingTo:data];
+    
+    return data;
+}
+
+//
+// bigIntegerValue
+//
+// Only real integers have an exact integer value.
+//
+- (BigInteger *)bigIntegerValue
+{
+    if (bcf_has_imaginary && ![bcf_imaginary isZero])
+        return nil;
+    
+    return [super bigIntegerValue];
+}
+
 //
 // imaginaryMantissaString
 //
@@ -8,6 +8,8 @@
 
 #import <Foundation/Foundation.h>
 
+@class BigInteger;
+
 //
 // About BigFloat
 //
@@ -33,7 +35,9 @@
 //
 
 // Basic constants defining the precision used by the class
+#ifndef BF_num_values
 #define	BF_num_values				16   // was 8
+#endif
 #define	BF_max_mantissa_length		(BF_num_values * 16 + 3)
 #define	BF_max_exponent_length		32
 
@@ -41,6 +45,94 @@
 	#error BF_num_values must be at least 2
 #endif
 
+// Set to 1 to compile in the operation counters and timers (see Statistics Functions).
+// They cost two clock reads per kernel call, so they are on only in debug builds (the
+// Development configuration defines DEBUG) and in the benchmark tools.
+#ifndef BF_statistics
+#ifdef DEBUG
+#define BF_statistics				1
+#else
+#define BF_statistics				0
+#endif
+#endif
+
+// The quantities counted by the operation statistics. Kernels (add to limitedString)
+// count their calls and accumulate their time; "terms" and "iterations" count the
+// passes through the series and Newton loops of the function before them.
+typedef NS_ENUM(int, BFStatistic)
+{
+	BF_stat_add,
+	BF_stat_subtract,
+	BF_stat_multiply,
+	BF_stat_divide,
+	BF_stat_modulo,
+	BF_stat_compare,
+	BF_stat_convert_radix,
+	BF_stat_implicit_conversion,
+	BF_stat_accumulate,
+	BF_stat_accumulate_terms,
+	BF_stat_power_of_e,
+	BF_stat_power_of_e_terms,
+	BF_stat_ln,
+	BF_stat_ln_terms,
+	BF_stat_raise_to_power,
+	BF_stat_sin,
+	BF_stat_sin_terms,
+	BF_stat_cos,
+	BF_stat_cos_terms,
+	BF_stat_tan,
+	BF_stat_tan_terms,
+	BF_stat_nroot,
+	BF_stat_nroot_iterations,
+	BF_stat_factorial,
+	BF_stat_factorial_terms,
+	BF_stat_limited_string,
+	BF_stat_count
+};
+
+// Version of the compact binary encoding (see Compact Encoding Functions)
+#define BF_encoding_version			1
+
+//
+// Reads a compact encoding in place, straight out of an NSData or a mapped file.
+// Reading past the end sets failed and returns zeros from then on, so a decode can
+// run to completion and be checked once at the end.
+//
+typedef struct
+{
+	const uint8_t	*bytes;
+	const uint8_t	*end;
+	BOOL			failed;
+} BFDecoder;
+
+BFDecoder BF_DecoderForData(NSData *data, NSUInteger offset);
+void BF_EncodeByte(NSMutableData *data, uint8_t byte);
+void BF_EncodeUnsigned(NSMutableData *data, unsigned long long number);
+void BF_EncodeSigned(NSMutableData *data, long long number);
+uint8_t BF_DecodeByte(BFDecoder *decoder);
+unsigned long long BF_DecodeUnsigned(BFDecoder *decoder);
+long long BF_DecodeSigned(BFDecoder *decoder);
+
+//
+// A number packed in the compact encoding ahead of time, so it can be loaded without
+// any arithmetic (see Packed Constants in BigFloat.m).
+//
+typedef struct
+{
+	const uint8_t	*bytes;
+	NSUInteger		length;
+} BFPackedNumber;
+
+// Constants packed ahead of time for the common radices
+typedef NS_ENUM(int, BFConstant)
+{
+	BF_constant_pi,
+	BF_constant_e,
+	BF_constant_ln2,
+	BF_constant_ln10,
+	BF_constant_count
+};
+
 // Mode for trigonometric operations
 typedef NS_ENUM(unsigned int, BFTrigMode)
 {
@@ -114,6 +206,13 @@ typedef NS_ENUM(unsigned int, BFTrigMode)
 - (void)divideBy:(BigFloat*)num;
 - (void)moduloBy:(BigFloat*)num;
 
+// Fused Arithmetic Functions (one rounding for the whole operation)
+- (void)accumulateProductsOf:(NSArray *)first and:(NSArray *)second signs:(const signed char *)signs;
+- (void)addProductOf:(BigFloat*)first and:(BigFloat*)second;
+- (void)subtractProductOf:(BigFloat*)first and:(BigFloat*)second;
+- (void)addProductsOf:(NSArray *)first and:(NSArray *)second;
+- (void)subtractProductsOf:(NSArray *)first and:(NSArray *)second;
+
 // Extended Mathematics Functions
 - (void)powerOfE;
 - (void)ln;
@@ -121,6 +220,7 @@ typedef NS_ENUM(unsigned int, BFTrigMode)
 - (void)raiseToPower:(BigFloat*)num;
 - (void)sqrt;
 - (void)cbrt;
+- (void)nRoot:(NSUInteger)n;
 - (void)inverse;
 - (void)logOfBase:(BigFloat *)base;
 - (void)sinWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp;
@@ -142,6 +242,53 @@ typedef NS_ENUM(unsigned int, BFTrigMode)
 - (void)norWith:(BigFloat*)num usingComplement:(int)complement;
 - (void)xnorWith:(BigFloat*)num usingComplement:(int)complement;
 
+// Uncached implementations of the cached extended functions (subclasses override these)
+- (void)computePowerOfE;
+- (void)computeLn;
+- (void)computeRaiseToPower:(BigFloat*)num;
+- (void)computeLogOfBase:(BigFloat *)base;
+- (void)computeSinWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp;
+- (void)computeCosWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp;
+- (void)computeTanWithTrigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp;
+- (void)computeFactorial;
+- (void)computeNPr: (BigFloat*)r;
+- (void)computeNCr: (BigFloat*)r;
+
+// Result Cache Functions
++ (NSUInteger)cacheHits;
++ (NSUInteger)cacheMisses;
++ (NSUInteger)cacheCount;
++ (NSUInteger)cacheCapacity;
++ (void)setCacheCapacity:(NSUInteger)capacity;
++ (void)clearCache;
+- (void)appendCacheKeyTo:(NSMutableData *)key;
+
+// Working Precision Functions
++ (unsigned int)workingDigits;
++ (void)setWorkingDigits:(unsigned int)digits;
+@property (nonatomic, readonly) int precisionDigits;
+- (BOOL)hasConvergedTo:(BigFloat *)previous;
+
+// Compact Encoding Functions
+- (instancetype)initWithEncoding:(BFDecoder *)decoder;
+- (void)appendEncodingTo:(NSMutableData *)data;
+
+// Packed Constant Functions
++ (BigFloat *)bigFloatWithPackedNumber:(BFPackedNumber)packed;
+- (BOOL)assignConstant:(BFConstant)constant;
+
+// Exact Integer Conversion Functions
+- (instancetype)initWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix;
++ (BigFloat*)bigFloatWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix;
+@property (nonatomic, readonly, strong) BigInteger *bigIntegerValue;
+
+// Statistics Functions
++ (NSDictionary *)statistics;
++ (NSDictionary *)threadStatistics;
++ (unsigned long long)threadKernelCalls;
++ (void)resetStatistics;
++ (NSString *)statisticsReport;
+
 // Conversion Functions
 @property (nonatomic, readonly) double doubleValue;
 @property (nonatomic, readonly, copy) NSString *mantissaString;
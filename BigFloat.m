@@ -7,6 +7,8 @@
 // #######################################################################
 
 #import "BigFloat.h"
+#import "BigFloatConstants.h"
+#import "BigInteger.h"
 
 //
 // About BigFloat
@@ -51,6 +53,160 @@ typedef struct
 	BOOL			bf_is_valid;
 } BigFloatElements;
 
+// The operations whose results are kept in the result cache
+typedef NS_ENUM(unsigned char, BFCachedOperation)
+{
+	BF_cache_power_of_e,
+	BF_cache_ln,
+	BF_cache_raise_to_power,
+	BF_cache_log_of_base,
+	BF_cache_sin,
+	BF_cache_cos,
+	BF_cache_tan,
+	BF_cache_factorial,
+	BF_cache_npr,
+	BF_cache_ncr
+};
+
+// Number of results the cache holds unless told otherwise
+#define BF_cache_default_capacity	256
+
+// Width of the fused functions' accumulator, in multiples of BF_num_values: a double
+// width product plus as much again for lining up terms of different magnitudes
+#define BF_accumulator_multiple		3
+
+//
+// BigFloatCacheEntry
+//
+// A node in the result cache's recency list. The dictionary owns the entries, so the
+// list links back without retaining.
+//
+@interface BigFloatCacheEntry : NSObject
+{
+@public
+	NSData								*key;
+	BigFloat							*result;
+	__unsafe_unretained BigFloatCacheEntry	*newer;
+	__unsafe_unretained BigFloatCacheEntry	*older;
+}
+@end
+
+@implementation BigFloatCacheEntry
+@end
+
+// The result cache: entries by key, most recently used at the head of the list
+static NSLock *BF_cache_lock = nil;
+static NSMutableDictionary *BF_cache_entries = nil;
+static __unsafe_unretained BigFloatCacheEntry *BF_cache_newest = nil;
+static __unsafe_unretained BigFloatCacheEntry *BF_cache_oldest = nil;
+static NSUInteger BF_cache_capacity = BF_cache_default_capacity;
+static NSUInteger BF_cache_hits = 0;
+static NSUInteger BF_cache_misses = 0;
+
+// The calling thread's working precision in digits, 0 for full (see Working Precision)
+static _Thread_local unsigned int BF_working_digits = 0;
+
+#if BF_statistics
+
+// One thread's operation statistics. Each thread fills in its own block without
+// locking; the blocks are linked together (and never freed) so they can be summed.
+typedef struct BFStatisticsBlock
+{
+	uint64_t					counts[BF_stat_count];
+	uint64_t					nanoseconds[BF_stat_count];
+	struct BFStatisticsBlock	*next;
+} BFStatisticsBlock;
+
+// A running timer for BF_TIME
+typedef struct
+{
+	BFStatistic	statistic;
+	uint64_t	start;
+} BFStatisticsTimer;
+
+static pthread_mutex_t BF_statistics_lock = PTHREAD_MUTEX_INITIALIZER;
+static BFStatisticsBlock *BF_statistics_blocks = NULL;
+static _Thread_local BFStatisticsBlock *BF_thread_statistics = NULL;
+
+//
+// BF_ThreadStatistics
+//
+// The calling thread's statistics, created and registered on first use.
+//
+static BFStatisticsBlock *
+BF_ThreadStatistics(void)
+{
+	if (BF_thread_statistics == NULL)
+	{
+		BF_thread_statistics = calloc(1, sizeof(BFStatisticsBlock));
+		pthread_mutex_lock(&BF_statistics_lock);
+		BF_thread_statistics->next = BF_statistics_blocks;
+		BF_statistics_blocks = BF_thread_statistics;
+		pthread_mutex_unlock(&BF_statistics_lock);
+	}
+	return BF_thread_statistics;
+}
+
+//
+// BF_StopTimer
+//
+// Counts a call and adds its elapsed time when a BF_TIME timer goes out of scope.
+//
+static void
+BF_StopTimer(BFStatisticsTimer *timer)
+{
+	BFStatisticsBlock *block = BF_ThreadStatistics();
+	
+	block->counts[timer->statistic]++;
+	block->nanoseconds[timer->statistic] += clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - timer->start;
+}
+
+// Counts one occurrence of a statistic
+#define BF_COUNT(statistic)		(BF_ThreadStatistics()->counts[(statistic)]++)
+
+// Counts a call and times it until the end of the enclosing scope (so every return
+// is covered). Must be used where a declaration is allowed.
+#define BF_TIME(statistic) \
+	__attribute__((cleanup(BF_StopTimer))) BFStatisticsTimer bf_timer = {(statistic), clock_gettime_nsec_np(CLOCK_UPTIME_RAW)}
+
+#else
+
+#define BF_COUNT(statistic)		do {} while (0)
+#define BF_TIME(statistic)		do {} while (0)
+
+#endif
+
+// Names of the statistics in reports and snapshots
+static const char *BF_statistic_names[BF_stat_count] =
+{
+	[BF_stat_add] = "add",
+	[BF_stat_subtract] = "subtract",
+	[BF_stat_multiply] = "multiplyBy",
+	[BF_stat_divide] = "divideBy",
+	[BF_stat_modulo] = "moduloBy",
+	[BF_stat_compare] = "compareWith",
+	[BF_stat_convert_radix] = "convertToRadix",
+	[BF_stat_implicit_conversion] = "implicit radix conversions",
+	[BF_stat_accumulate] = "accumulateProducts",
+	[BF_stat_accumulate_terms] = "accumulateProducts terms",
+	[BF_stat_power_of_e] = "powerOfE",
+	[BF_stat_power_of_e_terms] = "powerOfE terms",
+	[BF_stat_ln] = "ln",
+	[BF_stat_ln_terms] = "ln terms",
+	[BF_stat_raise_to_power] = "raiseToPower",
+	[BF_stat_sin] = "sin",
+	[BF_stat_sin_terms] = "sin terms",
+	[BF_stat_cos] = "cos",
+	[BF_stat_cos_terms] = "cos terms",
+	[BF_stat_tan] = "tan",
+	[BF_stat_tan_terms] = "tan terms",
+	[BF_stat_nroot] = "nRoot",
+	[BF_stat_nroot_iterations] = "nRoot iterations",
+	[BF_stat_factorial] = "factorial",
+	[BF_stat_factorial_terms] = "factorial terms",
+	[BF_stat_limited_string] = "limitedString"
+};
+
 #pragma mark
 
 @implementation BigFloat
@@ -58,6 +214,287 @@ typedef struct
 #pragma mark
 #pragma mark ### Inline helper functions ###
 
+//
+// About the kernels
+//
+// The loops over mantissas are generated by the macros below rather than written out
+// with a runtime bound. Each is expanded once for every limb count it's used at (one,
+// two and BF_accumulator_multiple lots of BF_num_values) and once for each kind of
+// number format: GENERAL divides by the limit and the radix, POW2 serves the radices
+// whose limit is also a power of two (2, 4, 8, 16 and 32) and shifts and masks
+// instead. Since every bound is known at compile time the loops are fully unrolled.
+//
+// Each radix gets a table of its kernels, filled in once by BF_KernelsSetup, which the
+// helper functions and the arithmetic methods find by indexing on the radix. A limit
+// that isn't the radix's own (convertToRadix mixes them) gets the GENERAL kernels.
+//
+typedef struct BFKernels
+{
+	unsigned short	radix;
+	unsigned long	limit;
+	unsigned int	radixShift;		// log2 of the radix and the limit (POW2 only)
+	unsigned int	limitShift;
+	
+	unsigned long	(*add)(unsigned long *values, const unsigned long *other, const struct BFKernels *format);
+	void			(*subtract)(unsigned long *result, const unsigned long *larger, const unsigned long *smaller, const struct BFKernels *format);
+	void			(*multiply)(unsigned long *result, const unsigned long *values, const unsigned long *other, const struct BFKernels *format);
+	
+	// Indexed by the number of multiples of BF_num_values, less one
+	void			(*addDigit[BF_accumulator_multiple])(unsigned long *values, unsigned long digit, const struct BFKernels *format);
+	void			(*shiftLeft[BF_accumulator_multiple])(unsigned long *values, unsigned long digit, const struct BFKernels *format);
+	unsigned long	(*shiftRight[BF_accumulator_multiple])(unsigned long *values, BOOL *isEmpty, const struct BFKernels *format);
+} BFKernels;
+
+#if BF_accumulator_multiple != 3
+	#error The kernels are only generated for one to three multiples of BF_num_values
+#endif
+
+// Division by, and remainder of, the limit and the radix in each kind of format
+#define BF_GENERAL_LIMIT_DIV(x, f)	((x) / (f)->limit)
+#define BF_GENERAL_LIMIT_MOD(x, f)	((x) % (f)->limit)
+#define BF_GENERAL_RADIX_DIV(x, f)	((x) / (f)->radix)
+#define BF_GENERAL_RADIX_MOD(x, f)	((x) % (f)->radix)
+#define BF_POW2_LIMIT_DIV(x, f)		((x) >> (f)->limitShift)
+#define BF_POW2_LIMIT_MOD(x, f)		((x) & ((f)->limit - 1))
+#define BF_POW2_RADIX_DIV(x, f)		((x) >> (f)->radixShift)
+#define BF_POW2_RADIX_MOD(x, f)		((x) & ((f)->radix - 1))
+
+#if defined(__clang__)
+#define BF_UNROLL					_Pragma("clang loop unroll(full)")
+#else
+#define BF_UNROLL
+#endif
+
+//
+// BF_DEFINE_FORMAT_KERNELS
+//
+// The kernels that work on single width mantissas: BF_Add_<kind> adds other to values
+// and returns the carry out of the top limb, BF_Multiply_<kind> adds the double width
+// product of values and other to result (skipping zero limbs of other, which add
+// nothing).
+//
+#define BF_DEFINE_FORMAT_KERNELS(kind)																\
+static unsigned long																				\
+BF_Add_##kind(unsigned long *values, const unsigned long *other, const BFKernels *format)			\
+{																									\
+	unsigned long carryBits = 0;																	\
+																									\
+	BF_UNROLL																						\
+	for (int i = 0; i < BF_num_values; i++)															\
+	{																								\
+		values[i] = values[i] + other[i] + carryBits;												\
+		carryBits = BF_##kind##_LIMIT_DIV(values[i], format);										\
+		values[i] = BF_##kind##_LIMIT_MOD(values[i], format);										\
+	}																								\
+																									\
+	return carryBits;																				\
+}																									\
+																									\
+static void																							\
+BF_Multiply_##kind(unsigned long *result, const unsigned long *values, const unsigned long *other, const BFKernels *format) \
+{																									\
+	for (int j = 0; j < BF_num_values; j++)															\
+	{																								\
+		unsigned long carryBits = 0;																\
+																									\
+		if (other[j] == 0)																			\
+			continue;																				\
+																									\
+		BF_UNROLL																					\
+		for (int i = 0; i < BF_num_values; i++)														\
+		{																							\
+			result[i + j] += (values[i] * other[j]) + carryBits;									\
+			carryBits = BF_##kind##_LIMIT_DIV(result[i + j], format);								\
+			result[i + j] = BF_##kind##_LIMIT_MOD(result[i + j], format);							\
+		}																							\
+		result[j + BF_num_values] += carryBits;														\
+	}																								\
+}
+
+//
+// BF_DEFINE_COUNT_KERNELS
+//
+// The kernels that work on mantissas of count times BF_num_values limbs: adding a
+// single limb, appending a digit (shifting left) and removing one (shifting right). A
+// carry out of the top is put back in limb BF_num_values - 1, as it always has been.
+//
+#define BF_DEFINE_COUNT_KERNELS(kind, count)														\
+static void																							\
+BF_AddDigit_##kind##_##count(unsigned long *values, unsigned long digit, const BFKernels *format)	\
+{																									\
+	BF_UNROLL																						\
+	for (int i = 0; i < BF_num_values * count; i++)													\
+	{																								\
+		values[i] += digit;																			\
+		digit = BF_##kind##_LIMIT_DIV(values[i], format);											\
+		values[i] = BF_##kind##_LIMIT_MOD(values[i], format);										\
+	}																								\
+	values[BF_num_values - 1] += digit * format->limit;												\
+}																									\
+																									\
+static void																							\
+BF_ShiftLeft_##kind##_##count(unsigned long *values, unsigned long digit, const BFKernels *format)	\
+{																									\
+	BF_UNROLL																						\
+	for (int i = 0; i < BF_num_values * count; i++)													\
+	{																								\
+		values[i] = (values[i] * format->radix) + digit;											\
+		digit = BF_##kind##_LIMIT_DIV(values[i], format);											\
+		values[i] = BF_##kind##_LIMIT_MOD(values[i], format);										\
+	}																								\
+	values[BF_num_values - 1] += digit * format->limit;												\
+}																									\
+																									\
+static unsigned long																				\
+BF_ShiftRight_##kind##_##count(unsigned long *values, BOOL *isEmpty, const BFKernels *format)		\
+{																									\
+	unsigned long	carryBits = 0;																	\
+	BOOL			empty = YES;																	\
+																									\
+	BF_UNROLL																						\
+	for (int i = (BF_num_values * count) - 1; i >= 0; i--)											\
+	{																								\
+		values[i] = values[i] + (carryBits * format->limit);										\
+		carryBits = BF_##kind##_RADIX_MOD(values[i], format);										\
+		values[i] = BF_##kind##_RADIX_DIV(values[i], format);										\
+		if (values[i] != 0) empty = NO;																\
+	}																								\
+																									\
+	if (isEmpty) *isEmpty = empty;																	\
+	return carryBits;																				\
+}
+
+BF_DEFINE_FORMAT_KERNELS(GENERAL)
+BF_DEFINE_FORMAT_KERNELS(POW2)
+BF_DEFINE_COUNT_KERNELS(GENERAL, 1)
+BF_DEFINE_COUNT_KERNELS(GENERAL, 2)
+BF_DEFINE_COUNT_KERNELS(GENERAL, 3)
+BF_DEFINE_COUNT_KERNELS(POW2, 1)
+BF_DEFINE_COUNT_KERNELS(POW2, 2)
+BF_DEFINE_COUNT_KERNELS(POW2, 3)
+
+//
+// BF_SubtractMantissas
+//
+// Sets result to larger less smaller (which must not be greater), borrowing from the
+// limb above. Needs no division, so it serves both kinds of format. result may be
+// either operand.
+//
+static void
+BF_SubtractMantissas(unsigned long *result, const unsigned long *larger, const unsigned long *smaller, const BFKernels *format)
+{
+	unsigned long	borrow = 0;
+	unsigned long	subtrahend;
+	
+	BF_UNROLL
+	for (int i = 0; i < BF_num_values; i++)
+	{
+		subtrahend = smaller[i] + borrow;
+		if (larger[i] >= subtrahend)
+		{
+			result[i] = larger[i] - subtrahend;
+			borrow = 0;
+		}
+		else
+		{
+			result[i] = larger[i] + format->limit - subtrahend;
+			borrow = 1;
+		}
+	}
+}
+
+//
+// BF_CompareMantissas
+//
+// Compares two normalised mantissas limb by limb from the top.
+//
+static inline NSComparisonResult
+BF_CompareMantissas(const unsigned long *values, const unsigned long *other)
+{
+	BF_UNROLL
+	for (int i = BF_num_values - 1; i >= 0; i--)
+	{
+		if (values[i] > other[i])
+			return NSOrderedDescending;
+		if (values[i] < other[i])
+			return NSOrderedAscending;
+	}
+	
+	return NSOrderedSame;
+}
+
+static const BFKernels BF_general_kernels =
+{
+	.add = BF_Add_GENERAL,
+	.subtract = BF_SubtractMantissas,
+	.multiply = BF_Multiply_GENERAL,
+	.addDigit = {BF_AddDigit_GENERAL_1, BF_AddDigit_GENERAL_2, BF_AddDigit_GENERAL_3},
+	.shiftLeft = {BF_ShiftLeft_GENERAL_1, BF_ShiftLeft_GENERAL_2, BF_ShiftLeft_GENERAL_3},
+	.shiftRight = {BF_ShiftRight_GENERAL_1, BF_ShiftRight_GENERAL_2, BF_ShiftRight_GENERAL_3}
+};
+
+static const BFKernels BF_pow2_kernels =
+{
+	.add = BF_Add_POW2,
+	.subtract = BF_SubtractMantissas,
+	.multiply = BF_Multiply_POW2,
+	.addDigit = {BF_AddDigit_POW2_1, BF_AddDigit_POW2_2, BF_AddDigit_POW2_3},
+	.shiftLeft = {BF_ShiftLeft_POW2_1, BF_ShiftLeft_POW2_2, BF_ShiftLeft_POW2_3},
+	.shiftRight = {BF_ShiftRight_POW2_1, BF_ShiftRight_POW2_2, BF_ShiftRight_POW2_3}
+};
+
+// The kernels for each radix (see BF_KernelsSetup)
+static BFKernels BF_radix_kernels[37];
+
+//
+// BF_KernelsSetup
+//
+// Chooses the kernels for every radix. Called once, from +initialize.
+//
+static void
+BF_KernelsSetup(void)
+{
+	unsigned short	radix;
+	unsigned long	precision;
+	unsigned long	limit;
+	BOOL			powerOfTwo;
+	
+	for (radix = 2; radix <= 36; radix++)
+	{
+		// The same limit setElements gives the radix
+		precision = (unsigned long)(log(0xFFFF + 1) / log(radix));
+		limit = (unsigned int)(pow(radix, precision));
+		powerOfTwo = (radix & (radix - 1)) == 0 && (limit & (limit - 1)) == 0;
+		
+		BF_radix_kernels[radix] = powerOfTwo ? BF_pow2_kernels : BF_general_kernels;
+		BF_radix_kernels[radix].radix = radix;
+		BF_radix_kernels[radix].limit = limit;
+		if (powerOfTwo)
+		{
+			BF_radix_kernels[radix].radixShift = (unsigned int)__builtin_ctzl(radix);
+			BF_radix_kernels[radix].limitShift = (unsigned int)__builtin_ctzl(limit);
+		}
+	}
+}
+
+//
+// BF_Kernels
+//
+// The kernels for a radix and limit. A pair that isn't one of the number formats is
+// set up in scratch with the GENERAL kernels.
+//
+static inline const BFKernels *
+BF_Kernels(unsigned short radix, unsigned long limit, BFKernels *scratch)
+{
+	if (radix <= 36 && BF_radix_kernels[radix].limit == limit)
+		return &BF_radix_kernels[radix];
+	
+	*scratch = BF_general_kernels;
+	scratch->radix = radix;
+	scratch->limit = limit;
+	return scratch;
+}
+
 //
 // BF_ClearValuesArray
 //
@@ -135,19 +572,13 @@ BF_AssignValues(unsigned long *destination, unsigned long *copyArray)
 // Adds a single unsigned long to an array of values.
 //
 void
-BF_AddToMantissa(unsigned long *values, unsigned long digit, unsigned long limit, unsigned int multiple)
+BF_AddToMantissa(unsigned long *values, unsigned long digit, unsigned short radix, unsigned long limit, unsigned int multiple)
 {
-	int i;
-
-	// Multiply through by the bf_radix and add the digit
-	for (i = 0; i < BF_num_values * multiple; i++)
-	{
-		values[i] += digit;
-		digit = values[i] / limit;
-		values[i] %= limit;
-	}
+	BFKernels		scratch;
+	const BFKernels	*format = BF_Kernels(radix, limit, &scratch);
 	
-	values[BF_num_values - 1] += digit * limit;
+	NSCAssert(multiple >= 1 && multiple <= BF_accumulator_multiple, @"No kernel for this width");
+	format->addDigit[multiple - 1](values, digit, format);
 }
 
 //
@@ -159,16 +590,11 @@ BF_AddToMantissa(unsigned long *values, unsigned long digit, unsigned long limit
 void
 BF_AppendDigitToMantissa(unsigned long *values, unsigned long digit, unsigned short radix, unsigned long limit, unsigned int multiple)
 {
-	int i;
-
-	// Multiply through by the bf_radix and add the digit
-	for (i = 0; i < BF_num_values * multiple; i++)
-	{
-		values[i]	= (values[i] * radix) + digit;
-		digit		= values[i] / limit;
-		values[i]	= values[i] % limit;
-	}
-	values[BF_num_values - 1] += digit * limit;
+	BFKernels		scratch;
+	const BFKernels	*format = BF_Kernels(radix, limit, &scratch);
+	
+	NSCAssert(multiple >= 1 && multiple <= BF_accumulator_multiple, @"No kernel for this width");
+	format->shiftLeft[multiple - 1](values, digit, format);
 }
 
 //
@@ -179,18 +605,11 @@ BF_AppendDigitToMantissa(unsigned long *values, unsigned long digit, unsigned sh
 signed long
 BF_RemoveDigitFromMantissa(unsigned long *values, unsigned short radix, unsigned long limit, unsigned int multiple)
 {
-	// Truncate a digit by dividing through by the bf_radix
-	unsigned long	carryBits = 0;
-	int			i;
-	
-	for (i = (BF_num_values * multiple) - 1; i >= 0; i--)
-	{
-		values[i] = values[i] + (carryBits * limit);
-		carryBits = values[i] % radix;
-		values[i] = values[i] / radix;
-	}
+	BFKernels		scratch;
+	const BFKernels	*format = BF_Kernels(radix, limit, &scratch);
 	
-	return carryBits;
+	NSCAssert(multiple >= 1 && multiple <= BF_accumulator_multiple, @"No kernel for this width");
+	return (signed long)format->shiftRight[multiple - 1](values, NULL, format);
 }
 
 //
@@ -202,22 +621,11 @@ BF_RemoveDigitFromMantissa(unsigned long *values, unsigned short radix, unsigned
 signed long
 BF_RemoveDigitFromMantissaAndFlagEmpty(unsigned long *values, unsigned short radix, unsigned long limit, unsigned int multiple, BOOL *isEmpty)
 {
-	// Truncate a digit by dividing through by the bf_radix
-	unsigned long	carryBits = 0;
-	int					i;
-	BOOL				empty = YES;
+	BFKernels		scratch;
+	const BFKernels	*format = BF_Kernels(radix, limit, &scratch);
 	
-	for (i = (BF_num_values * multiple) - 1; i >= 0; i--)
-	{
-		values[i] = values[i] + (carryBits * limit);
-		carryBits = values[i] % radix;
-		values[i] = values[i] / radix;
-		if (values[i] != 0) empty = NO;
-	}
-	
-	*isEmpty = empty;
-	
-	return carryBits;
+	NSCAssert(multiple >= 1 && multiple <= BF_accumulator_multiple, @"No kernel for this width");
+	return (signed long)format->shiftRight[multiple - 1](values, isEmpty, format);
 }
 
 //
@@ -338,11 +746,11 @@ BF_NormaliseNumbers
 	// Apply a round to nearest on any truncated values
 	if (!otherEmpty && (double)otherRoundingNum >= ((double)thisNumElements->bf_radix / 2.0))
 	{
-		BF_AddToMantissa(otherTerm, 1, otherNumElements->bf_value_limit, 1);
+		BF_AddToMantissa(otherTerm, 1, otherNumElements->bf_radix, otherNumElements->bf_value_limit, 1);
 	}
 	else if (!thisEmpty && (double)thisRoundingNum >= ((double)thisNumElements->bf_radix / 2.0))
 	{
-		BF_AddToMantissa(values, 1, thisNumElements->bf_value_limit, 1);
+		BF_AddToMantissa(values, 1, thisNumElements->bf_radix, thisNumElements->bf_value_limit, 1);
 	}
 	
 	if (thisEmpty && !otherEmpty)
@@ -459,7 +867,24 @@ BF_NormaliseNumbers
 }
 
 - (BigFloat *)pi {
-	if (!pi_array[bf_radix]) {[self calculatePi]; }
+	if (!pi_array[bf_radix])
+	{
+		BigFloat *packed = [[BigFloat alloc] initWithInt:0 radix:bf_radix];
+		
+		if ([packed assignConstant:BF_constant_pi])
+		{
+			pi_array[bf_radix] = packed;
+		}
+		else
+		{
+			// π is kept for good so it's always calculated at full precision
+			unsigned int workingDigits = BF_working_digits;
+			
+			BF_working_digits = 0;
+			[self calculatePi];
+			BF_working_digits = workingDigits;
+		}
+	}
 	return [pi_array[bf_radix] copy];
 }
 
@@ -565,6 +990,17 @@ BF_NormaliseNumbers
 #pragma mark
 #pragma mark ##### Constructors #####
 
+//
+// initialize
+//
+// Chooses the kernels for each radix before any number is made.
+//
++ (void)initialize
+{
+	if (self == [BigFloat class])
+		BF_KernelsSetup();
+}
+
 //
 // init
 //
@@ -1117,6 +1553,8 @@ BF_NormaliseNumbers
 	{
 		return;
 	}
+	
+	BF_TIME(BF_stat_convert_radix);
 
 	// ignore invalid numbers
 	if (bf_is_valid == NO)
@@ -1274,15 +1712,16 @@ BF_NormaliseNumbers
 //
 - (NSComparisonResult)compareWith: (BigFloat*)num
 {
+	BF_TIME(BF_stat_compare);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
-	int					i;
 	BigFloatElements	thisNumElements;
 	BigFloatElements	otherNumElements;
 	NSComparisonResult	compare;
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
 		[num convertToRadix:bf_radix];
 	}
@@ -1326,21 +1765,11 @@ BF_NormaliseNumbers
 		otherNum[0] *= bf_radix;
 	}
 	
-	// Now that we're normalised, do the actual comparison
-	compare = NSOrderedSame;
-	for (i = BF_num_values - 1; i >= 0; i--)
-	{
-		if ((values[i] > otherNum[i] && !bf_is_negative) || (values[i] < otherNum[i] && bf_is_negative))
-		{
-			compare = NSOrderedDescending;
-			break;
-		}
-		else if ((values[i] < otherNum[i] && !bf_is_negative) || (values[i] > otherNum[i] && bf_is_negative))
-		{
-			compare = NSOrderedAscending;
-			break;
-		}
-	}
+	// Now that we're normalised, do the actual comparison (of magnitudes, so flip it for
+	// negative numbers)
+	compare = BF_CompareMantissas(values, otherNum);
+	if (bf_is_negative && compare != NSOrderedSame)
+		compare = (compare == NSOrderedDescending) ? NSOrderedAscending : NSOrderedDescending;
 	
 	return compare;
 }
@@ -1404,17 +1833,21 @@ BF_NormaliseNumbers
 //
 - (void)add: (BigFloat*)num
 {
+	BF_TIME(BF_stat_add);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
-	int						i;
 	unsigned long 		carryBits = 0;
 	BigFloatElements	thisNumElements;
 	BigFloatElements	otherNumElements;
+	BFKernels			scratch;
+	const BFKernels		*format;
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
-		[num convertToRadix:bf_radix];	}
+		[num convertToRadix:bf_radix];
+	}
 
 	BF_CopyValues(bf_array, values);
 	[self copyElements: &thisNumElements];
@@ -1443,13 +1876,8 @@ BF_NormaliseNumbers
 	BF_NormaliseNumbers(values, otherNum, &thisNumElements, &otherNumElements);
 	
 	// We can finally do the addition at this point (yay!)
-	carryBits = 0;
-	for (i = 0; i < BF_num_values; i++)
-	{
-		values[i] = values[i] + otherNum[i] + carryBits;
-		carryBits = values[i] / thisNumElements.bf_value_limit;
-		values[i] %= thisNumElements.bf_value_limit;
-	}
+	format = BF_Kernels(thisNumElements.bf_radix, thisNumElements.bf_value_limit, &scratch);
+	carryBits = format->add(values, otherNum, format);
 	
 	// If we have exceeded the maximum precision, reel it back in
 	if (carryBits != 0)
@@ -1463,7 +1891,7 @@ BF_NormaliseNumbers
 	// Apply round to nearest
 	if ((double)carryBits >= ((double)thisNumElements.bf_radix / 2.0))
 	{
-		BF_AddToMantissa(values, 1, thisNumElements.bf_value_limit, 1);
+		BF_AddToMantissa(values, 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
 		
 		// If by shear fluke that cause the top digit to overflow, then shift back by one digit
 		if (values[BF_num_values - 1] > thisNumElements.bf_value_limit)
@@ -1488,15 +1916,18 @@ BF_NormaliseNumbers
 //
 - (void)subtract: (BigFloat*)num
 {
-	int					i, peek;
+	BF_TIME(BF_stat_subtract);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
 	BigFloatElements	thisNumElements;
 	BigFloatElements	otherNumElements;
 	NSComparisonResult	compare;
+	BFKernels			scratch;
+	const BFKernels		*format;
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
 		[num convertToRadix:bf_radix];
 	}
@@ -1526,42 +1957,13 @@ BF_NormaliseNumbers
 	BF_NormaliseNumbers(values, otherNum, &thisNumElements, &otherNumElements);
 	
 	// Compare the two values
-	compare = NSOrderedSame;
-	for (i = BF_num_values - 1; i >= 0; i--)
-	{
-		if (values[i] > otherNum[i])
-		{
-			compare = NSOrderedDescending;
-			break;
-		}
-		else if (values[i] < otherNum[i])
-		{
-			compare = NSOrderedAscending;
-			break;
-		}
-	}
+	compare = BF_CompareMantissas(values, otherNum);
+	format = BF_Kernels(thisNumElements.bf_radix, thisNumElements.bf_value_limit, &scratch);
 	
 	if (compare == NSOrderedDescending)
 	{
 		// Perform the subtraction
-		for (i = 0; i < BF_num_values; i++)
-		{
-			// Borrow from the next column if we need to
-			if (otherNum[i] > values[i])
-			{
-				// Since we know that this num is greater than otherNum, then we know
-				// that this will never exceed the bounds of the array
-				peek = 1;
-				while(values[i + peek] == 0)
-				{
-					values[i + peek] = thisNumElements.bf_value_limit - 1;
-					peek++;
-				}
-				values[i+peek]--;
-				values[i] += thisNumElements.bf_value_limit;
-			}
-			values[i] = values[i] - otherNum[i];
-		}
+		format->subtract(values, values, otherNum, format);
 	}
 	else if (compare == NSOrderedAscending)
 	{
@@ -1569,24 +1971,7 @@ BF_NormaliseNumbers
 		thisNumElements.bf_is_negative = !thisNumElements.bf_is_negative;
 		
 		// Perform the subtraction
-		for (i = 0; i < BF_num_values; i++)
-		{
-			// Borrow from the next column if we need to
-			if (values[i] > otherNum[i])
-			{
-				// Since we know that this num is greater than otherNum, then we know
-				// that this will never exceed the bounds of the array
-				peek = 1;
-				while(otherNum[i + peek] == 0)
-				{
-					otherNum[i + peek] = otherNumElements.bf_value_limit - 1;
-					peek++;
-				}
-				otherNum[i+peek]--;
-				otherNum[i] += otherNumElements.bf_value_limit;
-			}
-			values[i] = otherNum[i] - values[i];
-		}
+		format->subtract(values, otherNum, values, format);
 	}
 	else
 	{
@@ -1613,17 +1998,20 @@ BF_NormaliseNumbers
 //
 - (void)multiplyBy: (BigFloat*)num
 {
-	int					i, j;
+	BF_TIME(BF_stat_multiply);
 	long				carryBits = 0;
 	unsigned long		result[BF_num_values * 2];
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
 	BigFloatElements	thisNumElements;
 	BigFloatElements	otherNumElements;
+	BFKernels			scratch;
+	const BFKernels		*format;
 //	BOOL				shift = NO;
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
 		[num convertToRadix:bf_radix];
 	}
@@ -1658,23 +2046,8 @@ BF_NormaliseNumbers
 	
 	// Now we do the multiplication. Basic stuff: 
 	// Multiply each column of each of the otherNums by each other and sum all of the results
-	for (j = 0; j < BF_num_values; j++)
-	{
-		// Add the product of this column of otherNum with this num
-		carryBits = 0;
-		for (i = 0; i < BF_num_values; i++)
-		{
-			result[i + j] += (values[i] * otherNum[j]) + carryBits;
-			carryBits = result[i + j] / thisNumElements.bf_value_limit;
-			result[i + j] = result[i + j] % thisNumElements.bf_value_limit;
-			
-//			if (i + j >= BF_num_values && result[i + j] != 0) shift = YES;
-		}
-		
-		// Add the carry for the last multiplication to the next column
-		result[j + BF_num_values] += carryBits;
-//		if (result[j + BF_num_values] != 0) shift = YES;
-	}
+	format = BF_Kernels(thisNumElements.bf_radix, thisNumElements.bf_value_limit, &scratch);
+	format->multiply(result, values, otherNum, format);
 	
 	// If we have exceeded the precision, divide by the bf_radix until
 	// we are reeled back in.
@@ -1687,7 +2060,7 @@ BF_NormaliseNumbers
 	// Apply round to nearest
 	if ((double)carryBits >= ((double)bf_radix / 2.0))
 	{
-		BF_AddToMantissa(result, 1, thisNumElements.bf_value_limit, 1);
+		BF_AddToMantissa(result, 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
 		
 		// If by shear fluke that caused the top digit to overflow, then shift back by one digit
 		if (result[BF_num_values - 1] > thisNumElements.bf_value_limit)
@@ -1712,6 +2085,7 @@ BF_NormaliseNumbers
 //
 - (void)divideBy: (BigFloat*)num
 {
+	BF_TIME(BF_stat_divide);
 	int					i, j, peek;
 	unsigned long		carryBits;
 	unsigned long		values[BF_num_values * 2];
@@ -1725,6 +2099,7 @@ BF_NormaliseNumbers
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
 		[num convertToRadix:bf_radix];
 	}
@@ -1794,7 +2169,7 @@ BF_NormaliseNumbers
 
 		if ((double)carryBits >= ((double)otherNumElements.bf_radix / 2.0))
 		{
-			BF_AddToMantissa(otherNumValues, 1, otherNumElements.bf_value_limit, 2);
+			BF_AddToMantissa(otherNumValues, 1, otherNumElements.bf_radix, otherNumElements.bf_value_limit, 2);
 		}
 	}
 	else
@@ -1955,7 +2330,7 @@ BF_NormaliseNumbers
 	// Apply a round to nearest on the last digit
 	if (((double)result[BF_num_values - 1] / (double)(bf_value_limit / bf_radix)) >= ((double)bf_radix / 2.0))
 	{
-		BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_value_limit, 1);
+		BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
 		
 		// If by shear fluke that cause the top digit to overflow, then shift back by one digit
 		if (result[BF_num_values - 1] > thisNumElements.bf_value_limit)
@@ -1964,7 +2339,7 @@ BF_NormaliseNumbers
 			thisNumElements.bf_exponent++;
 			if ((double)carryBits >= ((double)thisNumElements.bf_radix / 2.0))
 			{
-				BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_value_limit, 1);
+				BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
 			}
 		}
 	}
@@ -1978,7 +2353,7 @@ BF_NormaliseNumbers
 	}
 	if ((double)carryBits >= ((double)thisNumElements.bf_radix / 2.0))
 	{
-		BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_value_limit, 1);
+		BF_AddToMantissa(&result[BF_num_values], 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
 	}
 	
 	
@@ -1997,6 +2372,7 @@ BF_NormaliseNumbers
 //
 - (void)moduloBy: (BigFloat*)num
 {
+	BF_TIME(BF_stat_modulo);
 	int					i, j, peek;
 	unsigned long		carryBits;
 	unsigned long		values[BF_num_values * 2];
@@ -2012,6 +2388,7 @@ BF_NormaliseNumbers
 	
 	if ([num radix] != bf_radix)
 	{
+		BF_COUNT(BF_stat_implicit_conversion);
 		num = [num copy];
 		[num convertToRadix:bf_radix];
 	}
@@ -2255,79 +2632,1478 @@ BF_NormaliseNumbers
 }
 
 #pragma mark
-#pragma mark ##### Extended Mathematics Functions #####
+#pragma mark ##### Fused Arithmetic Functions #####
 
 //
-// powerOfE
+// BF_AccumulateTerm
 //
-// The value of the receiver will be e^x where x is the value of the receiver
-// before calling this function.
+// Adds a term (magnitude, exponent and sign) into a running sum. Both are accumulator
+// width arrays: room for a double width product plus as much again to line up terms of
+// different size. The larger is shifted up while there is room, then the smaller is
+// shifted down to meet it, so digits are only lost far below anything that survives
+// the final rounding. The term is used as scratch.
 //
-- (void)powerOfE
+static void
+BF_AccumulateTerm
+(
+	unsigned long *sum, signed int *sumExponent, BOOL *sumNegative,
+	unsigned long *term, signed int termExponent, BOOL termNegative,
+	unsigned short radix, unsigned long limit
+)
 {
-	BigFloat	*prevIteration;
-	BigFloat	*powerCopy;
-	BigFloat	*nextTerm;
-	BigFloat	*original;
-	BigFloat	*factorialValue;
-	BigFloat	*one;
-	BigFloat	*two;
-	BOOL		use_inverse = NO;
-	BigFloat	*i;
-	int			squares = 0;
-	
-	if (!bf_is_valid)
+	const int		width = BF_num_values * BF_accumulator_multiple;
+	unsigned long	*high = sum;
+	unsigned long	*low = term;
+	unsigned long	*larger;
+	unsigned long	*smaller;
+	signed int		highExponent = *sumExponent;
+	signed int		lowExponent = termExponent;
+	unsigned long	carryBits;
+	long			difference;
+	int				i;
+	
+	if (!BF_ArrayIsNonZero(term, BF_accumulator_multiple))
 		return;
 	
-	// Pre-scale the number to aid convergeance
-	if (bf_is_negative)
+	if (!BF_ArrayIsNonZero(sum, BF_accumulator_multiple))
 	{
-		use_inverse = YES;
-		bf_is_negative = NO;
+		for (i = 0; i < width; i++) sum[i] = term[i];
+		*sumExponent = termExponent;
+		*sumNegative = termNegative;
+		return;
 	}
 	
-	one = [[BigFloat alloc] initWithInt:1 radix:bf_radix];
-	two = [[BigFloat alloc] initWithInt:2 radix:bf_radix];
-	while ([self compareWith: one] == NSOrderedDescending)
+	// Line the two numbers up
+	if (termExponent > *sumExponent)
 	{
-		[self divideBy: two];
-		squares++;
+		high = term;
+		highExponent = termExponent;
+		low = sum;
+		lowExponent = *sumExponent;
 	}
+	while (highExponent > lowExponent && high[width - 1] == 0 && high[width - 2] < limit / radix)
+	{
+		BF_AppendDigitToMantissa(high, 0, radix, limit, BF_accumulator_multiple);
+		highExponent--;
+	}
+	while (lowExponent < highExponent && BF_ArrayIsNonZero(low, BF_accumulator_multiple))
+	{
+		BF_RemoveDigitFromMantissa(low, radix, limit, BF_accumulator_multiple);
+		lowExponent++;
+	}
+	*sumExponent = highExponent;
 	
-	// Initialise stuff
-	factorialValue = [[BigFloat alloc] initWithInt:1 radix:bf_radix];
-	prevIteration = [factorialValue copy];
-	original = [self copy];
-	powerCopy = [self copy];
-	
-	// Set the current value to 1 (the zeroth term)
-	[self assign:factorialValue];
-
-	// Add the second term
-	[self add: original];
-	
-	// otherwise iterate the Taylor Series until we obtain a stable solution
-	i = [[BigFloat alloc] initWithInt:2 radix:bf_radix];;
-	nextTerm = [factorialValue copy];
-	while([self compareWith: prevIteration] != NSOrderedSame)
+	if (*sumNegative == termNegative)
 	{
-		// Get a copy of the current value so that we can see if it changes
-		[prevIteration assign:self];
-		
-		// Determine the next term of the series
-		[powerCopy multiplyBy: original];
-		[nextTerm assign:powerCopy];
-		
-		[factorialValue multiplyBy:i];
-		[nextTerm divideBy: factorialValue];
-		
-		// Add the next term if it is valid
-		if ([nextTerm isValid])
+		carryBits = 0;
+		for (i = 0; i < width; i++)
 		{
-			[self add: nextTerm];
+			sum[i] = sum[i] + term[i] + carryBits;
+			carryBits = sum[i] / limit;
+			sum[i] %= limit;
 		}
-		
-		[i add:one];
+	}
+	else
+	{
+		// Take the smaller magnitude from the larger, which gives the sign
+		for (i = width - 1; i > 0 && sum[i] == term[i]; i--);
+		larger = (term[i] > sum[i]) ? term : sum;
+		smaller = (larger == term) ? sum : term;
+		if (larger == term) *sumNegative = termNegative;
+		
+		carryBits = 0;
+		for (i = 0; i < width; i++)
+		{
+			difference = (long)larger[i] - (long)smaller[i] - (long)carryBits;
+			carryBits = (difference < 0);
+			sum[i] = (unsigned long)(carryBits ? difference + (long)limit : difference);
+		}
+	}
+	
+	// Keep the top value clear so the next addition has somewhere to carry to
+	while (sum[width - 1] != 0)
+	{
+		BF_RemoveDigitFromMantissa(sum, radix, limit, BF_accumulator_multiple);
+		(*sumExponent)++;
+	}
+}
+
+//
+// accumulateProductsOf
+//
+// The fused kernel behind the functions below: adds signs[i] * first[i] * second[i] to
+// the receiver for every i (signs may be NULL for all positive). Each product is formed
+// exactly at double width and summed in a wide accumulator along with the receiver's
+// own value, and the result is rounded once at the end, instead of rounding and
+// renormalising after every multiply and add.
+//
+- (void)accumulateProductsOf:(NSArray *)first and:(NSArray *)second signs:(const signed char *)signs
+{
+	BF_TIME(BF_stat_accumulate);
+	unsigned long		sum[BF_num_values * BF_accumulator_multiple];
+	unsigned long		term[BF_num_values * BF_accumulator_multiple];
+	signed int			sumExponent;
+	BOOL				sumNegative;
+	BigFloatElements	thisNumElements;
+	BigFloatElements	firstElements;
+	BigFloatElements	secondElements;
+	BigFloat			*firstNum;
+	BigFloat			*secondNum;
+	unsigned long		carryBits;
+	NSUInteger			n;
+	int					i, j;
+	
+	NSAssert([first count] == [second count], @"Both lists of factors must be the same length");
+	
+	[self copyElements: &thisNumElements];
+	if (thisNumElements.bf_is_valid == NO)
+		return;
+	
+	// Start from the receiver's own value
+	BF_ClearValuesArray(sum, BF_accumulator_multiple);
+	BF_CopyValues(bf_array, sum);
+	sumExponent = thisNumElements.bf_exponent - thisNumElements.bf_user_point;
+	sumNegative = thisNumElements.bf_is_negative;
+	
+	for (n = 0; n < [first count]; n++)
+	{
+		firstNum = first[n];
+		secondNum = second[n];
+		BF_COUNT(BF_stat_accumulate_terms);
+		if ([firstNum radix] != bf_radix)
+		{
+			BF_COUNT(BF_stat_implicit_conversion);
+			firstNum = [firstNum copy];
+			[firstNum convertToRadix:bf_radix];
+		}
+		if ([secondNum radix] != bf_radix)
+		{
+			BF_COUNT(BF_stat_implicit_conversion);
+			secondNum = [secondNum copy];
+			[secondNum convertToRadix:bf_radix];
+		}
+		[firstNum copyElements: &firstElements];
+		[secondNum copyElements: &secondElements];
+		
+		// ignore invalid numbers
+		if (firstElements.bf_is_valid == NO || secondElements.bf_is_valid == NO)
+		{
+			bf_is_valid = NO;
+			return;
+		}
+		
+		// The exact product, as in multiplyBy: but without rounding
+		BF_ClearValuesArray(term, BF_accumulator_multiple);
+		for (j = 0; j < BF_num_values; j++)
+		{
+			carryBits = 0;
+			for (i = 0; i < BF_num_values; i++)
+			{
+				term[i + j] += (firstNum->bf_array[i] * secondNum->bf_array[j]) + carryBits;
+				carryBits = term[i + j] / thisNumElements.bf_value_limit;
+				term[i + j] = term[i + j] % thisNumElements.bf_value_limit;
+			}
+			term[j + BF_num_values] += carryBits;
+		}
+		
+		BF_AccumulateTerm
+		(
+			sum, &sumExponent, &sumNegative,
+			term,
+			(firstElements.bf_exponent - firstElements.bf_user_point) + (secondElements.bf_exponent - secondElements.bf_user_point),
+			(firstElements.bf_is_negative != secondElements.bf_is_negative) != (signs != NULL && signs[n] < 0),
+			thisNumElements.bf_radix, thisNumElements.bf_value_limit
+		);
+	}
+	
+	// Round once, back to the normal precision
+	carryBits = 0;
+	while (BF_ArrayIsNonZero(&sum[BF_num_values], BF_accumulator_multiple - 1))
+	{
+		carryBits = BF_RemoveDigitFromMantissa(sum, thisNumElements.bf_radix, thisNumElements.bf_value_limit, BF_accumulator_multiple);
+		sumExponent++;
+	}
+	if ((double)carryBits >= ((double)thisNumElements.bf_radix / 2.0))
+	{
+		BF_AddToMantissa(sum, 1, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
+		
+		// If that overflowed the top digit, shift back by one digit
+		if (sum[BF_num_values - 1] >= thisNumElements.bf_value_limit)
+		{
+			BF_RemoveDigitFromMantissa(sum, thisNumElements.bf_radix, thisNumElements.bf_value_limit, 1);
+			sumExponent++;
+		}
+	}
+	
+	thisNumElements.bf_exponent = sumExponent;
+	thisNumElements.bf_user_point = 0;
+	thisNumElements.bf_is_negative = sumNegative && BF_ArrayIsNonZero(sum, 1);
+	
+	// Create a user pont, store all the values back in the class and we're done
+	BF_AssignValues(bf_array, sum);
+	[self assignElements: &thisNumElements];
+	[self createUserPoint];
+}
+
+//
+// addProductOf
+//
+// Fused multiply-add: adds first * second to the receiver with a single rounding.
+//
+- (void)addProductOf:(BigFloat*)first and:(BigFloat*)second
+{
+	[self accumulateProductsOf:@[first] and:@[second] signs:NULL];
+}
+
+//
+// subtractProductOf
+//
+// Fused multiply-subtract: takes first * second from the receiver with a single rounding.
+//
+- (void)subtractProductOf:(BigFloat*)first and:(BigFloat*)second
+{
+	const signed char minus = -1;
+	
+	[self accumulateProductsOf:@[first] and:@[second] signs:&minus];
+}
+
+//
+// addProductsOf
+//
+// Dot product: adds the sum of first[i] * second[i] to the receiver with a single rounding.
+//
+- (void)addProductsOf:(NSArray *)first and:(NSArray *)second
+{
+	[self accumulateProductsOf:first and:second signs:NULL];
+}
+
+//
+// subtractProductsOf
+//
+// Takes the sum of first[i] * second[i] from the receiver with a single rounding.
+//
+- (void)subtractProductsOf:(NSArray *)first and:(NSArray *)second
+{
+	NSMutableData *signs = [NSMutableData dataWithLength:[first count]];
+	
+	memset([signs mutableBytes], -1, [first count]);
+	[self accumulateProductsOf:first and:second signs:[signs bytes]];
+}
+
+#pragma mark
+#pragma mark ##### Result Cache #####
+
+//
+// BF_CacheSetup
+//
+// Creates the lock and the table the first time the cache is used.
+//
+static void
+BF_CacheSetup(void)
+{
+	static dispatch_once_t once;
+	
+	dispatch_once(&once, ^{
+		BF_cache_lock = [[NSLock alloc] init];
+		BF_cache_entries = [[NSMutableDictionary alloc] initWithCapacity:BF_cache_default_capacity];
+	});
+}
+
+//
+// BF_CacheUnlink
+//
+// Removes an entry from the recency list (but not from the table). Call with the
+// lock held.
+//
+static void
+BF_CacheUnlink(BigFloatCacheEntry *entry)
+{
+	if (entry->newer)
+		entry->newer->older = entry->older;
+	else
+		BF_cache_newest = entry->older;
+	
+	if (entry->older)
+		entry->older->newer = entry->newer;
+	else
+		BF_cache_oldest = entry->newer;
+	
+	entry->newer = nil;
+	entry->older = nil;
+}
+
+//
+// BF_CachePushNewest
+//
+// Puts an unlinked entry at the head of the recency list. Call with the lock held.
+//
+static void
+BF_CachePushNewest(BigFloatCacheEntry *entry)
+{
+	entry->older = BF_cache_newest;
+	entry->newer = nil;
+	
+	if (BF_cache_newest)
+		BF_cache_newest->newer = entry;
+	BF_cache_newest = entry;
+	
+	if (!BF_cache_oldest)
+		BF_cache_oldest = entry;
+}
+
+//
+// BF_CacheTrim
+//
+// Evicts least recently used entries until the cache fits its capacity. Call with
+// the lock held.
+//
+static void
+BF_CacheTrim(void)
+{
+	while ([BF_cache_entries count] > BF_cache_capacity && BF_cache_oldest)
+	{
+		BigFloatCacheEntry *victim = BF_cache_oldest;
+		
+		BF_CacheUnlink(victim);
+		[BF_cache_entries removeObjectForKey:victim->key];
+	}
+}
+
+//
+// BF_CacheLookup
+//
+// Returns the cached result for a key (marking it as recently used), or nil.
+//
+static BigFloat *
+BF_CacheLookup(NSData *key)
+{
+	BigFloatCacheEntry	*entry;
+	BigFloat			*result = nil;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	
+	entry = BF_cache_entries[key];
+	if (entry)
+	{
+		BF_CacheUnlink(entry);
+		BF_CachePushNewest(entry);
+		result = entry->result;
+		BF_cache_hits++;
+	}
+	else
+	{
+		BF_cache_misses++;
+	}
+	
+	[BF_cache_lock unlock];
+	return result;
+}
+
+//
+// BF_CacheStore
+//
+// Remembers a result for a key. The result must not be modified afterwards.
+//
+static void
+BF_CacheStore(NSData *key, BigFloat *result)
+{
+	BigFloatCacheEntry *entry;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	
+	if (BF_cache_capacity > 0)
+	{
+		// Another thread may have computed the same value in the meantime
+		entry = BF_cache_entries[key];
+		if (entry)
+		{
+			BF_CacheUnlink(entry);
+		}
+		else
+		{
+			entry = [[BigFloatCacheEntry alloc] init];
+			entry->key = key;
+			BF_cache_entries[key] = entry;
+		}
+		
+		entry->result = result;
+		BF_CachePushNewest(entry);
+		BF_CacheTrim();
+	}
+	
+	[BF_cache_lock unlock];
+}
+
+//
+// cacheHits
+//
+// Number of extended function calls answered from the cache.
+//
++ (NSUInteger)cacheHits
+{
+	NSUInteger hits;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	hits = BF_cache_hits;
+	[BF_cache_lock unlock];
+	
+	return hits;
+}
+
+//
+// cacheMisses
+//
+// Number of extended function calls that had to be calculated.
+//
++ (NSUInteger)cacheMisses
+{
+	NSUInteger misses;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	misses = BF_cache_misses;
+	[BF_cache_lock unlock];
+	
+	return misses;
+}
+
+//
+// cacheCount
+//
+// Number of results currently held in the cache.
+//
++ (NSUInteger)cacheCount
+{
+	NSUInteger count;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	count = [BF_cache_entries count];
+	[BF_cache_lock unlock];
+	
+	return count;
+}
+
+//
+// cacheCapacity
+//
+// The maximum number of results held before the least recently used are dropped.
+//
++ (NSUInteger)cacheCapacity
+{
+	NSUInteger capacity;
+	
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	capacity = BF_cache_capacity;
+	[BF_cache_lock unlock];
+	
+	return capacity;
+}
+
+//
+// setCacheCapacity
+//
+// Resizes the cache. Zero disables caching entirely.
+//
++ (void)setCacheCapacity:(NSUInteger)capacity
+{
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	BF_cache_capacity = capacity;
+	BF_CacheTrim();
+	[BF_cache_lock unlock];
+}
+
+//
+// clearCache
+//
+// Drops every cached result and zeroes the hit and miss counters.
+//
++ (void)clearCache
+{
+	BF_CacheSetup();
+	[BF_cache_lock lock];
+	[BF_cache_entries removeAllObjects];
+	BF_cache_newest = nil;
+	BF_cache_oldest = nil;
+	BF_cache_hits = 0;
+	BF_cache_misses = 0;
+	[BF_cache_lock unlock];
+}
+
+//
+// appendCacheKeyTo
+//
+// Appends the bits that determine this number's value (mantissa, exponent, sign,
+// radix and precision) to a cache key.
+//
+- (void)appendCacheKeyTo:(NSMutableData *)key
+{
+	BigFloatElements elements;
+	
+	// Clear the padding so that equal numbers give equal bytes
+	memset(&elements, 0, sizeof(elements));
+	[self copyElements: &elements];
+	
+	[key appendBytes:bf_array length:sizeof(bf_array)];
+	[key appendBytes:&elements length:sizeof(elements)];
+}
+
+//
+// cacheKeyForOperation
+//
+// Builds the key identifying an operation on the receiver (and on the operand, for
+// binary operations). The classes are part of the key since BigCFloat answers
+// differently for the same real input.
+//
+- (NSData *)cacheKeyForOperation:(BFCachedOperation)op operand:(BigFloat *)num trigMode:(BFTrigMode)mode inv:(BOOL)useInverse hyp:(BOOL)useHyp
+{
+	NSMutableData	*key = [NSMutableData dataWithCapacity:2 * (sizeof(bf_array) + sizeof(BigFloatElements)) + 32];
+	unsigned char	header[4] = {op, (unsigned char)mode, (unsigned char)useInverse, (unsigned char)useHyp};
+	uintptr_t		classTag = (uintptr_t)(__bridge void *)[self class];
+	
+	[key appendBytes:header length:sizeof(header)];
+	[key appendBytes:&classTag length:sizeof(classTag)];
+	[self appendCacheKeyTo:key];
+	
+	if (num)
+	{
+		classTag = (uintptr_t)(__bridge void *)[num class];
+		[key appendBytes:&classTag length:sizeof(classTag)];
+		[num appendCacheKeyTo:key];
+	}
+	
+	return key;
+}
+
+//
+// assignCachedResultForKey
+//
+// Sets the receiver to a previously cached result. Returns NO on a miss.
+//
+- (BOOL)assignCachedResultForKey:(NSData *)key
+{
+	BigFloat *result;
+	
+	// A full precision result would do, but at a reduced precision the lookup costs
+	// more than it saves
+	if (BF_working_digits != 0)
+		return NO;
+	
+	result = BF_CacheLookup(key);
+	if (!result)
+		return NO;
+	
+	[self assign:result];
+	return YES;
+}
+
+//
+// storeCachedResultForKey
+//
+// Stores a copy of the receiver as the result for key. Results calculated at a reduced
+// working precision aren't stored.
+//
+- (void)storeCachedResultForKey:(NSData *)key
+{
+	if (BF_working_digits != 0)
+		return;
+	
+	BF_CacheStore(key, [self copy]);
+}
+
+#pragma mark
+#pragma mark ##### Working Precision #####
+
+//
+// About the working precision
+//
+// Every BigFloat holds BF_num_values limbs, but a result that is only going to be
+// shown to a dozen digits doesn't need its series and Newton iterations run until the
+// last limb stops changing. Setting a working precision for the calling thread lets
+// those loops stop as soon as successive iterations agree to that many digits. The
+// arithmetic itself is unchanged. Results calculated at a reduced precision bypass the
+// result cache and π is always calculated at full precision, since both are kept.
+//
+
+//
+// workingDigits
+//
+// The calling thread's working precision in digits of the radix, or 0 for full
+// precision.
+//
++ (unsigned int)workingDigits
+{
+	return BF_working_digits;
+}
+
+//
+// setWorkingDigits
+//
+// Sets the calling thread's working precision. 0 restores full precision.
+//
++ (void)setWorkingDigits:(unsigned int)digits
+{
+	BF_working_digits = digits;
+}
+
+//
+// precisionDigits
+//
+// The number of radix digits the mantissa holds; one ulp is a unit in the last of them.
+//
+- (int)precisionDigits
+{
+	return BF_num_values * bf_value_precision;
+}
+
+//
+// hasConvergedTo
+//
+// The termination test for the series and Newton loops. YES if the receiver equals
+// previous or, with a working precision set, if the two differ only beyond the working
+// digits.
+//
+- (BOOL)hasConvergedTo:(BigFloat *)previous
+{
+	BigFloat	*difference;
+	long		magnitude;
+	long		differenceMagnitude;
+	
+	if ([self compareWith:previous] == NSOrderedSame)
+		return YES;
+	
+	if (BF_working_digits == 0 || BF_working_digits >= (unsigned int)[self precisionDigits])
+		return NO;
+	if (!bf_is_valid || ![previous isValid] || [self isZero])
+		return NO;
+	
+	difference = [self copy];
+	[difference subtract:previous];
+	if ([difference isZero])
+		return YES;
+	
+	// Compare the positions of the most significant digits
+	magnitude = BF_NumDigitsInArray(bf_array, bf_radix, bf_value_precision) + bf_exponent - bf_user_point;
+	differenceMagnitude =
+		BF_NumDigitsInArray(difference->bf_array, bf_radix, bf_value_precision) +
+		difference->bf_exponent - difference->bf_user_point;
+	
+	return magnitude - differenceMagnitude > (long)BF_working_digits;
+}
+
+#pragma mark
+#pragma mark ##### Compact Encoding #####
+
+//
+// About the compact encoding
+//
+// A binary alternative to the keyed archive for pasteboards and the history. Numbers
+// are variable length (7 bits a byte, least significant first; signed numbers are
+// zig-zagged so small negatives stay short) and a BigFloat is
+//
+//	flags (bit 0 negative, bit 1 valid), radix, exponent, user point,
+//	limb count, then the limbs (least significant first) as 16 bit little endian
+//
+// with high zero limbs left off. Precision and limits are derived from the radix, as
+// in setElements. A number written with more limbs than BF_num_values loses its
+// least significant limbs on reading.
+//
+
+//
+// BF_DecoderForData
+//
+// A decoder over the bytes of data from offset on. The data must outlive the decoder.
+//
+BFDecoder
+BF_DecoderForData(NSData *data, NSUInteger offset)
+{
+	BFDecoder decoder;
+	
+	decoder.bytes = (const uint8_t *)[data bytes] + MIN(offset, [data length]);
+	decoder.end = (const uint8_t *)[data bytes] + [data length];
+	decoder.failed = NO;
+	
+	return decoder;
+}
+
+//
+// BF_EncodeByte
+//
+// Appends one byte.
+//
+void
+BF_EncodeByte(NSMutableData *data, uint8_t byte)
+{
+	[data appendBytes:&byte length:1];
+}
+
+//
+// BF_EncodeUnsigned
+//
+// Appends a variable length unsigned number.
+//
+void
+BF_EncodeUnsigned(NSMutableData *data, unsigned long long number)
+{
+	uint8_t		bytes[10];
+	int			length = 0;
+	
+	do
+	{
+		bytes[length] = (number & 0x7F) | ((number > 0x7F) ? 0x80 : 0);
+		number >>= 7;
+		length++;
+	} while (number != 0);
+	
+	[data appendBytes:bytes length:length];
+}
+
+//
+// BF_EncodeSigned
+//
+// Appends a variable length signed number.
+//
+void
+BF_EncodeSigned(NSMutableData *data, long long number)
+{
+	BF_EncodeUnsigned(data, ((unsigned long long)number << 1) ^ (unsigned long long)(number >> 63));
+}
+
+//
+// BF_DecodeByte
+//
+// Reads one byte.
+//
+uint8_t
+BF_DecodeByte(BFDecoder *decoder)
+{
+	if (decoder->failed || decoder->bytes >= decoder->end)
+	{
+		decoder->failed = YES;
+		return 0;
+	}
+	
+	return *decoder->bytes++;
+}
+
+//
+// BF_DecodeUnsigned
+//
+// Reads a variable length unsigned number.
+//
+unsigned long long
+BF_DecodeUnsigned(BFDecoder *decoder)
+{
+	unsigned long long	number = 0;
+	int					shift;
+	uint8_t				byte;
+	
+	for (shift = 0; shift < 64; shift += 7)
+	{
+		byte = BF_DecodeByte(decoder);
+		number |= (unsigned long long)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			return number;
+	}
+	
+	decoder->failed = YES;
+	return 0;
+}
+
+//
+// BF_DecodeSigned
+//
+// Reads a variable length signed number.
+//
+long long
+BF_DecodeSigned(BFDecoder *decoder)
+{
+	unsigned long long number = BF_DecodeUnsigned(decoder);
+	
+	return (long long)(number >> 1) ^ -(long long)(number & 1);
+}
+
+//
+// initWithEncoding
+//
+// Reads a number written by appendEncodingTo:.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder
+{
+	uint8_t				flags;
+	unsigned short		radix;
+	long long			exponent;
+	unsigned long long	userPoint, count, dropped, i;
+	
+	self = [super init];
+	if (self)
+	{
+		flags = BF_DecodeByte(decoder);
+		radix = BF_DecodeByte(decoder);
+		exponent = BF_DecodeSigned(decoder);
+		userPoint = BF_DecodeUnsigned(decoder);
+		count = BF_DecodeUnsigned(decoder);
+		
+		if (radix < 2 || radix > 36 || exponent < INT_MIN || exponent > INT_MAX || count > (unsigned long long)(decoder->end - decoder->bytes) / 2)
+			decoder->failed = YES;
+		if (decoder->failed)
+			count = 0;
+		
+		BF_ClearValuesArray(bf_array, 1);
+		[self setElements:radix negative:(flags & 1) != 0 exp:0 valid:(flags & 2) != 0 userPoint:(unsigned short)MIN(userPoint, USHRT_MAX)];
+		
+		// Limbs beyond our precision are the least significant ones; drop them
+		dropped = (count > BF_num_values) ? count - BF_num_values : 0;
+		for (i = 0; i < count; i++)
+		{
+			unsigned long limb = BF_DecodeByte(decoder);
+			
+			limb |= (unsigned long)BF_DecodeByte(decoder) << 8;
+			if (i >= dropped)
+				bf_array[i - dropped] = MIN(limb, bf_value_limit - 1);
+		}
+		exponent += (long long)dropped * bf_value_precision;
+		bf_exponent = (int)MAX(MIN(exponent, INT_MAX), INT_MIN);
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Writes the number in the compact encoding.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	int count = BF_num_values;
+	int i;
+	
+	while (count > 0 && bf_array[count - 1] == 0)
+		count--;
+	
+	BF_EncodeByte(data, (bf_is_negative ? 1 : 0) | (bf_is_valid ? 2 : 0));
+	BF_EncodeByte(data, (uint8_t)bf_radix);
+	BF_EncodeSigned(data, bf_exponent);
+	BF_EncodeUnsigned(data, bf_user_point);
+	BF_EncodeUnsigned(data, count);
+	for (i = 0; i < count; i++)
+	{
+		uint8_t limb[2] = {bf_array[i] & 0xFF, (bf_array[i] >> 8) & 0xFF};
+		
+		[data appendBytes:limb length:sizeof(limb)];
+	}
+}
+
+#pragma mark
+#pragma mark ##### Packed Constants #####
+
+//
+// About the packed constants
+//
+// π, e, ln 2 and ln 10 for radices 2, 8, 10 and 16 are generated ahead of time by
+// Tools/make_constants.py into BigFloatConstants.h, correctly rounded and packed in the
+// compact encoding with no user point, so loading one is a decode with no arithmetic.
+// Other radices, or a build with any other number of limbs than the constants were
+// generated for, calculate them as before.
+//
+
+//
+// bigFloatWithPackedNumber
+//
+// Reads a packed number and gives it the usual user point. Always a plain BigFloat.
+//
++ (BigFloat *)bigFloatWithPackedNumber:(BFPackedNumber)packed
+{
+	BFDecoder	decoder = {packed.bytes, packed.bytes + packed.length, NO};
+	BigFloat	*result = [[BigFloat alloc] initWithEncoding:&decoder];
+	
+	NSAssert(!decoder.failed, @"Corrupt packed number");
+	[result createUserPoint];
+	return result;
+}
+
+//
+// assignConstant
+//
+// Sets the receiver to a packed constant in its own radix. Returns NO, leaving the
+// receiver alone, if that constant isn't packed for the radix.
+//
+- (BOOL)assignConstant:(BFConstant)constant
+{
+#if BF_num_values == BF_packed_num_values
+	BFPackedNumber packed = BF_packed_constants[constant][bf_radix];
+	
+	if (packed.bytes == NULL)
+		return NO;
+	
+	[self assign:[BigFloat bigFloatWithPackedNumber:packed]];
+	return YES;
+#else
+	return NO;
+#endif
+}
+
+#pragma mark
+#pragma mark ##### Exact Integer Conversion #####
+
+//
+// initWithBigInteger
+//
+// The nearest BigFloat to an exact integer, rounding half up if it has more digits than
+// the mantissa holds. A nil integer gives an invalid number.
+//
+- (instancetype)initWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix
+{
+	BigInteger			*mantissa = [integer absoluteValue];
+	BigInteger			*radixInteger, *limit, *digit = nil;
+	NSData				*digits;
+	int					precision, dropped = 0, estimate;
+	
+	self = [self initWithInt:0 radix:newRadix];
+	if (self == nil)
+		return nil;
+	
+	if (integer == nil)
+	{
+		bf_is_valid = NO;
+		return self;
+	}
+	if ([integer isZero])
+		return self;
+	
+	// Drop all but one more digit than fits in a single division (the estimate is never
+	// more than the real number of digits), then the rest one at a time
+	precision = bf_value_precision * BF_num_values;
+	radixInteger = [BigInteger integerWithLong:bf_radix];
+	limit = [radixInteger raiseToIntPower:precision];
+	estimate = (int)floor(([mantissa bitLength] - 1) * log(2.0) / log(bf_radix));
+	if (estimate > precision)
+	{
+		mantissa = [mantissa divideBy:[radixInteger raiseToIntPower:estimate - precision]];
+		dropped = estimate - precision;
+	}
+	while ([mantissa compareWith:limit] != NSOrderedAscending)
+	{
+		mantissa = [mantissa divideBy:radixInteger remainder:&digit];
+		dropped++;
+	}
+	
+	// Round on the last digit dropped
+	if (digit != nil && [[digit add:digit] compareWith:radixInteger] != NSOrderedAscending)
+	{
+		mantissa = [mantissa add:[BigInteger one]];
+		if ([mantissa compareWith:limit] == NSOrderedSame)
+		{
+			mantissa = [mantissa divideBy:radixInteger];
+			dropped++;
+		}
+	}
+	
+	digits = [mantissa digitsWithBase:bf_value_limit];
+	memcpy(bf_array, [digits bytes], MIN([digits length], sizeof(bf_array)));
+	bf_exponent = dropped;
+	bf_is_negative = [integer isNegative];
+	if (bf_exponent > 0xFFFF)
+		bf_is_valid = NO;
+	
+	return self;
+}
+
+//
+// bigFloatWithBigInteger
+//
++ (BigFloat*)bigFloatWithBigInteger:(BigInteger *)integer radix:(unsigned short)newRadix
+{
+	return [[BigFloat alloc] initWithBigInteger:integer radix:newRadix];
+}
+
+//
+// bigIntegerValue
+//
+// The exact integer this number holds, or nil if it is invalid or has a fractional part.
+//
+- (BigInteger *)bigIntegerValue
+{
+	BigInteger	*result, *scale, *remainder = nil;
+	int			shift = bf_exponent - bf_user_point;
+	
+	if (!bf_is_valid)
+		return nil;
+	
+	result = [BigInteger integerWithDigits:bf_array count:BF_num_values base:bf_value_limit negative:bf_is_negative];
+	if (shift == 0 || [result isZero])
+		return result;
+	
+	scale = [[BigInteger integerWithLong:bf_radix] raiseToIntPower:abs(shift)];
+	if (shift > 0)
+		return [result multiplyBy:scale];
+	
+	result = [result divideBy:scale remainder:&remainder];
+	return [remainder isZero] ? result : nil;
+}
+
+#pragma mark
+#pragma mark ##### Statistics #####
+
+//
+// BF_StatisticsDictionary
+//
+// Converts counts and times into the dictionary returned by the statistics methods.
+// Statistics that never occurred are left out.
+//
+static NSDictionary *
+BF_StatisticsDictionary(const uint64_t *counts, const uint64_t *nanoseconds)
+{
+	NSMutableDictionary	*result = [NSMutableDictionary dictionary];
+	int					i;
+	
+	for (i = 0; i < BF_stat_count; i++)
+	{
+		if (counts[i] == 0)
+			continue;
+		
+		result[@(BF_statistic_names[i])] = @{@"count": @(counts[i]), @"nanoseconds": @(nanoseconds[i])};
+	}
+	
+	return result;
+}
+
+//
+// statistics
+//
+// The operation statistics summed over every thread since the last reset, keyed by
+// name, each a dictionary with a "count" and (for the timed kernels) "nanoseconds".
+// Other threads may still be counting, so the totals are approximate while busy.
+//
++ (NSDictionary *)statistics
+{
+	uint64_t			counts[BF_stat_count] = {0};
+	uint64_t			nanoseconds[BF_stat_count] = {0};
+#if BF_statistics
+	BFStatisticsBlock	*block;
+	int					i;
+	
+	pthread_mutex_lock(&BF_statistics_lock);
+	for (block = BF_statistics_blocks; block != NULL; block = block->next)
+	{
+		for (i = 0; i < BF_stat_count; i++)
+		{
+			counts[i] += block->counts[i];
+			nanoseconds[i] += block->nanoseconds[i];
+		}
+	}
+	pthread_mutex_unlock(&BF_statistics_lock);
+#endif
+	
+	return BF_StatisticsDictionary(counts, nanoseconds);
+}
+
+//
+// threadStatistics
+//
+// As statistics but for the calling thread only.
+//
++ (NSDictionary *)threadStatistics
+{
+#if BF_statistics
+	BFStatisticsBlock *block = BF_ThreadStatistics();
+	
+	return BF_StatisticsDictionary(block->counts, block->nanoseconds);
+#else
+	return @{};
+#endif
+}
+
+//
+// threadKernelCalls
+//
+// The number of kernel calls made by the calling thread since the last reset, leaving
+// out the series terms, iterations and implicit conversions counted inside them. Cheap
+// enough to take around every node of an expression evaluation.
+//
++ (unsigned long long)threadKernelCalls
+{
+	unsigned long long	calls = 0;
+#if BF_statistics
+	BFStatisticsBlock	*block = BF_ThreadStatistics();
+	int					i;
+	
+	for (i = 0; i < BF_stat_count; i++)
+	{
+		switch (i)
+		{
+			case BF_stat_implicit_conversion:
+			case BF_stat_accumulate_terms:
+			case BF_stat_power_of_e_terms:
+			case BF_stat_ln_terms:
+			case BF_stat_sin_terms:
+			case BF_stat_cos_terms:
+			case BF_stat_tan_terms:
+			case BF_stat_nroot_iterations:
+			case BF_stat_factorial_terms:
+				break;
+			default:
+				calls += block->counts[i];
+				break;
+		}
+	}
+#endif
+	
+	return calls;
+}
+
+//
+// resetStatistics
+//
+// Zeroes the statistics of every thread.
+//
++ (void)resetStatistics
+{
+#if BF_statistics
+	BFStatisticsBlock *block;
+	
+	pthread_mutex_lock(&BF_statistics_lock);
+	for (block = BF_statistics_blocks; block != NULL; block = block->next)
+	{
+		memset(block->counts, 0, sizeof(block->counts));
+		memset(block->nanoseconds, 0, sizeof(block->nanoseconds));
+	}
+	pthread_mutex_unlock(&BF_statistics_lock);
+#endif
+}
+
+//
+// statisticsReport
+//
+// The statistics over every thread as a table, one line per statistic, followed by
+// the result cache counters.
+//
++ (NSString *)statisticsReport
+{
+	NSDictionary	*statistics = [BigFloat statistics];
+	NSMutableString	*report = [NSMutableString string];
+	int				i;
+	
+#if !BF_statistics
+	[report appendString:@"Operation statistics are not compiled in (BF_statistics is 0).\n"];
+#endif
+	
+	[report appendFormat:@"%-28s %12s %14s %12s\n", "operation", "count", "total ms", "ns/call"];
+	for (i = 0; i < BF_stat_count; i++)
+	{
+		NSDictionary	*entry = statistics[@(BF_statistic_names[i])];
+		uint64_t		count = [entry[@"count"] unsignedLongLongValue];
+		uint64_t		nanoseconds = [entry[@"nanoseconds"] unsignedLongLongValue];
+		
+		if (entry == nil)
+			continue;
+		
+		if (nanoseconds)
+			[report appendFormat:@"%-28s %12llu %14.3f %12.0f\n", BF_statistic_names[i], count, nanoseconds / 1.0e6, (double)nanoseconds / count];
+		else
+			[report appendFormat:@"%-28s %12llu\n", BF_statistic_names[i], count];
+	}
+	
+	[report appendFormat:@"\ncache: %lu hits, %lu misses, %lu of %lu entries\n",
+		(unsigned long)[BigFloat cacheHits], (unsigned long)[BigFloat cacheMisses],
+		(unsigned long)[BigFloat cacheCount], (unsigned long)[BigFloat cacheCapacity]];
+	
+	return report;
+}
+
+#pragma mark
+#pragma mark ##### Extended Mathematics Functions #####
+
+//
+// powerOfE
+//
+// The value of the receiver will be e^x where x is the value of the receiver
+// before calling this function. Results are cached; see computePowerOfE.
+//
+- (void)powerOfE
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_power_of_e operand:nil trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computePowerOfE];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// ln
+//
+// Takes the natural logarithm of the receiver. Results are cached; see computeLn.
+//
+- (void)ln
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_ln operand:nil trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeLn];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// raiseToPower
+//
+// Raises the receiver to the exponent "num". Results are cached; see
+// computeRaiseToPower.
+//
+- (void)raiseToPower: (BigFloat*)num
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_raise_to_power operand:num trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeRaiseToPower:num];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// logOfBase
+//
+// Takes the "base" log of the receiver. Results are cached; see computeLogOfBase.
+//
+- (void)logOfBase:(BigFloat *)base
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_log_of_base operand:base trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeLogOfBase:base];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// sinWithTrigMode
+//
+// sin, arcsin, hypsin and hyparcsin. Results are cached per trig mode; see
+// computeSinWithTrigMode.
+//
+- (void)sinWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_sin operand:nil trigMode:mode inv:useInverse hyp:useHyp];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeSinWithTrigMode:mode inv:useInverse hyp:useHyp];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// cosWithTrigMode
+//
+// cos, arccos, hypcos and hyparccos. Results are cached per trig mode; see
+// computeCosWithTrigMode.
+//
+- (void)cosWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_cos operand:nil trigMode:mode inv:useInverse hyp:useHyp];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeCosWithTrigMode:mode inv:useInverse hyp:useHyp];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// tanWithTrigMode
+//
+// tan, arctan, hyptan and hyparctan. Results are cached per trig mode; see
+// computeTanWithTrigMode.
+//
+- (void)tanWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_tan operand:nil trigMode:mode inv:useInverse hyp:useHyp];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeTanWithTrigMode:mode inv:useInverse hyp:useHyp];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// factorial
+//
+// Factorial of the receiver. Results are cached; see computeFactorial.
+//
+- (void)factorial
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_factorial operand:nil trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeFactorial];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// nPr
+//
+// Permutation of receiver samples made from a range of r options. Results are
+// cached; see computeNPr.
+//
+- (void)nPr: (BigFloat *)r
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_npr operand:r trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeNPr:r];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// nCr
+//
+// Receiver combinations of samples taken from a choice of r candidates. Results are
+// cached; see computeNCr.
+//
+- (void)nCr: (BigFloat *)r
+{
+	NSData *key;
+	
+	if (!bf_is_valid)
+		return;
+	
+	key = [self cacheKeyForOperation:BF_cache_ncr operand:r trigMode:BF_radians inv:NO hyp:NO];
+	if ([self assignCachedResultForKey:key])
+		return;
+	
+	[self computeNCr:r];
+	[self storeCachedResultForKey:key];
+}
+
+//
+// computePowerOfE
+//
+// The value of the receiver will be e^x where x is the value of the receiver
+// before calling this function.
+//
+- (void)computePowerOfE
+{
+	BF_TIME(BF_stat_power_of_e);
+	BigFloat	*prevIteration;
+	BigFloat	*powerCopy;
+	BigFloat	*nextTerm;
+	BigFloat	*original;
+	BigFloat	*factorialValue;
+	BigFloat	*one;
+	BigFloat	*two;
+	BOOL		use_inverse = NO;
+	BigFloat	*i;
+	int			squares = 0;
+	
+	if (!bf_is_valid)
+		return;
+	
+	// Pre-scale the number to aid convergeance
+	if (bf_is_negative)
+	{
+		use_inverse = YES;
+		bf_is_negative = NO;
+	}
+	
+	one = [[BigFloat alloc] initWithInt:1 radix:bf_radix];
+	two = [[BigFloat alloc] initWithInt:2 radix:bf_radix];
+	
+	// e itself is packed for the common radices
+	if (!use_inverse && [self compareWith:one] == NSOrderedSame && [self assignConstant:BF_constant_e])
+		return;
+	
+	while ([self compareWith: one] == NSOrderedDescending)
+	{
+		[self divideBy: two];
+		squares++;
+	}
+	
+	// Initialise stuff
+	factorialValue = [[BigFloat alloc] initWithInt:1 radix:bf_radix];
+	prevIteration = [factorialValue copy];
+	original = [self copy];
+	powerCopy = [self copy];
+	
+	// Set the current value to 1 (the zeroth term)
+	[self assign:factorialValue];
+
+	// Add the second term
+	[self add: original];
+	
+	// otherwise iterate the Taylor Series until we obtain a stable solution
+	i = [[BigFloat alloc] initWithInt:2 radix:bf_radix];;
+	nextTerm = [factorialValue copy];
+	while(![self hasConvergedTo: prevIteration])
+	{
+		BF_COUNT(BF_stat_power_of_e_terms);
+		// Get a copy of the current value so that we can see if it changes
+		[prevIteration assign:self];
+		
+		// Determine the next term of the series
+		[powerCopy multiplyBy: original];
+		[nextTerm assign:powerCopy];
+		
+		[factorialValue multiplyBy:i];
+		[nextTerm divideBy: factorialValue];
+		
+		// Add the next term if it is valid
+		if ([nextTerm isValid])
+		{
+			[self add: nextTerm];
+		}
+		
+		[i add:one];
 	}
 	
 	// Reverse the prescaling
@@ -2345,12 +4121,13 @@ BF_NormaliseNumbers
 }
 
 //
-// ln
+// computeLn
 //
 // Takes the natural logarithm of the receiver.
 //
-- (void)ln
+- (void)computeLn
 {
+	BF_TIME(BF_stat_ln);
 	BigFloat				*factorNum;
 	BigFloat				*prevIteration;
 	BigFloat				*powerCopy;
@@ -2379,6 +4156,12 @@ BF_NormaliseNumbers
 		return;
 	}
 	
+	// ln 2 and ln 10 are packed for the common radices (log₂ and log divide by them)
+	if ([self compareWith:i] == NSOrderedSame && [self assignConstant:BF_constant_ln2])
+		return;
+	if ([self compareWith:[BigFloat bigFloatWithInt:10 radix:bf_radix]] == NSOrderedSame && [self assignConstant:BF_constant_ln10])
+		return;
+	
 	// ln(x) for x > 1 == -ln(1/x)
 	compare = [self compareWith: one];
 	if (compare == NSOrderedDescending)
@@ -2404,8 +4187,9 @@ BF_NormaliseNumbers
 	nextTerm = [self copy];
 
 	// iterate the Taylor Series until we obtain a stable solution
-	while([self compareWith: prevIteration] != NSOrderedSame)
+	while(![self hasConvergedTo: prevIteration])
 	{
+		BF_COUNT(BF_stat_ln_terms);
 		// Get a copy of the current value so that we can see if it changes
 		[prevIteration assign: self];
 
@@ -2446,12 +4230,13 @@ BF_NormaliseNumbers
 }
 
 //
-// raiseToPower
+// computeRaiseToPower
 //
 // Raises the receiver to the exponent "num".
 //
-- (void)raiseToPower: (BigFloat*)num
+- (void)computeRaiseToPower: (BigFloat*)num
 {
+	BF_TIME(BF_stat_raise_to_power);
 	BigFloat	*numCopy;
 	BigFloat	*one;
 	BigFloat	*minus_one;
@@ -2587,6 +4372,7 @@ BF_NormaliseNumbers
 // Takes the nth root of the receiver
 //
 - (void)nRoot: (NSUInteger)n {
+	BF_TIME(BF_stat_nroot);
 	BigFloat			*original;
 	BigFloat			*prevGuess;
 	BigFloat			*newGuess;
@@ -2594,7 +4380,7 @@ BF_NormaliseNumbers
 	int					i, j;
 	BOOL				digitNotFound = YES;
 	int					numDigits;
-	NSComparisonResult	compare;
+	BOOL				converged;
 	BOOL				negative = bf_is_negative;
 	
 	if (!bf_is_valid) return;
@@ -2636,13 +4422,14 @@ BF_NormaliseNumbers
 	bf_exponent -= (numDigits / (int)n);
 	prevGuess = [self copy];
 	newGuess = [self copy];
-	compare = NSOrderedDescending;
+	converged = NO;
 	
 	// Do some Newton's method iterations until we converge
 	NSInteger maxIterations = 1000;
 	BigFloat *power = [[BigFloat alloc] init];
-	while (compare != NSOrderedSame && maxIterations-- > 0)
+	while (!converged && maxIterations-- > 0)
 	{
+		BF_COUNT(BF_stat_nroot_iterations);
 		[prevGuess assign:newGuess];
 		
 		[newGuess assign:original];
@@ -2652,7 +4439,7 @@ BF_NormaliseNumbers
 		[newGuess subtract:prevGuess];
 		[newGuess divideBy:root];
 		[newGuess add:prevGuess];
-		compare = [newGuess compareWith:prevGuess];
+		converged = [newGuess hasConvergedTo:prevGuess];
 	}
 	if (maxIterations <= 0) NSLog(@"Exceeded iteration limit on root evaluation: Error is likely");
 	
@@ -2724,11 +4511,11 @@ BF_NormaliseNumbers
 }
 
 //
-// logOfBase
+// computeLogOfBase
 //
 // Takes the "base" log of the receiver.
 //
-- (void)logOfBase:(BigFloat *)base
+- (void)computeLogOfBase:(BigFloat *)base
 {
 	BigFloat *baseCopy;
 	
@@ -2796,13 +4583,14 @@ BF_NormaliseNumbers
 }
 
 //
-// sinWithTrigMode
+// computeSinWithTrigMode
 //
 // Really this is four different functions in one:
 //		sin, arcsin, hypsin and hyparcsin
 //
-- (void)sinWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+- (void)computeSinWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
 {
+	BF_TIME(BF_stat_sin);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
 	BigFloatElements	thisNumElements;
@@ -2840,8 +4628,9 @@ BF_NormaliseNumbers
 			nextTerm = [self copy];
 			
 			i = 1;
-			while([self compareWith: prevIteration] != NSOrderedSame)
+			while(![self hasConvergedTo: prevIteration])
 			{
+				BF_COUNT(BF_stat_sin_terms);
 				BigFloat *twoN;
 				BigFloat *twoNPlusOne;
 				
@@ -2925,8 +4714,9 @@ BF_NormaliseNumbers
 			nextTerm = [self copy];
 			
 			i = 1;
-			while([self compareWith: prevIteration] != NSOrderedSame)
+			while(![self hasConvergedTo: prevIteration])
 			{
+				BF_COUNT(BF_stat_sin_terms);
 				BigFloat *twoN;
 				BigFloat *twoNMinusOne;
 				BigFloat *twoNPlusOne;
@@ -3004,13 +4794,14 @@ BF_NormaliseNumbers
 }
 
 //
-// cosWithTrigMode
+// computeCosWithTrigMode
 //
 // Really this is four different functions in one:
 //		cos, arccos, hypcos and hyparccos
 //
-- (void)cosWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+- (void)computeCosWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
 {
+	BF_TIME(BF_stat_cos);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
 	BigFloatElements	thisNumElements;
@@ -3048,8 +4839,9 @@ BF_NormaliseNumbers
 			[self assign: factorial];
 			
 			i = 1;
-			while([self compareWith: prevIteration] != NSOrderedSame)
+			while(![self hasConvergedTo: prevIteration])
 			{
+				BF_COUNT(BF_stat_cos_terms);
 				BigFloat *twoN;
 				BigFloat *twoNMinusOne;
 
@@ -3142,13 +4934,14 @@ BF_NormaliseNumbers
 }
 
 //
-// tanWithTrigMode
+// computeTanWithTrigMode
 //
 // Really this is four different functions in one:
 //		tan, arctan, hyptan and hyparctan
 //
-- (void)tanWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
+- (void)computeTanWithTrigMode: (BFTrigMode)mode inv: (BOOL)useInverse hyp: (BOOL)useHyp
 {
+	BF_TIME(BF_stat_tan);
 	unsigned long		values[BF_num_values];
 	unsigned long		otherNum[BF_num_values];
 	BigFloatElements	thisNumElements;
@@ -3229,8 +5022,9 @@ BF_NormaliseNumbers
 			{
 				prevIteration = [one copy];
 				
-				while([self compareWith: prevIteration] != NSOrderedSame)
+				while(![self hasConvergedTo: prevIteration])
 				{
+					BF_COUNT(BF_stat_tan_terms);
 					[prevIteration assign:self];
 					
 					[factorial add: two];
@@ -3268,8 +5062,9 @@ BF_NormaliseNumbers
 				[nextTerm inverse];
 				[self subtract: nextTerm];
 	
-				while([self compareWith: prevIteration] != NSOrderedSame)
+				while(![self hasConvergedTo: prevIteration])
 				{
+					BF_COUNT(BF_stat_tan_terms);
 					[prevIteration assign: self];
 					
 					[powerCopy multiplyBy:original];
@@ -3327,12 +5122,13 @@ BF_NormaliseNumbers
 }
 
 //
-// factorial
+// computeFactorial
 //
 // Calculates a factorial in the most basic way.
 //
-- (void)factorial
+- (void)computeFactorial
 {
+	BF_TIME(BF_stat_factorial);
 	BigFloat		*counter;
 	BigFloat		*zero;
 	BigFloat		*one;
@@ -3368,6 +5164,7 @@ BF_NormaliseNumbers
 		// Perform the basic factorial
 		while([counter compareWith: zero] == NSOrderedDescending && bf_is_valid)
 		{
+			BF_COUNT(BF_stat_factorial_terms);
 			[self multiplyBy: counter];
 			[counter subtract: one];
 		}
@@ -3403,11 +5200,11 @@ BF_NormaliseNumbers
 }
 
 //
-// nPr
+// computeNPr
 //
 // Permutation of receiver samples made from a range of r options 
 //
-- (void)nPr: (BigFloat *)r
+- (void)computeNPr: (BigFloat *)r
 {
 	BigFloat *self_minus_r;
 	BigFloat *rCopy = [r copy];
@@ -3442,11 +5239,11 @@ BF_NormaliseNumbers
 }
 
 //
-// nCr
+// computeNCr
 //
 // Calculates receiver combinations of samples taken from a choice of r candidates.
 //
-- (void)nCr: (BigFloat *)r
+- (void)computeNCr: (BigFloat *)r
 {
 	BigFloat *self_minus_r;
 	BigFloat *r_factorial;
@@ -4187,6 +5984,7 @@ BF_NormaliseNumbers
 //
 - (void)limitedString:(unsigned int)lengthLimit fixedPlaces:(unsigned int)places fillLimit:(BOOL)fill complement:(unsigned int)complement mantissa:(NSString**)mantissaOut exponent:(NSString**)exponentOut
 {
+	BF_TIME(BF_stat_limited_string);
 	unichar				digits[BF_max_mantissa_length];
 	unichar				*currentChar;
 	unsigned long		carryBits;
@@ -4294,7 +6092,7 @@ BF_NormaliseNumbers
 		// Apply round to nearest
 		if ((double)carryBits >= ((double)bf_radix / 2.0))
 		{
-			BF_AddToMantissa(values, 1, bf_value_limit, 1);
+			BF_AddToMantissa(values, 1, bf_radix, bf_value_limit, 1);
 			
 			// In the incredibly unlikely case that this rounding increases the number of digits
 			// in the number past the precision, then bail out.
@@ -4357,7 +6155,7 @@ BF_NormaliseNumbers
 		// Apply round to nearest
 		if ((double)carryBits >= ((double)bf_radix / 2.0))
 		{
-			BF_AddToMantissa(values, 1, bf_value_limit, 1);
+			BF_AddToMantissa(values, 1, bf_radix, bf_value_limit, 1);
 			
 			// If by shear fluke that cause the top digit to overflow, then shift back by one digit
 			if (values[BF_num_values - 1] / bf_value_limit != 0)
@@ -4429,7 +6227,7 @@ BF_NormaliseNumbers
 		// Apply round to nearest
 		if ((double)carryBits >= ((double)bf_radix / 2.0))
 		{
-			BF_AddToMantissa(mantissaNumber->bf_array, 1, bf_value_limit, 1);
+			BF_AddToMantissa(mantissaNumber->bf_array, 1, bf_radix, bf_value_limit, 1);
 			
 			// If by shear fluke that cause the top digit to overflow, then shift back by one digit
 			if (values[BF_num_values - 1] / bf_value_limit != 0)
@@ -0,0 +1,137 @@
+// ##############################################################
+//  BigFloatConstants.h
+//  Magic Number Machine
+//
+//  Generated by Tools/make_constants.py. Do not edit.
+// ##############################################################
+
+//
+// About BigFloatConstants
+//
+// π, e, ln 2 and ln 10 for the common radices, correctly rounded to
+// BF_packed_num_values limbs and packed in the compact encoding with no user point
+// (see Packed Constants in BigFloat.m).
+//
+
+#define BF_packed_num_values		16
+
+static const uint8_t BF_packed_pi_2[] =
+{
+	0x02, 0x02, 0xFB, 0x03, 0x00, 0x10, 0x22, 0x9B, 0x13, 0x3B, 0xA6, 0xBE, 0x0B, 0x02, 0x74, 0xCC,
+	0x67, 0x8A, 0x08, 0x4E, 0x02, 0x29, 0xD1, 0x1C, 0xDC, 0x80, 0x8B, 0x62, 0xC6, 0xC4, 0x34, 0xC2,
+	0x68, 0x21, 0xA2, 0xDA, 0x0F, 0xC9
+};
+
+static const uint8_t BF_packed_pi_8[] =
+{
+	0x02, 0x08, 0x9D, 0x01, 0x00, 0x10, 0x8A, 0x1D, 0xA6, 0x3E, 0x17, 0x04, 0xD0, 0x31, 0x3E, 0x53,
+	0x88, 0x60, 0x49, 0x20, 0x4A, 0x34, 0x0E, 0x6E, 0x80, 0x0B, 0xC5, 0x0C, 0x13, 0x53, 0x11, 0x46,
+	0x16, 0x22, 0x54, 0x7B, 0x43, 0x32
+};
+
+static const uint8_t BF_packed_pi_10[] =
+{
+	0x02, 0x0A, 0x7D, 0x00, 0x10, 0xF0, 0x11, 0x46, 0x1D, 0x11, 0x20, 0xF1, 0x13, 0xD1, 0x26, 0x9D,
+	0x06, 0x65, 0x10, 0x20, 0x01, 0xEB, 0x0A, 0x37, 0x0D, 0x78, 0x18, 0x50, 0x09, 0x41, 0x26, 0xEE,
+	0x14, 0x26, 0x17, 0x45, 0x0C
+};
+
+static const uint8_t BF_packed_pi_16[] =
+{
+	0x02, 0x10, 0x7D, 0x00, 0x10, 0xC9, 0xE6, 0xC4, 0x8E, 0xA9, 0xEF, 0x82, 0x00, 0x1D, 0xF3, 0x99,
+	0x22, 0x82, 0x93, 0x40, 0x4A, 0x34, 0x07, 0x37, 0xE0, 0xA2, 0x98, 0x31, 0x31, 0x8D, 0x30, 0x5A,
+	0x88, 0xA8, 0xF6, 0x43, 0x32
+};
+
+static const uint8_t BF_packed_e_2[] =
+{
+	0x02, 0x02, 0xFB, 0x03, 0x00, 0x10, 0xFC, 0x33, 0x64, 0x14, 0x41, 0x36, 0xE1, 0xA9, 0x95, 0x36,
+	0x2D, 0xCE, 0x83, 0xC5, 0xB9, 0xD8, 0xF1, 0x3C, 0x3D, 0x27, 0x20, 0x56, 0xDC, 0xAF, 0x9A, 0x4A,
+	0xBB, 0xA2, 0x58, 0x54, 0xF8, 0xAD
+};
+
+static const uint8_t BF_packed_e_8[] =
+{
+	0x02, 0x08, 0x9D, 0x01, 0x00, 0x10, 0x32, 0x0A, 0x41, 0x36, 0xC2, 0x53, 0x56, 0x5A, 0x69, 0x71,
+	0x3C, 0x58, 0x38, 0x17, 0x76, 0x3C, 0x9E, 0x1E, 0x27, 0x20, 0xAC, 0x38, 0xBF, 0x6A, 0x54, 0x5A,
+	0x2B, 0x0A, 0x8B, 0x0A, 0x7E, 0x2B
+};
+
+static const uint8_t BF_packed_e_10[] =
+{
+	0x02, 0x0A, 0x7D, 0x00, 0x10, 0xCC, 0x1D, 0x28, 0x1A, 0x75, 0x16, 0xE7, 0x26, 0x99, 0x24, 0xA6,
+	0x09, 0x4D, 0x1E, 0x69, 0x18, 0xC6, 0x0D, 0x2F, 0x1D, 0x8C, 0x17, 0x31, 0x09, 0x55, 0x23, 0x1D,
+	0x0B, 0x02, 0x0B, 0x9E, 0x0A
+};
+
+static const uint8_t BF_packed_e_16[] =
+{
+	0x02, 0x10, 0x7D, 0x00, 0x10, 0xFF, 0x0C, 0x19, 0x45, 0x90, 0x4D, 0x78, 0x6A, 0xA5, 0x4D, 0x8B,
+	0xF3, 0x60, 0x71, 0x2E, 0x76, 0x3C, 0x4F, 0xCF, 0x09, 0x88, 0x15, 0xF7, 0xAB, 0xA6, 0xD2, 0xAE,
+	0x28, 0x16, 0x15, 0x7E, 0x2B
+};
+
+static const uint8_t BF_packed_ln2_2[] =
+{
+	0x02, 0x02, 0xFF, 0x03, 0x00, 0x10, 0x2C, 0xFA, 0xAA, 0x8B, 0x5B, 0x17, 0x0D, 0x8A, 0x2D, 0xB6,
+	0x98, 0x72, 0x26, 0x43, 0xF3, 0x40, 0xAF, 0xF6, 0xF2, 0x03, 0x98, 0xB3, 0xE3, 0xC9, 0xAB, 0x79,
+	0xCF, 0xD1, 0xF7, 0x17, 0x72, 0xB1
+};
+
+static const uint8_t BF_packed_ln2_8[] =
+{
+	0x02, 0x08, 0x9F, 0x01, 0x00, 0x10, 0xAB, 0x0B, 0xB7, 0x2E, 0x34, 0x28, 0x6C, 0x31, 0x8B, 0x29,
+	0xCE, 0x64, 0xD0, 0x3C, 0xA0, 0x57, 0xF6, 0x72, 0x07, 0x30, 0xCE, 0x0E, 0x4F, 0x5E, 0x9A, 0x77,
+	0x39, 0x7A, 0xFD, 0x05, 0xB9, 0x58
+};
+
+static const uint8_t BF_packed_ln2_10[] =
+{
+	0x02, 0x0A, 0x7F, 0x00, 0x10, 0x5F, 0x00, 0xA8, 0x02, 0x24, 0x15, 0xF8, 0x09, 0x08, 0x11, 0x0D,
+	0x00, 0xF3, 0x02, 0xA8, 0x19, 0xB9, 0x16, 0xBE, 0x04, 0x40, 0x1C, 0xAD, 0x03, 0xED, 0x24, 0x2F,
+	0x02, 0x6E, 0x12, 0x13, 0x1B
+};
+
+static const uint8_t BF_packed_ln2_16[] =
+{
+	0x02, 0x10, 0x7F, 0x00, 0x10, 0x2C, 0xFA, 0xAA, 0x8B, 0x5B, 0x17, 0x0D, 0x8A, 0x2D, 0xB6, 0x98,
+	0x72, 0x26, 0x43, 0xF3, 0x40, 0xAF, 0xF6, 0xF2, 0x03, 0x98, 0xB3, 0xE3, 0xC9, 0xAB, 0x79, 0xCF,
+	0xD1, 0xF7, 0x17, 0x72, 0xB1
+};
+
+static const uint8_t BF_packed_ln10_2[] =
+{
+	0x02, 0x02, 0xFB, 0x03, 0x00, 0x10, 0x73, 0x2D, 0xF0, 0x01, 0x82, 0x1E, 0xC6, 0x83, 0x0E, 0xF9,
+	0x5D, 0xDA, 0xF9, 0xEC, 0x8F, 0xE2, 0x28, 0x0A, 0xD3, 0x82, 0x2B, 0xD6, 0x56, 0xEA, 0x16, 0xAC,
+	0xA8, 0xAA, 0xDD, 0x8D, 0x5D, 0x93
+};
+
+static const uint8_t BF_packed_ln10_8[] =
+{
+	0x02, 0x08, 0x9D, 0x01, 0x00, 0x10, 0xF8, 0x00, 0x82, 0x1E, 0x8C, 0x07, 0x3A, 0x64, 0xEF, 0x52,
+	0x9D, 0x4F, 0xFD, 0x51, 0x38, 0x0A, 0x85, 0x69, 0x82, 0x2B, 0xAC, 0x2D, 0xA9, 0x5B, 0x60, 0x45,
+	0xAA, 0x5A, 0xBB, 0x31, 0xD7, 0x24
+};
+
+static const uint8_t BF_packed_ln10_10[] =
+{
+	0x02, 0x0A, 0x7D, 0x00, 0x10, 0xDD, 0x1E, 0x04, 0x0D, 0x20, 0x26, 0x44, 0x22, 0x9E, 0x22, 0xF6,
+	0x03, 0xB1, 0x1D, 0x14, 0x19, 0xBB, 0x1A, 0xAE, 0x05, 0x07, 0x07, 0xB8, 0x1A, 0xCD, 0x0F, 0x53,
+	0x24, 0xDA, 0x16, 0xFE, 0x08
+};
+
+static const uint8_t BF_packed_ln10_16[] =
+{
+	0x02, 0x10, 0x7D, 0x00, 0x10, 0x5D, 0x0B, 0x7C, 0x80, 0xA0, 0x87, 0xF1, 0xA0, 0x43, 0x7E, 0x97,
+	0x76, 0x3E, 0xFB, 0xA3, 0x38, 0x8A, 0xC2, 0xB4, 0xE0, 0x8A, 0xB5, 0x95, 0xBA, 0x05, 0x2B, 0xAA,
+	0x6A, 0x77, 0x63, 0xD7, 0x24
+};
+
+// By constant and radix; radices without a packed value are left empty
+static const BFPackedNumber BF_packed_constants[BF_constant_count][37] =
+{
+	[BF_constant_pi] = {[2] = {BF_packed_pi_2, sizeof(BF_packed_pi_2)}, [8] = {BF_packed_pi_8, sizeof(BF_packed_pi_8)}, [10] = {BF_packed_pi_10, sizeof(BF_packed_pi_10)}, [16] = {BF_packed_pi_16, sizeof(BF_packed_pi_16)}},
+	[BF_constant_e] = {[2] = {BF_packed_e_2, sizeof(BF_packed_e_2)}, [8] = {BF_packed_e_8, sizeof(BF_packed_e_8)}, [10] = {BF_packed_e_10, sizeof(BF_packed_e_10)}, [16] = {BF_packed_e_16, sizeof(BF_packed_e_16)}},
+	[BF_constant_ln2] = {[2] = {BF_packed_ln2_2, sizeof(BF_packed_ln2_2)}, [8] = {BF_packed_ln2_8, sizeof(BF_packed_ln2_8)}, [10] = {BF_packed_ln2_10, sizeof(BF_packed_ln2_10)}, [16] = {BF_packed_ln2_16, sizeof(BF_packed_ln2_16)}},
+	[BF_constant_ln10] = {[2] = {BF_packed_ln10_2, sizeof(BF_packed_ln10_2)}, [8] = {BF_packed_ln10_8, sizeof(BF_packed_ln10_8)}, [10] = {BF_packed_ln10_10, sizeof(BF_packed_ln10_10)}, [16] = {BF_packed_ln10_16, sizeof(BF_packed_ln10_16)}}
+};
@@ -0,0 +1,85 @@
+// ##############################################################
+//  BigInteger.h
+//  Magic Number Machine
+//
+// ##############################################################
+
+#import <Foundation/Foundation.h>
+
+//
+// About BigInteger
+//
+// An exact integer of any size (up to BI_max_bits), used to evaluate the parts of an
+// expression that only involve integers so that 100!, 2^200 or a large nCr come out
+// with every digit instead of being rounded to the BigFloat precision.
+//
+// Unlike BigFloat, BigIntegers are immutable: every operation returns a new number.
+// Anything without an exact integer result (a division with a remainder, a negative
+// power, a result bigger than BI_max_bits) returns nil, and since messages to nil
+// return nil an invalid operand simply propagates to the end of a calculation, where
+// the caller falls back to BigFloat.
+//
+// The magnitude is held in 32 bit limbs, least significant first. Multiplication is
+// Karatsuba above a threshold, division is Knuth's algorithm D, and the number theory
+// functions (modular powers, primality and factorisation) work in Montgomery form
+// with 64 bit shortcuts for numbers that fit in a word.
+//
+
+// Largest result, in bits, that an operation will produce (about 79,000 decimal digits)
+#define BI_max_bits		(1 << 18)
+
+// Largest number, in bits, that primality testing and factorisation are used on (about
+// 1,200 decimal digits). A prime test this size takes under a second.
+#define BI_number_theory_bits	4096
+
+@interface BigInteger : NSObject <NSCopying>
+{
+	uint32_t		*bi_limbs;
+	NSUInteger		bi_count;
+	BOOL			bi_is_negative;
+}
+
+// Constructors
++ (BigInteger *)zero;
++ (BigInteger *)one;
++ (BigInteger *)integerWithLong:(long long)value;
++ (BigInteger *)integerWithDigits:(const unsigned long *)digits count:(NSUInteger)count base:(unsigned long)base negative:(BOOL)negative;
+- (id)copyWithZone:(NSZone *)zone;
+
+// Accessors
+@property (nonatomic, readonly) NSUInteger bitLength;
+@property (nonatomic, readonly) BOOL isZero;
+@property (nonatomic, readonly) BOOL isNegative;
+@property (nonatomic, readonly) BOOL isOdd;
+@property (nonatomic, readonly) double doubleValue;
+- (BOOL)getLongValue:(long long *)result;
+- (NSData *)digitsWithBase:(unsigned long)base;
+- (NSString *)stringWithRadix:(unsigned short)radix;
+
+// Arithmetic Functions
+- (NSComparisonResult)compareWith:(BigInteger *)num;
+- (BigInteger *)negated;
+- (BigInteger *)absoluteValue;
+- (BigInteger *)add:(BigInteger *)num;
+- (BigInteger *)subtract:(BigInteger *)num;
+- (BigInteger *)multiplyBy:(BigInteger *)num;
+- (BigInteger *)divideBy:(BigInteger *)num remainder:(BigInteger **)remainder;
+- (BigInteger *)divideBy:(BigInteger *)num;
+- (BigInteger *)moduloBy:(BigInteger *)num;
+- (BigInteger *)raiseToIntPower:(NSUInteger)n;
+- (BigInteger *)raiseToPower:(BigInteger *)num;
+
+// Combinatorial Functions
+- (BigInteger *)factorial;
+- (BigInteger *)nPr:(BigInteger *)r;
+- (BigInteger *)nCr:(BigInteger *)r;
+
+// Number Theory Functions
+- (BigInteger *)gcdWith:(BigInteger *)num;
+- (BigInteger *)lcmWith:(BigInteger *)num;
+- (BigInteger *)raiseToPower:(BigInteger *)num modulo:(BigInteger *)modulus;
+@property (nonatomic, readonly) BOOL isProbablePrime;
+@property (nonatomic, readonly, copy) NSArray *primeFactors;
+@property (nonatomic, readonly, strong) BigInteger *smallestPrimeFactor;
+
+@end
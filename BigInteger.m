@@ -0,0 +1,1968 @@
+// ##############################################################
+//  BigInteger.m
+//  Magic Number Machine
+//
+// ##############################################################
+
+#import "BigInteger.h"
+#include <math.h>
+
+//
+// About BigInteger
+//
+// An immutable exact integer. See the header for what it is used for. The C functions
+// below work on magnitudes (arrays of limbs, least significant first) and the class
+// wraps them with signs, allocation and the BI_max_bits limit.
+//
+
+typedef uint32_t	BILimb;
+typedef uint64_t	BIDoubleLimb;
+
+// Operands shorter than this many limbs are multiplied by the schoolbook method
+#define BI_karatsuba_threshold		32
+
+// Limbs of scratch space BI_MultiplyKaratsuba needs for n limb operands
+#define BI_KARATSUBA_SCRATCH(n)		(4 * (n) + 1024)
+
+// Factors below this are found by trial division before anything cleverer is tried
+#define BI_trial_division_limit		1000
+
+// Pollard's rho takes the products of this many differences between gcds and tries up
+// to this many different polynomials. A whole factorisation gets BI_rho_work steps
+// divided by the square of the number's length in limbs (since that is what a step
+// costs), but never more than BI_rho_max_steps.
+#define BI_rho_batch				128
+#define BI_rho_work					(1 << 26)
+#define BI_rho_max_steps			(1 << 22)
+#define BI_rho_max_attempts			8
+
+// Binomial coefficients of numbers up to this are built from their prime factorisation
+#define BI_prime_power_limit		(1 << 22)
+
+// Products of ranges are split until this many terms are left, which are multiplied in turn
+#define BI_product_leaf				8
+
+// The primes below BI_trial_division_limit
+static unsigned int BI_small_primes[BI_trial_division_limit];
+static NSUInteger BI_small_prime_count = 0;
+
+// Bases for the Miller-Rabin test. The primes to 41 make it exact below 3.3 x 10^24, so
+// they are used for numbers below 2^81.
+static const BILimb BI_witness_primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+#define BI_witness_count			(sizeof(BI_witness_primes) / sizeof(BI_witness_primes[0]))
+#define BI_deterministic_bits		81
+
+// Random bases tried after base 2 on larger numbers
+#define BI_random_witness_count		4
+
+#pragma mark
+#pragma mark ### Magnitude Functions ###
+
+//
+// BI_SmallPrimesSetup
+//
+// Sieves the primes for trial division.
+//
+static void
+BI_SmallPrimesSetup(void)
+{
+	BOOL		composite[BI_trial_division_limit] = {NO};
+	NSUInteger	i, j;
+
+	for (i = 2; i < BI_trial_division_limit; i++)
+	{
+		if (composite[i])
+			continue;
+
+		BI_small_primes[BI_small_prime_count++] = (unsigned int)i;
+		for (j = i * i; j < BI_trial_division_limit; j += i)
+			composite[j] = YES;
+	}
+}
+
+//
+// BI_Normalise
+//
+// The length of a without its leading zero limbs.
+//
+static NSUInteger
+BI_Normalise(const BILimb *a, NSUInteger n)
+{
+	while (n > 0 && a[n - 1] == 0)
+		n--;
+	return n;
+}
+
+//
+// BI_Compare
+//
+// Compares two normalised magnitudes (or two of the same length), returning -1, 0 or 1.
+//
+static int
+BI_Compare(const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	NSUInteger i;
+
+	if (an != bn)
+		return (an < bn) ? -1 : 1;
+
+	for (i = an; i > 0; i--)
+	{
+		if (a[i - 1] != b[i - 1])
+			return (a[i - 1] < b[i - 1]) ? -1 : 1;
+	}
+	return 0;
+}
+
+//
+// BI_Add
+//
+// r = a + b where an >= bn, over an limbs. Returns the carry out. r may be a.
+//
+static BILimb
+BI_Add(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	BIDoubleLimb	carry = 0;
+	NSUInteger		i;
+
+	for (i = 0; i < bn; i++)
+	{
+		carry += (BIDoubleLimb)a[i] + b[i];
+		r[i] = (BILimb)carry;
+		carry >>= 32;
+	}
+	for (; i < an; i++)
+	{
+		carry += a[i];
+		r[i] = (BILimb)carry;
+		carry >>= 32;
+	}
+	return (BILimb)carry;
+}
+
+//
+// BI_Subtract
+//
+// r = a - b where an >= bn, over an limbs. Returns the borrow out. r may be a.
+//
+static BILimb
+BI_Subtract(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	BIDoubleLimb	difference;
+	BILimb			borrow = 0;
+	NSUInteger		i;
+
+	for (i = 0; i < bn; i++)
+	{
+		difference = (BIDoubleLimb)a[i] - b[i] - borrow;
+		r[i] = (BILimb)difference;
+		borrow = (BILimb)(difference >> 32) & 1;
+	}
+	for (; i < an; i++)
+	{
+		difference = (BIDoubleLimb)a[i] - borrow;
+		r[i] = (BILimb)difference;
+		borrow = (BILimb)(difference >> 32) & 1;
+	}
+	return borrow;
+}
+
+//
+// BI_MultiplyAddSmall
+//
+// a = a * m + add in place over n limbs. Returns the limb carried out.
+//
+static BILimb
+BI_MultiplyAddSmall(BILimb *a, NSUInteger n, BILimb m, BILimb add)
+{
+	BIDoubleLimb	carry = add;
+	NSUInteger		i;
+
+	for (i = 0; i < n; i++)
+	{
+		carry += (BIDoubleLimb)a[i] * m;
+		a[i] = (BILimb)carry;
+		carry >>= 32;
+	}
+	return (BILimb)carry;
+}
+
+//
+// BI_DivideSmall
+//
+// q = a / d for a one limb divisor, returning the remainder. q may be a.
+//
+static BILimb
+BI_DivideSmall(BILimb *q, const BILimb *a, NSUInteger n, BILimb d)
+{
+	BIDoubleLimb	remainder = 0;
+	NSUInteger		i;
+
+	for (i = n; i > 0; i--)
+	{
+		remainder = (remainder << 32) | a[i - 1];
+		q[i - 1] = (BILimb)(remainder / d);
+		remainder %= d;
+	}
+	return (BILimb)remainder;
+}
+
+//
+// BI_RemainderSmall
+//
+// a mod d for a one limb divisor.
+//
+static BILimb
+BI_RemainderSmall(const BILimb *a, NSUInteger n, BILimb d)
+{
+	BIDoubleLimb	remainder = 0;
+	NSUInteger		i;
+
+	for (i = n; i > 0; i--)
+		remainder = ((remainder << 32) | a[i - 1]) % d;
+	return (BILimb)remainder;
+}
+
+//
+// BI_ShiftRight
+//
+// a = a >> bits in place, for bits less than 32.
+//
+static void
+BI_ShiftRight(BILimb *a, NSUInteger n, unsigned int bits)
+{
+	NSUInteger i;
+
+	if (bits == 0)
+		return;
+
+	for (i = 0; i + 1 < n; i++)
+		a[i] = (a[i] >> bits) | (a[i + 1] << (32 - bits));
+	if (n > 0)
+		a[n - 1] >>= bits;
+}
+
+//
+// BI_MultiplySchoolbook
+//
+// r = a * b over an + bn limbs. r must not overlap a or b.
+//
+static void
+BI_MultiplySchoolbook(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	BIDoubleLimb	carry;
+	NSUInteger		i, j;
+
+	memset(r, 0, (an + bn) * sizeof(BILimb));
+	for (j = 0; j < bn; j++)
+	{
+		if (b[j] == 0)
+			continue;
+
+		carry = 0;
+		for (i = 0; i < an; i++)
+		{
+			carry += (BIDoubleLimb)a[i] * b[j] + r[i + j];
+			r[i + j] = (BILimb)carry;
+			carry >>= 32;
+		}
+		r[j + an] = (BILimb)carry;
+	}
+}
+
+//
+// BI_MultiplyKaratsuba
+//
+// r = a * b over 2n limbs for two n limb operands. Splitting each into a high and low
+// half, the product needs only three half size products: the low halves, the high
+// halves and the sums of the halves (from which the other two are subtracted to give
+// the middle term). Needs BI_KARATSUBA_SCRATCH(n) limbs of scratch.
+//
+static void
+BI_MultiplyKaratsuba(BILimb *r, const BILimb *a, const BILimb *b, NSUInteger n, BILimb *scratch)
+{
+	NSUInteger	low, high, sumCount, middleCount;
+	BILimb		*aSum, *bSum, *middle, *next;
+
+	if (n < BI_karatsuba_threshold)
+	{
+		BI_MultiplySchoolbook(r, a, n, b, n);
+		return;
+	}
+
+	low = n / 2;
+	high = n - low;
+	sumCount = high + 1;
+	aSum = scratch;
+	bSum = aSum + sumCount;
+	middle = bSum + sumCount;
+	next = middle + 2 * sumCount;
+
+	aSum[high] = BI_Add(aSum, a + low, high, a, low);
+	bSum[high] = BI_Add(bSum, b + low, high, b, low);
+
+	BI_MultiplyKaratsuba(r, a, b, low, next);
+	BI_MultiplyKaratsuba(r + 2 * low, a + low, b + low, high, next);
+	BI_MultiplyKaratsuba(middle, aSum, bSum, sumCount, next);
+
+	BI_Subtract(middle, middle, 2 * sumCount, r, 2 * low);
+	BI_Subtract(middle, middle, 2 * sumCount, r + 2 * low, 2 * high);
+	middleCount = BI_Normalise(middle, 2 * sumCount);
+	BI_Add(r + low, r + low, 2 * n - low, middle, middleCount);
+}
+
+//
+// BI_Multiply
+//
+// r = a * b over an + bn limbs for operands of any length. r must not overlap a or b.
+// Operands of different lengths are multiplied a piece of the longer one at a time.
+//
+static void
+BI_Multiply(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	const BILimb	*swap;
+	BILimb			*scratch, *product;
+	NSUInteger		i;
+
+	if (an < bn)
+	{
+		swap = a; a = b; b = swap;
+		i = an; an = bn; bn = i;
+	}
+
+	if (bn < BI_karatsuba_threshold)
+	{
+		BI_MultiplySchoolbook(r, a, an, b, bn);
+		return;
+	}
+
+	scratch = malloc((BI_KARATSUBA_SCRATCH(bn) + 2 * bn) * sizeof(BILimb));
+	if (an == bn)
+	{
+		BI_MultiplyKaratsuba(r, a, b, bn, scratch);
+		free(scratch);
+		return;
+	}
+
+	product = scratch + BI_KARATSUBA_SCRATCH(bn);
+	memset(r, 0, (an + bn) * sizeof(BILimb));
+	for (i = 0; i + bn <= an; i += bn)
+	{
+		BI_MultiplyKaratsuba(product, a + i, b, bn, scratch);
+		BI_Add(r + i, r + i, an + bn - i, product, 2 * bn);
+	}
+	if (i < an)
+	{
+		BI_Multiply(product, b, bn, a + i, an - i);
+		BI_Add(r + i, r + i, an + bn - i, product, bn + an - i);
+	}
+	free(scratch);
+}
+
+//
+// BI_Divide
+//
+// Knuth's algorithm D. Divides a by b (normalised, an >= bn >= 2) giving an - bn + 1
+// limbs of quotient in q and bn limbs of remainder in r (either may be NULL). Both
+// operands are shifted so the divisor's top bit is set, which keeps each estimated
+// quotient limb at most two too large.
+//
+static void
+BI_Divide(BILimb *q, BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	BILimb			*u, *v;
+	BIDoubleLimb	numerator, estimate, estimateRemainder, product, sum;
+	int64_t			difference, borrow;
+	unsigned int	shift = __builtin_clz(b[bn - 1]);
+	NSUInteger		i, j;
+
+	u = malloc((an + 1 + bn) * sizeof(BILimb));
+	v = u + an + 1;
+
+	for (i = bn - 1; i > 0; i--)
+		v[i] = (b[i] << shift) | (BILimb)((BIDoubleLimb)b[i - 1] >> (32 - shift));
+	v[0] = b[0] << shift;
+	u[an] = (BILimb)((BIDoubleLimb)a[an - 1] >> (32 - shift));
+	for (i = an - 1; i > 0; i--)
+		u[i] = (a[i] << shift) | (BILimb)((BIDoubleLimb)a[i - 1] >> (32 - shift));
+	u[0] = a[0] << shift;
+
+	for (j = an - bn + 1; j-- > 0;)
+	{
+		// Estimate the quotient limb from the top two limbs and correct it with the third
+		numerator = ((BIDoubleLimb)u[j + bn] << 32) | u[j + bn - 1];
+		estimate = numerator / v[bn - 1];
+		estimateRemainder = numerator % v[bn - 1];
+		while ((estimate >> 32) != 0 || estimate * v[bn - 2] > ((estimateRemainder << 32) | u[j + bn - 2]))
+		{
+			estimate--;
+			estimateRemainder += v[bn - 1];
+			if ((estimateRemainder >> 32) != 0)
+				break;
+		}
+
+		// Subtract estimate * v
+		borrow = 0;
+		for (i = 0; i < bn; i++)
+		{
+			product = estimate * v[i];
+			difference = (int64_t)u[i + j] - borrow - (int64_t)(product & 0xFFFFFFFF);
+			u[i + j] = (BILimb)difference;
+			borrow = (int64_t)(product >> 32) - (difference >> 32);
+		}
+		difference = (int64_t)u[j + bn] - borrow;
+		u[j + bn] = (BILimb)difference;
+
+		// Rarely the estimate is still one too big, so add v back
+		if (difference < 0)
+		{
+			estimate--;
+			sum = 0;
+			for (i = 0; i < bn; i++)
+			{
+				sum += (BIDoubleLimb)u[i + j] + v[i];
+				u[i + j] = (BILimb)sum;
+				sum >>= 32;
+			}
+			u[j + bn] += (BILimb)sum;
+		}
+
+		if (q != NULL)
+			q[j] = (BILimb)estimate;
+	}
+
+	if (r != NULL)
+	{
+		for (i = 0; i + 1 < bn; i++)
+			r[i] = (u[i] >> shift) | (BILimb)((BIDoubleLimb)u[i + 1] << (32 - shift));
+		r[bn - 1] = u[bn - 1] >> shift;
+	}
+	free(u);
+}
+
+//
+// BI_Remainder
+//
+// r = a mod b for normalised a and b (b nonzero), returning the normalised length of
+// r. r needs bn limbs and may not overlap a.
+//
+static NSUInteger
+BI_Remainder(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	if (BI_Compare(a, an, b, bn) < 0)
+	{
+		memcpy(r, a, an * sizeof(BILimb));
+		return an;
+	}
+	if (bn == 1)
+	{
+		r[0] = BI_RemainderSmall(a, an, b[0]);
+		return (r[0] != 0) ? 1 : 0;
+	}
+
+	BI_Divide(NULL, r, a, an, b, bn);
+	return BI_Normalise(r, bn);
+}
+
+//
+// BI_Gcd64
+//
+// Euclid's algorithm for numbers that fit in a word.
+//
+static uint64_t
+BI_Gcd64(uint64_t a, uint64_t b)
+{
+	uint64_t t;
+
+	while (b != 0)
+	{
+		t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+//
+// BI_Gcd
+//
+// r = gcd(a, b) for normalised a and b, returning its length. r needs max(an, bn)
+// limbs. Euclid's algorithm, finishing in a word once the numbers are small enough.
+// The gcd with 0 is the other operand.
+//
+static NSUInteger
+BI_Gcd(BILimb *r, const BILimb *a, NSUInteger an, const BILimb *b, NSUInteger bn)
+{
+	NSUInteger	count = MAX(an, bn) + 1;
+	BILimb		*buffer;
+	BILimb		*x, *y, *z, *swap;
+	NSUInteger	xn = an, yn = bn, zn;
+	uint64_t	small;
+
+	if (an == 0 || bn == 0)
+	{
+		memcpy(r, (an == 0) ? b : a, (an == 0 ? bn : an) * sizeof(BILimb));
+		return (an == 0) ? bn : an;
+	}
+
+	buffer = malloc(3 * count * sizeof(BILimb));
+	x = buffer;
+	y = buffer + count;
+	z = buffer + 2 * count;
+	memcpy(x, a, an * sizeof(BILimb));
+	memcpy(y, b, bn * sizeof(BILimb));
+	while (yn > 2 || (yn > 0 && xn > 2))
+	{
+		zn = BI_Remainder(z, x, xn, y, yn);
+		swap = x; x = y; y = z; z = swap;
+		xn = yn;
+		yn = zn;
+	}
+
+	if (yn > 0)
+	{
+		small = BI_Gcd64(x[0] | ((xn > 1) ? (uint64_t)x[1] << 32 : 0), y[0] | ((yn > 1) ? (uint64_t)y[1] << 32 : 0));
+		x[0] = (BILimb)small;
+		x[1] = (BILimb)(small >> 32);
+		xn = BI_Normalise(x, 2);
+	}
+	memcpy(r, x, xn * sizeof(BILimb));
+	free(buffer);
+	return xn;
+}
+
+#pragma mark
+#pragma mark ### Montgomery Functions ###
+
+//
+// A modulus prepared for Montgomery multiplication: numbers modulo an odd n are held
+// as x * R mod n, where R = 2^(32 * count), so multiplication only needs a reduction
+// by R (which is just dropping limbs) instead of a division by n.
+//
+typedef struct
+{
+	NSUInteger		count;
+	const BILimb	*modulus;
+	BILimb			inverse;		// -1 / modulus mod 2^32
+	BILimb			*squaredR;		// R^2 mod modulus, to convert into Montgomery form
+	BILimb			*one;			// R mod modulus, 1 in Montgomery form
+	BILimb			*scratch;		// count + 2 limbs for BI_MontgomeryMultiply
+} BIMontgomery;
+
+//
+// BI_MontgomerySetup
+//
+// Prepares the normalised odd modulus of count limbs. The modulus is not copied.
+//
+static void
+BI_MontgomerySetup(BIMontgomery *m, const BILimb *modulus, NSUInteger count)
+{
+	BILimb		inverse = modulus[0];
+	BILimb		*power = calloc(2 * count + 1, sizeof(BILimb));
+	int			i;
+
+	// Newton's iteration doubles the correct bits each time (three to start with)
+	for (i = 0; i < 4; i++)
+		inverse *= 2 - modulus[0] * inverse;
+
+	m->count = count;
+	m->modulus = modulus;
+	m->inverse = -inverse;
+	m->squaredR = calloc(count, sizeof(BILimb));
+	m->one = calloc(count, sizeof(BILimb));
+	m->scratch = calloc(count + 2, sizeof(BILimb));
+
+	power[2 * count] = 1;
+	BI_Remainder(m->squaredR, power, 2 * count + 1, modulus, count);
+	power[2 * count] = 0;
+	power[count] = 1;
+	BI_Remainder(m->one, power, count + 1, modulus, count);
+	free(power);
+}
+
+//
+// BI_MontgomeryFree
+//
+static void
+BI_MontgomeryFree(BIMontgomery *m)
+{
+	free(m->squaredR);
+	free(m->one);
+	free(m->scratch);
+}
+
+//
+// BI_MontgomeryMultiply
+//
+// r = a * b / R mod n, interleaving the multiplication with the reduction a limb at a
+// time (coarsely integrated operand scanning). r may be a or b.
+//
+static void
+BI_MontgomeryMultiply(const BIMontgomery *m, BILimb *r, const BILimb *a, const BILimb *b)
+{
+	NSUInteger		k = m->count;
+	BILimb			*t = m->scratch;
+	BILimb			carry, factor;
+	BIDoubleLimb	sum;
+	NSUInteger		i, j;
+
+	memset(t, 0, (k + 2) * sizeof(BILimb));
+	for (i = 0; i < k; i++)
+	{
+		carry = 0;
+		for (j = 0; j < k; j++)
+		{
+			sum = (BIDoubleLimb)a[j] * b[i] + t[j] + carry;
+			t[j] = (BILimb)sum;
+			carry = (BILimb)(sum >> 32);
+		}
+		sum = (BIDoubleLimb)t[k] + carry;
+		t[k] = (BILimb)sum;
+		t[k + 1] = (BILimb)(sum >> 32);
+
+		// Add the multiple of n that clears the bottom limb, then drop it
+		factor = t[0] * m->inverse;
+		sum = (BIDoubleLimb)factor * m->modulus[0] + t[0];
+		carry = (BILimb)(sum >> 32);
+		for (j = 1; j < k; j++)
+		{
+			sum = (BIDoubleLimb)factor * m->modulus[j] + t[j] + carry;
+			t[j - 1] = (BILimb)sum;
+			carry = (BILimb)(sum >> 32);
+		}
+		sum = (BIDoubleLimb)t[k] + carry;
+		t[k - 1] = (BILimb)sum;
+		t[k] = t[k + 1] + (BILimb)(sum >> 32);
+	}
+
+	if (t[k] != 0 || BI_Compare(t, k, m->modulus, k) >= 0)
+		BI_Subtract(t, t, k, m->modulus, k);
+	memcpy(r, t, k * sizeof(BILimb));
+}
+
+//
+// BI_MontgomeryPower
+//
+// r = base^e with base and r in Montgomery form, taking the exponent four bits at a
+// time from a table of the first sixteen powers. r may be base.
+//
+static void
+BI_MontgomeryPower(const BIMontgomery *m, BILimb *r, const BILimb *base, const BILimb *e, NSUInteger en)
+{
+	NSUInteger		k = m->count;
+	BILimb			*table = malloc(16 * k * sizeof(BILimb));
+	unsigned int	window;
+	BOOL			started = NO;
+	NSUInteger		i;
+
+	memcpy(table, m->one, k * sizeof(BILimb));
+	memcpy(table + k, base, k * sizeof(BILimb));
+	for (i = 2; i < 16; i++)
+		BI_MontgomeryMultiply(m, table + i * k, table + (i - 1) * k, table + k);
+
+	memcpy(r, m->one, k * sizeof(BILimb));
+	for (i = en * 8; i-- > 0;)
+	{
+		if (started)
+		{
+			BI_MontgomeryMultiply(m, r, r, r);
+			BI_MontgomeryMultiply(m, r, r, r);
+			BI_MontgomeryMultiply(m, r, r, r);
+			BI_MontgomeryMultiply(m, r, r, r);
+		}
+
+		window = (e[i / 8] >> (4 * (i % 8))) & 15;
+		if (window != 0)
+		{
+			BI_MontgomeryMultiply(m, r, r, table + window * k);
+			started = YES;
+		}
+	}
+	free(table);
+}
+
+//
+// BI_AddModulo
+//
+// r = a + b mod n for a and b already below n, all of count limbs. r may be a or b.
+//
+static void
+BI_AddModulo(BILimb *r, const BILimb *a, const BILimb *b, const BILimb *n, NSUInteger count)
+{
+	if (BI_Add(r, a, count, b, count) != 0 || BI_Compare(r, count, n, count) >= 0)
+		BI_Subtract(r, r, count, n, count);
+}
+
+//
+// BI_IsStrongProbablePrime
+//
+// The Miller-Rabin test of the odd modulus of m against witness. minusOne is n - 1,
+// odd is n - 1 with its twos removed and twos is how many there were.
+//
+static BOOL
+BI_IsStrongProbablePrime(const BIMontgomery *m, BILimb witness, const BILimb *odd, NSUInteger oddCount, NSUInteger twos)
+{
+	NSUInteger	k = m->count;
+	BILimb		*x = calloc(2 * k, sizeof(BILimb));
+	BILimb		*minusOne = x + k;
+	BOOL		result = NO;
+	NSUInteger	i;
+
+	// -1 in Montgomery form is n - R mod n
+	BI_Subtract(minusOne, m->modulus, k, m->one, k);
+
+	x[0] = witness;
+	BI_MontgomeryMultiply(m, x, x, m->squaredR);
+	BI_MontgomeryPower(m, x, x, odd, oddCount);
+
+	if (BI_Compare(x, k, m->one, k) == 0 || BI_Compare(x, k, minusOne, k) == 0)
+	{
+		result = YES;
+	}
+	else
+	{
+		for (i = 1; i < twos; i++)
+		{
+			BI_MontgomeryMultiply(m, x, x, x);
+			if (BI_Compare(x, k, minusOne, k) == 0)
+			{
+				result = YES;
+				break;
+			}
+			if (BI_Compare(x, k, m->one, k) == 0)
+				break;
+		}
+	}
+	free(x);
+	return result;
+}
+
+//
+// BI_IsProbablePrime
+//
+// Miller-Rabin for an odd normalised n of two or more limbs that has no small factors.
+// Below 2^81 the fixed bases make the test exact. Above that it is base 2 and a few
+// random bases, each of which lets through at most a quarter of composites (and far
+// fewer for composites that weren't made to fool it).
+//
+static BOOL
+BI_IsProbablePrime(const BILimb *n, NSUInteger count)
+{
+	BIMontgomery	m;
+	BILimb			*odd = malloc(count * sizeof(BILimb));
+	NSUInteger		oddCount, twos = 0, i;
+	uint64_t		random = 0x9E3779B97F4A7C15ULL ^ n[0] ^ ((uint64_t)n[count - 1] << 32);
+	BILimb			witness;
+	BOOL			result = YES;
+	BOOL			exact = (count * 32 - __builtin_clz(n[count - 1]) <= BI_deterministic_bits);
+	NSUInteger		witnesses = exact ? BI_witness_count : 1 + BI_random_witness_count;
+
+	memcpy(odd, n, count * sizeof(BILimb));
+	odd[0] -= 1;
+	for (i = 0; odd[i] == 0; i++)
+		twos += 32;
+	memmove(odd, odd + i, (count - i) * sizeof(BILimb));
+	oddCount = count - i;
+	twos += __builtin_ctz(odd[0]);
+	BI_ShiftRight(odd, oddCount, __builtin_ctz(odd[0]));
+	oddCount = BI_Normalise(odd, oddCount);
+
+	BI_MontgomerySetup(&m, n, count);
+	for (i = 0; i < witnesses && result; i++)
+	{
+		if (exact || i == 0)
+		{
+			witness = BI_witness_primes[i];
+		}
+		else
+		{
+			random ^= random << 13;
+			random ^= random >> 7;
+			random ^= random << 17;
+			witness = (BILimb)(random >> 32) | 2;
+		}
+		result = BI_IsStrongProbablePrime(&m, witness, odd, oddCount, twos);
+	}
+	BI_MontgomeryFree(&m);
+	free(odd);
+	return result;
+}
+
+//
+// BI_RhoFactor
+//
+// Brent's variant of Pollard's rho on an odd composite n of two or more limbs, iterating
+// x^2 + c in Montgomery form. The differences are multiplied together and only
+// checked against n every BI_rho_batch steps, going back over the last batch one
+// step at a time if that finds all of n. Writes a nontrivial factor into factor
+// (count limbs) and returns its length, or 0 if none was found within budget steps.
+// The steps taken are subtracted from budget.
+//
+static NSUInteger
+BI_RhoFactor(BILimb *factor, const BILimb *n, NSUInteger count, BILimb c, NSUInteger *budget)
+{
+	BIMontgomery	m;
+	BILimb			*buffer = calloc(6 * count, sizeof(BILimb));
+	BILimb			*x = buffer, *y = x + count, *saved = y + count, *product = saved + count;
+	BILimb			*difference = product + count, *constant = difference + count;
+	NSUInteger		length = 1, steps = 0, done, i, gcdCount = 1;
+
+	BI_MontgomerySetup(&m, n, count);
+	y[0] = 2;
+	constant[0] = c;
+	memcpy(product, m.one, count * sizeof(BILimb));
+	factor[0] = 1;
+
+	#define BI_RHO_STEP(v)		BI_MontgomeryMultiply(&m, v, v, v); BI_AddModulo(v, v, constant, n, count)
+	#define BI_RHO_DIFFERENCE(a, b)	\
+		if (BI_Compare(a, count, b, count) >= 0) BI_Subtract(difference, a, count, b, count);	\
+		else BI_Subtract(difference, b, count, a, count)
+
+	while (gcdCount == 1 && factor[0] == 1 && steps < *budget)
+	{
+		memcpy(x, y, count * sizeof(BILimb));
+		for (i = 0; i < length; i++)
+		{
+			BI_RHO_STEP(y);
+		}
+
+		for (done = 0; done < length && gcdCount == 1 && factor[0] == 1; done += BI_rho_batch)
+		{
+			memcpy(saved, y, count * sizeof(BILimb));
+			for (i = 0; i < BI_rho_batch && done + i < length; i++)
+			{
+				BI_RHO_STEP(y);
+				BI_RHO_DIFFERENCE(x, y);
+				BI_MontgomeryMultiply(&m, product, product, difference);
+			}
+			gcdCount = BI_Gcd(factor, product, BI_Normalise(product, count), n, count);
+			steps += i;
+		}
+		length *= 2;
+		steps += length;
+	}
+
+	// The batch went past the factor and straight to n, so retrace it a step at a time
+	if (gcdCount == count && BI_Compare(factor, count, n, count) == 0)
+	{
+		gcdCount = 0;
+		for (i = 0; i < BI_rho_batch && gcdCount == 0; i++)
+		{
+			BI_RHO_STEP(saved);
+			BI_RHO_DIFFERENCE(x, saved);
+			gcdCount = BI_Gcd(factor, difference, BI_Normalise(difference, count), n, count);
+			if (gcdCount == 1 && factor[0] == 1)
+				gcdCount = 0;
+		}
+	}
+
+	#undef BI_RHO_STEP
+	#undef BI_RHO_DIFFERENCE
+
+	BI_MontgomeryFree(&m);
+	free(buffer);
+	*budget -= MIN(steps, *budget);
+
+	if ((gcdCount == 1 && factor[0] == 1) || gcdCount == 0 || (gcdCount == count && BI_Compare(factor, count, n, count) == 0))
+		return 0;
+	return gcdCount;
+}
+
+#pragma mark
+#pragma mark ### Word Functions ###
+
+//
+// BI_MultiplyModulo64
+//
+static uint64_t
+BI_MultiplyModulo64(uint64_t a, uint64_t b, uint64_t n)
+{
+	return (uint64_t)((unsigned __int128)a * b % n);
+}
+
+//
+// BI_PowerModulo64
+//
+// base^e mod n for a one word modulus and an exponent of any length.
+//
+static uint64_t
+BI_PowerModulo64(uint64_t base, const BILimb *e, NSUInteger en, uint64_t n)
+{
+	uint64_t	result = 1 % n;
+	NSUInteger	i;
+	int			bit;
+
+	base %= n;
+	for (i = en; i > 0; i--)
+	{
+		for (bit = 31; bit >= 0; bit--)
+		{
+			result = BI_MultiplyModulo64(result, result, n);
+			if ((e[i - 1] >> bit) & 1)
+				result = BI_MultiplyModulo64(result, base, n);
+		}
+	}
+	return result;
+}
+
+//
+// BI_IsPrime64
+//
+// Miller-Rabin with the bases up to 37, which is exact for every 64 bit number.
+//
+static BOOL
+BI_IsPrime64(uint64_t n)
+{
+	uint64_t	odd, x;
+	BILimb		oddLimbs[2];
+	int			twos, i;
+	NSUInteger	w;
+	BOOL		passed;
+
+	if (n < 2)
+		return NO;
+	for (w = 0; w < BI_witness_count; w++)
+	{
+		if (n % BI_witness_primes[w] == 0)
+			return n == BI_witness_primes[w];
+	}
+
+	twos = __builtin_ctzll(n - 1);
+	odd = (n - 1) >> twos;
+	oddLimbs[0] = (BILimb)odd;
+	oddLimbs[1] = (BILimb)(odd >> 32);
+	for (w = 0; w < BI_witness_count; w++)
+	{
+		x = BI_PowerModulo64(BI_witness_primes[w], oddLimbs, 2, n);
+		if (x == 1 || x == n - 1)
+			continue;
+
+		passed = NO;
+		for (i = 1; i < twos && !passed; i++)
+		{
+			x = BI_MultiplyModulo64(x, x, n);
+			passed = (x == n - 1);
+		}
+		if (!passed)
+			return NO;
+	}
+	return YES;
+}
+
+//
+// BI_RhoFactor64
+//
+// BI_RhoFactor for an odd composite that fits in a word. Returns 0 if no factor was found.
+//
+static uint64_t
+BI_RhoFactor64(uint64_t n, uint64_t c, NSUInteger *budget)
+{
+	uint64_t	x = 0, y = 2, saved = 2, product = 1, g = 1;
+	NSUInteger	length = 1, steps = 0, done, i;
+
+	#define BI_RHO_STEP64(v)	v = (uint64_t)(((unsigned __int128)v * v + c) % n)
+
+	while (g == 1 && steps < *budget)
+	{
+		x = y;
+		for (i = 0; i < length; i++)
+		{
+			BI_RHO_STEP64(y);
+		}
+
+		for (done = 0; done < length && g == 1; done += BI_rho_batch)
+		{
+			saved = y;
+			for (i = 0; i < BI_rho_batch && done + i < length; i++)
+			{
+				BI_RHO_STEP64(y);
+				product = BI_MultiplyModulo64(product, (x > y) ? x - y : y - x, n);
+			}
+			g = BI_Gcd64(product, n);
+			steps += i;
+		}
+		length *= 2;
+		steps += length;
+	}
+
+	if (g == n || g == 0)
+	{
+		g = 1;
+		for (i = 0; i < BI_rho_batch && g == 1; i++)
+		{
+			BI_RHO_STEP64(saved);
+			g = BI_Gcd64((x > saved) ? x - saved : saved - x, n);
+		}
+	}
+
+	#undef BI_RHO_STEP64
+
+	*budget -= MIN(steps, *budget);
+	return (g == 1 || g == n || g == 0) ? 0 : g;
+}
+
+@implementation BigInteger
+
+//
+// initialize
+//
+// Sieves the small primes before any number is made.
+//
++ (void)initialize
+{
+	if (self == [BigInteger class])
+		BI_SmallPrimesSetup();
+}
+
+#pragma mark
+#pragma mark ### Constructors ###
+
+//
+// initWithLimbs
+//
+// Takes ownership of a malloced magnitude of count limbs.
+//
+- (instancetype)initWithLimbs:(BILimb *)limbs count:(NSUInteger)count negative:(BOOL)negative
+{
+	self = [super init];
+	if (self)
+	{
+		bi_limbs = limbs;
+		bi_count = BI_Normalise(limbs, count);
+		bi_is_negative = negative && bi_count > 0;
+	}
+	else
+	{
+		free(limbs);
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free(bi_limbs);
+}
+
++ (BigInteger *)zero
+{
+	return [BigInteger integerWithLong:0];
+}
+
++ (BigInteger *)one
+{
+	return [BigInteger integerWithLong:1];
+}
+
+//
+// integerWithLong
+//
++ (BigInteger *)integerWithLong:(long long)value
+{
+	BILimb				*limbs = malloc(2 * sizeof(BILimb));
+	unsigned long long	magnitude = (value < 0) ? -(unsigned long long)value : (unsigned long long)value;
+
+	limbs[0] = (BILimb)magnitude;
+	limbs[1] = (BILimb)(magnitude >> 32);
+	return [[BigInteger alloc] initWithLimbs:limbs count:2 negative:value < 0];
+}
+
+//
+// integerWithUnsignedLong
+//
++ (BigInteger *)integerWithUnsignedLong:(uint64_t)value
+{
+	BILimb *limbs = malloc(2 * sizeof(BILimb));
+
+	limbs[0] = (BILimb)value;
+	limbs[1] = (BILimb)(value >> 32);
+	return [[BigInteger alloc] initWithLimbs:limbs count:2 negative:NO];
+}
+
+//
+// integerWithDigits
+//
+// The number with the given digits (least significant first) in a base below 2^32.
+//
++ (BigInteger *)integerWithDigits:(const unsigned long *)digits count:(NSUInteger)count base:(unsigned long)base negative:(BOOL)negative
+{
+	BILimb		*limbs = calloc(count + 1, sizeof(BILimb));
+	NSUInteger	length = 0, i;
+
+	for (i = count; i > 0; i--)
+	{
+		BILimb carry = BI_MultiplyAddSmall(limbs, length, (BILimb)base, (BILimb)digits[i - 1]);
+		if (carry != 0)
+			limbs[length++] = carry;
+	}
+	return [[BigInteger alloc] initWithLimbs:limbs count:length negative:negative];
+}
+
+//
+// copyWithZone
+//
+// BigIntegers are immutable so a copy is the same number.
+//
+- (id)copyWithZone:(NSZone *)zone
+{
+	return self;
+}
+
+//
+// duplicateWithNegative
+//
+// A new number with the magnitude of the receiver and the given sign.
+//
+- (BigInteger *)duplicateWithNegative:(BOOL)negative
+{
+	BILimb *limbs = malloc(MAX(bi_count, 1) * sizeof(BILimb));
+
+	memcpy(limbs, bi_limbs, bi_count * sizeof(BILimb));
+	return [[BigInteger alloc] initWithLimbs:limbs count:bi_count negative:negative];
+}
+
+//
+// capped
+//
+// The receiver, or nil if it is bigger than BI_max_bits.
+//
+- (BigInteger *)capped
+{
+	return ([self bitLength] > BI_max_bits) ? nil : self;
+}
+
+#pragma mark
+#pragma mark ### Accessors ###
+
+- (NSUInteger)bitLength
+{
+	if (bi_count == 0)
+		return 0;
+	return 32 * bi_count - __builtin_clz(bi_limbs[bi_count - 1]);
+}
+
+- (BOOL)isZero
+{
+	return bi_count == 0;
+}
+
+- (BOOL)isNegative
+{
+	return bi_is_negative;
+}
+
+- (BOOL)isOdd
+{
+	return bi_count > 0 && (bi_limbs[0] & 1) != 0;
+}
+
+//
+// doubleValue
+//
+// The nearest double (or infinity). The top 64 bits are rounded by the conversion, with
+// any lower bits that are set kept as a sticky bit so that ties are only ties when the
+// rest of the number is zero.
+//
+- (double)doubleValue
+{
+	NSUInteger	bits, shift, limb, offset, i;
+	uint64_t	top;
+	BOOL		sticky;
+	double		result;
+
+	if (bi_count == 0)
+		return 0.0;
+
+	bits = 32 * bi_count - __builtin_clz(bi_limbs[bi_count - 1]);
+	if (bits <= 64)
+	{
+		top = bi_limbs[0] | ((bi_count > 1) ? (uint64_t)bi_limbs[1] << 32 : 0);
+		result = (double)top;
+	}
+	else
+	{
+		shift = bits - 64;
+		limb = shift / 32;
+		offset = shift % 32;
+		if (offset == 0)
+		{
+			top = bi_limbs[limb] | (uint64_t)bi_limbs[limb + 1] << 32;
+			sticky = NO;
+		}
+		else
+		{
+			top = (bi_limbs[limb] >> offset) | (uint64_t)bi_limbs[limb + 1] << (32 - offset) | (uint64_t)bi_limbs[limb + 2] << (64 - offset);
+			sticky = (bi_limbs[limb] & ((1u << offset) - 1)) != 0;
+		}
+		for (i = 0; i < limb && !sticky; i++)
+			sticky = bi_limbs[i] != 0;
+		result = ldexp((double)(top | (sticky ? 1 : 0)), (int)MIN(shift, 4096));
+	}
+	return bi_is_negative ? -result : result;
+}
+
+//
+// getLongValue
+//
+// Sets result and returns YES if the number fits in a long long.
+//
+- (BOOL)getLongValue:(long long *)result
+{
+	unsigned long long magnitude;
+
+	if (bi_count > 2)
+		return NO;
+
+	magnitude = (bi_count > 0) ? bi_limbs[0] : 0;
+	if (bi_count > 1)
+		magnitude |= (unsigned long long)bi_limbs[1] << 32;
+	if (magnitude > (unsigned long long)LLONG_MAX + (bi_is_negative ? 1 : 0))
+		return NO;
+
+	*result = bi_is_negative ? (long long)(0 - magnitude) : (long long)magnitude;
+	return YES;
+}
+
+//
+// getWordValue
+//
+// Sets result to the magnitude and returns YES if it fits in 64 bits.
+//
+- (BOOL)getWordValue:(uint64_t *)result
+{
+	if (bi_count > 2)
+		return NO;
+
+	*result = (bi_count > 0) ? bi_limbs[0] : 0;
+	if (bi_count > 1)
+		*result |= (uint64_t)bi_limbs[1] << 32;
+	return YES;
+}
+
+//
+// digitsWithBase
+//
+// The digits of the magnitude in a base below 2^32 as unsigned longs, least significant
+// first (no digits for zero).
+//
+- (NSData *)digitsWithBase:(unsigned long)base
+{
+	NSMutableData	*result = [NSMutableData data];
+	BILimb			*limbs = malloc(MAX(bi_count, 1) * sizeof(BILimb));
+	NSUInteger		count = bi_count;
+	unsigned long	digit;
+
+	memcpy(limbs, bi_limbs, bi_count * sizeof(BILimb));
+	while (count > 0)
+	{
+		digit = BI_DivideSmall(limbs, limbs, count, (BILimb)base);
+		count = BI_Normalise(limbs, count);
+		[result appendBytes:&digit length:sizeof(digit)];
+	}
+	free(limbs);
+	return result;
+}
+
+//
+// stringWithRadix
+//
+// Every digit of the number in a radix from 2 to 36. The limbs are divided by the
+// largest power of the radix that fits in a limb, so each division gives several digits.
+//
+- (NSString *)stringWithRadix:(unsigned short)radix
+{
+	static const char	digitCharacters[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	unsigned long		chunk = radix;
+	int					chunkDigits = 1, i;
+	NSData				*chunks;
+	const unsigned long	*values;
+	NSUInteger			count, position, j;
+	char				*characters;
+	NSString			*result;
+
+	if (radix < 2 || radix > 36)
+		radix = 10;
+	if (bi_count == 0)
+		return @"0";
+
+	for (chunk = radix; chunk * radix <= 0xFFFFFFFFUL; chunk *= radix)
+		chunkDigits++;
+
+	chunks = [self digitsWithBase:chunk];
+	values = [chunks bytes];
+	count = [chunks length] / sizeof(unsigned long);
+	characters = malloc(count * chunkDigits + 2);
+	position = count * chunkDigits + 1;
+	characters[position] = 0;
+
+	for (j = 0; j < count; j++)
+	{
+		unsigned long value = values[j];
+		for (i = 0; i < chunkDigits; i++)
+		{
+			characters[--position] = digitCharacters[value % radix];
+			value /= radix;
+		}
+	}
+	while (characters[position] == '0' && characters[position + 1] != 0)
+		position++;
+	if (bi_is_negative)
+		characters[--position] = '-';
+
+	result = @(characters + position);
+	free(characters);
+	return result;
+}
+
+- (NSString *)description
+{
+	return [self stringWithRadix:10];
+}
+
+#pragma mark
+#pragma mark ### Arithmetic Functions ###
+
+//
+// compareWith
+//
+- (NSComparisonResult)compareWith:(BigInteger *)num
+{
+	int magnitude;
+
+	if (bi_is_negative != num->bi_is_negative)
+		return bi_is_negative ? NSOrderedAscending : NSOrderedDescending;
+
+	magnitude = BI_Compare(bi_limbs, bi_count, num->bi_limbs, num->bi_count);
+	if (bi_is_negative)
+		magnitude = -magnitude;
+	return (magnitude < 0) ? NSOrderedAscending : (magnitude > 0) ? NSOrderedDescending : NSOrderedSame;
+}
+
+- (BigInteger *)negated
+{
+	return [self duplicateWithNegative:!bi_is_negative];
+}
+
+- (BigInteger *)absoluteValue
+{
+	return bi_is_negative ? [self duplicateWithNegative:NO] : self;
+}
+
+//
+// addWith
+//
+// self + num, with num's sign flipped when subtracting.
+//
+- (BigInteger *)addWith:(BigInteger *)num negative:(BOOL)numNegative
+{
+	const BILimb	*a = bi_limbs, *b = num->bi_limbs;
+	NSUInteger		an = bi_count, bn = num->bi_count;
+	BILimb			*limbs;
+	BOOL			negative = bi_is_negative;
+
+	limbs = malloc((MAX(an, bn) + 1) * sizeof(BILimb));
+	if (bi_is_negative == numNegative)
+	{
+		if (an < bn)
+		{
+			a = num->bi_limbs; b = bi_limbs;
+			an = num->bi_count; bn = bi_count;
+		}
+		limbs[an] = BI_Add(limbs, a, an, b, bn);
+		an++;
+	}
+	else
+	{
+		if (BI_Compare(a, an, b, bn) < 0)
+		{
+			a = num->bi_limbs; b = bi_limbs;
+			an = num->bi_count; bn = bi_count;
+			negative = numNegative;
+		}
+		BI_Subtract(limbs, a, an, b, bn);
+	}
+	return [[[BigInteger alloc] initWithLimbs:limbs count:an negative:negative] capped];
+}
+
+- (BigInteger *)add:(BigInteger *)num
+{
+	if (num == nil)
+		return nil;
+	return [self addWith:num negative:num->bi_is_negative];
+}
+
+- (BigInteger *)subtract:(BigInteger *)num
+{
+	if (num == nil)
+		return nil;
+	return [self addWith:num negative:!num->bi_is_negative];
+}
+
+//
+// productWith
+//
+// self * num without the size limit, for intermediate results.
+//
+- (BigInteger *)productWith:(BigInteger *)num
+{
+	BILimb *limbs;
+
+	if (num == nil)
+		return nil;
+	if (bi_count == 0 || num->bi_count == 0)
+		return [BigInteger zero];
+
+	limbs = malloc((bi_count + num->bi_count) * sizeof(BILimb));
+	BI_Multiply(limbs, bi_limbs, bi_count, num->bi_limbs, num->bi_count);
+	return [[BigInteger alloc] initWithLimbs:limbs count:bi_count + num->bi_count negative:bi_is_negative != num->bi_is_negative];
+}
+
+- (BigInteger *)multiplyBy:(BigInteger *)num
+{
+	return [[self productWith:num] capped];
+}
+
+//
+// divideBy:remainder:
+//
+// The quotient rounded towards zero, with the remainder taking the sign of the dividend
+// (as BigFloat's moduloBy: does). Returns nil when dividing by zero.
+//
+- (BigInteger *)divideBy:(BigInteger *)num remainder:(BigInteger **)remainder
+{
+	BILimb		*quotientLimbs, *remainderLimbs;
+	NSUInteger	quotientCount, remainderCount;
+
+	if (num == nil || num->bi_count == 0)
+		return nil;
+
+	if (BI_Compare(bi_limbs, bi_count, num->bi_limbs, num->bi_count) < 0)
+	{
+		if (remainder != NULL)
+			*remainder = self;
+		return [BigInteger zero];
+	}
+
+	quotientCount = bi_count - num->bi_count + 1;
+	remainderCount = num->bi_count;
+	quotientLimbs = malloc(quotientCount * sizeof(BILimb));
+	remainderLimbs = malloc(remainderCount * sizeof(BILimb));
+	if (num->bi_count == 1)
+		remainderLimbs[0] = BI_DivideSmall(quotientLimbs, bi_limbs, bi_count, num->bi_limbs[0]);
+	else
+		BI_Divide(quotientLimbs, remainderLimbs, bi_limbs, bi_count, num->bi_limbs, num->bi_count);
+
+	if (remainder != NULL)
+		*remainder = [[BigInteger alloc] initWithLimbs:remainderLimbs count:remainderCount negative:bi_is_negative];
+	else
+		free(remainderLimbs);
+	return [[BigInteger alloc] initWithLimbs:quotientLimbs count:quotientCount negative:bi_is_negative != num->bi_is_negative];
+}
+
+- (BigInteger *)divideBy:(BigInteger *)num
+{
+	return [self divideBy:num remainder:NULL];
+}
+
+- (BigInteger *)moduloBy:(BigInteger *)num
+{
+	BigInteger *remainder = nil;
+
+	[self divideBy:num remainder:&remainder];
+	return remainder;
+}
+
+//
+// raiseToIntPower
+//
+// Binary powering (each squaring is a single multiplication of equal lengths, which
+// is where Karatsuba does best). 0^0 is left undefined.
+//
+- (BigInteger *)raiseToIntPower:(NSUInteger)n
+{
+	BigInteger	*result = [BigInteger one];
+	BigInteger	*square = self;
+
+	if (n == 0)
+		return (bi_count == 0) ? nil : result;
+	if (bi_count == 0 || (bi_count == 1 && bi_limbs[0] == 1))
+		return (bi_is_negative && (n & 1) == 0) ? [self negated] : self;
+	if ((double)n * ([self bitLength] - 1) > BI_max_bits)
+		return nil;
+
+	while (YES)
+	{
+		if (n & 1)
+			result = [result productWith:square];
+		n >>= 1;
+		if (n == 0)
+			break;
+		square = [square productWith:square];
+	}
+	return [result capped];
+}
+
+//
+// raiseToPower
+//
+// An integer power. Negative powers only have integer results for 1 and -1.
+//
+- (BigInteger *)raiseToPower:(BigInteger *)num
+{
+	uint64_t n;
+
+	if (num == nil)
+		return nil;
+
+	if (bi_count == 1 && bi_limbs[0] == 1)
+		return (bi_is_negative && ![num isOdd]) ? [self negated] : self;
+	if (num->bi_is_negative)
+		return nil;
+	if (bi_count == 0)
+		return (num->bi_count == 0) ? nil : self;
+	if (![num getWordValue:&n] || n > BI_max_bits)
+		return nil;
+
+	return [self raiseToIntPower:(NSUInteger)n];
+}
+
+#pragma mark
+#pragma mark ### Combinatorial Functions ###
+
+//
+// productFrom
+//
+// high * (high - 1) * ... * (high - count + 1), split in halves so that the
+// multiplications are between numbers of similar sizes. Not limited in size.
+//
++ (BigInteger *)productFrom:(BigInteger *)high count:(NSUInteger)count
+{
+	BigInteger	*result;
+	NSUInteger	half, i;
+
+	if (count == 0)
+		return [BigInteger one];
+
+	if (count <= BI_product_leaf)
+	{
+		result = high;
+		for (i = 1; i < count; i++)
+			result = [result productWith:[high subtract:[BigInteger integerWithLong:i]]];
+		return result;
+	}
+
+	half = count / 2;
+	return [[BigInteger productFrom:high count:half] productWith:
+		[BigInteger productFrom:[high subtract:[BigInteger integerWithLong:half]] count:count - half]];
+}
+
+//
+// productOf
+//
+// The product of the numbers in the range of factors, split in halves.
+//
++ (BigInteger *)productOf:(NSArray *)factors range:(NSRange)range
+{
+	NSUInteger half;
+
+	if (range.length == 0)
+		return [BigInteger one];
+	if (range.length == 1)
+		return factors[range.location];
+
+	half = range.length / 2;
+	return [[BigInteger productOf:factors range:NSMakeRange(range.location, half)] productWith:
+		[BigInteger productOf:factors range:NSMakeRange(range.location + half, range.length - half)]];
+}
+
+//
+// BI_Log2FallingFactorial
+//
+// Roughly log2(n! / (n - r)!), to turn away results that can't fit before working
+// them out. Never more than a few bits too big.
+//
+static double
+BI_Log2FallingFactorial(BigInteger *n, NSUInteger r)
+{
+	double value = [n doubleValue];
+
+	if ([n bitLength] <= 32)
+		return (lgamma(value + 1.0) - lgamma(value - r + 1.0)) / M_LN2;
+
+	// Only reached for r < BI_max_bits, so every factor is more than half of n
+	return (double)r * ([n bitLength] - 2);
+}
+
+//
+// factorial
+//
+- (BigInteger *)factorial
+{
+	uint64_t n;
+
+	if (bi_is_negative || ![self getWordValue:&n] || n > BI_max_bits)
+		return nil;
+	if (n < 2)
+		return [BigInteger one];
+	if (BI_Log2FallingFactorial(self, (NSUInteger)n) > BI_max_bits + 64)
+		return nil;
+
+	return [[BigInteger productFrom:self count:(NSUInteger)n] capped];
+}
+
+//
+// nPr
+//
+// Permutations: n! / (n - r)!, which is zero if r > n (as for BigFloat).
+//
+- (BigInteger *)nPr:(BigInteger *)r
+{
+	uint64_t count;
+
+	if (r == nil || bi_is_negative || r->bi_is_negative)
+		return nil;
+	if ([r compareWith:self] == NSOrderedDescending)
+		return [BigInteger zero];
+	if (![r getWordValue:&count] || count > BI_max_bits)
+		return nil;
+	if (BI_Log2FallingFactorial(self, (NSUInteger)count) > BI_max_bits + 64)
+		return nil;
+
+	return [[BigInteger productFrom:self count:(NSUInteger)count] capped];
+}
+
+//
+// nCr
+//
+// Combinations: n! / (r! (n - r)!), which is zero if r > n (as for BigFloat). For n up
+// to BI_prime_power_limit the result is built from its prime factorisation (the power
+// of each prime p being the carries when adding r and n - r in base p, by Kummer's
+// theorem, counted here with Legendre's formula) so nothing bigger than the result is
+// ever made. Larger n are only possible with small r, so there the falling factorial
+// is divided by r!.
+//
+- (BigInteger *)nCr:(BigInteger *)r
+{
+	BigInteger		*other;
+	NSMutableArray	*factors;
+	uint64_t		count, n, p, power, exponent, product;
+	unsigned char	*composite;
+
+	if (r == nil || bi_is_negative || r->bi_is_negative)
+		return nil;
+	if ([r compareWith:self] == NSOrderedDescending)
+		return [BigInteger zero];
+
+	// C(n, r) = C(n, n - r), so use the smaller
+	other = [self subtract:r];
+	if ([other compareWith:r] == NSOrderedAscending)
+		r = other;
+	if (![r getWordValue:&count] || count > BI_max_bits)
+		return nil;
+	if (count == 0)
+		return [BigInteger one];
+	if (BI_Log2FallingFactorial(self, (NSUInteger)count) - BI_Log2FallingFactorial(r, (NSUInteger)count) > BI_max_bits + 64)
+		return nil;
+
+	if (![self getWordValue:&n] || n > BI_prime_power_limit || count <= BI_product_leaf)
+	{
+		return [[[BigInteger productFrom:self count:(NSUInteger)count] divideBy:
+			[BigInteger productFrom:r count:(NSUInteger)count]] capped];
+	}
+
+	factors = [NSMutableArray array];
+	composite = calloc(n + 1, 1);
+	product = 1;
+	for (p = 2; p <= n; p++)
+	{
+		if (composite[p])
+			continue;
+		for (power = p * p; power <= n; power += p)
+			composite[power] = 1;
+
+		exponent = 0;
+		for (power = p; power <= n; power *= p)
+		{
+			exponent += n / power - count / power - (n - count) / power;
+			if (power > n / p)
+				break;
+		}
+		for (; exponent > 0; exponent--)
+		{
+			if (product > UINT32_MAX)
+			{
+				[factors addObject:[BigInteger integerWithUnsignedLong:product]];
+				product = 1;
+			}
+			product *= p;
+		}
+	}
+	free(composite);
+	[factors addObject:[BigInteger integerWithUnsignedLong:product]];
+
+	return [[BigInteger productOf:factors range:NSMakeRange(0, [factors count])] capped];
+}
+
+#pragma mark
+#pragma mark ### Number Theory Functions ###
+
+//
+// gcdWith
+//
+// The greatest common divisor, which is never negative. gcd(0, 0) is 0.
+//
+- (BigInteger *)gcdWith:(BigInteger *)num
+{
+	BILimb		*limbs;
+	NSUInteger	count;
+
+	if (num == nil)
+		return nil;
+	if (bi_count == 0)
+		return [num absoluteValue];
+	if (num->bi_count == 0)
+		return [self absoluteValue];
+
+	limbs = malloc(MAX(bi_count, num->bi_count) * sizeof(BILimb));
+	count = BI_Gcd(limbs, bi_limbs, bi_count, num->bi_limbs, num->bi_count);
+	return [[BigInteger alloc] initWithLimbs:limbs count:count negative:NO];
+}
+
+//
+// lcmWith
+//
+// The least common multiple, which is never negative. The lcm with 0 is 0.
+//
+- (BigInteger *)lcmWith:(BigInteger *)num
+{
+	if (num == nil)
+		return nil;
+	if (bi_count == 0 || num->bi_count == 0)
+		return [BigInteger zero];
+
+	return [[[[self divideBy:[self gcdWith:num]] productWith:num] absoluteValue] capped];
+}
+
+//
+// raiseToPower:modulo:
+//
+// self^num mod modulus without ever making self^num, so the power can be as large
+// as the modulus allows. Odd moduli use Montgomery multiplication (words use 128 bit
+// arithmetic instead). Like moduloBy:, the result takes the sign of self^num.
+//
+- (BigInteger *)raiseToPower:(BigInteger *)num modulo:(BigInteger *)modulus
+{
+	BigInteger		*m = [modulus absoluteValue];
+	BigInteger		*base, *result;
+	BIMontgomery	mont;
+	BILimb			*x, *unit;
+	uint64_t		word;
+	NSUInteger		i;
+	int				bit;
+
+	if (num == nil || m == nil || m->bi_count == 0 || num->bi_is_negative)
+		return nil;
+	if (bi_count == 0 && num->bi_count == 0)
+		return nil;
+
+	base = [[self absoluteValue] moduloBy:m];
+	if ([m getWordValue:&word])
+	{
+		uint64_t baseWord;
+		[base getWordValue:&baseWord];
+		result = [BigInteger integerWithUnsignedLong:BI_PowerModulo64(baseWord, num->bi_limbs, num->bi_count, word)];
+	}
+	else if ([m isOdd])
+	{
+		BI_MontgomerySetup(&mont, m->bi_limbs, m->bi_count);
+		x = calloc(m->bi_count, sizeof(BILimb));
+		unit = calloc(m->bi_count, sizeof(BILimb));
+		memcpy(x, base->bi_limbs, base->bi_count * sizeof(BILimb));
+		unit[0] = 1;
+
+		BI_MontgomeryMultiply(&mont, x, x, mont.squaredR);
+		BI_MontgomeryPower(&mont, x, x, num->bi_limbs, num->bi_count);
+		BI_MontgomeryMultiply(&mont, x, x, unit);
+
+		free(unit);
+		BI_MontgomeryFree(&mont);
+		result = [[BigInteger alloc] initWithLimbs:x count:m->bi_count negative:NO];
+	}
+	else
+	{
+		result = [BigInteger one];
+		for (i = num->bi_count; i > 0; i--)
+		{
+			for (bit = 31; bit >= 0; bit--)
+			{
+				result = [[result productWith:result] moduloBy:m];
+				if ((num->bi_limbs[i - 1] >> bit) & 1)
+					result = [[result productWith:base] moduloBy:m];
+			}
+		}
+	}
+
+	return (bi_is_negative && [num isOdd]) ? [result negated] : result;
+}
+
+//
+// isProbablePrime
+//
+// Whether the number is prime: exact below 2^81 and wrong with a probability below
+// 4^-5 above that. Only positive numbers are prime. The time taken grows with the cube
+// of the length, so callers limit it to BI_number_theory_bits.
+//
+- (BOOL)isProbablePrime
+{
+	uint64_t	word;
+	NSUInteger	i;
+
+	if (bi_is_negative)
+		return NO;
+	if ([self getWordValue:&word])
+		return BI_IsPrime64(word);
+	if (![self isOdd])
+		return NO;
+
+	for (i = 0; i < BI_small_prime_count; i++)
+	{
+		if (BI_RemainderSmall(bi_limbs, bi_count, BI_small_primes[i]) == 0)
+			return NO;
+	}
+	return BI_IsProbablePrime(bi_limbs, bi_count);
+}
+
+//
+// findFactorWithin
+//
+// A nontrivial factor of an odd composite without small factors, or nil if Pollard's
+// rho couldn't find one within budget steps. The steps taken are subtracted from budget.
+//
+- (BigInteger *)findFactorWithin:(NSUInteger *)budget
+{
+	BILimb		*limbs;
+	NSUInteger	count;
+	uint64_t	word, factor;
+	BILimb		c;
+
+	for (c = 1; c <= BI_rho_max_attempts && *budget > 0; c++)
+	{
+		if ([self getWordValue:&word])
+		{
+			factor = BI_RhoFactor64(word, c, budget);
+			if (factor != 0)
+				return [BigInteger integerWithUnsignedLong:factor];
+		}
+		else
+		{
+			limbs = malloc(bi_count * sizeof(BILimb));
+			count = BI_RhoFactor(limbs, bi_limbs, bi_count, c, budget);
+			if (count != 0)
+				return [[BigInteger alloc] initWithLimbs:limbs count:count negative:NO];
+			free(limbs);
+		}
+	}
+	return nil;
+}
+
+//
+// removeSmallFactorsInto
+//
+// Divides out the primes below BI_trial_division_limit, adding each to factors (as
+// often as it divides), and returns what is left.
+//
+- (BigInteger *)removeSmallFactorsInto:(NSMutableArray *)factors stopAtFirst:(BOOL)stop
+{
+	BILimb		*limbs = malloc(MAX(bi_count, 1) * sizeof(BILimb));
+	BILimb		*quotient = malloc(MAX(bi_count, 1) * sizeof(BILimb));
+	BILimb		*swap, p;
+	NSUInteger	count = bi_count, i;
+
+	memcpy(limbs, bi_limbs, bi_count * sizeof(BILimb));
+	for (i = 0; i < BI_small_prime_count && count > 0 && !(count == 1 && limbs[0] == 1); i++)
+	{
+		p = BI_small_primes[i];
+		while (count > 0 && BI_DivideSmall(quotient, limbs, count, p) == 0)
+		{
+			[factors addObject:[BigInteger integerWithLong:p]];
+			if (stop)
+				break;
+
+			swap = limbs; limbs = quotient; quotient = swap;
+			count = BI_Normalise(limbs, count);
+		}
+		if (stop && [factors count] > 0)
+			break;
+	}
+	free(quotient);
+	return [[BigInteger alloc] initWithLimbs:limbs count:count negative:NO];
+}
+
+//
+// primeFactors
+//
+// The prime factors of the magnitude in increasing order, repeated as often as they
+// divide it: trial division for the small ones then Pollard's rho, splitting until
+// every part passes isProbablePrime. Empty for 1 and nil for 0, above
+// BI_number_theory_bits or if a factor couldn't be found within the rho budget.
+//
+- (NSArray *)primeFactors
+{
+	NSMutableArray	*factors = [NSMutableArray array];
+	NSMutableArray	*composites = [NSMutableArray array];
+	BigInteger		*rest, *factor;
+	NSUInteger		budget;
+
+	if (bi_count == 0 || [self bitLength] > BI_number_theory_bits)
+		return nil;
+
+	rest = [self removeSmallFactorsInto:factors stopAtFirst:NO];
+	if (!(rest->bi_count == 1 && rest->bi_limbs[0] == 1))
+		[composites addObject:rest];
+	budget = MIN(BI_rho_max_steps, BI_rho_work / (rest->bi_count * rest->bi_count));
+
+	while ([composites count] > 0)
+	{
+		rest = [composites lastObject];
+		[composites removeLastObject];
+
+		if ([rest isProbablePrime])
+		{
+			[factors addObject:rest];
+			continue;
+		}
+
+		factor = [rest findFactorWithin:&budget];
+		if (factor == nil)
+			return nil;
+		[composites addObject:factor];
+		[composites addObject:[rest divideBy:factor]];
+	}
+
+	[factors sortUsingComparator:^(BigInteger *a, BigInteger *b) { return [a compareWith:b]; }];
+	return factors;
+}
+
+//
+// smallestPrimeFactor
+//
+// The smallest prime dividing the magnitude (the number itself if it is prime), or nil
+// below 2, above BI_number_theory_bits or if a factor couldn't be found.
+//
+- (BigInteger *)smallestPrimeFactor
+{
+	NSMutableArray	*factors = [NSMutableArray array];
+	BigInteger		*magnitude = [self absoluteValue];
+
+	if (bi_count == 0 || (bi_count == 1 && bi_limbs[0] == 1) || [self bitLength] > BI_number_theory_bits)
+		return nil;
+
+	[magnitude removeSmallFactorsInto:factors stopAtFirst:YES];
+	if ([factors count] > 0)
+		return factors[0];
+	if ([magnitude isProbablePrime])
+		return magnitude;
+
+	return [[magnitude primeFactors] firstObject];
+}
+
+@end
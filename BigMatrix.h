@@ -0,0 +1,65 @@
+// ##############################################################
+//  BigMatrix.h
+//  Magic Number Machine
+//
+// ##############################################################
+
+#import <Foundation/Foundation.h>
+
+@class BigCFloat;
+
+//
+// About BigMatrix
+//
+// A dense matrix of BigCFloats used by the array drawer's linear algebra. The
+// elements are held row-major in a single array. Factorising the matrix replaces it
+// in place with its LU decomposition (partial pivoting by magnitude, unit lower
+// triangle below the diagonal, upper triangle on and above it) and remembers the
+// row permutation, after which determinants, solutions and the inverse all come
+// from the factors.
+//
+// Elimination is blocked: a panel of columns is factorised, then the trailing rows
+// are updated from the panel in one pass, each row on its own thread.
+//
+// Products are tiled and each tile is computed on its own thread; every element of a
+// product is one fused dot product, so it is rounded only once.
+//
+// refinedSolve: is the fast path for real, reasonably conditioned systems: it
+// factorises in hardware doubles and iteratively refines the solution using residuals
+// computed at full precision, falling back to the BigCFloat factorisation otherwise.
+//
+@interface BigMatrix : NSObject
+{
+	int				bm_rows;
+	int				bm_columns;
+	unsigned short	bm_radix;
+	NSMutableArray	*bm_elements;
+	NSMutableArray	*bm_permutation;
+	BOOL			bm_is_factorised;
+	BOOL			bm_is_singular;
+	BOOL			bm_odd_exchanges;
+}
+
+// Constructors
+- (instancetype)initWithArray:(NSArray *)values rows:(int)rows columns:(int)columns radix:(unsigned short)radix;
+- (instancetype)initIdentityWithSize:(int)size radix:(unsigned short)radix;
+
+// Accessors
+@property (nonatomic, readonly) int rows;
+@property (nonatomic, readonly) int columns;
+- (BigCFloat *)elementAtRow:(int)row column:(int)column;
+- (void)copyToArray:(NSMutableArray *)values;
+
+// Linear Algebra Functions
+- (BOOL)factorise;
+- (BigCFloat *)determinant;
+- (BigMatrix *)solve:(BigMatrix *)rhs;
+- (BigMatrix *)refinedSolve:(BigMatrix *)rhs;
+- (BigMatrix *)inverse;
+
+// Matrix Arithmetic Functions
+- (BigMatrix *)multiplyBy:(BigMatrix *)other;
+- (BigMatrix *)power:(int)exponent;
+- (BigMatrix *)transpose;
+
+@end
@@ -0,0 +1,747 @@
+// ##############################################################
+//  BigMatrix.m
+//  Magic Number Machine
+//
+// ##############################################################
+
+#import "BigMatrix.h"
+#import "BigCFloat.h"
+
+//
+// About BigMatrix
+//
+// A dense matrix of BigCFloats used by the array drawer's linear algebra. See the
+// header for the storage and factorisation scheme.
+//
+
+// Number of columns factorised together before the trailing rows are updated
+#define BM_block_size		16
+
+// Mixed precision solves give up on matrices whose estimated condition number is
+// above this, and on refinements that have not converged after this many steps
+#define BM_refinement_condition_limit	1.0e10
+#define BM_refinement_max_iterations	40
+
+// Products are computed a tile of this many rows by this many columns at a time, so
+// each tile's rows and columns stay in cache while all of its dot products are taken
+#define BM_product_tile		32
+
+// Element (i, j) of the receiver
+#define BM_ELEMENT(i, j)	((BigCFloat *)self->bm_elements[(i) * self->bm_columns + (j)])
+
+@implementation BigMatrix
+
+#pragma mark
+#pragma mark ### Constructors ###
+
+//
+// initWithArray
+//
+// Creates a matrix holding copies of the row-major values.
+//
+- (instancetype)initWithArray:(NSArray *)values rows:(int)rows columns:(int)columns radix:(unsigned short)radix
+{
+	int i;
+
+	self = [super init];
+	if (self)
+	{
+		bm_rows = rows;
+		bm_columns = columns;
+		bm_radix = radix;
+		bm_elements = [NSMutableArray arrayWithCapacity:rows * columns];
+		bm_permutation = [NSMutableArray arrayWithCapacity:rows];
+
+		for (i = 0; i < rows * columns; i++)
+		{
+			if (i < [values count])
+				[bm_elements addObject:[values[i] duplicate]];
+			else
+				[bm_elements addObject:[BigCFloat bigFloatWithInt:0 radix:radix]];
+		}
+		for (i = 0; i < rows; i++)
+		{
+			[bm_permutation addObject:@(i)];
+		}
+	}
+	return self;
+}
+
+//
+// initIdentityWithSize
+//
+// Creates a size by size identity matrix.
+//
+- (instancetype)initIdentityWithSize:(int)size radix:(unsigned short)radix
+{
+	int i;
+
+	self = [self initWithArray:@[] rows:size columns:size radix:radix];
+	if (self)
+	{
+		for (i = 0; i < size; i++)
+		{
+			[BM_ELEMENT(i, i) assign:[BigCFloat bigFloatWithInt:1 radix:radix]];
+		}
+	}
+	return self;
+}
+
+#pragma mark
+#pragma mark ### Accessors ###
+
+- (int)rows
+{
+	return bm_rows;
+}
+
+- (int)columns
+{
+	return bm_columns;
+}
+
+//
+// elementAtRow
+//
+// The element at (row, column). After factorising this is an element of the factors.
+//
+- (BigCFloat *)elementAtRow:(int)row column:(int)column
+{
+	return BM_ELEMENT(row, column);
+}
+
+//
+// copyToArray
+//
+// Assigns the elements, row-major, into the existing BigCFloats of values.
+//
+- (void)copyToArray:(NSMutableArray *)values
+{
+	int i;
+
+	for (i = 0; i < bm_rows * bm_columns && i < [values count]; i++)
+	{
+		[values[i] assign:bm_elements[i]];
+	}
+}
+
+#pragma mark
+#pragma mark ### Linear Algebra Functions ###
+
+//
+// exchangeRow
+//
+// Swaps two rows. Only the element pointers move.
+//
+- (void)exchangeRow:(int)one withRow:(int)two
+{
+	int j;
+
+	if (one == two)
+		return;
+
+	for (j = 0; j < bm_columns; j++)
+	{
+		[bm_elements exchangeObjectAtIndex:one * bm_columns + j withObjectAtIndex:two * bm_columns + j];
+	}
+	[bm_permutation exchangeObjectAtIndex:one withObjectAtIndex:two];
+	bm_odd_exchanges = !bm_odd_exchanges;
+}
+
+//
+// pivotRowForColumn
+//
+// The row at or below "column" with the largest magnitude in that column, or -1 if
+// they are all zero.
+//
+- (int)pivotRowForColumn:(int)column
+{
+	BigFloat	*largest = nil;
+	BigFloat	*magnitude;
+	int			result = -1;
+	int			i;
+
+	for (i = column; i < bm_rows; i++)
+	{
+		if ([BM_ELEMENT(i, column) isZero])
+			continue;
+
+		magnitude = [BM_ELEMENT(i, column) magnitude];
+		if (largest == nil || [magnitude compareWith:largest] == NSOrderedDescending)
+		{
+			largest = magnitude;
+			result = i;
+		}
+	}
+
+	return result;
+}
+
+//
+// factorise
+//
+// Replaces the matrix with its LU factors. Returns NO if the matrix is singular.
+// Factorising an already factorised matrix does nothing.
+//
+- (BOOL)factorise
+{
+	dispatch_queue_t	queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+	int					n = bm_rows;
+	int					block_start, block_end;
+	int					k;
+
+	NSAssert(bm_rows == bm_columns, @"Only square matrices can be factorised");
+
+	if (bm_is_factorised)
+		return !bm_is_singular;
+	bm_is_factorised = YES;
+
+	for (block_start = 0; block_start < n; block_start = block_end)
+	{
+		block_end = MIN(block_start + BM_block_size, n);
+
+		// Factorise the panel (the columns of this block, all rows from here down)
+		for (k = block_start; k < block_end; k++)
+		{
+			int pivot_row = [self pivotRowForColumn:k];
+
+			if (pivot_row == -1)
+			{
+				bm_is_singular = YES;
+				return NO;
+			}
+			[self exchangeRow:k withRow:pivot_row];
+
+			BigCFloat *pivot = BM_ELEMENT(k, k);
+			dispatch_apply(n - k - 1, queue, ^(size_t offset) {
+				int			i = k + 1 + (int)offset;
+				int			j;
+				BigCFloat	*multiplier = BM_ELEMENT(i, k);
+
+				if ([multiplier isZero])
+					return;
+
+				[multiplier divideBy:pivot];
+				for (j = k + 1; j < block_end; j++)
+				{
+					[BM_ELEMENT(i, j) subtractProductOf:multiplier and:BM_ELEMENT(k, j)];
+				}
+			});
+		}
+
+		if (block_end == n)
+			break;
+
+		// Bring the block's rows to the right of the panel up to date (each column
+		// is a forward substitution with the unit lower triangle of the panel)
+		dispatch_apply(n - block_end, queue, ^(size_t offset) {
+			int			j = block_end + (int)offset;
+			int			i, kk;
+
+			for (kk = block_start; kk < block_end; kk++)
+			{
+				for (i = kk + 1; i < block_end; i++)
+				{
+					[BM_ELEMENT(i, j) subtractProductOf:BM_ELEMENT(i, kk) and:BM_ELEMENT(kk, j)];
+				}
+			}
+		});
+
+		// Update the trailing rows from the panel, one row per task. Each element takes
+		// the dot product of its row of the panel with its column of the block's rows.
+		NSMutableArray *block_columns = [NSMutableArray arrayWithCapacity:n - block_end];
+		for (int j = block_end; j < n; j++)
+		{
+			NSMutableArray *block_column = [NSMutableArray arrayWithCapacity:block_end - block_start];
+			for (int kk = block_start; kk < block_end; kk++)
+			{
+				[block_column addObject:BM_ELEMENT(kk, j)];
+			}
+			[block_columns addObject:block_column];
+		}
+
+		dispatch_apply(n - block_end, queue, ^(size_t offset) {
+			int		i = block_end + (int)offset;
+			int		j;
+			NSArray	*panel_row = [self->bm_elements subarrayWithRange:NSMakeRange(i * n + block_start, block_end - block_start)];
+
+			for (j = block_end; j < n; j++)
+			{
+				[BM_ELEMENT(i, j) subtractProductsOf:panel_row and:block_columns[j - block_end]];
+			}
+		});
+	}
+
+	return YES;
+}
+
+//
+// determinant
+//
+// The product of the pivots, negated for an odd number of row exchanges.
+//
+- (BigCFloat *)determinant
+{
+	BigCFloat	*result = [BigCFloat bigFloatWithInt:1 radix:bm_radix];
+	int			i;
+
+	if (![self factorise])
+		return [BigCFloat bigFloatWithInt:0 radix:bm_radix];
+
+	for (i = 0; i < bm_rows; i++)
+	{
+		[result multiplyBy:BM_ELEMENT(i, i)];
+	}
+
+	if (bm_odd_exchanges)
+		[result multiplyBy:[BigCFloat bigFloatWithInt:-1 radix:bm_radix]];
+
+	return result;
+}
+
+//
+// solve
+//
+// Returns X such that (the original) receiver * X = rhs, or nil if the receiver is
+// singular. Each column of rhs is substituted through the factors on its own thread.
+//
+- (BigMatrix *)solve:(BigMatrix *)rhs
+{
+	BigMatrix	*solution;
+	int			n = bm_rows;
+
+	if (rhs->bm_rows != n || ![self factorise])
+		return nil;
+
+	solution = [[BigMatrix alloc] initWithArray:@[] rows:n columns:rhs->bm_columns radix:bm_radix];
+
+	dispatch_apply(rhs->bm_columns, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t column) {
+		NSMutableArray	*xs = [NSMutableArray arrayWithCapacity:n];
+		BigCFloat		*x;
+		int				i;
+
+		// Permute the right hand side to match the row exchanges
+		for (i = 0; i < n; i++)
+		{
+			int source = [self->bm_permutation[i] intValue];
+			x = [solution elementAtRow:i column:(int)column];
+			[x assign:[rhs elementAtRow:source column:(int)column]];
+			[xs addObject:x];
+		}
+
+		// Forward substitution through the unit lower triangle, each step one dot product
+		for (i = 1; i < n; i++)
+		{
+			[xs[i] subtractProductsOf:[self->bm_elements subarrayWithRange:NSMakeRange(i * n, i)]
+								  and:[xs subarrayWithRange:NSMakeRange(0, i)]];
+		}
+
+		// Back substitution through the upper triangle
+		for (i = n - 1; i >= 0; i--)
+		{
+			x = xs[i];
+			[x subtractProductsOf:[self->bm_elements subarrayWithRange:NSMakeRange(i * n + i + 1, n - i - 1)]
+							  and:[xs subarrayWithRange:NSMakeRange(i + 1, n - i - 1)]];
+			[x divideBy:BM_ELEMENT(i, i)];
+		}
+	});
+
+	return solution;
+}
+
+#pragma mark
+#pragma mark ### Mixed Precision Functions ###
+
+//
+// BM_DoubleSolve
+//
+// Solves in place using an LU factorisation held in doubles (unit lower triangle,
+// pivots recorded as the row exchanged with at each step).
+//
+static void
+BM_DoubleSolve(const double *lu, const int *pivots, int n, double *x)
+{
+	int i, k;
+
+	for (i = 0; i < n; i++)
+	{
+		double temp = x[i];
+		x[i] = x[pivots[i]];
+		x[pivots[i]] = temp;
+	}
+	for (i = 1; i < n; i++)
+	{
+		for (k = 0; k < i; k++)
+			x[i] -= lu[i * n + k] * x[k];
+	}
+	for (i = n - 1; i >= 0; i--)
+	{
+		for (k = i + 1; k < n; k++)
+			x[i] -= lu[i * n + k] * x[k];
+		x[i] /= lu[i * n + i];
+	}
+}
+
+//
+// BM_InfinityNorm
+//
+// The largest absolute value in a vector.
+//
+static double
+BM_InfinityNorm(const double *x, int n)
+{
+	double	norm = 0.0;
+	int		i;
+
+	for (i = 0; i < n; i++)
+		norm = MAX(norm, fabs(x[i]));
+
+	return norm;
+}
+
+//
+// factoriseDouble
+//
+// Factorises a double precision copy of the (unfactorised) receiver into lu and
+// pivots. Returns NO if any element is complex or out of range for a double, or if
+// the matrix is too ill-conditioned for refinement to converge.
+//
+- (BOOL)factoriseDouble:(double *)lu pivots:(int *)pivots
+{
+	int		n = bm_rows;
+	double	*column = malloc(sizeof(double) * n);
+	double	matrix_norm = 0.0;
+	double	inverse_norm = 0.0;
+	int		i, j, k;
+
+	for (i = 0; i < n; i++)
+	{
+		double row_sum = 0.0;
+
+		for (j = 0; j < n; j++)
+		{
+			BigCFloat *element = BM_ELEMENT(i, j);
+
+			lu[i * n + j] = [element doubleValue];
+			if ([element hasImaginary] || !isfinite(lu[i * n + j]))
+			{
+				free(column);
+				return NO;
+			}
+			row_sum += fabs(lu[i * n + j]);
+		}
+		matrix_norm = MAX(matrix_norm, row_sum);
+	}
+
+	for (k = 0; k < n; k++)
+	{
+		int pivot_row = k;
+
+		for (i = k + 1; i < n; i++)
+		{
+			if (fabs(lu[i * n + k]) > fabs(lu[pivot_row * n + k]))
+				pivot_row = i;
+		}
+		if (lu[pivot_row * n + k] == 0.0)
+		{
+			free(column);
+			return NO;
+		}
+
+		pivots[k] = pivot_row;
+		for (j = 0; j < n; j++)
+		{
+			double temp = lu[k * n + j];
+			lu[k * n + j] = lu[pivot_row * n + j];
+			lu[pivot_row * n + j] = temp;
+		}
+
+		for (i = k + 1; i < n; i++)
+		{
+			lu[i * n + k] /= lu[k * n + k];
+			for (j = k + 1; j < n; j++)
+				lu[i * n + j] -= lu[i * n + k] * lu[k * n + j];
+		}
+	}
+
+	// Estimate the condition number from the column sums of the inverse
+	for (j = 0; j < n; j++)
+	{
+		for (i = 0; i < n; i++)
+			column[i] = (i == j) ? 1.0 : 0.0;
+		BM_DoubleSolve(lu, pivots, n, column);
+		inverse_norm = MAX(inverse_norm, BM_InfinityNorm(column, n));
+	}
+	free(column);
+
+	return isfinite(inverse_norm) && matrix_norm * inverse_norm * n < BM_refinement_condition_limit;
+}
+
+//
+// refineColumn
+//
+// Solves for one column of rhs: an initial double precision solution, then repeated
+// corrections from residuals computed in BigCFloats. Returns NO if the corrections
+// stop shrinking before reaching the working precision.
+//
+- (BOOL)refineColumn:(int)column of:(BigMatrix *)rhs into:(BigMatrix *)solution lu:(const double *)lu pivots:(const int *)pivots
+{
+	int			n = bm_rows;
+	double		*correction = malloc(sizeof(double) * n);
+	double		*estimate = malloc(sizeof(double) * n);
+	double		previous_norm = HUGE_VAL;
+	double		working_epsilon = pow(bm_radix, -(double)(BF_num_values * (int)(log(0xFFFF + 1) / log(bm_radix))));
+	BigCFloat	*residual = [BigCFloat bigFloatWithInt:0 radix:bm_radix];
+	BigCFloat	*product = [BigCFloat bigFloatWithInt:0 radix:bm_radix];
+	NSMutableArray	*xs = [NSMutableArray arrayWithCapacity:n];
+	BigCFloat	*x;
+	BOOL		converged = NO;
+	int			i, iteration;
+
+	for (i = 0; i < n; i++)
+	{
+		BigCFloat *b = [rhs elementAtRow:i column:column];
+
+		correction[i] = [b doubleValue];
+		if ([b hasImaginary] || !isfinite(correction[i]))
+		{
+			free(correction);
+			free(estimate);
+			return NO;
+		}
+	}
+	BM_DoubleSolve(lu, pivots, n, correction);
+	for (i = 0; i < n; i++)
+	{
+		x = [solution elementAtRow:i column:column];
+		[x assign:[BigCFloat bigFloatWithDouble:correction[i] radix:bm_radix]];
+		[xs addObject:x];
+		estimate[i] = correction[i];
+	}
+
+	for (iteration = 0; iteration < BM_refinement_max_iterations && !converged; iteration++)
+	{
+		BOOL	changed = NO;
+		double	correction_norm;
+
+		// The residual b - Ax at full precision (each row one fused dot product, so it is
+		// rounded once), then rounded to double for the correction
+		for (i = 0; i < n; i++)
+		{
+			[residual assign:[rhs elementAtRow:i column:column]];
+			[residual subtractProductsOf:[bm_elements subarrayWithRange:NSMakeRange(i * n, n)] and:xs];
+			correction[i] = [residual doubleValue];
+		}
+		BM_DoubleSolve(lu, pivots, n, correction);
+
+		correction_norm = BM_InfinityNorm(correction, n);
+		if (correction_norm <= working_epsilon * BM_InfinityNorm(estimate, n))
+		{
+			converged = YES;
+			break;
+		}
+		if (!isfinite(correction_norm) || correction_norm > previous_norm * 0.5)
+			break;
+		previous_norm = correction_norm;
+
+		for (i = 0; i < n; i++)
+		{
+			if (correction[i] == 0.0)
+				continue;
+
+			x = [solution elementAtRow:i column:column];
+			[product assign:x];
+			[x add:[BigCFloat bigFloatWithDouble:correction[i] radix:bm_radix]];
+			changed = changed || [x compareWith:product] != NSOrderedSame;
+			estimate[i] = [x doubleValue];
+		}
+
+		// Corrections too small to change the solution mean we are at working precision
+		converged = !changed;
+	}
+
+	free(correction);
+	free(estimate);
+	return converged;
+}
+
+//
+// refinedSolve
+//
+// Solves like solve: but factorises in double precision and refines the solution
+// with full precision residuals. Complex, out of range or ill-conditioned systems,
+// and any column that fails to converge, fall back to solve:.
+//
+- (BigMatrix *)refinedSolve:(BigMatrix *)rhs
+{
+	BigMatrix		*solution;
+	double			*lu;
+	int				*pivots;
+	int				n = bm_rows;
+	__block BOOL	converged = YES;
+
+	NSAssert(bm_rows == bm_columns, @"Only square systems can be solved");
+
+	if (bm_is_factorised || rhs->bm_rows != n)
+		return [self solve:rhs];
+
+	lu = malloc(sizeof(double) * n * n);
+	pivots = malloc(sizeof(int) * n);
+	if (![self factoriseDouble:lu pivots:pivots])
+	{
+		free(lu);
+		free(pivots);
+		return [self solve:rhs];
+	}
+
+	solution = [[BigMatrix alloc] initWithArray:@[] rows:n columns:rhs->bm_columns radix:bm_radix];
+	dispatch_apply(rhs->bm_columns, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t column) {
+		if (![self refineColumn:(int)column of:rhs into:solution lu:lu pivots:pivots])
+			converged = NO;
+	});
+	free(lu);
+	free(pivots);
+
+	if (!converged)
+		return [self solve:rhs];
+
+	return solution;
+}
+
+//
+// inverse
+//
+// The inverse of the (original) receiver, or nil if it is singular.
+//
+- (BigMatrix *)inverse
+{
+	return [self refinedSolve:[[BigMatrix alloc] initIdentityWithSize:bm_rows radix:bm_radix]];
+}
+
+#pragma mark
+#pragma mark ### Matrix Arithmetic Functions ###
+
+//
+// multiplyBy
+//
+// Returns receiver * other, or nil if the receiver's columns do not match other's rows.
+// Each element is a single fused dot product (rounded once). The result is divided into
+// tiles which are computed on their own threads; the columns of other are gathered once
+// up front so that every dot product walks two contiguous arrays.
+//
+- (BigMatrix *)multiplyBy:(BigMatrix *)other
+{
+	BigMatrix		*product;
+	NSMutableArray	*other_columns;
+	int				tile_rows, tile_columns;
+	int				i, j;
+
+	NSAssert(!bm_is_factorised && !other->bm_is_factorised, @"Factorised matrices hold their factors, not their elements");
+
+	if (bm_columns != other->bm_rows)
+		return nil;
+
+	product = [[BigMatrix alloc] initWithArray:@[] rows:bm_rows columns:other->bm_columns radix:bm_radix];
+
+	other_columns = [NSMutableArray arrayWithCapacity:other->bm_columns];
+	for (j = 0; j < other->bm_columns; j++)
+	{
+		NSMutableArray *column = [NSMutableArray arrayWithCapacity:other->bm_rows];
+		for (i = 0; i < other->bm_rows; i++)
+		{
+			[column addObject:[other elementAtRow:i column:j]];
+		}
+		[other_columns addObject:column];
+	}
+
+	tile_rows = (bm_rows + BM_product_tile - 1) / BM_product_tile;
+	tile_columns = (other->bm_columns + BM_product_tile - 1) / BM_product_tile;
+
+	dispatch_apply(tile_rows * tile_columns, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t tile) {
+		int	row_start = (int)(tile / tile_columns) * BM_product_tile;
+		int	column_start = (int)(tile % tile_columns) * BM_product_tile;
+		int	row_end = MIN(row_start + BM_product_tile, self->bm_rows);
+		int	column_end = MIN(column_start + BM_product_tile, other->bm_columns);
+		int	row, column;
+
+		for (row = row_start; row < row_end; row++)
+		{
+			NSArray *receiver_row = [self->bm_elements subarrayWithRange:NSMakeRange(row * self->bm_columns, self->bm_columns)];
+
+			for (column = column_start; column < column_end; column++)
+			{
+				[[product elementAtRow:row column:column] addProductsOf:receiver_row and:other_columns[column]];
+			}
+		}
+	});
+
+	return product;
+}
+
+//
+// power
+//
+// Returns the receiver raised to an integer power by repeated squaring, or nil if the
+// receiver is not square or the exponent is negative and the receiver is singular. A
+// negative exponent inverts the receiver first, which factorises it.
+//
+- (BigMatrix *)power:(int)exponent
+{
+	BigMatrix	*result = nil;
+	BigMatrix	*square;
+	unsigned	remaining;
+
+	if (bm_rows != bm_columns)
+		return nil;
+
+	square = (exponent < 0) ? [self inverse] : self;
+	if (square == nil)
+		return nil;
+
+	remaining = (exponent < 0) ? -(unsigned)exponent : (unsigned)exponent;
+	if (remaining == 0)
+		return [[BigMatrix alloc] initIdentityWithSize:bm_rows radix:bm_radix];
+
+	while (YES)
+	{
+		if (remaining & 1)
+			result = (result == nil) ? square : [result multiplyBy:square];
+
+		remaining >>= 1;
+		if (remaining == 0)
+			break;
+
+		square = [square multiplyBy:square];
+	}
+
+	// Never hand back the receiver itself
+	if (result == self)
+		result = [[BigMatrix alloc] initWithArray:bm_elements rows:bm_rows columns:bm_columns radix:bm_radix];
+
+	return result;
+}
+
+//
+// transpose
+//
+// Returns a new matrix with the receiver's rows as its columns.
+//
+- (BigMatrix *)transpose
+{
+	BigMatrix	*result = [[BigMatrix alloc] initWithArray:@[] rows:bm_columns columns:bm_rows radix:bm_radix];
+	int			i, j;
+
+	NSAssert(!bm_is_factorised, @"Factorised matrices hold their factors, not their elements");
+
+	for (i = 0; i < bm_rows; i++)
+	{
+		for (j = 0; j < bm_columns; j++)
+		{
+			[[result elementAtRow:j column:i] assign:BM_ELEMENT(i, j)];
+		}
+	}
+
+	return result;
+}
+
+@end
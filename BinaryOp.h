@@ -31,14 +31,20 @@
 	BOOL				userSkippedLeft;
 	Expression		*leftChild;
 	NSRect			leftChildNaturalBounds;
-	NSRect			leftChildDisplayBounds;
+	NSAffineTransform	*leftChildPlacement;
+	__weak Expression	*composedLeftChild;
+	NSInteger			composedRoot;
 }
 - (instancetype)initWithParent:(Expression*)newParent manager:(DataManager*)newManager
 	leftChild:(Expression*)newChild andOp:(int)newOp;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
+- (void)appendEncodingTo:(NSMutableData *)data;
+- (void)appendEncodedChildrenTo:(NSMutableData *)data;
+- (void)decodeChildrenWithEncoding:(BFDecoder *)decoder;
 - (void)appendDigit:(int)digit;
-- (void)appendOpToPath:(NSBezierPath*)path atLevel:(int)level;
+- (void)appendOpToPath:(NSBezierPath*)path after:(NSRect)boundsRect atLevel:(int)level;
 - (void)binaryOpPressed:(int)newOp;
 - (void)bracketPressed;
 - (void)childChanged:(Expression*)oldChild replacedWith:(Expression*)newChild;
@@ -51,13 +57,18 @@
 @property (NS_NONATOMIC_IOSONLY, getter=getCaretPoint, readonly) NSPoint caretPoint;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
 @property (NS_NONATOMIC_IOSONLY, getter=getValue, readonly, strong) BigCFloat *value;
+- (BigInteger*)calculateExactValue;
+- (unsigned int)digitsOfValueUsingSeries:(BOOL)usesSeries;
 @property (NS_NONATOMIC_IOSONLY, readonly, strong) Expression *leftChild;
 - (void)managerChanged:(DataManager*)newManager;
 - (Expression*)nodeContainingPoint:(NSPoint)point;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (void)composePathAtLevel:(int)level;
+- (void)appendPathTo:(NSBezierPath*)path withTransform:(NSAffineTransform*)transform;
+- (void)draw;
 - (void)postOpPressed:(int)op;
 - (void)preOpPressed:(int)op;
-- (void)receiveBounds:(NSRect)bounds;
+- (BOOL)updateChildLayout;
+- (NSRect)displayBoundsOfChild:(Expression*)node;
 - (void)refresh;
 - (void)replaceChild:(Expression*)oldChild withBinOp:(int)newOp;
 - (void)replaceChild:(Expression*)node withPostOp:(int)newOp;
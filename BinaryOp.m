@@ -9,6 +9,7 @@
 #import "BinaryOp.h"
 #import "ExpressionSymbols.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "DataManager.h"
 #import "Value.h"
 #import "Bracket.h"
@@ -94,6 +95,58 @@
 	[coder encodeBool:userSkippedLeft forKey:@"MEUserSkippedLeft"];
 }
 
+//
+// initWithEncoding
+//
+// Reads the operation from the compact encoding.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		op = (int)BF_DecodeSigned(decoder);
+		userSkippedLeft = BF_DecodeByte(decoder) != 0;
+		leftChild = nil;
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Writes the operation in the compact encoding.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	[super appendEncodingTo:data];
+	
+	BF_EncodeSigned(data, op);
+	BF_EncodeByte(data, userSkippedLeft ? 1 : 0);
+}
+
+//
+// appendEncodedChildrenTo
+//
+// The left child goes before the right.
+//
+- (void)appendEncodedChildrenTo:(NSMutableData *)data
+{
+	[Expression appendEncodingOf:leftChild to:data];
+	[super appendEncodedChildrenTo:data];
+}
+
+//
+// decodeChildrenWithEncoding
+//
+// Reads the left child, then the right.
+//
+- (void)decodeChildrenWithEncoding:(BFDecoder *)decoder
+{
+	leftChild = [Expression expressionWithEncoding:decoder parent:self];
+	[super decodeChildrenWithEncoding:decoder];
+}
+
 //
 // Destructor
 //
@@ -124,18 +177,15 @@
 //
 // appendOpToPath
 //
-// Draws this operation. This method should only be called internally from pathAtLevel.
+// Draws this operation after boundsRect (the bounds of whatever has been laid out to
+// its left). This method should only be called internally from composePathAtLevel.
 //
-- (void)appendOpToPath:(NSBezierPath*)path atLevel:(int)level
+- (void)appendOpToPath:(NSBezierPath*)path after:(NSRect)boundsRect atLevel:(int)level
 {
 	NSBezierPath		*opPath;
 	NSAffineTransform	*transform = [NSAffineTransform transform];
-	NSRect				boundsRect;
 	double				scale = [Expression scaleWithLevel:level];
 	
-	if (![path isEmpty]) boundsRect = [path bounds];
-	else boundsRect = NSZeroRect;
-	
 	switch (op)
     {
         case '-':
@@ -156,6 +206,12 @@
         case 'c':
             opPath = [ExpressionSymbols ncrPath];
             break;
+        case gcdOp:
+            opPath = [ExpressionSymbols gcdPath];
+            break;
+        case lcmOp:
+            opPath = [ExpressionSymbols lcmPath];
+            break;
         case 'a':
             opPath = [ExpressionSymbols andPath];
             break;
@@ -191,8 +247,9 @@
 
 	if (level >= 2) [transform scaleBy:scale];
 	
-	[opPath transformUsingAffineTransform:transform];
-	[path appendBezierPath:opPath];
+	// The symbol paths are shared so they are transformed into a new path
+	if (opPath != nil)
+		[path appendBezierPath:[transform transformBezierPath:opPath]];
 }
 
 //
@@ -428,6 +485,8 @@
 {
 	NSPoint caretPoint;
 	
+	[self updateDisplayBounds];
+	
 	if (leftChild == nil && !userSkippedLeft)
 	{
 		caretPoint = displayBounds.origin;
@@ -489,6 +548,12 @@
 		case 'c':
 			resultString = [resultString stringByAppendingString:@" ncr "];
 			break;
+		case gcdOp:
+			resultString = [resultString stringByAppendingString:@" gcd "];
+			break;
+		case lcmOp:
+			resultString = [resultString stringByAppendingString:@" lcm "];
+			break;
 		case 'a':
 			resultString = [resultString stringByAppendingString:@" & "];
 			break;
@@ -531,15 +596,31 @@
 // getValue
 //
 // Depending on the operation associated with this node, calculates the resultant value
-// from the combination of the left and right child nodes.
+// from the combination of the left and right child nodes. If the result is an exact
+// integer (see calculateExactValue) it is used instead, so integer results aren't
+// rounded to the BigFloat precision on the way. The value is kept until something
+// below changes or a more precise one is needed (see isValueCurrent).
 //
 - (BigCFloat*)getValue
 {
 	BigCFloat *leftChildValue;
 	BigCFloat *rightChildValue;
+	BigInteger *exact;
 	
-	if (valueValid == NO)
+	if (![self isValueCurrent])
 	{
+		EXProfile profile = [self beginProfile];
+		
+		exact = [self getExactValue];
+		if (exact != nil)
+		{
+			value = [BigCFloat bigFloatWithBigInteger:exact radix:[manager getRadix]];
+			valueValid = YES;
+			valueDigits = 0;
+			[self endProfile:profile];
+			return value;
+		}
+		
 		if (child != nil) rightChildValue = [child getValue];
 		else rightChildValue = [BigCFloat zero];
 		
@@ -572,6 +653,12 @@
 			case 'c':
 				[value nCr:rightChildValue];
 				break;
+			case gcdOp:
+				value = [BigCFloat bigFloatWithBigInteger:[[leftChildValue bigIntegerValue] gcdWith:[rightChildValue bigIntegerValue]] radix:[manager getRadix]];
+				break;
+			case lcmOp:
+				value = [BigCFloat bigFloatWithBigInteger:[[leftChildValue bigIntegerValue] lcmWith:[rightChildValue bigIntegerValue]] radix:[manager getRadix]];
+				break;
 			case '^':
 				[value raiseToPower:rightChildValue];
 				break;
@@ -601,11 +688,102 @@
 			default:
 				break;
 		}
-	
+		valueValid = YES;
+		
+		// Powers, roots and complex permutations and combinations only converge to the
+		// working precision
+		valueDigits = [self digitsOfValueUsingSeries:
+			(op == '^' || op == rootOp ||
+			 ((op == 'p' || op == 'c') && ([leftChildValue hasImaginary] || [rightChildValue hasImaginary])))];
+		
+		[self endProfile:profile];
 	}
 	return value;
 }
 
+//
+// digitsOfValueUsingSeries
+//
+// As inherited but the left child's precision counts as well.
+//
+- (unsigned int)digitsOfValueUsingSeries:(BOOL)usesSeries
+{
+	unsigned int digits = [super digitsOfValueUsingSeries:usesSeries];
+	unsigned int leftDigits = (leftChild != nil) ? [leftChild getValueDigits] : 0;
+	
+	if (leftDigits != 0 && (digits == 0 || leftDigits < digits))
+		digits = leftDigits;
+	
+	return digits;
+}
+
+//
+// calculateExactValue
+//
+// The exact result if both children are integers and so is the result of the operation
+// on them (nil otherwise). A power taken modulo something, (a^b) % m, is worked out as
+// a modular power without ever making a^b, so it is exact however big a^b would be.
+//
+- (BigInteger*)calculateExactValue
+{
+	BigInteger	*left, *right, *quotient, *remainder = nil, *power;
+	Expression	*node = leftChild;
+	
+	if (child != nil) right = [child getExactValue];
+	else right = [BigInteger zero];
+	
+	if (op == '%')
+	{
+		while ([node class] == [Bracket class])
+			node = [node child];
+		
+		if ([node class] == [BinaryOp class] && ((BinaryOp*)node)->op == '^')
+		{
+			BinaryOp *powerNode = (BinaryOp*)node;
+			BigInteger *base = (powerNode->leftChild != nil) ? [powerNode->leftChild getExactValue] : [BigInteger zero];
+			BigInteger *exponent = (powerNode->child != nil) ? [powerNode->child getExactValue] : [BigInteger zero];
+			
+			power = [base raiseToPower:exponent modulo:right];
+			if (power != nil)
+				return power;
+		}
+	}
+	
+	if (leftChild != nil) left = [leftChild getExactValue];
+	else left = [BigInteger zero];
+	
+	if (left == nil || right == nil)
+		return nil;
+	
+	switch (op)
+	{
+		case '-':
+			return [left subtract:right];
+		case '+':
+			return [left add:right];
+		case '*':
+		case '.':
+			return [left multiplyBy:right];
+		case '/':
+			quotient = [left divideBy:right remainder:&remainder];
+			return [remainder isZero] ? quotient : nil;
+		case '%':
+			return [left moduloBy:right];
+		case 'p':
+			return [left nPr:right];
+		case 'c':
+			return [left nCr:right];
+		case gcdOp:
+			return [left gcdWith:right];
+		case lcmOp:
+			return [left lcmWith:right];
+		case '^':
+			return [left raiseToPower:right];
+		default:
+			return nil;
+	}
+}
+
 //
 // leftChild
 //
@@ -643,6 +821,7 @@
 //
 - (Expression*)nodeContainingPoint:(NSPoint)point
 {
+	[self updateDisplayBounds];
 	NSAssert(isBoundsValid == YES, @"Point in bounds requested before bounds received.\n");
 	
 	if (NSMouseInRect(point, displayBounds, NO))
@@ -671,209 +850,236 @@
 }
 
 //
-// pathAtLevel
+// rootIndex
 //
-// Draws the bezier path for this node. The child nodes are drawn through their own
-// methods. The operators are drawn by appendOpToPath. Most of this method is about
-// handling the different layout caused by the division operator and exponents.
+// The index drawn in front of a root sign (2 when there is no left child).
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (NSInteger)rootIndex
 {
-	NSBezierPath		*copy;
-	double			scale = [Expression scaleWithLevel:level];
+	if (leftChild == nil)
+		return 2;
 	
-	if (pathValidAt != level)
-	{
-		NSBezierPath *rightChildPath = [NSBezierPath bezierPath];
-		NSBezierPath *leftChildPath = [NSBezierPath bezierPath];
+	return leftChild.value.realPart.doubleValue;
+}
 
-		expressionPath = [NSBezierPath bezierPath];
+//
+// composePathAtLevel
+//
+// Lays out this node. The child nodes are laid out through their own methods and
+// placed by transform. The operators are drawn by appendOpToPath. Most of this method
+// is about handling the different layout caused by the division operator and exponents.
+//
+- (void)composePathAtLevel:(int)level
+{
+	double			scale = [Expression scaleWithLevel:level];
+	NSRect			ownBounds;
 
-		if (op == '/')
+	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = [NSAffineTransform transform];
+	leftChildPlacement = [NSAffineTransform transform];
+	composedLeftChild = leftChild;
+	childNaturalBounds = NSZeroRect;
+	leftChildNaturalBounds = NSZeroRect;
+
+	if (op == '/')
+	{
+		NSRect	numeratorBounds = NSZeroRect;
+		NSRect	denominatorBounds = NSZeroRect;
+		NSRect	combinedBounds = NSZeroRect;
+		NSRect	lineBounds = NSZeroRect;
+		
+		if (leftChild != nil)
 		{
-			NSRect	numeratorBounds = NSZeroRect;
-			NSRect	denominatorBounds = NSZeroRect;
-			NSRect	combinedBounds = NSZeroRect;
-			NSRect	lineBounds = NSZeroRect;
-			NSAffineTransform *transform;
+			numeratorBounds = [leftChild naturalBoundsAtLevel:level + 1];
+			[leftChildPlacement translateXBy:3 * scale yBy:scale * 11 - numeratorBounds.origin.y];
+		}
+		if (child != nil)
+		{
+			denominatorBounds = [child naturalBoundsAtLevel:level + 1];
+			
+			[childPlacement translateXBy:3 * scale yBy:(scale * 5) - (denominatorBounds.size.height + denominatorBounds.origin.y)];
 			
 			if (leftChild != nil)
 			{
-				leftChildPath = [leftChild pathAtLevel:level + 1];
-				numeratorBounds = [leftChildPath bounds];
-				transform = [NSAffineTransform transform];
-				[transform translateXBy:3 * scale yBy:scale * 11 - numeratorBounds.origin.y];
-				[leftChildPath transformUsingAffineTransform:transform];
-			}
-			if (child != nil)
-			{
-				rightChildPath = [child pathAtLevel:level + 1];
-				denominatorBounds = [rightChildPath bounds];
-				
-				transform = [NSAffineTransform transform];
-				[transform translateXBy:3 * scale yBy:(scale * 5) - (denominatorBounds.size.height + denominatorBounds.origin.y)];
-				
-				if (leftChild != nil)
+				if (denominatorBounds.size.width < numeratorBounds.size.width)
 				{
-					if (denominatorBounds.size.width < numeratorBounds.size.width)
-					{
-						[transform
-							translateXBy:
-								(numeratorBounds.size.width - denominatorBounds.size.width) / 2.0
-								+
-								numeratorBounds.origin.x - denominatorBounds.origin.x
-							yBy:0
-						];
-					}
-					else
-					{
-						NSAffineTransform	*numeratorTransform = [NSAffineTransform transform];
-						
-						[numeratorTransform
-							translateXBy:
-								(denominatorBounds.size.width - numeratorBounds.size.width) / 2.0
-								+
-								denominatorBounds.origin.x - numeratorBounds.origin.x
-							yBy:0
-						];
-						[leftChildPath transformUsingAffineTransform:numeratorTransform];
-					}
+					[childPlacement
+						translateXBy:
+							(numeratorBounds.size.width - denominatorBounds.size.width) / 2.0
+							+
+							numeratorBounds.origin.x - denominatorBounds.origin.x
+						yBy:0
+					];
+				}
+				else
+				{
+					NSAffineTransform	*numeratorTransform = [NSAffineTransform transform];
+					
+					[numeratorTransform
+						translateXBy:
+							(denominatorBounds.size.width - numeratorBounds.size.width) / 2.0
+							+
+							denominatorBounds.origin.x - numeratorBounds.origin.x
+						yBy:0
+					];
+					[leftChildPlacement appendTransform:numeratorTransform];
 				}
-				[rightChildPath transformUsingAffineTransform:transform];
 			}
+		}
+		
+		leftChildNaturalBounds = [Expression rect:numeratorBounds transformedBy:leftChildPlacement];
+		childNaturalBounds = [Expression rect:denominatorBounds transformedBy:childPlacement];
+		combinedBounds = NSUnionRect(leftChildNaturalBounds, childNaturalBounds);
+		
+		if (NSIsEmptyRect(combinedBounds))
+		{
+			combinedBounds = NSMakeRect(0.0, 0.0, 16.0, 0.0);
+		}
+		
+		lineBounds = NSMakeRect	(combinedBounds.origin.x - (scale * 3.0), (scale * 7.25), combinedBounds.size.width + (scale * 6.0), (scale * 1.5));
+		[expressionPath appendBezierPath:[NSBezierPath bezierPathWithRect:lineBounds]];
+	}
+	else if (op == '^')
+	{
+		if (leftChild != nil)
+		{
+			leftChildNaturalBounds = [leftChild naturalBoundsAtLevel:level];
+		}
+	
+		[self appendOpToPath:expressionPath after:leftChildNaturalBounds atLevel:level];
+		
+		if (child != nil)
+		{
+			NSRect				boundsRect = NSUnionRect(leftChildNaturalBounds, [Expression boundsOfPath:expressionPath]);
+			NSRect				childBounds;
+		
+			if (level == 0)
+				childBounds = [child naturalBoundsAtLevel:level + 2];
+			else
+				childBounds = [child naturalBoundsAtLevel:level + 1];
+			[childPlacement translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:scale * 11];
+			childNaturalBounds = [Expression rect:childBounds transformedBy:childPlacement];
+		}
+	}
+	else if (op == rootOp)
+	{
+		NSInteger root = [self rootIndex];
+		NSBezierPath *rootBase = [NSBezierPath bezierPath];
+		
+		// The root is drawn as a small digit, not as the left child's path, so the
+		// path is recomposed whenever the index changes (see updateChildLayout)
+		leftChildPlacement = nil;
+		composedRoot = root;
+		
+		if (root != 2) rootBase = [ExpressionSymbols nRootPath:root];
+		[expressionPath appendBezierPath:[ExpressionSymbols sqrtPath]];
+		[self appendOpToPath:expressionPath after:[expressionPath bounds] atLevel:level];
+		
+		if (child != nil) {
+			NSAffineTransform *transform = [NSAffineTransform transform];
+			NSBezierPath *overLine  = [NSBezierPath bezierPath];
+			NSRect       boundsRect = [expressionPath bounds];
+			NSRect       childBounds = [child naturalBoundsAtLevel:level];
 			
-			if (![leftChildPath isEmpty])
-				[expressionPath appendBezierPath:leftChildPath];
-			if (![rightChildPath isEmpty])
-				[expressionPath appendBezierPath:rightChildPath];
+			[childPlacement translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
+			childNaturalBounds = [Expression rect:childBounds transformedBy:childPlacement];
 			
-			if (![expressionPath isEmpty])
-			{
-				combinedBounds = [expressionPath bounds];
-			}
-			else
-			{
-				combinedBounds = NSMakeRect(0.0, 0.0, 16.0, 0.0);
-			}
+			[transform translateXBy:0.0 yBy:childBounds.origin.y - 0.8 * boundsRect.origin.y];
+			[transform scaleXBy:1.0 yBy:(childBounds.size.height / boundsRect.size.height) * 1.25];
+			[expressionPath transformUsingAffineTransform:transform];
+			boundsRect = [expressionPath bounds];
 			
-			lineBounds = NSMakeRect	(combinedBounds.origin.x - (scale * 3.0), (scale * 7.25), combinedBounds.size.width + (scale * 6.0), (scale * 1.5));
-			[expressionPath appendBezierPath:[NSBezierPath bezierPathWithRect:lineBounds]];
+			[overLine moveToPoint:
+				NSMakePoint
+				(boundsRect.origin.x + boundsRect.size.width,
+				 boundsRect.origin.y + boundsRect.size.height)
+			];
+			[overLine relativeLineToPoint: NSMakePoint(childBounds.size.width + 5.0, 0) ];
+			[overLine relativeLineToPoint:NSMakePoint(-0.5, -1.5)];
+			[overLine relativeLineToPoint: NSMakePoint(-(childBounds.size.width + 5.0), 0)];
+			[overLine closePath];
+			[expressionPath appendBezierPath:overLine];
 		}
-		else if (op == '^')
+		[expressionPath appendBezierPath:rootBase];
+	}
+	else
+	{
+		if (leftChild != nil)
 		{
-			if (leftChild != nil)
-			{
-				leftChildPath = [leftChild pathAtLevel:level];
-				[expressionPath appendBezierPath:leftChildPath];
-			}
+			leftChildNaturalBounds = [leftChild naturalBoundsAtLevel:level];
+		}
+	
+		[self appendOpToPath:expressionPath after:leftChildNaturalBounds atLevel:level];
 		
-			[self appendOpToPath:expressionPath atLevel:level];
-			
-			if (child != nil)
-			{
-				NSAffineTransform *transform = [NSAffineTransform transform];
-				NSRect				boundsRect = [expressionPath bounds];
+		if (child != nil)
+		{
+			NSRect				boundsRect = NSUnionRect(leftChildNaturalBounds, [Expression boundsOfPath:expressionPath]);
+			NSRect				childBounds;
+			double				spacing;
 			
-				if (level == 0)
-					rightChildPath = [child pathAtLevel:level + 2];
-				else
-					rightChildPath = [child pathAtLevel:level + 1];
-				[transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:scale * 11];
-				[rightChildPath transformUsingAffineTransform:transform];
-				
-				[expressionPath appendBezierPath:rightChildPath];
-			}
-        }
-        else if (op == rootOp)
-        {
-            NSInteger root = 2;
-            NSBezierPath *rootBase = [NSBezierPath bezierPath];
-            
-            if (leftChild != nil) {
-                root = leftChild.value.realPart.doubleValue;
-            }
-            if (root != 2) rootBase = [ExpressionSymbols nRootPath:root];
-            [expressionPath appendBezierPath:[ExpressionSymbols sqrtPath]];
-            [self appendOpToPath:expressionPath atLevel:level];
-            
-            if (child != nil) {
-                NSAffineTransform *transform = [NSAffineTransform transform];
-                NSBezierPath *overLine  = [NSBezierPath bezierPath];
-                NSRect       boundsRect = [expressionPath bounds];
-           
-                rightChildPath = [child pathAtLevel:level];
-                NSRect childBounds = [rightChildPath bounds];
-                
-                [transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
-                [rightChildPath transformUsingAffineTransform:transform];
-                
-                transform = [NSAffineTransform transform];
-                [transform translateXBy:0.0 yBy:childBounds.origin.y - 0.8 * boundsRect.origin.y];
-                [transform scaleXBy:1.0 yBy:(childBounds.size.height / boundsRect.size.height) * 1.25];
-                [expressionPath transformUsingAffineTransform:transform];
-                boundsRect = [expressionPath bounds];
-                
-                [overLine moveToPoint:
-                    NSMakePoint
-                    (boundsRect.origin.x + boundsRect.size.width,
-                     boundsRect.origin.y + boundsRect.size.height)
-                ];
-                [overLine relativeLineToPoint: NSMakePoint(childBounds.size.width + 5.0, 0) ];
-                [overLine relativeLineToPoint:NSMakePoint(-0.5, -1.5)];
-                [overLine relativeLineToPoint: NSMakePoint(-(childBounds.size.width + 5.0), 0)];
-                [overLine closePath];
-                [expressionPath appendBezierPath:overLine];
-                [expressionPath appendBezierPath:rightChildPath];
-            }
-            [expressionPath appendBezierPath:rootBase];
-        }
-        else
-        {
-			if (leftChild != nil)
-			{
-				leftChildPath = [leftChild pathAtLevel:level];
-				[expressionPath appendBezierPath:leftChildPath];
-			}
-		
-			[self appendOpToPath:expressionPath atLevel:level];
+			spacing = (op == '.' || leftChild == nil) ? (scale * 4.0) : (scale * 6.0);	 // less space is more - Mike
+//			spacing = (op == '.' || leftChild == nil) ? (scale * 4.0) : (scale * 12.0);
 			
-			if (child != nil)
-			{
-				NSAffineTransform *transform = [NSAffineTransform transform];
-				NSRect				boundsRect = [expressionPath bounds];
-				double				spacing;
-				
-				spacing = (op == '.' || leftChild == nil) ? (scale * 4.0) : (scale * 6.0);	 // less space is more - Mike
-//				spacing = (op == '.' || leftChild == nil) ? (scale * 4.0) : (scale * 12.0);
-				
-				rightChildPath = [child pathAtLevel:level];
-			
-				[transform translateXBy:boundsRect.origin.x + boundsRect.size.width + spacing yBy:0];
-				[rightChildPath transformUsingAffineTransform:transform];
-				
-				[expressionPath appendBezierPath:rightChildPath];
-			}
+			childBounds = [child naturalBoundsAtLevel:level];
+			[childPlacement translateXBy:boundsRect.origin.x + boundsRect.size.width + spacing yBy:0];
+			childNaturalBounds = [Expression rect:childBounds transformedBy:childPlacement];
 		}
-		
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSZeroRect;
-		if (![rightChildPath isEmpty])
-			childNaturalBounds = [rightChildPath bounds];
-		else
-			childNaturalBounds = NSZeroRect;
-		if (![leftChildPath isEmpty])
-			leftChildNaturalBounds = [leftChildPath bounds];
-		else
-			leftChildNaturalBounds = NSZeroRect;
-		pathValidAt = level;
 	}
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
+	ownBounds = [Expression boundsOfPath:expressionPath];
+	naturalBounds = NSUnionRect(NSUnionRect(ownBounds, leftChildNaturalBounds), childNaturalBounds);
+}
+
+//
+// updateChildLayout
+//
+// Performs the inherited behaviour for the left child as well. Both children are always
+// laid out so that neither is left dirty. A root's index is part of this node's own path,
+// so a new index value needs recomposing even when the left child keeps its size.
+//
+- (BOOL)updateChildLayout
+{
+	BOOL	leftChanged = [self updateLayoutOfNode:leftChild composedAs:composedLeftChild];
+	BOOL	rightChanged = [super updateChildLayout];
+	BOOL	rootChanged = (op == rootOp && [self rootIndex] != composedRoot);
 	
-	return copy;
+	return leftChanged || rightChanged || rootChanged;
+}
+
+//
+// appendPathTo
+//
+// Performs the inherited behaviour plus appends the left child as well.
+//
+- (void)appendPathTo:(NSBezierPath*)path withTransform:(NSAffineTransform*)transform
+{
+	[super appendPathTo:path withTransform:transform];
+	
+	if (leftChild != nil && leftChildPlacement != nil)
+	{
+		NSAffineTransform *leftChildTransform = [leftChildPlacement copy];
+		
+		[leftChildTransform appendTransform:transform];
+		[leftChild appendPathTo:path withTransform:leftChildTransform];
+	}
+}
+
+//
+// draw
+//
+// Performs the inherited behaviour plus draws the left child as well.
+//
+- (void)draw
+{
+	[super draw];
+	
+	if (leftChild != nil && leftChildPlacement != nil)
+	{
+		[NSGraphicsContext saveGraphicsState];
+		[leftChildPlacement concat];
+		[leftChild draw];
+		[NSGraphicsContext restoreGraphicsState];
+	}
 }
 
 //
@@ -907,44 +1113,31 @@
 }
 
 //
-// receiveBounds
+// profileChildren
 //
-// Performs the inherited behaviour plus sends the message to the left child as well.
+// Both children contribute to a binary operation's value.
 //
-- (void)receiveBounds:(NSRect)bounds
+- (NSArray *)profileChildren
 {
-	NSBezierPath		*leftChildPath = [NSBezierPath bezierPathWithRect:leftChildNaturalBounds];
-	NSAffineTransform	*leftChildTransform = [NSAffineTransform transform];
+	NSMutableArray *children = [NSMutableArray array];
 	
-	[super receiveBounds:bounds];
+	if (leftChild != nil) [children addObject:leftChild];
+	if (child != nil) [children addObject:child];
 	
-	if (leftChild != nil)
-	{
-		if (!NSIsEmptyRect(naturalBounds))
-		{
-			[leftChildTransform
-				translateXBy:displayBounds.origin.x
-				yBy:displayBounds.origin.y
-			];
-			[leftChildTransform
-				scaleXBy:displayBounds.size.width / naturalBounds.size.width
-				yBy:displayBounds.size.height / naturalBounds.size.height
-			];
-			[leftChildTransform
-				translateXBy:-naturalBounds.origin.x
-				yBy:-naturalBounds.origin.y
-			];
-			[leftChildPath transformUsingAffineTransform:leftChildTransform];
+	return children;
+}
 
-			leftChildDisplayBounds = [leftChildPath bounds];
-		}
-		else
-		{
-			leftChildDisplayBounds = bounds;
-		}
-		
-		[leftChild receiveBounds:leftChildDisplayBounds];
-	}
+//
+// displayBoundsOfChild
+//
+// Performs the inherited behaviour but knows where the left child was displayed as well.
+//
+- (NSRect)displayBoundsOfChild:(Expression*)node
+{
+	if (node != nil && node == leftChild)
+		return [self displayRectForNaturalRect:leftChildNaturalBounds];
+	
+	return [super displayBoundsOfChild:node];
 }
 
 //
@@ -24,12 +24,14 @@
 - (instancetype)initWithParent:(Expression*)newParent andManager:(DataManager*)newManager NS_DESIGNATED_INITIALIZER;
 - (instancetype)initWithCoder:(NSCoder *)coder NS_DESIGNATED_INITIALIZER;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent NS_DESIGNATED_INITIALIZER;
+- (void)appendEncodingTo:(NSMutableData *)data;
 - (void)binaryOpPressed:(int)op;
 - (void)closeBracketPressed;
 - (void)deleteDigit;
 - (void)equalsPressed;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (void)composePathAtLevel:(int)level;
 - (void)postOpPressed:(int)op;
 
 @end
@@ -66,6 +66,33 @@
 	[coder encodeBool:closed forKey:@"MEClosed"];
 }
 
+//
+// initWithEncoding
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		closed = BF_DecodeByte(decoder) != 0;
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	[super appendEncodingTo:data];
+	
+	BF_EncodeByte(data, closed ? 1 : 0);
+}
+
 //
 // binaryOpPressed
 //
@@ -155,110 +182,87 @@
 }
 
 //
-// pathAtLevel
+// composePathAtLevel
 //
-// Drawing this node is pretty simple: it draws the child node and places a left bracket to
-// the left of the child and a right bracket to the right if this node is closed.
+// Laying out this node is pretty simple: it places the child node and puts a left bracket
+// to the left of the child and a right bracket to the right if this node is closed.
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (void)composePathAtLevel:(int)level
 {
-	NSBezierPath *copy;
+	NSBezierPath 		*rightBracket;
+	NSAffineTransform	*transform;
+	double				scale = [Expression scaleWithLevel:level];
+	NSRect				boundsRect;
+	double				bracketHeight;
+	double				bracketWidth;
+	double				bracketBaseline;
 	
-	if (pathValidAt != level)
-	{
-		NSBezierPath 		*rightBracket;
-		NSAffineTransform	*transform;
-		double				scale = [Expression scaleWithLevel:level];
-		NSRect				boundsRect;
-		NSBezierPath		*childPath = [NSBezierPath bezierPath];
-		double				bracketHeight;
-		double				bracketWidth;
-		double				bracketBaseline;
-		
-		expressionPath = [NSBezierPath bezierPath];
+	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = [NSAffineTransform transform];
+	childNaturalBounds = NSZeroRect;
+
+	// Get the left bracket
+	[expressionPath appendBezierPath:[ExpressionSymbols leftBracketPath]];
+	transform = [NSAffineTransform transform];
+	[transform scaleBy:scale];
+	[expressionPath transformUsingAffineTransform:transform];
+	
+	boundsRect = [expressionPath bounds];
+	bracketWidth = boundsRect.origin.x + boundsRect.size.width;
+	bracketHeight = boundsRect.size.height;
+	bracketBaseline = boundsRect.origin.y;
 
-		// Get the left bracket
-		[expressionPath appendBezierPath:[ExpressionSymbols leftBracketPath]];
+	if (child != nil)
+	{
+		// Place the bracket contents to the right of the left bracket
+		[childPlacement translateXBy:bracketWidth yBy:0];
+		childNaturalBounds = [Expression rect:[child naturalBoundsAtLevel:level] transformedBy:childPlacement];
+	}
+	
+	if (closed)
+	{
+		// Get the right bracket (the shared symbol is transformed into a new path)
 		transform = [NSAffineTransform transform];
 		[transform scaleBy:scale];
-		[expressionPath transformUsingAffineTransform:transform];
-		
-		boundsRect = [expressionPath bounds];
-		bracketWidth = boundsRect.origin.x + boundsRect.size.width;
-		bracketHeight = boundsRect.size.height;
-		bracketBaseline = boundsRect.origin.y;
-
-		if (child != nil)
-		{
-			// Get the bracket contents
-			childPath = [child pathAtLevel:level];
-			
-			// Transform the op to the right of the child's value
-			transform = [NSAffineTransform transform];
-			[transform translateXBy:bracketWidth yBy:0];
-			[childPath transformUsingAffineTransform:transform];
-		}
-		
-		if (closed)
-		{
-			// Get the right bracket
-			rightBracket = [ExpressionSymbols rightBracketPath];
-			transform = [NSAffineTransform transform];
-			[transform scaleBy:scale];
-			[rightBracket transformUsingAffineTransform:transform];
-			
-			transform = [NSAffineTransform transform];
-			if (child != nil)
-			{
-				// Position the right bracket after the bracket contents
-				boundsRect = [childPath bounds];
-				[transform
-					translateXBy:boundsRect.origin.x + boundsRect.size.width + (scale * 2.0) yBy:0
-				];
-			}
-			else
-			{
-				// Position the right bracket after the left bracket
-				transform = [NSAffineTransform transform];
-				[transform translateXBy:bracketWidth yBy:0];
-			}
-			// The left and right bracket now get joined together
-			[rightBracket transformUsingAffineTransform:transform];
-			[expressionPath appendBezierPath:rightBracket];
-		}
+		rightBracket = [transform transformBezierPath:[ExpressionSymbols rightBracketPath]];
 		
+		transform = [NSAffineTransform transform];
 		if (child != nil)
 		{
-			// Scale the brackets so that they are the same height as the value that they contain
-			boundsRect = [childPath bounds];
-			transform = [NSAffineTransform transform];
+			// Position the right bracket after the bracket contents
+			boundsRect = childNaturalBounds;
 			[transform
-				translateXBy:0.0
-				yBy:((boundsRect.origin.y < 0.0) ? boundsRect.origin.y : 0.0) - (3.0 * scale)
+				translateXBy:boundsRect.origin.x + boundsRect.size.width + (scale * 2.0) yBy:0
 			];
-			
-			if ((boundsRect.size.height + (6.0 * scale)) / bracketHeight > 1.0)
-				[transform scaleXBy:1.0 yBy:(boundsRect.size.height + (6.0 * scale)) / bracketHeight];
-			[transform translateXBy:0.0 yBy:-bracketBaseline];
-			[expressionPath transformUsingAffineTransform:transform];
-			[expressionPath appendBezierPath:childPath];
 		}
-		
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
 		else
-			naturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		if (![childPath isEmpty])
-			childNaturalBounds = [childPath bounds];
-		else
-			childNaturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		pathValidAt = level;
+		{
+			// Position the right bracket after the left bracket
+			transform = [NSAffineTransform transform];
+			[transform translateXBy:bracketWidth yBy:0];
+		}
+		// The left and right bracket now get joined together
+		[rightBracket transformUsingAffineTransform:transform];
+		[expressionPath appendBezierPath:rightBracket];
 	}
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
+	if (child != nil)
+	{
+		// Scale the brackets so that they are the same height as the value that they contain
+		boundsRect = childNaturalBounds;
+		transform = [NSAffineTransform transform];
+		[transform
+			translateXBy:0.0
+			yBy:((boundsRect.origin.y < 0.0) ? boundsRect.origin.y : 0.0) - (3.0 * scale)
+		];
+		
+		if ((boundsRect.size.height + (6.0 * scale)) / bracketHeight > 1.0)
+			[transform scaleXBy:1.0 yBy:(boundsRect.size.height + (6.0 * scale)) / bracketHeight];
+		[transform translateXBy:0.0 yBy:-bracketBaseline];
+		[expressionPath transformUsingAffineTransform:transform];
+	}
 	
-	return copy;
+	naturalBounds = NSUnionRect([Expression boundsOfPath:expressionPath], childNaturalBounds);
 }
 
 //
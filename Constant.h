@@ -42,13 +42,16 @@
 - (instancetype)initWithParent:(Expression*)newParent manager:(DataManager*)newManager andConstant:(int)newConstant;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
+- (void)appendEncodingTo:(NSMutableData *)data;
 
 - (void)appendDigit:(int)digit;
 - (void)bracketPressed;
 - (void)constantPressed:(enum ConstType)newConstant;
 - (void)expressionInserted:(Expression*)newExpression;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (BigInteger*)calculateExactValue;
+- (void)composePathAtLevel:(int)level;
 - (void)preOpPressed:(int)newOp;
 - (void)valueInserted:(BigCFloat*)newValue;
 
@@ -9,6 +9,7 @@
 #import "Constant.h"
 #import "ExpressionSymbols.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "DataManager.h"
 #import "OpEnumerations.h"
 #import "PreOp.h"
@@ -75,6 +76,37 @@
 	[coder encodeObject:value forKey:@"MEValue"];
 }
 
+//
+// initWithEncoding
+//
+// Reads the constant and its value from the compact encoding.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		constant = (enum ConstType)BF_DecodeUnsigned(decoder);
+		negative = BF_DecodeByte(decoder) != 0;
+		value = [[BigCFloat alloc] initWithEncoding:decoder];
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Writes the constant and its value in the compact encoding.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	[super appendEncodingTo:data];
+	
+	BF_EncodeUnsigned(data, (unsigned int)constant);
+	BF_EncodeByte(data, negative ? 1 : 0);
+	[value appendEncodingTo:data];
+}
+
 //
 // appendDigit
 //
@@ -145,54 +177,48 @@
 }
 
 //
-// pathAtLevel
+// calculateExactValue
+//
+// The number itself if it is an integer. Also used by Value for entered numbers.
+//
+- (BigInteger*)calculateExactValue
+{
+	return [value bigIntegerValue];
+}
+
+//
+// composePathAtLevel
 //
-// Creates a path containing either π or i
+// Creates a path containing the constant's symbol
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (void)composePathAtLevel:(int)level
 {
-	NSBezierPath		*copy;
+	expressionPath = [NSBezierPath bezierPath];
+	[expressionPath appendBezierPath:[ExpressionSymbols makeSymbolForConstant:constant]];
 	
-	if (pathValidAt != level)
+	if (negative)
 	{
-		expressionPath = [NSBezierPath bezierPath];
-		[expressionPath appendBezierPath:[ExpressionSymbols makeSymbolForConstant:constant]];
-		
-		if (negative)
-		{
-			NSBezierPath		*minusPath = [NSBezierPath bezierPath];
-			NSAffineTransform	*signTransform = [NSAffineTransform transform];
-			NSRect				boundsRect;
-
-			[minusPath appendBezierPath:[ExpressionSymbols minusPath]];
-			boundsRect = [minusPath bounds];
-			
-			[signTransform translateXBy:boundsRect.origin.x + boundsRect.size.width + 4.0 yBy:0];
-			[expressionPath transformUsingAffineTransform:signTransform];
-			[expressionPath appendBezierPath:minusPath];
-		}
-
-		if (level >= 2)
-		{
-			NSAffineTransform	*transform = [NSAffineTransform transform];
-			double				scale = [Expression scaleWithLevel:level];
-	
-			[transform scaleBy:scale];
-			[expressionPath transformUsingAffineTransform:transform];
-		}
+		NSBezierPath		*minusPath = [ExpressionSymbols minusPath];
+		NSAffineTransform	*signTransform = [NSAffineTransform transform];
+		NSRect				boundsRect;
+
+		boundsRect = [minusPath bounds];
 		
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
+		[signTransform translateXBy:boundsRect.origin.x + boundsRect.size.width + 4.0 yBy:0];
+		[expressionPath transformUsingAffineTransform:signTransform];
+		[expressionPath appendBezierPath:minusPath];
+	}
 
-		pathValidAt = level;
+	if (level >= 2)
+	{
+		NSAffineTransform	*transform = [NSAffineTransform transform];
+		double				scale = [Expression scaleWithLevel:level];
+
+		[transform scaleBy:scale];
+		[expressionPath transformUsingAffineTransform:transform];
 	}
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
-	
-	return copy;
+	naturalBounds = [Expression boundsOfPath:expressionPath];
 }
 
 //
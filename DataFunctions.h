@@ -11,6 +11,13 @@
 @class DataManager;
 @class DrawerManager;
 @class BigCFloat;
+@class BigMatrix;
+
+//
+// A reduction step: accumulates the group of values starting at index into sums (one
+// partial sum per quantity), using scratch for any temporary.
+//
+typedef void (^DFReductionStep)(NSArray *values, NSUInteger index, NSArray *sums, BigCFloat *scratch);
 
 //
 // About DataFunctions
@@ -22,30 +29,71 @@
 {
 	IBOutlet DataManager	*dataManager;
 	IBOutlet DrawerManager	*drawerManager;
+	
+	NSArray					*sortedSource;
+	NSArray					*sortedValues;
+	
+	NSArray					*regressionSource;
+	short					regressionRadix;
+	BigCFloat				*regressionCount;
+	BigCFloat				*regressionSumX;
+	BigCFloat				*regressionSumY;
+	BigCFloat				*regressionSumXX;
+	BigCFloat				*regressionSumYY;
+	BigCFloat				*regressionSumXY;
+	
+	BigMatrix				*storedMatrix;
 }
 - (id)afromrankregressiononx:(NSMutableArray *)values;
 - (id)afromrankregressionony:(NSMutableArray *)values;
 - (id)bfromrankregressiononx:(NSMutableArray *)values;
 - (id)bfromrankregressionony:(NSMutableArray *)values;
+- (BigCFloat *)centredSum:(BigCFloat *)sum of:(BigCFloat *)first and:(BigCFloat *)second;
 - (id)coefofvariation:(NSMutableArray *)values;
+- (id)correlation:(NSMutableArray *)values;
+- (void)data2DChanged;
 - (NSMutableArray *)determinantsubmatrix:(NSMutableArray *)values size:(int)size withoutRow:(int)row orColumn:(int)column;
 - (BigCFloat *)determinant:(NSMutableArray *)values size:(int)size;
 - (id)determinant:(NSMutableArray *)values;
+- (int)pivotRow:(NSMutableArray *)values column:(int)column fromRow:(int)row columns:(int)numColumns rows:(int)numRows;
+- (void)eliminateColumn:(int)column pivotRow:(int)row values:(NSMutableArray *)values columns:(int)numColumns rows:(int)numRows;
 - (void)exchangeRows:(NSMutableArray *)values firstRow:(int)one secondRow:(int)two columns:(int)numColumns;
 - (id)gaussianelimination:(NSMutableArray *)values columns:(int)numColumns rows:(int)numRows;
 - (id)gaussianelimination:(NSMutableArray *)values;
 - (id)backsub:(NSMutableArray *)values columns:(int)num_columns rows:(int)num_rows;
 - (id)gaussianeliminationwithbacksub:(NSMutableArray *)values;
+- (BOOL)solveSquareSystem:(NSMutableArray *)values rows:(int)numRows;
+- (id)histogram:(NSMutableArray *)values;
+- (id)interquartilerange:(NSMutableArray *)values;
+- (BigCFloat *)largestOf:(NSArray *)values below:(NSUInteger)count;
+- (id)lowerquartile:(NSMutableArray *)values;
+- (id)matrixpower:(NSMutableArray *)values;
 - (id)mean:(NSMutableArray *)values;
 - (id)median:(NSMutableArray *)values;
 - (id)mode:(NSMutableArray *)values;
+- (id)multiplybystoredmatrix:(NSMutableArray *)values;
+- (BigCFloat *)percentile:(BigCFloat *)fraction ofSorted:(NSArray *)sorted;
+- (id)percentile:(NSMutableArray *)values;
+- (id)percentile:(int)percent ofValues:(NSMutableArray *)values;
+- (id)percentile10:(NSMutableArray *)values;
+- (id)percentile90:(NSMutableArray *)values;
+- (id)selectKth:(NSUInteger)k inValues:(NSMutableArray *)values;
+- (NSArray *)sortedValues:(NSArray *)values;
 - (id)mfromrankregressiononx:(NSMutableArray *)values;
 - (id)mfromrankregressiononxwithoriginintercept:(NSMutableArray *)values;
 - (id)mfromrankregressionony:(NSMutableArray *)values;
 - (id)mfromrankregressiononywithoriginintercept:(NSMutableArray *)values;
 - (void)prepareArray:(NSMutableArray *)values outColumns:(int *)columns outRows:(int *)rows;
++ (NSArray *)reduce:(NSArray *)values stride:(NSUInteger)stride sums:(int)numSums radix:(short)radix withStep:(DFReductionStep)step;
+- (void)regressionStatistics:(NSMutableArray *)values;
+- (void)replaceArray:(NSMutableArray *)values withMatrix:(BigMatrix *)matrix;
 - (id)stddev:(NSMutableArray *)values;
+- (id)storematrix:(NSMutableArray *)values;
 - (id)sum:(NSMutableArray *)values;
++ (BigCFloat *)sumOf:(NSArray *)values radix:(short)radix;
++ (BigCFloat *)sumOfSquaredDeviations:(NSArray *)values from:(BigCFloat *)mean radix:(short)radix;
+- (id)transpose:(NSMutableArray *)values;
+- (id)upperquartile:(NSMutableArray *)values;
 - (id)variance:(NSMutableArray *)values;
 - (id)zero:(NSMutableArray *)values;
 - (id)inverse:(NSMutableArray *)values;
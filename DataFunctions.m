@@ -10,6 +10,15 @@
 #import "BigCFloat.h"
 #import "DataManager.h"
 #import "DrawerManager.h"
+#import "BigMatrix.h"
+
+// Largest matrix whose determinant is still found by cofactor expansion. Above this
+// the LU factorisation (BigMatrix) is cheaper.
+#define DF_cofactor_determinant_limit	3
+
+// Number of value groups each worker reduces at a time. The chunking does not depend
+// on the number of threads, so neither do the rounding errors of a reduction.
+#define DF_reduction_chunk_size			2048
 
 //
 // About DataFunctions
@@ -27,20 +36,9 @@
 - (id)afromrankregressiononx:(NSMutableArray *)values
 {
 	BigCFloat *a = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *averagex = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *m = [self mfromrankregressiononx:values];
-	BigCFloat *b = [self bfromrankregressiononx:values];
-	int			i;
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagex add:values[i * 2]];
-	}
-	[averagex divideBy:n];
-
-	[a subtract:b];
-	[a divideBy:m];
+	
+	[a subtract:[self bfromrankregressiononx:values]];
+	[a divideBy:[self mfromrankregressiononx:values]];
 	
 	return a;
 }
@@ -53,20 +51,9 @@
 - (id)afromrankregressionony:(NSMutableArray *)values
 {
 	BigCFloat *a = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *averagex = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *m = [self mfromrankregressionony:values];
-	BigCFloat *b = [self bfromrankregressionony:values];
-	int			i;
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagex add:values[i * 2]];
-	}
-	[averagex divideBy:n];
-
-	[a subtract:b];
-	[a divideBy:m];
+	
+	[a subtract:[self bfromrankregressionony:values]];
+	[a divideBy:[self mfromrankregressionony:values]];
 	
 	return a;
 }
@@ -78,28 +65,18 @@
 //
 - (id)bfromrankregressiononx:(NSMutableArray *)values
 {
-	BigCFloat *averagey = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *averagex = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *m = [self bfromrankregressiononx:values];
-	int			i;
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagex add:values[i * 2]];
-	}
-	[averagex divideBy:n];
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagey add:values[i * 2 + 1]];
-	}
-	[averagey divideBy:n];
-
-	[averagex multiplyBy:m];
-	[averagey subtract:averagex];
+	BigCFloat *b;
+	BigCFloat *mx;
+	
+	[self regressionStatistics:values];
 	
-	return averagey;
+	b = (BigCFloat *)[regressionSumY duplicate];
+	mx = [self mfromrankregressiononx:values];
+	[mx multiplyBy:regressionSumX];
+	[b subtract:mx];
+	[b divideBy:regressionCount];
+	
+	return b;
 }
 
 //
@@ -109,28 +86,36 @@
 //
 - (id)bfromrankregressionony:(NSMutableArray *)values
 {
-	BigCFloat *averagey = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *averagex = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *m = [self mfromrankregressionony:values];
-	int			i;
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagex add:values[i * 2]];
-	}
-	[averagex divideBy:n];
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[averagey add:values[i * 2 + 1]];
-	}
-	[averagey divideBy:n];
+	BigCFloat *b;
+	BigCFloat *mx;
+	
+	[self regressionStatistics:values];
+	
+	b = (BigCFloat *)[regressionSumY duplicate];
+	mx = [self mfromrankregressionony:values];
+	[mx multiplyBy:regressionSumX];
+	[b subtract:mx];
+	[b divideBy:regressionCount];
+	
+	return b;
+}
 
-	[averagex multiplyBy:m];
-	[averagey subtract:averagex];
+//
+// centredSum
+//
+// A sum of products taken about the means: sum - first * second / n, using the
+// regression statistics for n.
+//
+- (BigCFloat *)centredSum:(BigCFloat *)sum of:(BigCFloat *)first and:(BigCFloat *)second
+{
+	BigCFloat *centred = (BigCFloat *)[sum duplicate];
+	BigCFloat *product = (BigCFloat *)[first duplicate];
 	
-	return averagey;
+	[product multiplyBy:second];
+	[product divideBy:regressionCount];
+	[centred subtract:product];
+	
+	return centred;
 }
 
 //
@@ -158,6 +143,37 @@
 	return standardDeviation;
 }
 
+//
+// correlation
+//
+// Pearson's correlation coefficient of the 2D data
+//
+- (id)correlation:(NSMutableArray *)values
+{
+	BigCFloat *r;
+	BigCFloat *spread;
+	
+	[self regressionStatistics:values];
+	
+	r = [self centredSum:regressionSumXY of:regressionSumX and:regressionSumY];
+	spread = [self centredSum:regressionSumXX of:regressionSumX and:regressionSumX];
+	[spread multiplyBy:[self centredSum:regressionSumYY of:regressionSumY and:regressionSumY]];
+	[spread sqrt];
+	[r divideBy:spread];
+	
+	return r;
+}
+
+//
+// data2DChanged
+//
+// Drops the regression statistics. Called whenever the 2D data is modified.
+//
+- (void)data2DChanged
+{
+	regressionSource = nil;
+}
+
 //
 // determinantsubmatrix
 //
@@ -191,34 +207,31 @@
 {
 	int i;
 	BigCFloat *result = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *temp = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
+	NSMutableArray *minors = [NSMutableArray arrayWithCapacity:size];
+	signed char signs[size];
 	
-	if (size == 2)
+	if (size == 1)
 	{
 		[result add:values[0]];
-		[result multiplyBy:values[3]];
-		[temp add:values[1]];
-		[temp multiplyBy:values[2]];
-		[result subtract:temp];
 		
 		return result;
 	}
 	
+	// Expand along the first row, summing the terms with a single rounding
 	for (i = 0; i < size; i++)
 	{
-		[temp assign:values[i]];
-		[temp multiplyBy:
-			[self
-				determinant:[self determinantsubmatrix:values size:size withoutRow:0 orColumn:i]
-				size:size - 1
-			]
-		];
-		
-		if (i % 2 == 0)
-			[result add:temp];
+		if (size == 2)
+			[minors addObject:values[3 - i]];
 		else
-			[result subtract:temp];
+			[minors addObject:
+				[self
+					determinant:[self determinantsubmatrix:values size:size withoutRow:0 orColumn:i]
+					size:size - 1
+				]
+			];
+		signs[i] = (i % 2 == 0) ? 1 : -1;
 	}
+	[result accumulateProductsOf:[values subarrayWithRange:NSMakeRange(0, size)] and:minors signs:signs];
 	
 	return result;
 }
@@ -247,7 +260,10 @@
 		return nil;
 	}
 
-	return [self determinant:values size:num_rows];
+	if (num_rows <= DF_cofactor_determinant_limit)
+		return [self determinant:values size:num_rows];
+	
+	return [[[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]] determinant];
 }
 
 //
@@ -271,6 +287,72 @@
 	}
 }
 
+//
+// pivotRow
+//
+// Internal function used for elimination. Finds the row at or below "row" with the
+// largest magnitude in "column", or -1 if the column is zero from "row" down.
+//
+- (int)pivotRow:(NSMutableArray *)values column:(int)column fromRow:(int)row columns:(int)numColumns rows:(int)numRows
+{
+	BigFloat	*largest = nil;
+	BigFloat	*magnitude;
+	int			result = -1;
+	int			j;
+	
+	for (j = row; j < numRows; j++)
+	{
+		if ([values[j * numColumns + column] isZero])
+			continue;
+		
+		magnitude = [values[j * numColumns + column] magnitude];
+		if (largest == nil || [magnitude compareWith:largest] == NSOrderedDescending)
+		{
+			largest = magnitude;
+			result = j;
+		}
+	}
+	
+	return result;
+}
+
+//
+// eliminateColumn
+//
+// The elimination kernel. Divides the pivot row through by its (non-zero) pivot then
+// subtracts multiples of it from every row below so the column is zero under the pivot.
+//
+- (void)eliminateColumn:(int)column pivotRow:(int)row values:(NSMutableArray *)values columns:(int)numColumns rows:(int)numRows
+{
+	BigCFloat *one = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
+	BigCFloat *zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
+	int i, j;
+	
+	// Divide this row through by its leftmost value
+	for (i = column + 1; i < numColumns; i++)
+	{
+		[values[row * numColumns + i] divideBy:values[row * numColumns + column]];
+	}
+	
+	// Set the leftmost value to one
+	[values[row * numColumns + column] assign:one];
+	
+	// We now clear this value from all subsequent rows
+	for (j = row + 1; j < numRows; j++)
+	{
+		// The value to be cleared is zero in this row
+		if ([values[j * numColumns + column] isZero])
+			continue;
+		
+		// Subtract the "row"th row times (column, j) from the j-th row
+		for (i = column + 1; i < numColumns; i++)
+		{
+			[values[j * numColumns + i] subtractProductOf:values[j * numColumns + column] and:values[row * numColumns + i]];
+		}
+		[values[j * numColumns + column] assign:zero];
+	}
+}
+
 //
 // gaussianelimination
 //
@@ -282,61 +364,23 @@
 	int start_row = 0;
 	int start_column = 0;
 	int i, j;
-	BigCFloat *one = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
-	BigCFloat *zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *subtractor = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 
 	// The gaussian elimination begins here
 	while (start_row < numRows && start_column < numColumns - 1)
 	{
-		// Check the top-leftmost value for a zero
-		if ([values[start_row * numColumns + start_column] isZero])
-		{
-			// If we have a zero at this point, move a lower row (without a zero) up
-			for (i = start_row + 1; i < numRows; i++)
-			{
-				if (![values[i * numColumns + start_column] isZero])
-				{
-					[self exchangeRows:values firstRow:i secondRow:start_row columns:numColumns];
-					break;
-				}
-			}
-			
-			// We found no non-zero values. This column is empty from here down.
-			if (i == numRows)
-			{
-				// Ignore this column and move on to the next
-				start_column++;
-				continue;
-			}
-		}
-
-		// Divide this row through by its leftmost value
-		for (i = start_column + 1; i < numColumns; i++)
-		{
-			[values[start_row * numColumns + i] divideBy:values[start_row * numColumns + start_column]];
-		}
-		
-		// Set the leftmost value to one
-		[values[start_row * numColumns + start_column] assign:one];
+		// Move the row with the largest value in this column up to be the pivot
+		i = [self pivotRow:values column:start_column fromRow:start_row columns:numColumns rows:numRows];
 		
-		// We now clear this value from all subsequent rows
-		for (j = start_row + 1; j < numRows; j++)
+		// We found no non-zero values. This column is empty from here down.
+		if (i == -1)
 		{
-			// The value to be cleared is zero in this row
-			if ([values[j * numColumns + start_column] isZero])
-				continue;
-			
-			// Subtract the "start_row"th row times (start_column, j) from the j-th row
-			for (i = start_column + 1; i < numColumns; i++)
-			{
-				[subtractor assign:values[j * numColumns + start_column]];
-				[subtractor multiplyBy:values[start_row * numColumns + i]];
-				
-				[values[j * numColumns + i] subtract:subtractor];
-			}
-			[values[j * numColumns + start_column] assign:zero];
+			// Ignore this column and move on to the next
+			start_column++;
+			continue;
 		}
+		[self exchangeRows:values firstRow:i secondRow:start_row columns:numColumns];
+
+		[self eliminateColumn:start_column pivotRow:start_row values:values columns:numColumns rows:numRows];
 		
 		// We have now cleared this row and column combination. Move on to the next
 		start_row++;
@@ -403,7 +447,6 @@
 
 	BigCFloat *one = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
 	BigCFloat *zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *subtractor = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 	
 	// Backsub all rows that we can
 	for (j = num_rows - 1; j >= 0; j--)
@@ -436,9 +479,8 @@
 			{
 				for (i = first_non_zero + 1; i < num_columns; i++)
 				{
-					[subtractor assign:(BigCFloat *)values[(j * num_columns) + i]];
-					[subtractor multiplyBy:(BigCFloat *)values[(k * num_columns) + first_non_zero]];				
-					[(BigCFloat *)values[(k * num_columns) + i] subtract:subtractor];
+					[(BigCFloat *)values[(k * num_columns) + i] subtractProductOf:(BigCFloat *)values[(j * num_columns) + i]
+																			  and:(BigCFloat *)values[(k * num_columns) + first_non_zero]];
 				}
 				[(BigCFloat *)values[(k * num_columns) + first_non_zero] assign:zero];
 			}
@@ -448,6 +490,47 @@
 	return nil;
 }
 
+//
+// solveSquareSystem
+//
+// Solves an n by n+1 augmented system (by mixed precision refinement where possible)
+// and writes back the reduced form (the identity followed by the solution column).
+// Returns NO, leaving values untouched, if the system has no unique solution.
+//
+- (BOOL)solveSquareSystem:(NSMutableArray *)values rows:(int)numRows
+{
+	BigMatrix	*coefficients = [[BigMatrix alloc] initWithArray:@[] rows:numRows columns:numRows radix:[dataManager getRadix]];
+	BigMatrix	*rhs = [[BigMatrix alloc] initWithArray:@[] rows:numRows columns:1 radix:[dataManager getRadix]];
+	BigMatrix	*solution;
+	BigCFloat	*one = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
+	BigCFloat	*zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
+	int			i, j;
+	
+	for (j = 0; j < numRows; j++)
+	{
+		for (i = 0; i < numRows; i++)
+		{
+			[[coefficients elementAtRow:j column:i] assign:values[j * (numRows + 1) + i]];
+		}
+		[[rhs elementAtRow:j column:0] assign:values[j * (numRows + 1) + numRows]];
+	}
+	
+	solution = [coefficients refinedSolve:rhs];
+	if (solution == nil)
+		return NO;
+	
+	for (j = 0; j < numRows; j++)
+	{
+		for (i = 0; i < numRows; i++)
+		{
+			[values[j * (numRows + 1) + i] assign:(i == j) ? one : zero];
+		}
+		[values[j * (numRows + 1) + numRows] assign:[solution elementAtRow:j column:0]];
+	}
+	
+	return YES;
+}
+
 //
 // gaussianeliminationwithbacksub
 //
@@ -458,28 +541,124 @@
 	int numRows, numColumns;
 	
 	[self prepareArray:values outColumns:&numColumns outRows:&numRows];	
+	
+	// A square system with a unique solution is solved directly from its LU factors
+	if (numColumns == numRows + 1 && [self solveSquareSystem:values rows:numRows])
+		return nil;
+	
 	[self gaussianelimination:values columns:numColumns rows:numRows];
 	
 	return [self backsub:values columns:numColumns rows:numRows];
 }
 
+//
+// histogram
+//
+// Counts the values into equal width bins (Sturges' rule for the number of bins) and
+// replaces the 2D data with (bin centre, count) pairs. Existing 2D data is only
+// replaced once the user has confirmed it.
+//
+- (id)histogram:(NSMutableArray *)values
+{
+	NSArray			*sorted;
+	NSMutableArray	*data2D = [dataManager data2D];
+	BigCFloat		*width;
+	BigCFloat		*halfWidth;
+	BigCFloat		*lower;
+	BigCFloat		*upper;
+	BigCFloat		*centre;
+	NSUInteger		index = 0;
+	NSUInteger		start;
+	int				bins;
+	int				bin;
+	
+	if ([values count] == 0)
+		return nil;
+	
+	if ([data2D count] != 0)
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"Replace the 2D data with the histogram?"];
+		[alert setInformativeText:@"The values currently in the 2D data will be lost."];
+		[alert addButtonWithTitle:@"Replace"];
+		[alert addButtonWithTitle:@"Cancel"];
+		if ([alert runModal] != NSAlertFirstButtonReturn)
+			return nil;
+	}
+	
+	sorted = [self sortedValues:values];
+	bins = (int)ceil(log2((double)[sorted count])) + 1;
+	
+	width = (BigCFloat *)[[sorted lastObject] duplicate];
+	[width subtract:sorted[0]];
+	if ([width isZero])
+	{
+		bins = 1;
+		width = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
+	}
+	else
+	{
+		[width divideBy:[BigCFloat bigFloatWithInt:bins radix:[dataManager getRadix]]];
+	}
+	halfWidth = (BigCFloat *)[width duplicate];
+	[halfWidth divideBy:[BigCFloat bigFloatWithInt:2 radix:[dataManager getRadix]]];
+	
+	[data2D removeAllObjects];
+	lower = (BigCFloat *)[sorted[0] duplicate];
+	for (bin = 0; bin < bins; bin++)
+	{
+		upper = (BigCFloat *)[lower duplicate];
+		[upper add:width];
+		
+		// Count up to this bin's upper edge (the last bin takes everything left)
+		start = index;
+		while
+		(
+			index < [sorted count] &&
+			(bin == bins - 1 || [sorted[index] compareWith:upper] == NSOrderedAscending)
+		)
+		{
+			index++;
+		}
+		
+		centre = (BigCFloat *)[lower duplicate];
+		[centre add:halfWidth];
+		[data2D addObject:centre];
+		[data2D addObject:[BigCFloat bigFloatWithInt:(int)(index - start) radix:[dataManager getRadix]]];
+		
+		lower = upper;
+	}
+	[self data2DChanged];
+	
+	return nil;
+}
+
+//
+// interquartilerange
+//
+// The upper quartile less the lower quartile
+//
+- (id)interquartilerange:(NSMutableArray *)values
+{
+	BigCFloat *range = [self upperquartile:values];
+	
+	[range subtract:[self lowerquartile:values]];
+	
+	return range;
+}
+
 //
 // inverse
 //
-// Inverts a matrix. Does it by extending the matrix with a triangular matrix, gaussian
-// eliminating the extended matrix and taking the values from the appended region.
+// Inverts a matrix. Does it by LU factorising the matrix and solving against the
+// identity, one column per thread.
 //
 - (id)inverse:(NSMutableArray *)values
 {
 	int num_rows, num_columns;
-	int i, j;
-	NSMutableArray *solution;
-	BOOL inverse_exists;
-	
-	BigCFloat *one = [BigCFloat bigFloatWithInt:1 radix:[dataManager getRadix]];
-	BigCFloat *zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
+	BigMatrix *solution;
 
-	[self prepareArray:values outColumns:&num_rows outRows:&num_columns];	
+	[self prepareArray:values outColumns:&num_columns outRows:&num_rows];	
 	
 	if (num_rows != num_columns)
 	{
@@ -490,176 +669,178 @@
 		return nil;
 	}
 	
-	solution = [NSMutableArray arrayWithCapacity:(num_rows * num_columns * 2)];
+	solution = [[[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]] inverse];
+	
+	if (solution == nil)
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"The matrix is not invertible."];
+		[alert runModal];
+//		NSRunAlertPanel(nil, @"The matrix is not invertible.", nil, nil, nil);
+		return nil;
+	}
+	
+	[solution copyToArray:values];
+	
+	return nil;
+}
 
-	for (j = 0; j < num_rows; j++)
+//
+// largestOf
+//
+// Internal utility for median. The largest of the first "count" values.
+//
+- (BigCFloat *)largestOf:(NSArray *)values below:(NSUInteger)count
+{
+	BigCFloat	*largest = values[0];
+	NSUInteger	i;
+	
+	for (i = 1; i < count; i++)
 	{
-		for (i = 0; i < num_columns; i++)
-		{
-			[solution addObject:[values[j * num_columns + i] duplicate]];
-		}
-		for (i = 0; i < num_columns; i++)
-		{
-			if (i == j)
-				[solution addObject:[one duplicate]];
-			else
-				[solution addObject:[zero duplicate]];
-		}
+		if ([values[i] compareWith:largest] == NSOrderedDescending)
+			largest = values[i];
 	}
 	
-	[self gaussianelimination:solution columns:num_columns * 2 rows:num_rows];
-	[self backsub:solution columns:num_columns * 2 rows:num_rows];
+	return largest;
+}
+
+//
+// lowerquartile
+//
+// The 25th percentile
+//
+- (id)lowerquartile:(NSMutableArray *)values
+{
+	return [self percentile:25 ofValues:values];
+}
+
+//
+// matrixpower
+//
+// Raises the array to the integer power in the display. Negative powers are powers of
+// the inverse.
+//
+- (id)matrixpower:(NSMutableArray *)values
+{
+	BigCFloat	*exponent = [[[dataManager getCurrentExpression] getValue] copy];
+	BigCFloat	*fraction = [exponent copy];
+	BigMatrix	*result;
+	int			num_rows, num_columns;
+	
+	[self prepareArray:values outColumns:&num_columns outRows:&num_rows];
 	
-	inverse_exists = YES;
-	for (j = 0; j < num_rows; j++)
+	if (num_rows != num_columns)
 	{
-		for (i = 0; i < num_columns; i++)
-		{
-			if (i == j)
-			{
-				if ([solution[j * num_columns * 2 + i] compareWith:one] != NSOrderedSame)
-				{
-					inverse_exists = NO;
-					break;
-				}
-			}
-			else
-			{
-				if ([solution[j * num_columns * 2 + i] compareWith:zero] != NSOrderedSame)
-				{
-					inverse_exists = NO;
-					break;
-				}
-			}
-		}
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"Can only raise a square matrix to a power (a square matrix has the same number of columns as rows)"];
+		[alert runModal];
+		return nil;
 	}
 	
-	if (!inverse_exists)
+	[fraction fractionalPart];
+	if
+	(
+		exponent == nil || ![exponent isValid] || [exponent hasImaginary] || ![fraction isZero] ||
+		fabs([exponent doubleValue]) > INT_MAX
+	)
 	{
 		NSAlert *alert = [[NSAlert alloc] init];
-		[alert setMessageText:@"The matrix is not invertible."];
+		[alert setMessageText:@"Enter a whole number power in the display before choosing Power"];
 		[alert runModal];
-//		NSRunAlertPanel(nil, @"The matrix is not invertible.", nil, nil, nil);
 		return nil;
 	}
 	
-	for (j = 0; j < num_rows; j++)
+	result = [[[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]] power:(int)[exponent doubleValue]];
+	
+	if (result == nil)
 	{
-		for (i = 0; i < num_columns; i++)
-		{
-			[(BigCFloat *)values[j * num_columns + i] assign:(BigCFloat*)solution[j * num_columns * 2 + num_columns+ i]];
-		}
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"The matrix is not invertible, so it has no negative powers."];
+		[alert runModal];
+		return nil;
 	}
 	
+	[self replaceArray:values withMatrix:result];
+	
 	return nil;
 }
 
 //
 // mean
 //
-// Averages values.
+// Averages values. The data drawer's own values are answered from the running
+// statistics kept by the DataManager.
 //
 - (id)mean:(NSMutableArray *)values
 {
 	BigCFloat	*sum;
 	BigCFloat	*total;
 	int			numValues = (int)[values count];
-	int			i;
 	
-	sum = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	total = [BigCFloat bigFloatWithInt:numValues radix:[dataManager getRadix]];
+	if ([dataManager hasStatisticsForData:values])
+		return [dataManager dataMean];
 	
-	for (i = 0; i < numValues; i++)
-	{
-		[sum add:values[i]];
-	}
+	sum = [DataFunctions sumOf:values radix:[dataManager getRadix]];
+	total = [BigCFloat bigFloatWithInt:numValues radix:[dataManager getRadix]];
 	[sum divideBy:total];
 	
 	return sum;
 }
 
+//
+// median
+//
+// The middle value. Uses the shared sorted view if it is current, otherwise selects
+// the middle element(s) from a scratch copy in linear time.
+//
 - (id)median:(NSMutableArray *)values
 {
-	NSMutableArray *sortedValues;
+	NSMutableArray *scratch;
 	BigCFloat *median;
 	BigCFloat *two = [BigCFloat bigFloatWithInt:2 radix:[dataManager getRadix]];
+	NSUInteger count = [values count];
 	
-	if ([values count] == 0)
+	if (count == 0)
 	{
 		return [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 	}
 	
-	sortedValues = [NSMutableArray arrayWithCapacity:[values count]];
-	[sortedValues addObjectsFromArray:values];
-	[sortedValues sortUsingSelector:@selector(compareWith:)];
+	if (sortedSource != nil && [sortedSource isEqualToArray:values])
+	{
+		median = (BigCFloat *)[sortedValues[count / 2] duplicate];
+		if (count % 2 == 1)
+			return median;
+		
+		[median add:sortedValues[count / 2 - 1]];
+		[median divideBy:two];
+		return median;
+	}
 	
-	if ([values count] % 2 == 1)
-		return sortedValues[([values count] - 1) / 2];
+	scratch = [NSMutableArray arrayWithArray:values];
+	median = (BigCFloat *)[[self selectKth:count / 2 inValues:scratch] duplicate];
+	if (count % 2 == 1)
+		return median;
 	
-	median = (BigCFloat *)[sortedValues[([values count] - 1) / 2] duplicate];
-	[median add:sortedValues[1 + ([values count] - 1) / 2]];
+	// The other middle value is the largest of those left below the selected one
+	[median add:[self largestOf:scratch below:count / 2]];
 	[median divideBy:two];
 	
 	return median;
 }
 
-//
-// mfromrankregressiononx
 //
 // Slope of the line of best fit (values calculated based on horizontal distance).
 //
 - (id)mfromrankregressiononx:(NSMutableArray *)values
 {
-	BigCFloat *nth_product_of_sums = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumysquared = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumx = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumy = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sum_of_products = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *product = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *numerator = [BigCFloat bigFloatWithInt:(int)[values count] radix:[dataManager getRadix]];
-	BigCFloat *denominator = [BigCFloat bigFloatWithInt:(int)[values count] radix:[dataManager getRadix]];
-	int			i;
-	
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sum_of_products add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2 + 1]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sumysquared add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[sumx add:values[i * 2]];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[sumy add:values[i * 2 + 1]];
-	}
+	BigCFloat *syy;
 	
-	[nth_product_of_sums assign:sumx];
-	[nth_product_of_sums add:sumy];
-	[nth_product_of_sums divideBy:n];
+	[self regressionStatistics:values];
 	
-	[sumy multiplyBy:sumy];
-	[sumy divideBy:n];
+	syy = [self centredSum:regressionSumYY of:regressionSumY and:regressionSumY];
+	[syy divideBy:[self centredSum:regressionSumXY of:regressionSumX and:regressionSumY]];
 	
-	[numerator assign:sum_of_products];
-	[numerator subtract:nth_product_of_sums];
-	[denominator assign:sumysquared];
-	[denominator subtract:sumy];
-	
-	[denominator divideBy:numerator];
-	
-	return denominator;
+	return syy;
 }
 
 //
@@ -670,26 +851,12 @@
 //
 - (id)mfromrankregressiononxwithoriginintercept:(NSMutableArray *)values
 {
-	BigCFloat *sumysquared = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sum_of_products = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *product = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	int			i;
+	BigCFloat *sumysquared;
 	
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sum_of_products add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2 + 1]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sumysquared add:product];
-	}
+	[self regressionStatistics:values];
 	
-	[sumysquared divideBy:sum_of_products];
+	sumysquared = (BigCFloat *)[regressionSumYY duplicate];
+	[sumysquared divideBy:regressionSumXY];
 	
 	return sumysquared;
 }
@@ -701,56 +868,14 @@
 //
 - (id)mfromrankregressionony:(NSMutableArray *)values
 {
-	BigCFloat *nth_product_of_sums = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumxsquared = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumx = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sumy = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sum_of_products = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *product = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *n = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:[dataManager getRadix]];
-	BigCFloat *numerator = [BigCFloat bigFloatWithInt:(int)[values count] radix:[dataManager getRadix]];
-	BigCFloat *denominator = [BigCFloat bigFloatWithInt:(int)[values count] radix:[dataManager getRadix]];
-	int			i;
+	BigCFloat *sxy;
 	
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sum_of_products add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2]];
-		[sumxsquared add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[sumx add:values[i * 2]];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[sumy add:values[i * 2 + 1]];
-	}
-	
-	[nth_product_of_sums assign:sumx];
-	[nth_product_of_sums multiplyBy:sumy];
-	[nth_product_of_sums divideBy:n];
+	[self regressionStatistics:values];
 	
-	[sumx multiplyBy:sumx];
-	[sumx divideBy:n];
+	sxy = [self centredSum:regressionSumXY of:regressionSumX and:regressionSumY];
+	[sxy divideBy:[self centredSum:regressionSumXX of:regressionSumX and:regressionSumX]];
 	
-	[numerator assign:sum_of_products];
-	[numerator subtract:nth_product_of_sums];
-	[denominator assign:sumxsquared];
-	[denominator subtract:sumx];
-	
-	[numerator divideBy:denominator];
-	
-	return numerator;
+	return sxy;
 }
 
 //
@@ -761,26 +886,12 @@
 //
 - (id)mfromrankregressiononywithoriginintercept:(NSMutableArray *)values
 {
-	BigCFloat *sumxsquared = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *sum_of_products = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	BigCFloat *product = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	int			i;
+	BigCFloat *sum_of_products;
 	
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2 + 1]];
-		[sum_of_products add:product];
-	}
-
-	for (i = 0; i < [values count] / 2; i++)
-	{
-		[product assign:values[i * 2]];
-		[product multiplyBy:values[i * 2]];
-		[sumxsquared add:product];
-	}
+	[self regressionStatistics:values];
 	
-	[sum_of_products divideBy:sumxsquared];
+	sum_of_products = (BigCFloat *)[regressionSumXY duplicate];
+	[sum_of_products divideBy:regressionSumXX];
 	
 	return sum_of_products;
 }
@@ -788,41 +899,169 @@
 //
 // mode
 //
-// Returns the mode commonly occuring value in the data set.
+// Returns the most commonly occuring value in the data set. Equal values are adjacent
+// in the sorted view, so this is one scan for the longest run (the smallest value wins
+// a tie).
 //
 - (id)mode:(NSMutableArray *)values
 {
-	int	*valueCounts = (int *)malloc(sizeof(int) * [values count]);
-	int	i, j;
-	int modeIndex;
+	NSArray		*sorted;
+	NSUInteger	i;
+	NSUInteger	runStart = 0;
+	NSUInteger	modeIndex = 0;
+	NSUInteger	modeLength = 0;
 	
 	if ([values count] == 0)
 	{
-		free(valueCounts);
 		return [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 	}
 	
-	for (i = 0; i < [values count]; i++)
+	sorted = [self sortedValues:values];
+	for (i = 1; i <= [sorted count]; i++)
 	{
-		valueCounts[i] = 0;
-		for (j = i; j < [values count]; j++)
+		if (i < [sorted count] && [sorted[i] compareWith:sorted[runStart]] == NSOrderedSame)
+			continue;
+		
+		if (i - runStart > modeLength)
 		{
-			if ([values[i] compareWith:values[j]] == NSOrderedSame)
-			{
-				valueCounts[i]++;
-			}
+			modeIndex = runStart;
+			modeLength = i - runStart;
 		}
+		runStart = i;
+	}
+	
+	return sorted[modeIndex];
+}
+
+//
+// multiplybystoredmatrix
+//
+// Replaces the array with the array times the matrix saved by storematrix.
+//
+- (id)multiplybystoredmatrix:(NSMutableArray *)values
+{
+	BigMatrix	*product;
+	int			num_rows, num_columns;
+	
+	if (storedMatrix == nil || [storedMatrix columns] == 0)
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"Choose Store Matrix on the second matrix before choosing Multiply by Stored Matrix"];
+		[alert runModal];
+		return nil;
+	}
+	
+	[self prepareArray:values outColumns:&num_columns outRows:&num_rows];
+	
+	if (num_columns != [storedMatrix rows])
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:[NSString stringWithFormat:@"Can only multiply by the stored matrix when the array has as many columns as the stored matrix has rows (%d)", [storedMatrix rows]]];
+		[alert runModal];
+		return nil;
 	}
 	
-	modeIndex = 0;
-	for (i = 1; i < [values count]; i++)
+	product = [[[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]] multiplyBy:storedMatrix];
+	[self replaceArray:values withMatrix:product];
+	
+	return nil;
+}
+
+//
+// percentile
+//
+// The value "fraction" (0 to 1) of the way through the sorted values, interpolating
+// linearly between neighbours.
+//
+- (BigCFloat *)percentile:(BigCFloat *)fraction ofSorted:(NSArray *)sorted
+{
+	BigCFloat	*position = [BigCFloat bigFloatWithInt:(int)[sorted count] - 1 radix:[dataManager getRadix]];
+	BigCFloat	*result;
+	BigCFloat	*step;
+	int			lower;
+	
+	[position multiplyBy:fraction];
+	lower = (int)[position doubleValue];
+	lower = MAX(0, MIN(lower, (int)[sorted count] - 1));
+	
+	result = (BigCFloat *)[sorted[lower] duplicate];
+	if (lower + 1 >= [sorted count])
+		return result;
+	
+	[position fractionalPart];
+	if ([position isZero])
+		return result;
+	
+	step = (BigCFloat *)[sorted[lower + 1] duplicate];
+	[step subtract:sorted[lower]];
+	[step multiplyBy:position];
+	[result add:step];
+	
+	return result;
+}
+
+//
+// percentile
+//
+// External version taking the percentage (0 to 100) from the current display value.
+//
+- (id)percentile:(NSMutableArray *)values
+{
+	BigCFloat *fraction = [[[dataManager getCurrentExpression] getValue] copy];
+	BigCFloat *hundred = [BigCFloat bigFloatWithInt:100 radix:[dataManager getRadix]];
+	
+	if
+	(
+		fraction == nil || ![fraction isValid] || [fraction hasImaginary] ||
+		[fraction isNegative] || [fraction compareWith:hundred] == NSOrderedDescending
+	)
 	{
-		if (valueCounts[i] > valueCounts[modeIndex])
-			modeIndex = i;
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"Enter the percentage (from 0 to 100) in the display before choosing Percentile"];
+		[alert runModal];
+		return nil;
 	}
 	
-	free(valueCounts);
-	return values[modeIndex];
+	[fraction divideBy:hundred];
+	return [self percentile:fraction ofSorted:[self sortedValues:values]];
+}
+
+//
+// percentile
+//
+// Helper for the fixed percentiles in the function table.
+//
+- (id)percentile:(int)percent ofValues:(NSMutableArray *)values
+{
+	BigCFloat *fraction = [BigCFloat bigFloatWithInt:percent radix:[dataManager getRadix]];
+	
+	if ([values count] == 0)
+	{
+		return [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
+	}
+	
+	[fraction divideBy:[BigCFloat bigFloatWithInt:100 radix:[dataManager getRadix]]];
+	return [self percentile:fraction ofSorted:[self sortedValues:values]];
+}
+
+//
+// percentile10
+//
+// The 10th percentile
+//
+- (id)percentile10:(NSMutableArray *)values
+{
+	return [self percentile:10 ofValues:values];
+}
+
+//
+// percentile90
+//
+// The 90th percentile
+//
+- (id)percentile90:(NSMutableArray *)values
+{
+	return [self percentile:90 ofValues:values];
 }
 
 //
@@ -836,9 +1075,10 @@
 	int numRows;
 	BigCFloat *zero = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 	
+	// Pad with separate zeros since the array functions modify values in place
 	while ([values count] % numColumns != 0)
 	{
-		[values addObject:zero];
+		[values addObject:[zero duplicate]];
 	}
 	numRows = (int)[values count] / numColumns;
 	
@@ -846,6 +1086,214 @@
 	*rows = numRows;
 }
 
+//
+// reduce
+//
+// Sums numSums quantities over values taken stride at a time. The groups are split into
+// fixed size chunks, each reduced on a worker thread into its own partial sums, and the
+// partials are then combined pairwise in a fixed tree order, so the result is the same
+// on any number of threads. Returns the numSums totals.
+//
++ (NSArray *)reduce:(NSArray *)values stride:(NSUInteger)stride sums:(int)numSums radix:(short)radix withStep:(DFReductionStep)step
+{
+	NSUInteger		numGroups = [values count] / stride;
+	NSUInteger		numChunks = (numGroups + DF_reduction_chunk_size - 1) / DF_reduction_chunk_size;
+	NSMutableArray	*partials = [NSMutableArray arrayWithCapacity:numChunks];
+	NSMutableArray	*scratch = [NSMutableArray arrayWithCapacity:numChunks];
+	NSUInteger		width;
+	NSUInteger		chunk;
+	int				i;
+	
+	if (numChunks == 0)
+		numChunks = 1;
+	
+	// Every chunk's accumulators are made up front so the workers only touch their own
+	for (chunk = 0; chunk < numChunks; chunk++)
+	{
+		NSMutableArray *sums = [NSMutableArray arrayWithCapacity:numSums];
+		for (i = 0; i < numSums; i++)
+		{
+			[sums addObject:[BigCFloat bigFloatWithInt:0 radix:radix]];
+		}
+		[partials addObject:sums];
+		[scratch addObject:[BigCFloat bigFloatWithInt:0 radix:radix]];
+	}
+	
+	dispatch_apply(numChunks, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t chunkIndex) {
+		NSArray		*sums = partials[chunkIndex];
+		BigCFloat	*temp = scratch[chunkIndex];
+		NSUInteger	group = chunkIndex * DF_reduction_chunk_size;
+		NSUInteger	end = MIN(group + DF_reduction_chunk_size, numGroups);
+		
+		for (; group < end; group++)
+		{
+			step(values, group * stride, sums, temp);
+		}
+	});
+	
+	for (width = 1; width < numChunks; width *= 2)
+	{
+		for (chunk = 0; chunk + width < numChunks; chunk += 2 * width)
+		{
+			for (i = 0; i < numSums; i++)
+			{
+				[(BigCFloat *)partials[chunk][i] add:partials[chunk + width][i]];
+			}
+		}
+	}
+	
+	return partials[0];
+}
+
+//
+// regressionStatistics
+//
+// Makes one (parallel) pass over the (x, y) pairs collecting n, the sums of x and y,
+// of their squares and of their products, from which every slope, intercept and correlation is
+// derived. The sums are kept until the 2D data changes (see data2DChanged) or the
+// radix does.
+//
+- (void)regressionStatistics:(NSMutableArray *)values
+{
+	short		radix = [dataManager getRadix];
+	NSArray		*sums;
+	
+	if (regressionSource == values && regressionRadix == radix)
+		return;
+	
+	sums = [DataFunctions reduce:values stride:2 sums:5 radix:radix withStep:^(NSArray *pairs, NSUInteger index, NSArray *partial, BigCFloat *scratch) {
+		BigCFloat *x = pairs[index];
+		BigCFloat *y = pairs[index + 1];
+		
+		[(BigCFloat *)partial[0] add:x];
+		[(BigCFloat *)partial[1] add:y];
+		[(BigCFloat *)partial[2] addProductOf:x and:x];
+		[(BigCFloat *)partial[3] addProductOf:y and:y];
+		[(BigCFloat *)partial[4] addProductOf:x and:y];
+	}];
+	
+	regressionCount = [BigCFloat bigFloatWithInt:(int)[values count] / 2 radix:radix];
+	regressionSumX = sums[0];
+	regressionSumY = sums[1];
+	regressionSumXX = sums[2];
+	regressionSumYY = sums[3];
+	regressionSumXY = sums[4];
+	
+	regressionSource = values;
+	regressionRadix = radix;
+}
+
+//
+// replaceArray
+//
+// Replaces the array values with the elements of matrix and lays the array drawer out
+// with the matrix's number of columns.
+//
+- (void)replaceArray:(NSMutableArray *)values withMatrix:(BigMatrix *)matrix
+{
+	int i, j;
+	
+	[values removeAllObjects];
+	for (i = 0; i < [matrix rows]; i++)
+	{
+		for (j = 0; j < [matrix columns]; j++)
+		{
+			[values addObject:[matrix elementAtRow:i column:j]];
+		}
+	}
+	
+	[drawerManager setNumberOfArrayColumns:[matrix columns]];
+}
+
+//
+// selectKth
+//
+// Introselect. Rearranges values so that the k-th smallest is at index k with nothing
+// larger before it and nothing smaller after it, and returns it. Quickselect with a
+// median of three pivot and three way partitioning (so runs of equal values cost
+// nothing), falling back to sorting the remaining range if partitioning keeps going
+// badly.
+//
+- (id)selectKth:(NSUInteger)k inValues:(NSMutableArray *)values
+{
+	NSUInteger	low = 0;
+	NSUInteger	high = [values count] - 1;
+	int			depthLimit = 2 * (int)log2((double)[values count] + 1);
+	
+	while (high > low)
+	{
+		NSUInteger	middle = low + (high - low) / 2;
+		NSUInteger	lessEnd, greaterStart, i;
+		id			pivot;
+		
+		if (depthLimit-- == 0)
+		{
+			NSRange			range = NSMakeRange(low, high - low + 1);
+			NSMutableArray	*rest = [[values subarrayWithRange:range] mutableCopy];
+			
+			[rest sortUsingSelector:@selector(compareWith:)];
+			[values replaceObjectsInRange:range withObjectsFromArray:rest];
+			break;
+		}
+		
+		// Median of the first, middle and last values
+		if ([values[middle] compareWith:values[low]] == NSOrderedAscending)
+			[values exchangeObjectAtIndex:middle withObjectAtIndex:low];
+		if ([values[high] compareWith:values[low]] == NSOrderedAscending)
+			[values exchangeObjectAtIndex:high withObjectAtIndex:low];
+		if ([values[high] compareWith:values[middle]] == NSOrderedAscending)
+			[values exchangeObjectAtIndex:high withObjectAtIndex:middle];
+		pivot = values[middle];
+		
+		// Partition into less than, equal to and greater than the pivot
+		lessEnd = low;
+		greaterStart = high + 1;
+		i = low;
+		while (i < greaterStart)
+		{
+			NSComparisonResult result = [values[i] compareWith:pivot];
+			
+			if (result == NSOrderedAscending)
+				[values exchangeObjectAtIndex:i++ withObjectAtIndex:lessEnd++];
+			else if (result == NSOrderedDescending)
+				[values exchangeObjectAtIndex:i withObjectAtIndex:--greaterStart];
+			else
+				i++;
+		}
+		
+		if (k < lessEnd)
+			high = lessEnd - 1;
+		else if (k >= greaterStart)
+			low = greaterStart;
+		else
+			return values[k];
+	}
+	
+	return values[k];
+}
+
+//
+// sortedValues
+//
+// The values in ascending order. The sorted view is kept until the data changes so
+// that the order statistics (mode, quartiles, percentiles, histogram) share one sort.
+//
+- (NSArray *)sortedValues:(NSArray *)values
+{
+	NSMutableArray *sorted;
+	
+	if (sortedSource != nil && [sortedSource isEqualToArray:values])
+		return sortedValues;
+	
+	sorted = [NSMutableArray arrayWithArray:values];
+	[sorted sortUsingSelector:@selector(compareWith:)];
+	
+	sortedSource = [values copy];
+	sortedValues = sorted;
+	
+	return sortedValues;
+}
+
 //
 // stddev
 //
@@ -860,61 +1308,121 @@
 	return variance;
 }
 
+//
+// storematrix
+//
+// Saves a copy of the array as the right hand side for multiplybystoredmatrix. The
+// array itself is left unchanged.
+//
+- (id)storematrix:(NSMutableArray *)values
+{
+	int num_rows, num_columns;
+	
+	[self prepareArray:values outColumns:&num_columns outRows:&num_rows];
+	
+	storedMatrix = [[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]];
+	
+	return nil;
+}
+
 //
 // sum
 //
-// Calculates the sum of all the values
+// Calculates the sum of all the values, from the running statistics for the data drawer
 //
 - (id)sum:(NSMutableArray *)values
 {
-	BigCFloat	*sum = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	int			i;
+	if ([dataManager hasStatisticsForData:values])
+		return [dataManager dataSum];
 	
-	for (i = 0; i < [values count]; i++)
-	{
-		[sum add:values[i]];
-	}
+	return [DataFunctions sumOf:values radix:[dataManager getRadix]];
+}
+
+//
+// sumOf
+//
+// The total of the values, reduced in parallel
+//
++ (BigCFloat *)sumOf:(NSArray *)values radix:(short)radix
+{
+	NSArray *sums = [DataFunctions reduce:values stride:1 sums:1 radix:radix withStep:^(NSArray *items, NSUInteger index, NSArray *partial, BigCFloat *scratch) {
+		[(BigCFloat *)partial[0] add:items[index]];
+	}];
 	
-	return sum;
+	return sums[0];
+}
+
+//
+// sumOfSquaredDeviations
+//
+// The sum of (x - mean)^2 over the values, reduced in parallel
+//
++ (BigCFloat *)sumOfSquaredDeviations:(NSArray *)values from:(BigCFloat *)mean radix:(short)radix
+{
+	NSArray *sums = [DataFunctions reduce:values stride:1 sums:1 radix:radix withStep:^(NSArray *items, NSUInteger index, NSArray *partial, BigCFloat *deviation) {
+		[deviation assign:items[index]];
+		[deviation subtract:mean];
+		[(BigCFloat *)partial[0] addProductOf:deviation and:deviation];
+	}];
+	
+	return sums[0];
+}
+
+//
+// transpose
+//
+// Replaces the array with its transpose.
+//
+- (id)transpose:(NSMutableArray *)values
+{
+	int num_rows, num_columns;
+	
+	[self prepareArray:values outColumns:&num_columns outRows:&num_rows];
+	
+	[self replaceArray:values withMatrix:[[[BigMatrix alloc] initWithArray:values rows:num_rows columns:num_columns radix:[dataManager getRadix]] transpose]];
+	
+	return nil;
+}
+
+//
+// upperquartile
+//
+// The 75th percentile
+//
+- (id)upperquartile:(NSMutableArray *)values
+{
+	return [self percentile:75 ofValues:values];
 }
 
 //
 // variance
 //
-// Calculates the variance of the values.
+// Calculates the variance of the values. For the data drawer this is the running
+// sum of squared deviations kept by the DataManager divided by n - 1.
 //
 - (id)variance:(NSMutableArray *)values
 {
 	BigCFloat	*mean;
+	BigCFloat	*deviations;
 	BigCFloat	*term1;
-	BigCFloat	*term2;
-	BigCFloat	*term3;
-	int			i;
 	
 	if ([values count] == 0 || [values count] == 1)
 	{
 		return [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
 	}
 	
+	if ([dataManager hasStatisticsForData:values])
+		return [dataManager dataVariance];
+	
 	mean = [self mean:values];
 	
 	term1 = [BigCFloat bigFloatWithInt:(int)[values count] - 1 radix:[dataManager getRadix]];
 	[term1 inverse];
 	
-	term3 = [BigCFloat bigFloatWithInt:0 radix:[dataManager getRadix]];
-	
-	for (i = 0; i < [values count]; i++)
-	{
-		term2 = (BigCFloat*)[values[i] duplicate];
-		[term2 subtract:mean];
-		[term2 multiplyBy:term2];
-		
-		[term3 add:term2];
-	}
-	
-	[term3 multiplyBy:term1];
+	deviations = [DataFunctions sumOfSquaredDeviations:values from:mean radix:[dataManager getRadix]];
+	[deviations multiplyBy:term1];
 	
-	return term3;
+	return deviations;
 }
 
 //
@@ -92,6 +92,14 @@
 	NSMutableArray				*dataArray;
 	NSMutableArray				*data2DArray;
 	NSMutableArray				*arrayDataArray;
+	
+	// Running statistics over dataArray (Welford's method)
+	int							dataStatisticsCount;
+	short						dataStatisticsRadix;
+	BigCFloat					*dataStatisticsSum;
+	BigCFloat					*dataStatisticsMean;
+	BigCFloat					*dataStatisticsM2;
+	
 	TreeHead					*currentExpression;
 	Expression					*currentInputPoint;
 }
@@ -104,8 +112,15 @@
 - (IBAction)clearHistory:(id)sender;
 - (NSMutableArray*)data;
 - (NSMutableArray*)data2D;
+- (BigCFloat*)dataMean;
+- (BigCFloat*)dataSum;
+- (void)dataValueAdded:(BigCFloat*)value;
+- (void)dataValueRemoved:(BigCFloat*)value;
+- (void)dataValuesChanged;
+- (BigCFloat*)dataVariance;
 - (void)ensureInputWithValue:(BOOL)preserveValue;
 - (void)equalsPressed;
+- (void)expressionEvaluated:(Expression*)tree;
 - (int)getComplement;
 - (Expression*)getCurrentExpression;
 - (BOOL)getEqualsPressed;
@@ -120,6 +135,7 @@
 - (BOOL)getThousandsSeparator;
 - (BOOL)getFractionSeparator;
 - (int)getTrigMode;
+- (BOOL)hasStatisticsForData:(NSArray*)values;
 - (History*)history;
 - (void)lengthLimit:(unsigned int)limit fillLimit:(BOOL)fill fixedPlaces:(unsigned int)places;
 - (void)optionIsPressed:(BOOL)isPressed;
@@ -161,6 +177,8 @@
 - (BOOL)getDefaultFractionSeparatorFromPref;
 - (void)setDefaultTrigMode:(int)mode;
 - (BFTrigMode)getDefaultTrigModeFromPref;
+- (unsigned int)getSlowExpressionThresholdFromPref;
+- (BOOL)getAdaptivePrecisionFromPref;
 
 // Update the view when the defaults have changed
 - (void)updateRadixDisplay;
@@ -14,6 +14,7 @@
 #import "ExpressionSymbols.h"
 #import "Value.h"
 #import "History.h"
+#import "DataFunctions.h"
 // #import "SYFlatButton.h"
 
 //
@@ -54,6 +55,9 @@
 
 	factoryDefaults[@"defaultTrigMode"] = @((int)BF_degrees);
 	
+	factoryDefaults[@"MNMSlowExpressionMilliseconds"] = @250;
+	factoryDefaults[@"MNMAdaptivePrecision"] = @YES;
+	
 	[[NSUserDefaults standardUserDefaults] registerDefaults: factoryDefaults];
 }
 
@@ -150,38 +154,46 @@
     return [[NSUserDefaults standardUserDefaults] boolForKey:@"useFractionSeparator"];
 }
 
-- (void)setHistoryData:(History *)historyData
-{
-	NSFileManager *fileManager = [NSFileManager defaultManager];
-	NSArray *paths = [fileManager URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask];
-	NSURL *file = [paths.firstObject URLByAppendingPathComponent:@"MagicNumberMachine" isDirectory:YES];
-	NSError *error;
-	[fileManager createDirectoryAtURL:file withIntermediateDirectories:YES attributes:nil error:&error];
-	file = [file URLByAppendingPathComponent:@"historyData.bin" isDirectory:NO];
-    NSData *fileData = [NSKeyedArchiver archivedDataWithRootObject:historyData requiringSecureCoding:NO error:nil];
-//    NSData *fileData = [NSKeyedArchiver archivedDataWithRootObject:historyData];
-//    printf("Saving history data. Number of items: %ld", historyData.count);
-    [fileData writeToURL:file atomically:YES];
-//    [fileData writeToURL:file error:&error];
-//    if (error) {
-//        NSLog(@"Write error: %@", error);
-//    }
-}
-
-
+//
+// getHistoryDataFromPref
+//
+// Opens the history log in the application support folder. A history saved by older
+// versions as a single keyed archive is moved into the log the first time through. The
+// old file is only deleted once every item has been written and flushed to the log; if
+// anything fails the log is emptied again, the old history is used from memory and the
+// move is retried at the next launch. An old file found next to a log that already has
+// items is left alone.
+//
 - (History *)getHistoryDataFromPref {
-	History *historyData = [[History alloc] init];
 	NSFileManager *fileManager = [NSFileManager defaultManager];
 	NSArray *paths = [fileManager URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask];
-	NSURL *file = [paths.firstObject URLByAppendingPathComponent:@"MagicNumberMachine" isDirectory:YES];
-	file = [file URLByAppendingPathComponent:@"historyData.bin" isDirectory:NO];
-	NSData *fileData = [NSData dataWithContentsOfURL:file];
+	NSURL *folder = [paths.firstObject URLByAppendingPathComponent:@"MagicNumberMachine" isDirectory:YES];
+	NSError *error;
+	[fileManager createDirectoryAtURL:folder withIntermediateDirectories:YES attributes:nil error:&error];
+	
+	History *historyData = [[History alloc] initWithLogAtURL:[folder URLByAppendingPathComponent:@"historyLog.bin" isDirectory:NO]];
+	
+	NSURL *legacyFile = [folder URLByAppendingPathComponent:@"historyData.bin" isDirectory:NO];
+	NSData *fileData = [NSData dataWithContentsOfURL:legacyFile];
 	if (fileData) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-//        historyData = [NSKeyedUnarchiver unarchivedObjectOfClass:History.class fromData:fileData error:nil];
-		historyData = [NSKeyedUnarchiver unarchiveTopLevelObjectWithData:fileData error:nil];
+		History *legacyData = [NSKeyedUnarchiver unarchiveTopLevelObjectWithData:fileData error:nil];
 #pragma GCC diagnostic pop
+		if (legacyData != nil && historyData.count == 0) {
+			BOOL moved = YES;
+			for (NSInteger i = 0; i < legacyData.count && moved; i++) {
+				NSData *item = [legacyData getItemAtIndex:i];
+				moved = [historyData addItem:item searchText:[[Expression expressionWithData:item] getExpressionString] ?: @"" value:NAN];
+			}
+			if (moved && [historyData synchronize]) {
+				[fileManager removeItemAtURL:legacyFile error:nil];
+			} else {
+				// Keep using the old history, in memory only, until the log can be written
+				[historyData clear];
+				historyData = legacyData;
+			}
+		}
 	}
 	return historyData;
 }
@@ -198,6 +210,29 @@
 	return (BFTrigMode)[[NSUserDefaults standardUserDefaults] integerForKey:@"defaultTrigMode"];
 }
 
+//
+// getSlowExpressionThresholdFromPref
+//
+// Evaluations taking at least this many milliseconds are written to the slow expression
+// log. Zero turns the log off. There is no UI for this; set it with "defaults write".
+//
+- (unsigned int)getSlowExpressionThresholdFromPref
+{
+	return (unsigned int)MAX([[NSUserDefaults standardUserDefaults] integerForKey:@"MNMSlowExpressionMilliseconds"], 0);
+}
+
+//
+// getAdaptivePrecisionFromPref
+//
+// Whether the displayed result is calculated at display precision (see Expression
+// getDisplayValue) rather than always at full precision. There is no UI for this; set
+// it with "defaults write".
+//
+- (BOOL)getAdaptivePrecisionFromPref
+{
+	return [[NSUserDefaults standardUserDefaults] boolForKey:@"MNMAdaptivePrecision"];
+}
+
 //
 // dennis
 //
@@ -240,10 +275,11 @@
 		arrayDataArray = [NSMutableArray arrayWithCapacity:0];
 		dataArray      = [NSMutableArray arrayWithCapacity:0];
 		data2DArray    = [NSMutableArray arrayWithCapacity:0];
+		[self dataValuesChanged];
 //		historyArray   = [NSMutableArray arrayWithCapacity:0];
 		
-		// Read a history array from user defaults
-		historyArray = [self getHistoryDataFromPref];
+		// The history log is opened the first time it's needed (see history)
+		historyArray = nil;
 	}
 	return self;
 }
@@ -379,6 +415,7 @@
 - (void)updateExpressionDisplay {
 	[currentExpression refresh];
 	[self valueChanged];
+	[drawerManager historyFormatChanged];
 }
 
 
@@ -485,8 +522,7 @@
 //
 - (IBAction)clearHistory:(id)sender
 {
-	historyArray = [[History alloc] init];
-	[self setHistoryData:historyArray];
+	[[self history] clear];
 	[drawerManager updateHistory];
 }
 
@@ -510,6 +546,127 @@
 	return data2DArray;
 }
 
+//
+// dataMean
+//
+// The mean of the data from the running statistics. Returns a new value that the
+// caller may modify.
+//
+- (BigCFloat*)dataMean
+{
+	BigCFloat	*mean = (BigCFloat*)[dataStatisticsSum duplicate];
+	
+	if (dataStatisticsCount > 0)
+		[mean divideBy:[BigCFloat bigFloatWithInt:dataStatisticsCount radix:dataStatisticsRadix]];
+	
+	return mean;
+}
+
+//
+// dataSum
+//
+// The sum of the data from the running statistics. Returns a new value that the
+// caller may modify.
+//
+- (BigCFloat*)dataSum
+{
+	return (BigCFloat*)[dataStatisticsSum duplicate];
+}
+
+//
+// dataValueAdded
+//
+// Folds a value appended to the data into the running statistics:
+//		mean += (x - mean) / n,  M2 += (x - old mean) * (x - new mean)
+//
+- (void)dataValueAdded:(BigCFloat*)value
+{
+	BigCFloat	*delta;
+	BigCFloat	*step;
+	
+	dataStatisticsCount++;
+	[dataStatisticsSum add:value];
+	
+	delta = (BigCFloat*)[value duplicate];
+	[delta subtract:dataStatisticsMean];
+	step = (BigCFloat*)[delta duplicate];
+	[step divideBy:[BigCFloat bigFloatWithInt:dataStatisticsCount radix:dataStatisticsRadix]];
+	[dataStatisticsMean add:step];
+	
+	step = (BigCFloat*)[value duplicate];
+	[step subtract:dataStatisticsMean];
+	[delta multiplyBy:step];
+	[dataStatisticsM2 add:delta];
+}
+
+//
+// dataValueRemoved
+//
+// Takes a value removed from the data back out of the running statistics. This is
+// dataValueAdded run backwards.
+//
+- (void)dataValueRemoved:(BigCFloat*)value
+{
+	BigCFloat	*delta;
+	BigCFloat	*step;
+	
+	if (dataStatisticsCount <= 1)
+	{
+		[self dataValuesChanged];
+		return;
+	}
+	
+	dataStatisticsCount--;
+	[dataStatisticsSum subtract:value];
+	
+	delta = (BigCFloat*)[value duplicate];
+	[delta subtract:dataStatisticsMean];
+	step = (BigCFloat*)[delta duplicate];
+	[step divideBy:[BigCFloat bigFloatWithInt:dataStatisticsCount radix:dataStatisticsRadix]];
+	[dataStatisticsMean subtract:step];
+	
+	step = (BigCFloat*)[value duplicate];
+	[step subtract:dataStatisticsMean];
+	[delta multiplyBy:step];
+	[dataStatisticsM2 subtract:delta];
+}
+
+//
+// dataValuesChanged
+//
+// Rebuilds the running statistics from scratch (two parallel passes: the sum, then the
+// squared deviations from the mean). Used when the data is cleared, when a value is
+// replaced and when the radix changes.
+//
+- (void)dataValuesChanged
+{
+	dataStatisticsCount = (int)[dataArray count];
+	dataStatisticsRadix = radix;
+	dataStatisticsSum = [DataFunctions sumOf:dataArray radix:radix];
+	dataStatisticsMean = (BigCFloat*)[dataStatisticsSum duplicate];
+	if (dataStatisticsCount > 0)
+		[dataStatisticsMean divideBy:[BigCFloat bigFloatWithInt:dataStatisticsCount radix:radix]];
+	dataStatisticsM2 = [DataFunctions sumOfSquaredDeviations:dataArray from:dataStatisticsMean radix:radix];
+}
+
+//
+// dataVariance
+//
+// The sample variance of the data from the running statistics. Returns a new value
+// that the caller may modify.
+//
+- (BigCFloat*)dataVariance
+{
+	BigCFloat	*variance = (BigCFloat*)[dataStatisticsM2 duplicate];
+	
+	if (dataStatisticsCount < 2)
+		return [BigCFloat bigFloatWithInt:0 radix:dataStatisticsRadix];
+	
+	[variance divideBy:[BigCFloat bigFloatWithInt:dataStatisticsCount - 1 radix:dataStatisticsRadix]];
+	
+	return variance;
+}
+
 //
 // ensureInputWithValue
 //
@@ -553,13 +710,52 @@
 	// Append the current expression to the history
 	if ([currentExpression child] != nil)
 	{
-		[historyArray addItem:[NSKeyedArchiver archivedDataWithRootObject:[currentExpression child] requiringSecureCoding:NO error:nil]
-			   withBezierPath:[expressionDisplay expressionPathFlipped]];
-		[self setHistoryData:historyArray];   // save the data to user preferences
+		BigCFloat	*result = [currentExpression getDisplayValue];
+		NSString	*searchText = [NSString stringWithFormat:@"%@ = %@", [[currentExpression child] getExpressionString], [result toShortString:12]];
+		
+		[[self history] addItem:[[currentExpression child] encodedData] searchText:searchText value:[result isValid] ? [result doubleValue] : NAN];
 		[drawerManager updateHistory];
 	}
 }
 
+//
+// expressionEvaluated
+//
+// Called by the head of the expression tree each time it is calculated. If the
+// calculation was slow, the expression, the settings it was calculated with and its
+// profile are appended to slowExpressions.log in the application support folder.
+//
+- (void)expressionEvaluated:(Expression*)tree
+{
+	unsigned int	threshold = [self getSlowExpressionThresholdFromPref];
+	double			milliseconds = [tree profileTime] / 1.0e6;
+	
+	if (threshold == 0 || milliseconds < threshold)
+		return;
+	
+	NSFileManager *fileManager = [NSFileManager defaultManager];
+	NSArray *paths = [fileManager URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask];
+	NSURL *folder = [paths.firstObject URLByAppendingPathComponent:@"MagicNumberMachine" isDirectory:YES];
+	NSURL *logFile = [folder URLByAppendingPathComponent:@"slowExpressions.log" isDirectory:NO];
+	[fileManager createDirectoryAtURL:folder withIntermediateDirectories:YES attributes:nil error:nil];
+	
+	NSMutableString *entry = [NSMutableString string];
+	[entry appendFormat:@"%@  %.3f ms\n", [NSDate date], milliseconds];
+	[entry appendFormat:@"expression: %@\n", [tree getExpressionString]];
+	[entry appendFormat:@"radix: %d  trig mode: %@  precision: %u digits (%d limbs)\n",
+		[self getRadix], [self getTrigStringForMode:(BFTrigMode)[self getTrigMode]], [self getLengthLimit], BF_num_values];
+	[entry appendString:[tree profileReport]];
+	[entry appendString:@"\n"];
+	
+	if (![fileManager fileExistsAtPath:logFile.path])
+		[fileManager createFileAtPath:logFile.path contents:nil attributes:nil];
+	
+	NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:logFile error:nil];
+	[handle seekToEndOfFile];
+	[handle writeData:[entry dataUsingEncoding:NSUTF8StringEncoding]];
+	[handle closeFile];
+}
+
 //
 // getComplement
 //
@@ -697,13 +893,35 @@
 	return trigMode;
 }
 
+//
+// hasStatisticsForData
+//
+// Whether the running statistics describe the given values, which is only the case
+// for the data array itself. Statistics gathered in another radix are rebuilt first.
+//
+- (BOOL)hasStatisticsForData:(NSArray*)values
+{
+	if (values != dataArray)
+		return NO;
+	
+	if (dataStatisticsRadix != radix)
+		[self dataValuesChanged];
+	
+	NSAssert(dataStatisticsCount == [dataArray count], @"Data statistics out of step with the data");
+	
+	return YES;
+}
+
 //
 // history
 //
-// Allows access to the history array.
+// Allows access to the history array. The log (and any legacy history it takes over)
+// is opened on first use rather than at launch.
 //
 - (History *)history
 {
+	if (historyArray == nil)
+		historyArray = [self getHistoryDataFromPref];
 	return historyArray;
 }
 
@@ -63,6 +63,10 @@
 	NSArray					*dataFunctionRows;
 	NSArray					*data2DFunctionRows;
 	HistoryCell				*historyCell;
+	NSMutableDictionary		*historyPaths;
+	NSMutableArray			*historyPathOrder;
+	NSSearchField			*historySearchField;
+	NSMutableData			*historyMatches;		// history rows shown while searching (NSUInteger), or nil
 	int						numArrayColumns;
 }
 - (instancetype)init NS_DESIGNATED_INITIALIZER;
@@ -82,9 +86,19 @@
 - (IBAction)clearDataValue:(id)sender;
 - (IBAction)constantSelected:(id)sender;
 - (IBAction)copyDataValueToDisplay:(id)sender;
+- (IBAction)exportData:(id)sender;
+- (void)exportValues:(NSArray *)values columns:(NSUInteger)columns toURL:(NSURL *)url;
+- (BOOL)getOpenDataValues:(NSMutableArray **)values columns:(NSUInteger *)columns;
 - (IBAction)historySelected:(id)sender;
+- (IBAction)historySearchChanged:(id)sender;
+- (NSInteger)historyIndexForRow:(NSInteger)row;
+- (IBAction)importData:(id)sender;
+- (void)importValuesFromURL:(NSURL *)url into:(NSMutableArray *)values;
 @property (NS_NONATOMIC_IOSONLY, readonly) int numberOfArrayColumns;
 - (int)numberOfRowsInTableView:(NSTableView *)aTableView;
+- (NSString *)parseValuesFromURL:(NSURL *)url radix:(unsigned short)radix into:(NSMutableArray *)imported fields:(NSUInteger *)outFields;
+- (void)replaceValues:(NSMutableArray *)values withImported:(NSMutableArray *)imported fields:(NSUInteger)fields error:(NSString *)error fromURL:(NSURL *)url;
+- (void)setNumberOfArrayColumns:(int)columns;
 - (void)setStartupState;
 - (id)tableView:(NSTableView*)aTableView objectValueForTableColumn:(NSTableColumn*)aTableColumn row:(int)rowIndex;
 - (IBAction)toggleDrawer:(id)sender;
@@ -92,5 +106,7 @@
 - (void)updateData2DArray;
 - (void)updateDataArray;
 - (void)updateHistory;
+- (void)historyFormatChanged;
+- (NSBezierPath *)historyPathForData:(NSData *)data;
 
 @end
@@ -18,6 +18,9 @@
 
 @class MainWindow;
 
+// Laid out history rows kept for redrawing (about a few screens' worth)
+#define DM_history_path_capacity	64
+
 //
 // About the DrawerManager
 //
@@ -32,6 +35,141 @@
 // The actual data kept in the "Data" drawers is owned by the DataManager class.
 //
 
+// Imported files are split into pieces of about this many bytes (at line breaks) that
+// are parsed in parallel
+#define DM_import_chunk_size	(1 << 20)
+
+// Exported text is written out whenever this much has been formatted
+#define DM_export_buffer_size	(1 << 16)
+
+//
+// DM_IsSeparator
+//
+// Fields in an imported file may be separated by commas, semicolons or white space
+//
+static BOOL DM_IsSeparator(char c)
+{
+	return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+//
+// DM_IsNumber
+//
+// Checks a real number (mantissa with optional sign and point, optional exponent after
+// an 'e' in decimal or a 'p' in other radices) before it is handed to BigFloat, whose
+// string parser stops quietly at the first character it doesn't understand.
+//
+static BOOL DM_IsNumber(NSString *string, unsigned short radix)
+{
+	unichar		separator = (radix == 10) ? 'E' : 'P';
+	NSUInteger	i = 0;
+	NSUInteger	length = [string length];
+	BOOL		mantissaDigits = NO;
+	BOOL		exponentDigits = NO;
+	
+	#define DM_IS_DIGIT(c)	((((c) >= '0' && (c) <= '9') ? (c) - '0' : ((c) >= 'A' && (c) <= 'Z') ? (c) - 'A' + 10 : radix) < radix)
+	
+	if (i < length && ([string characterAtIndex:i] == '+' || [string characterAtIndex:i] == '-')) i++;
+	for (; i < length && DM_IS_DIGIT([string characterAtIndex:i]); i++) mantissaDigits = YES;
+	if (i < length && [string characterAtIndex:i] == '.') i++;
+	for (; i < length && DM_IS_DIGIT([string characterAtIndex:i]); i++) mantissaDigits = YES;
+	if (!mantissaDigits) return NO;
+	if (i == length) return YES;
+	
+	if ([string characterAtIndex:i] != separator) return NO;
+	i++;
+	if (i < length && ([string characterAtIndex:i] == '+' || [string characterAtIndex:i] == '-')) i++;
+	for (; i < length && DM_IS_DIGIT([string characterAtIndex:i]); i++) exponentDigits = YES;
+	
+	#undef DM_IS_DIGIT
+	
+	return exponentDigits && i == length;
+}
+
+//
+// DM_ParseField
+//
+// Converts one imported field to a BigCFloat at the given radix, or returns nil if it
+// isn't a number. Complex values are written a+bi (or bi).
+//
+static BigCFloat *DM_ParseField(const char *bytes, NSUInteger length, unsigned short radix)
+{
+	NSString	*field;
+	NSString	*real = @"0";
+	NSString	*imaginary = nil;
+	unichar		separator = (radix == 10) ? 'E' : 'P';
+	NSUInteger	split;
+	
+	if (length >= 2 && bytes[0] == '"' && bytes[length - 1] == '"')
+	{
+		bytes++;
+		length -= 2;
+	}
+	field = [[NSString alloc] initWithBytes:bytes length:length encoding:NSASCIIStringEncoding];
+	if ([field length] == 0)
+		return nil;
+	
+	if ([field hasSuffix:@"i"])
+	{
+		field = [field substringToIndex:[field length] - 1];
+		
+		// The imaginary part starts at the last sign that isn't leading an exponent
+		for (split = [field length]; split > 0; split--)
+		{
+			unichar c = [field characterAtIndex:split - 1];
+			if ((c == '+' || c == '-') && (split == 1 || toupper([field characterAtIndex:split - 2]) != separator))
+				break;
+		}
+		split = (split > 0) ? split - 1 : 0;
+		
+		imaginary = [field substringFromIndex:split];
+		if (split > 0)
+			real = [[field substringToIndex:split] uppercaseString];
+		if ([imaginary isEqualToString:@""] || [imaginary isEqualToString:@"+"] || [imaginary isEqualToString:@"-"])
+			imaginary = [imaginary stringByAppendingString:@"1"];
+		imaginary = [imaginary uppercaseString];
+		
+		if (!DM_IsNumber(real, radix) || !DM_IsNumber(imaginary, radix))
+			return nil;
+		
+		return [BigCFloat bigFloatWithReal:[BigFloat bigFloatWithString:real radix:radix]
+								 imaginary:[BigFloat bigFloatWithString:imaginary radix:radix]];
+	}
+	
+	real = [field uppercaseString];
+	if (!DM_IsNumber(real, radix))
+		return nil;
+	
+	return [BigCFloat bigFloatWithString:real radix:radix];
+}
+
+//
+// DM_FieldForValue
+//
+// Formats a value for export in the form DM_ParseField reads back
+//
+static NSString *DM_FieldForValue(BigCFloat *value, unsigned short radix)
+{
+	NSString	*separator = (radix == 10) ? @"e" : @"p";
+	NSString	*field = [value mantissaString];
+	NSString	*imaginary;
+	
+	if ([value hasExponent])
+		field = [NSString stringWithFormat:@"%@%@%@", field, separator, [value exponentString]];
+	
+	if ([value hasImaginary])
+	{
+		imaginary = [value imaginaryMantissaString];
+		if (![imaginary hasPrefix:@"-"])
+			imaginary = [@"+" stringByAppendingString:imaginary];
+		if ([[value imaginaryPart] hasExponent])
+			imaginary = [NSString stringWithFormat:@"%@%@%@", imaginary, separator, [value imaginaryExponentString]];
+		field = [NSString stringWithFormat:@"%@%@i", field, imaginary];
+	}
+	
+	return field;
+}
+
 @implementation DrawerManager
 
 //
@@ -49,17 +187,30 @@
 		numArrayColumns = 3;
 		
 		historyCell = [[HistoryCell alloc] init];
+		historyPaths = [NSMutableDictionary dictionaryWithCapacity:DM_history_path_capacity];
+		historyPathOrder = [NSMutableArray arrayWithCapacity:DM_history_path_capacity];
 		
 		arrayDataFunctionRows =
 			@[@[@"Gaussian Elimination", [NSValue value:&@selector(gaussianelimination:) withObjCType:@encode(SEL)]],
 				@[@"Gaussian Elimination w/ Backsub", [NSValue value:&@selector(gaussianeliminationwithbacksub:) withObjCType:@encode(SEL)]],
 				@[@"Determinant", [NSValue value:&@selector(determinant:) withObjCType:@encode(SEL)]],
-				@[@"Inverse", [NSValue value:&@selector(inverse:) withObjCType:@encode(SEL)]]];
+				@[@"Inverse", [NSValue value:&@selector(inverse:) withObjCType:@encode(SEL)]],
+				@[@"Transpose", [NSValue value:&@selector(transpose:) withObjCType:@encode(SEL)]],
+				@[@"Power (display value)", [NSValue value:&@selector(matrixpower:) withObjCType:@encode(SEL)]],
+				@[@"Store Matrix", [NSValue value:&@selector(storematrix:) withObjCType:@encode(SEL)]],
+				@[@"Multiply by Stored Matrix", [NSValue value:&@selector(multiplybystoredmatrix:) withObjCType:@encode(SEL)]]];
 		dataFunctionRows =
 			@[@[@"Sum", [NSValue value:&@selector(sum:) withObjCType:@encode(SEL)]],
 				@[@"Mean (Average)", [NSValue value:&@selector(mean:) withObjCType:@encode(SEL)]],
 				@[@"Mode (Most Frequent)", [NSValue value:&@selector(mode:) withObjCType:@encode(SEL)]],
 				@[@"Median (Middle value)", [NSValue value:&@selector(median:) withObjCType:@encode(SEL)]],
+				@[@"Lower Quartile (25th percentile)", [NSValue value:&@selector(lowerquartile:) withObjCType:@encode(SEL)]],
+				@[@"Upper Quartile (75th percentile)", [NSValue value:&@selector(upperquartile:) withObjCType:@encode(SEL)]],
+				@[@"Interquartile Range", [NSValue value:&@selector(interquartilerange:) withObjCType:@encode(SEL)]],
+				@[@"10th Percentile", [NSValue value:&@selector(percentile10:) withObjCType:@encode(SEL)]],
+				@[@"90th Percentile", [NSValue value:&@selector(percentile90:) withObjCType:@encode(SEL)]],
+				@[@"Percentile (display value %)", [NSValue value:&@selector(percentile:) withObjCType:@encode(SEL)]],
+				@[@"Histogram (into 2D Data)", [NSValue value:&@selector(histogram:) withObjCType:@encode(SEL)]],
 				@[@"Variance", [NSValue value:&@selector(variance:) withObjCType:@encode(SEL)]],
 				@[@"Standard Deviation", [NSValue value:&@selector(stddev:) withObjCType:@encode(SEL)]],
 				@[@"Coefficient of Variation", [NSValue value:&@selector(coefofvariation:) withObjCType:@encode(SEL)]]];
@@ -69,9 +220,10 @@
 				@[@"a (x-intercept, Rank regression on y)", [NSValue value:&@selector(afromrankregressionony:) withObjCType:@encode(SEL)]],
 				@[@"m (slope, Rank regression on x)", [NSValue value:&@selector(mfromrankregressiononx:) withObjCType:@encode(SEL)]],
 				@[@"b (y-intercept, Rank regression on x)", [NSValue value:&@selector(bfromrankregressiononx:) withObjCType:@encode(SEL)]],
-				@[@"a (x-intercept, Rank regression on x)", [NSValue value:&@selector(bfromrankregressiononx:) withObjCType:@encode(SEL)]],
+				@[@"a (x-intercept, Rank regression on x)", [NSValue value:&@selector(afromrankregressiononx:) withObjCType:@encode(SEL)]],
 				@[@"m (slope, regression on y, intercept at origin)", [NSValue value:&@selector(mfromrankregressiononywithoriginintercept:) withObjCType:@encode(SEL)]],
-				@[@"m (slope, regression on x, intercept at origin)", [NSValue value:&@selector(mfromrankregressiononxwithoriginintercept:) withObjCType:@encode(SEL)]]];
+				@[@"m (slope, regression on x, intercept at origin)", [NSValue value:&@selector(mfromrankregressiononxwithoriginintercept:) withObjCType:@encode(SEL)]],
+				@[@"r (correlation coefficient)", [NSValue value:&@selector(correlation:) withObjCType:@encode(SEL)]]];
 		
 		radixDataRows = @[
 			@[@2, @"Binary", @0],
@@ -119,11 +271,13 @@
 		[dataTableView selectedRow] > [[dataManager data] count])
 	{
 		[[dataManager data] addObject:value];
+		[dataManager dataValueAdded:value];
 		[self updateDataArray];
 		return;
 	}
 	
 	[dataManager data][[dataTableView selectedRow]] = value;
+	[dataManager dataValuesChanged];
 	[self updateDataArray];
 }
 
@@ -135,6 +289,7 @@
 - (void)addData2D:(BigCFloat*)value
 {
 	[[dataManager data2D] addObject:value];
+	[dataFunctions data2DChanged];
 	[self updateData2DArray];
 	return;
 }
@@ -145,10 +300,20 @@
 // Changes the number of columns in the array data.
 //
 - (IBAction)arrayColumnsChanged:(id)sender
+{
+	[self setNumberOfArrayColumns:[sender intValue]];
+}
+
+//
+// setNumberOfArrayColumns
+//
+// Lays the array data table out with the given number of columns.
+//
+- (void)setNumberOfArrayColumns:(int)columns
 {
 	NSTableColumn	*column;
 
-	numArrayColumns = [sender intValue];
+	numArrayColumns = columns;
 	
 	while ([arrayDataTableView numberOfColumns] > numArrayColumns)
 	{
@@ -253,6 +418,10 @@
 		[[dataManager getInputPoint] valueInserted:result];
 		[dataManager valueChanged];
 	}
+	else
+	{
+		[self updateData2DArray];
+	}
 }
 
 //
@@ -285,6 +454,7 @@
 - (IBAction)clearAllData2DValues:(id)sender
 {
 	[[dataManager data2D] removeAllObjects];
+	[dataFunctions data2DChanged];
 	[self updateData2DArray];
 }
 
@@ -296,6 +466,7 @@
 - (IBAction)clearAllDataValues:(id)sender
 {
 	[[dataManager data] removeAllObjects];
+	[dataManager dataValuesChanged];
 	[self updateDataArray];
 }
 
@@ -335,6 +506,7 @@
 	[[dataManager data2D] removeObjectAtIndex:[data2DTableView selectedRow] * 2];
 	if ([data2DTableView selectedRow] * 2 < [[dataManager data2D] count])
 		[[dataManager data2D] removeObjectAtIndex:[data2DTableView selectedRow] * 2];
+	[dataFunctions data2DChanged];
 	[self updateData2DArray];
 }
 
@@ -345,7 +517,13 @@
 //
 - (IBAction)clearDataValue:(id)sender
 {
+	BigCFloat	*value;
+	
+	if ([dataTableView selectedRow] == -1) { return; }
+	
+	value = [dataManager data][[dataTableView selectedRow]];
 	[[dataManager data] removeObjectAtIndex:[dataTableView selectedRow]];
+	[dataManager dataValueRemoved:value];
 	[self updateDataArray];
 }
 
@@ -384,8 +562,110 @@
 	[dataManager valueChanged];
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+//
+// exportData
+//
+// Writes the values in the open data drawer to a comma separated text file: one value
+// per line for the data, x,y pairs for the 2D data and one row per line for the array
+// data.
+//
+- (IBAction)exportData:(id)sender
+{
+	NSMutableArray	*values;
+	NSUInteger		columns;
+	NSSavePanel		*savePanel;
+	
+	if (![self getOpenDataValues:&values columns:&columns])
+		return;
+	
+	savePanel = [NSSavePanel savePanel];
+	[savePanel setNameFieldStringValue:@"Data.csv"];
+	[savePanel beginSheetModalForWindow:[dataManager window] completionHandler:^(NSInteger result) {
+		if (result == NSModalResponseOK)
+		{
+			NSURL *filename = [savePanel URL];
+			if (filename.pathExtension.length == 0) { filename = [filename URLByAppendingPathExtension:@"csv"]; }
+			[self exportValues:values columns:columns toURL:filename];
+		}
+	}];
+}
+
+//
+// exportValues
+//
+// Streams the values to a file, columns fields to a line, writing out a buffer at a
+// time rather than building the whole text in memory.
+//
+- (void)exportValues:(NSArray *)values columns:(NSUInteger)columns toURL:(NSURL *)url
+{
+	NSFileHandle	*handle = nil;
+	NSMutableData	*buffer = [NSMutableData dataWithCapacity:DM_export_buffer_size];
+	unsigned short	radix = [dataManager getRadix];
+	NSUInteger		i;
+	
+	if ([[NSData data] writeToURL:url options:NSDataWritingAtomic error:nil])
+		handle = [NSFileHandle fileHandleForWritingToURL:url error:nil];
+	if (handle == nil)
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:[NSString stringWithFormat:@"Unable to write to \"%@\"", [url lastPathComponent]]];
+		[alert runModal];
+		return;
+	}
+	
+	for (i = 0; i < [values count]; i++)
+	{
+		NSString *field = DM_FieldForValue(values[i], radix);
+		
+		[buffer appendData:[field dataUsingEncoding:NSASCIIStringEncoding]];
+		[buffer appendBytes:((i + 1) % columns == 0 || i + 1 == [values count]) ? "\n" : "," length:1];
+		
+		if ([buffer length] >= DM_export_buffer_size)
+		{
+			[handle writeData:buffer];
+			[buffer setLength:0];
+		}
+	}
+	[handle writeData:buffer];
+	[handle closeFile];
+}
+
+//
+// getOpenDataValues
+//
+// Finds the values (and the number of fields per line) of the data drawer currently
+// shown. Returns NO, after telling the user, if no data drawer is open.
+//
+- (BOOL)getOpenDataValues:(NSMutableArray **)values columns:(NSUInteger *)columns
+{
+	NSString *identifier = [[drawerTabView selectedTabViewItem] identifier];
+	
+	if ([identifier isEqual:@"Data"])
+	{
+		*values = [dataManager data];
+		*columns = 1;
+	}
+	else if ([identifier isEqual:@"Data 2D"])
+	{
+		*values = [dataManager data2D];
+		*columns = 2;
+	}
+	else if ([identifier isEqual:@"Data Array"])
+	{
+		*values = [dataManager arrayData];
+		*columns = numArrayColumns;
+	}
+	else
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:@"Open the Data, 2D Data or Array Data drawer to import or export its values"];
+		[alert runModal];
+		return NO;
+	}
+	
+	return YES;
+}
+
 //
 // historySelected
 //
@@ -398,9 +678,10 @@
 	
 	if ([sender clickedRow] == -1) return;
 	
-	NSArray *item = [dataManager.history getItemAtIndex:[sender clickedRow]];
-//	pasteExpression = [NSKeyedUnarchiver unarchivedObjectOfClass:History.class fromData:item[0] error:nil];
-    pasteExpression = [NSKeyedUnarchiver unarchiveObjectWithData:item[0]];
+	NSData *item = [dataManager.history getItemAtIndex:[self historyIndexForRow:[sender clickedRow]]];
+	if (item == nil) return;
+	pasteExpression = [Expression expressionWithData:item];
+	if (pasteExpression == nil) return;
 	[dataManager ensureInputWithValue:NO];
 //	inputPoint = [dataManager getInputPoint];
 //	[inputPoint bracketPressed];
@@ -410,7 +691,213 @@
 //	[inputPoint closeBracketPressed];
 	[dataManager valueChanged];
 }
-#pragma GCC diagnostic pop
+
+//
+// importData
+//
+// Replaces the values in the open data drawer with the numbers in a comma or white
+// space separated text file, read at the current radix.
+//
+- (IBAction)importData:(id)sender
+{
+	NSMutableArray	*values;
+	NSUInteger		columns;
+	NSOpenPanel		*openPanel;
+	
+	if (![self getOpenDataValues:&values columns:&columns])
+		return;
+	
+	openPanel = [NSOpenPanel openPanel];
+	[openPanel setAllowsMultipleSelection:NO];
+	[openPanel setCanChooseDirectories:NO];
+	[openPanel beginSheetModalForWindow:[dataManager window] completionHandler:^(NSInteger result) {
+		if (result == NSModalResponseOK)
+		{
+			[self importValuesFromURL:[openPanel URL] into:values];
+		}
+	}];
+}
+
+//
+// importValuesFromURL
+//
+// The file is read and parsed on a background queue so that a large file doesn't stall
+// the interface; the drawer's values are then replaced in one go, with one table reload,
+// back on the main queue. Nothing changes if the file can't be read or holds no values.
+//
+- (void)importValuesFromURL:(NSURL *)url into:(NSMutableArray *)values
+{
+	unsigned short	radix = [dataManager getRadix];
+	
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+		NSMutableArray	*imported = [NSMutableArray array];
+		NSUInteger		fields = 0;
+		NSString		*error = [self parseValuesFromURL:url radix:radix into:imported fields:&fields];
+		
+		dispatch_async(dispatch_get_main_queue(), ^{
+			[self replaceValues:values withImported:imported fields:fields error:error fromURL:url];
+		});
+	});
+}
+
+//
+// parseValuesFromURL
+//
+// The file is memory mapped and cut at line breaks into pieces which are parsed on
+// separate threads, then the pieces are joined in order into imported. A first line that
+// isn't all numbers is taken to be column headings and skipped. Returns a message for
+// the user, and leaves imported empty, if the file can't be read or any other field
+// isn't a number. Safe to call from any thread.
+//
+- (NSString *)parseValuesFromURL:(NSURL *)url radix:(unsigned short)radix into:(NSMutableArray *)imported fields:(NSUInteger *)outFields
+{
+	NSData			*file = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedAlways error:nil];
+	const char		*bytes = [file bytes];
+	NSUInteger		length = [file length];
+	NSMutableArray	*chunkValues = [NSMutableArray array];
+	NSMutableArray	*chunkErrors = [NSMutableArray array];
+	NSMutableData	*chunkStarts = [NSMutableData data];
+	NSMutableData	*chunkLines;
+	NSUInteger		numChunks;
+	NSUInteger		dataStart = 0;
+	NSUInteger		firstLine = 1;
+	NSUInteger		fields = 0;
+	NSUInteger		start;
+	NSUInteger		i;
+	
+	if (file == nil)
+		return [NSString stringWithFormat:@"Unable to read \"%@\"", [url lastPathComponent]];
+	
+	// Look at the first line for headings and for the number of fields in a row
+	for (i = 0; i <= length; i++)
+	{
+		if (i == length || bytes[i] == '\n')
+		{
+			if (fields > 0 || i == length)
+				break;
+			firstLine++;
+			dataStart = i + 1;
+			continue;
+		}
+		if (DM_IsSeparator(bytes[i]))
+			continue;
+		
+		start = i;
+		while (i < length && !DM_IsSeparator(bytes[i])) i++;
+		if (DM_ParseField(bytes + start, i - start, radix) == nil)
+		{
+			// Headings: skip the line and count the fields on the next one instead
+			while (i < length && bytes[i] != '\n') i++;
+			firstLine++;
+			dataStart = i + 1;
+			fields = 0;
+			for (i = dataStart; i < length && bytes[i] != '\n'; i++)
+			{
+				if (!DM_IsSeparator(bytes[i]) && (i == dataStart || DM_IsSeparator(bytes[i - 1])))
+					fields++;
+			}
+			break;
+		}
+		fields++;
+		i--;
+	}
+	
+	// Cut the rest of the file at line breaks into similar sized pieces
+	for (start = MIN(dataStart, length); start < length; )
+	{
+		[chunkStarts appendBytes:&start length:sizeof(start)];
+		[chunkValues addObject:[NSMutableArray array]];
+		[chunkErrors addObject:[NSMutableString string]];
+		start += DM_import_chunk_size;
+		while (start < length && bytes[start - 1] != '\n') start++;
+	}
+	numChunks = [chunkValues count];
+	[chunkStarts appendBytes:&length length:sizeof(length)];
+	chunkLines = [NSMutableData dataWithLength:numChunks * sizeof(NSUInteger)];
+	
+	const NSUInteger	*starts = [chunkStarts bytes];
+	NSUInteger			*lines = [chunkLines mutableBytes];
+	
+	dispatch_apply(numChunks, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t chunk) {
+		NSMutableArray	*parsed = chunkValues[chunk];
+		NSUInteger		end = starts[chunk + 1];
+		NSUInteger		index = starts[chunk];
+		NSUInteger		fieldStart;
+		BigCFloat		*value;
+		
+		while (index < end)
+		{
+			if (bytes[index] == '\n')
+				lines[chunk]++;
+			if (DM_IsSeparator(bytes[index]))
+			{
+				index++;
+				continue;
+			}
+			
+			fieldStart = index;
+			while (index < end && !DM_IsSeparator(bytes[index])) index++;
+			value = DM_ParseField(bytes + fieldStart, index - fieldStart, radix);
+			if (value == nil)
+			{
+				[chunkErrors[chunk] setString:[[NSString alloc] initWithBytes:bytes + fieldStart length:index - fieldStart encoding:NSASCIIStringEncoding] ?: @"?"];
+				break;
+			}
+			[parsed addObject:value];
+		}
+	});
+	
+	for (i = 0; i < numChunks; i++)
+	{
+		if ([chunkErrors[i] length] > 0)
+		{
+			[imported removeAllObjects];
+			return [NSString stringWithFormat:@"Line %lu: \"%@\" is not a number in the current radix", (unsigned long)(firstLine + lines[i]), chunkErrors[i]];
+		}
+		firstLine += lines[i];
+		[imported addObjectsFromArray:chunkValues[i]];
+	}
+	*outFields = fields;
+	
+	return nil;
+}
+
+//
+// replaceValues
+//
+// Finishes an import on the main queue: tells the user why nothing was imported, or
+// replaces the drawer's values with the imported ones and reloads its table.
+//
+- (void)replaceValues:(NSMutableArray *)values withImported:(NSMutableArray *)imported fields:(NSUInteger)fields error:(NSString *)error fromURL:(NSURL *)url
+{
+	if (error == nil && [imported count] == 0)
+		error = [NSString stringWithFormat:@"\"%@\" holds no values, so nothing was imported", [url lastPathComponent]];
+	if (error == nil && values == [dataManager data2D] && [imported count] % 2 != 0)
+		error = @"The 2D data needs x, y pairs but the file holds an odd number of values";
+	if (error != nil)
+	{
+		NSAlert *alert = [[NSAlert alloc] init];
+		[alert setMessageText:error];
+		[alert runModal];
+		return;
+	}
+	
+	[values setArray:imported];
+	if (values == [dataManager data])
+	{
+		[dataManager dataValuesChanged];
+		[self updateDataArray];
+	}
+	else if (values == [dataManager data2D])
+	{
+		[dataFunctions data2DChanged];
+		[self updateData2DArray];
+	}
+	else
+	{
+		[self setNumberOfArrayColumns:fields > 0 ? (int)fields : numArrayColumns];
+	}
+}
 
 //
 // numberOfArrayColumns
@@ -459,6 +946,8 @@
 	}
 	else if ([aTableView isEqualTo:historyTableView])
 	{
+		if (historyMatches != nil)
+			return (int)([historyMatches length] / sizeof(NSUInteger));
 		return (int)[[dataManager history] count];
 	}
 	else if ([aTableView isEqualTo:radixTableView])
@@ -549,6 +1038,7 @@
 
 	
 	[[historyTableView tableColumns][0] setDataCell:historyCell];
+	[self addHistorySearchField];
 	
 	[data2DFunctionsTableView reloadData];
 	[arrayDataFunctionsTableView reloadData];
@@ -616,8 +1106,9 @@
 	}
 	else if ([aTableView isEqualTo:historyTableView])
 	{
-		NSArray *data = [dataManager.history getItemAtIndex:rowIndex];
-		return data;
+		NSInteger index = [self historyIndexForRow:rowIndex];
+		NSData *data = [dataManager.history getItemAtIndex:index];
+		return (data != nil) ? @[[self historyPathForData:data], @(index + 1)] : nil;
 	}
 	else if ([aTableView isEqualTo:radixTableView])
 	{
@@ -754,8 +1245,138 @@
 //
 - (void)updateHistory
 {
+	// Keep showing only the matches (the history may have been added to or cleared)
+	if (historyMatches != nil)
+		[self historySearchChanged:nil];
 	[historyTableView reloadData];
-	[historyTableView scrollRowToVisible:[[dataManager history] count] - 1];
+	[historyTableView scrollRowToVisible:[historyTableView numberOfRows] - 1];
+}
+
+//
+// addHistorySearchField
+//
+// Puts a search field above the history table, made here rather than in the nib so
+// that every localisation of the window gets it.
+//
+- (void)addHistorySearchField
+{
+	NSScrollView	*scrollView = [historyTableView enclosingScrollView];
+	NSView			*drawerView = [scrollView superview];
+	NSRect			tableFrame = [scrollView frame];
+	NSRect			searchFrame;
+	BOOL			flipped = [drawerView isFlipped];
+	
+	NSDivideRect(tableFrame, &searchFrame, &tableFrame, 30.0, flipped ? NSMinYEdge : NSMaxYEdge);
+	historySearchField = [[NSSearchField alloc] initWithFrame:NSInsetRect(searchFrame, 4.0, 4.0)];
+	[historySearchField setAutoresizingMask:NSViewWidthSizable | (flipped ? NSViewMaxYMargin : NSViewMinYMargin)];
+	[[historySearchField cell] setPlaceholderString:NSLocalizedString(@"Search history", @"History search field placeholder")];
+	[historySearchField setTarget:self];
+	[historySearchField setAction:@selector(historySearchChanged:)];
+	
+	[scrollView setFrame:tableFrame];
+	[drawerView addSubview:historySearchField];
+}
+
+//
+// historySearchChanged
+//
+// Shows only the history items matching the search field (see HistoryIndex for what a
+// query can be), or all of them when it's empty.
+//
+- (IBAction)historySearchChanged:(id)sender
+{
+	NSString	*query = [historySearchField stringValue];
+	NSIndexSet	*matches;
+	
+	if ([[query stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]] length] == 0)
+	{
+		historyMatches = nil;
+	}
+	else
+	{
+		matches = [[dataManager history] itemsMatching:query];
+		historyMatches = [NSMutableData dataWithLength:[matches count] * sizeof(NSUInteger)];
+		[matches getIndexes:[historyMatches mutableBytes] maxCount:[matches count] inIndexRange:nil];
+	}
+	
+	if (sender == historySearchField)
+	{
+		[historyTableView reloadData];
+		[historyTableView scrollRowToVisible:[historyTableView numberOfRows] - 1];
+	}
+}
+
+//
+// historyIndexForRow
+//
+// The history item shown in a row of the history table.
+//
+- (NSInteger)historyIndexForRow:(NSInteger)row
+{
+	if (historyMatches == nil)
+		return row;
+	if (row < 0 || row >= (NSInteger)([historyMatches length] / sizeof(NSUInteger)))
+		return -1;
+	return (NSInteger)((const NSUInteger *)[historyMatches bytes])[row];
+}
+
+//
+// historyFormatChanged
+//
+// The radix or number format changed, so the history rows are laid out again as they
+// are next drawn.
+//
+- (void)historyFormatChanged
+{
+	[historyPaths removeAllObjects];
+	[historyPathOrder removeAllObjects];
+	[historyTableView setNeedsDisplay:YES];
+}
+
+//
+// historyPathForData
+//
+// Lays out an expression from the history for the history table, flipped since the
+// table's origin is at the top. Only rows the table draws are laid out and the most
+// recently drawn are kept, so scrolling back and forth doesn't repeat the work.
+//
+- (NSBezierPath *)historyPathForData:(NSData *)data
+{
+	NSBezierPath		*path = historyPaths[data];
+	Expression			*expression;
+	NSAffineTransform	*transform;
+	NSRect				bounds;
+	
+	if (path != nil)
+	{
+		[historyPathOrder removeObject:data];
+		[historyPathOrder addObject:data];
+		return path;
+	}
+	
+	path = [NSBezierPath bezierPath];
+	expression = [Expression expressionWithData:data];
+	if (expression != nil)
+	{
+		[expression managerChanged:dataManager];
+		[path appendBezierPath:[expression pathAtLevel:0]];
+		bounds = [expression naturalBoundsAtLevel:0];
+		
+		transform = [NSAffineTransform transform];
+		[transform scaleXBy:1.0 yBy:-1.0];
+		[transform translateXBy:-bounds.origin.x yBy:-bounds.size.height - bounds.origin.y];
+		[path transformUsingAffineTransform:transform];
+	}
+	
+	if ([historyPathOrder count] >= DM_history_path_capacity)
+	{
+		[historyPaths removeObjectForKey:historyPathOrder[0]];
+		[historyPathOrder removeObjectAtIndex:0];
+	}
+	historyPaths[data] = path;
+	[historyPathOrder addObject:data];
+	
+	return path;
 }
 
 @end
@@ -10,8 +10,10 @@
 // ##############################################################
 
 #import <Foundation/Foundation.h>
+#import "BigFloat.h"
 
 @class BigCFloat;
+@class BigInteger;
 @class DataManager;
 
 //
@@ -41,6 +43,17 @@
 // view classes would create more work that I care to do.
 //
 
+//
+// Profile of one node's evaluation, from beginProfile to endProfile
+//
+typedef struct
+{
+	uint64_t			start;
+	unsigned long long	kernelCalls;
+	uint64_t			childTime;
+	unsigned long long	childKernelCalls;
+} EXProfile;
+
 @interface Expression : NSObject <NSCoding>
 {
 @protected
@@ -49,20 +62,49 @@
 	Expression		*parent;
 	DataManager	*manager;
 	NSBezierPath	*expressionPath;
+	NSAffineTransform	*childPlacement;
+	__weak Expression	*composedChild;
 	NSRect			displayBounds;
 	NSRect			naturalBounds;
 	NSRect			childNaturalBounds;
-	NSRect			childDisplayBounds;
 	BOOL			isInputPoint;
 	int 			pathValidAt;
+	int				layoutLevel;
+	BOOL			isChildLayoutValid;
 	BOOL			isBoundsValid;
+	NSUInteger		boundsValidAt;
 	BOOL			valueValid;
+	
+	// Working precision the value was calculated at, 0 for full precision (see getDisplayValue)
+	unsigned int	valueDigits;
+	
+	// The value as an exact integer (nil if it isn't one), when exactValid (see getExactValue)
+	BigInteger		*exactValue;
+	BOOL			exactValid;
+	
+	// Cost of the node's last evaluation (nanoseconds and BigFloat kernel calls), with
+	// and without its children, and which evaluation of the tree that was
+	uint64_t			profileTime;
+	uint64_t			profileSelfTime;
+	unsigned long long	profileKernelCalls;
+	unsigned long long	profileSelfKernelCalls;
+	unsigned int		profileEvaluation;
 }
 - (instancetype)init NS_DESIGNATED_INITIALIZER;
 - (instancetype)initWithParent:(Expression*)newParent andManager:(DataManager*)newManager NS_DESIGNATED_INITIALIZER;
 - (instancetype)initWithCoder:(NSCoder *)coder NS_DESIGNATED_INITIALIZER;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent NS_DESIGNATED_INITIALIZER;
+- (void)appendEncodingTo:(NSMutableData *)data;
+- (void)appendEncodedChildrenTo:(NSMutableData *)data;
+- (void)decodeChildrenWithEncoding:(BFDecoder *)decoder;
++ (void)appendEncodingOf:(Expression*)node to:(NSMutableData *)data;
++ (Expression*)expressionWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
++ (Expression*)expressionWithData:(NSData *)data;
+@property (NS_NONATOMIC_IOSONLY, readonly, copy) NSData *encodedData;
 + (double)scaleWithLevel:(int)level;
++ (NSRect)boundsOfPath:(NSBezierPath*)path;
++ (NSRect)rect:(NSRect)rect transformedBy:(NSAffineTransform*)transform;
 - (void)appendDigit:(int)digit;
 - (void)binaryOpPressed:(int)op;
 - (void)bracketPressed;
@@ -81,13 +123,29 @@
 @property (NS_NONATOMIC_IOSONLY, getter=getValue, readonly, strong) BigCFloat *value;
 //@property (NS_NONATOMIC_IOSONLY, getter=getValue, readonly, strong) BigCFloat *value;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
+@property (NS_NONATOMIC_IOSONLY, getter=getExactValue, readonly, strong) BigInteger *exactValue;
+- (BigInteger*)calculateExactValue;
+- (BigCFloat*)getDisplayValue;
+- (NSString*)displayedDigitsOf:(BigCFloat*)number;
 - (NSBezierPath*)getValuePathWithLevel:(int)level;
+- (BOOL)isValueCurrent;
+@property (NS_NONATOMIC_IOSONLY, getter=getValueDigits, readonly) unsigned int valueDigits;
+- (unsigned int)digitsOfValueUsingSeries:(BOOL)usesSeries;
 - (void)inputPoint;
 - (void)managerChanged:(DataManager*)newManager;
 - (Expression*)nodeContainingPoint:(NSPoint)point;
 @property (NS_NONATOMIC_IOSONLY, readonly, strong) Expression *parent;
 - (void)parentChanged:(Expression*)newParent;
 - (NSBezierPath*)pathAtLevel:(int)level;
+- (NSRect)naturalBoundsAtLevel:(int)level;
+- (void)composePathAtLevel:(int)level;
+- (void)appendPathTo:(NSBezierPath*)path withTransform:(NSAffineTransform*)transform;
+- (void)draw;
+- (BOOL)updateChildLayout;
+- (BOOL)updateLayoutOfNode:(Expression*)node composedAs:(Expression*)composedNode;
+- (BOOL)updateDisplayBounds;
+- (NSRect)displayBoundsOfChild:(Expression*)node;
+- (NSRect)displayRectForNaturalRect:(NSRect)rect;
 - (void)postOpPressed:(int)op;
 - (void)preOpPressed:(int)op;
 - (void)receiveBounds:(NSRect)bounds;
@@ -98,6 +156,18 @@
 - (void)shiftValue:(BOOL)left;
 - (void)userPointPressed;
 - (void)valueChanged;
+- (void)layoutChanged;
+- (void)descendantLayoutChanged;
 - (void)valueInserted:(BigCFloat*)newValue;
 
+// Profiling
++ (void)beginProfiledEvaluation;
+- (EXProfile)beginProfile;
+- (void)endProfile:(EXProfile)profile;
+@property (NS_NONATOMIC_IOSONLY, readonly, copy) NSArray *profileChildren;
+@property (NS_NONATOMIC_IOSONLY, readonly) uint64_t profileTime;
+- (void)appendProfileTo:(NSMutableString *)report depth:(int)depth;
+- (void)collectProfiledOperations:(NSMutableArray *)operations;
+@property (NS_NONATOMIC_IOSONLY, readonly, copy) NSString *profileReport;
+
 @end
@@ -15,8 +15,11 @@
 #import "PostOp.h"
 #import "PreOp.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "DataManager.h"
 #import "Bracket.h"
+#import "Constant.h"
+#import "TreeHead.h"
 
 //
 // About Expression
@@ -44,6 +47,25 @@
 // independent to the other methods, but to separate them out into specific
 // view classes would create more work that I care to do.
 //
+// Incremented whenever any layout or display bounds change. Nodes cache their display
+// bounds against it.
+static NSUInteger displayGeneration = 1;
+
+#if BF_statistics
+// Time and kernel calls of the children evaluated so far by the node being profiled
+static _Thread_local uint64_t EX_profile_child_time = 0;
+static _Thread_local unsigned long long EX_profile_child_kernel_calls = 0;
+#endif
+
+// Counts evaluations of whole trees, so stale (cached) node profiles can be told apart
+static unsigned int EX_profile_evaluation = 0;
+
+// Longest expression text shown for a node in a profile
+#define EX_profile_label_length	40
+
+// Guard digits of the first adaptive evaluation (doubled on each retry)
+#define EX_guard_digits			6
+
 @implementation Expression
 
 - (instancetype)init
@@ -68,13 +90,16 @@
 		manager = newManager;
 		parent = newParent;
 		expressionPath = [NSBezierPath bezierPath];
+		childPlacement = nil;
 		isInputPoint = NO;
 		pathValidAt = -1;
+		layoutLevel = -1;
+		isChildLayoutValid = YES;
 		isBoundsValid = NO;
+		boundsValidAt = 0;
 		displayBounds = NSZeroRect;
 		naturalBounds = NSZeroRect;
 		childNaturalBounds = NSZeroRect;
-		childDisplayBounds = NSZeroRect;
 		value = [BigCFloat zero];
 		valueValid = YES;
 	}
@@ -94,13 +119,16 @@
 	manager = nil;
 	parent = [coder decodeObjectForKey:@"MEParent"];
 	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = nil;
 	isInputPoint = NO;
 	pathValidAt = -1;
+	layoutLevel = -1;
+	isChildLayoutValid = YES;
 	isBoundsValid = NO;
+	boundsValidAt = 0;
 	displayBounds = NSZeroRect;
 	naturalBounds = NSZeroRect;
 	childNaturalBounds = NSZeroRect;
-	childDisplayBounds = NSZeroRect;
 	value = [BigCFloat zero];
 	valueValid = NO;
 	
@@ -118,6 +146,177 @@
 	[coder encodeConditionalObject:parent forKey:@"MEParent"];
 }
 
+//
+// EX_EncodingClasses
+//
+// The node classes of the compact encoding, each written as its index plus one (zero
+// means no node). Only ever add to the end: the order is part of the format.
+//
+static NSArray *
+EX_EncodingClasses(void)
+{
+	static NSArray			*classes;
+	static dispatch_once_t	once;
+	
+	dispatch_once(&once, ^{
+		classes = @[[Expression class], [TreeHead class], [Bracket class], [BinaryOp class],
+			[PreOp class], [PostOp class], [Constant class], [Value class]];
+	});
+	
+	return classes;
+}
+
+//
+// initWithEncoding
+//
+// Reads the node's own fields from the compact encoding. The children are read
+// afterwards by decodeChildrenWithEncoding:, once every class has read its fields.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super init];
+	if (self)
+	{
+		child = nil;
+		manager = nil;
+		parent = newParent;
+		expressionPath = [NSBezierPath bezierPath];
+		childPlacement = nil;
+		isInputPoint = NO;
+		pathValidAt = -1;
+		layoutLevel = -1;
+		isChildLayoutValid = YES;
+		isBoundsValid = NO;
+		boundsValidAt = 0;
+		displayBounds = NSZeroRect;
+		naturalBounds = NSZeroRect;
+		childNaturalBounds = NSZeroRect;
+		value = [BigCFloat zero];
+		valueValid = NO;
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Writes the node's own fields in the compact encoding. The base class has none;
+// subclasses write theirs after calling super.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+}
+
+//
+// appendEncodedChildrenTo
+//
+// Writes the children of the node. Subclasses with more children write those first.
+//
+- (void)appendEncodedChildrenTo:(NSMutableData *)data
+{
+	[Expression appendEncodingOf:child to:data];
+}
+
+//
+// decodeChildrenWithEncoding
+//
+// Reads the children written by appendEncodedChildrenTo:.
+//
+- (void)decodeChildrenWithEncoding:(BFDecoder *)decoder
+{
+	child = [Expression expressionWithEncoding:decoder parent:self];
+}
+
+//
+// appendEncodingOf
+//
+// Writes a node (or nil) in the compact encoding: its class, its fields and then its
+// children, so a tree comes out in preorder.
+//
++ (void)appendEncodingOf:(Expression*)node to:(NSMutableData *)data
+{
+	NSUInteger index = (node == nil) ? NSNotFound : [EX_EncodingClasses() indexOfObject:[node class]];
+	
+	NSAssert(node == nil || index != NSNotFound, @"No compact encoding for this class of node.\n");
+	BF_EncodeByte(data, (node == nil || index == NSNotFound) ? 0 : (uint8_t)(index + 1));
+	if (node != nil && index != NSNotFound)
+	{
+		[node appendEncodingTo:data];
+		[node appendEncodedChildrenTo:data];
+	}
+}
+
+//
+// expressionWithEncoding
+//
+// Reads a node (or nil) and the tree below it from the compact encoding.
+//
++ (Expression*)expressionWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	NSArray		*classes = EX_EncodingClasses();
+	uint8_t		tag = BF_DecodeByte(decoder);
+	Expression	*node;
+	
+	if (tag == 0 || decoder->failed)
+		return nil;
+	if (tag > [classes count])
+	{
+		decoder->failed = YES;
+		return nil;
+	}
+	
+	node = [[classes[tag - 1] alloc] initWithEncoding:decoder parent:newParent];
+	[node decodeChildrenWithEncoding:decoder];
+	
+	return node;
+}
+
+//
+// expressionWithData
+//
+// Reads a tree from encodedData, or from a keyed archive written by older versions.
+// Returns nil if the data is neither.
+//
++ (Expression*)expressionWithData:(NSData *)data
+{
+	const char	magic[4] = {'M', 'N', 'M', 'E'};
+	BFDecoder	decoder;
+	Expression	*result;
+	
+	if ([data length] > sizeof(magic) && memcmp([data bytes], magic, sizeof(magic)) == 0)
+	{
+		decoder = BF_DecoderForData(data, sizeof(magic));
+		if (BF_DecodeByte(&decoder) > BF_encoding_version)
+			return nil;
+		
+		result = [Expression expressionWithEncoding:&decoder parent:nil];
+		return decoder.failed ? nil : result;
+	}
+	
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+	result = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+#pragma GCC diagnostic pop
+	return [result isKindOfClass:[Expression class]] ? result : nil;
+}
+
+//
+// encodedData
+//
+// The tree below (and including) this node in the compact encoding, behind a magic
+// number and version. Used for the pasteboard and the history.
+//
+- (NSData *)encodedData
+{
+	const char		magic[4] = {'M', 'N', 'M', 'E'};
+	NSMutableData	*data = [NSMutableData dataWithBytes:magic length:sizeof(magic)];
+	
+	BF_EncodeByte(data, BF_encoding_version);
+	[Expression appendEncodingOf:self to:data];
+	
+	return data;
+}
+
 //
 // dealloc
 //
@@ -135,6 +334,46 @@
 	return (level >= 2) ? (1.0 / pow(1.5, level - 1.0)) : 1.0;
 }
 
+//
+// boundsOfPath
+//
+// Returns the bounds of a path or NSZeroRect if the path is empty. Empty paths are
+// recorded as zero bounds throughout the tree.
+//
++ (NSRect)boundsOfPath:(NSBezierPath*)path
+{
+	if (path == nil || [path isEmpty])
+		return NSZeroRect;
+	
+	return [path bounds];
+}
+
+//
+// rect:transformedBy:
+//
+// Returns the bounds of the rectangle once mapped through the transform. The layout only
+// ever uses translations and scales so mapping the two corners is sufficient.
+//
++ (NSRect)rect:(NSRect)rect transformedBy:(NSAffineTransform*)transform
+{
+	NSPoint	lowerLeft;
+	NSPoint	upperRight;
+	
+	if (NSIsEmptyRect(rect))
+		return NSZeroRect;
+	
+	lowerLeft = [transform transformPoint:rect.origin];
+	upperRight = [transform transformPoint:NSMakePoint(NSMaxX(rect), NSMaxY(rect))];
+	
+	return NSMakeRect
+	(
+		MIN(lowerLeft.x, upperRight.x),
+		MIN(lowerLeft.y, upperRight.y),
+		fabs(upperRight.x - lowerLeft.x),
+		fabs(upperRight.y - lowerLeft.y)
+	);
+}
+
 //
 // appendDigit
 //
@@ -378,6 +617,7 @@
 {
 	NSPoint	caretPoint;
 	
+	[self updateDisplayBounds];
 	NSAssert(isBoundsValid == YES, @"Display bounds requested before being received.\n");
 	
 	caretPoint = displayBounds.origin;
@@ -393,6 +633,7 @@
 //
 - (NSRect)getDisplayBounds
 {
+	[self updateDisplayBounds];
 	NSAssert(isBoundsValid == YES, @"Display bounds requested before being received.\n");
 	
 	return displayBounds;
@@ -405,18 +646,277 @@
 //
 - (BigCFloat*)getValue
 {
-	if (valueValid == NO)
+	if (![self isValueCurrent])
 	{
+		EXProfile profile = [self beginProfile];
+		
 		if (child != nil)
 		{
 			value = [child getValue];
 		}
 		valueValid = YES;
+		valueDigits = [self digitsOfValueUsingSeries:NO];
+		
+		[self endProfile:profile];
 	}
 	
 	return value;
 }
 
+//
+// isValueCurrent
+//
+// YES if the cached value will do at the calling thread's working precision: it must
+// be valid and have been calculated at least as precisely as is now being asked for.
+//
+- (BOOL)isValueCurrent
+{
+	unsigned int workingDigits = [BigFloat workingDigits];
+	
+	if (valueValid == NO)
+		return NO;
+	
+	return valueDigits == 0 || (workingDigits != 0 && valueDigits >= workingDigits);
+}
+
+//
+// getValueDigits
+//
+// The working precision the current value was calculated at, 0 for full precision.
+//
+- (unsigned int)getValueDigits
+{
+	return valueDigits;
+}
+
+//
+// digitsOfValueUsingSeries
+//
+// The precision of a value just calculated from the children's values: full precision
+// (0) unless a child's value is less precise or this node's own function is a series or
+// Newton iteration (usesSeries), which only converges to the working precision. Nodes
+// doing nothing but arithmetic keep full precision, so the display evaluates them once.
+//
+- (unsigned int)digitsOfValueUsingSeries:(BOOL)usesSeries
+{
+	unsigned int digits = usesSeries ? [BigFloat workingDigits] : 0;
+	unsigned int childDigits = (child != nil) ? [child getValueDigits] : 0;
+	
+	if (childDigits != 0 && (digits == 0 || childDigits < digits))
+		digits = childDigits;
+	
+	return digits;
+}
+
+//
+// getExactValue
+//
+// The value of this node as an exact integer, or nil if it isn't one (something in the
+// node or below it isn't an integer, or the result would be too big). Unlike getValue
+// this doesn't depend on the working precision, so it is kept until the value changes.
+//
+- (BigInteger*)getExactValue
+{
+	if (!exactValid)
+	{
+		exactValue = [self calculateExactValue];
+		exactValid = YES;
+	}
+	
+	return exactValue;
+}
+
+//
+// calculateExactValue
+//
+// Works out the exact value for getExactValue. By default that of the child.
+//
+- (BigInteger*)calculateExactValue
+{
+	if (child == nil)
+		return [BigInteger zero];
+	
+	return [child getExactValue];
+}
+
+//
+// beginProfiledEvaluation
+//
+// Marks the start of a new evaluation of a whole tree. Nodes not profiled after this
+// show up as cached in profile reports.
+//
++ (void)beginProfiledEvaluation
+{
+	EX_profile_evaluation++;
+}
+
+//
+// beginProfile
+//
+// Starts profiling the evaluation of this node. Every getValue that calculates brackets
+// the calculation with beginProfile and endProfile. Profiling is compiled in with the
+// BigFloat statistics.
+//
+- (EXProfile)beginProfile
+{
+	EXProfile profile = {0};
+	
+#if BF_statistics
+	profile.start = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+	profile.kernelCalls = [BigFloat threadKernelCalls];
+	profile.childTime = EX_profile_child_time;
+	profile.childKernelCalls = EX_profile_child_kernel_calls;
+	
+	EX_profile_child_time = 0;
+	EX_profile_child_kernel_calls = 0;
+#endif
+	
+	return profile;
+}
+
+//
+// endProfile
+//
+// Records the cost of this node's evaluation. The cost of the children evaluated in
+// the meantime is taken off to give the node's own cost, then the node's total is
+// handed up to its parent.
+//
+- (void)endProfile:(EXProfile)profile
+{
+#if BF_statistics
+	unsigned long long kernelCalls = [BigFloat threadKernelCalls];
+	
+	// The statistics may have been reset part way through
+	profileTime = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) - profile.start;
+	profileKernelCalls = (kernelCalls > profile.kernelCalls) ? kernelCalls - profile.kernelCalls : 0;
+	profileSelfTime = profileTime - MIN(EX_profile_child_time, profileTime);
+	profileSelfKernelCalls = profileKernelCalls - MIN(EX_profile_child_kernel_calls, profileKernelCalls);
+	profileEvaluation = EX_profile_evaluation;
+	
+	EX_profile_child_time = profile.childTime + profileTime;
+	EX_profile_child_kernel_calls = profile.childKernelCalls + profileKernelCalls;
+#endif
+}
+
+//
+// profileChildren
+//
+// The nodes whose values this node's value is calculated from.
+//
+- (NSArray *)profileChildren
+{
+	return (child != nil) ? @[child] : @[];
+}
+
+//
+// profileTime
+//
+// Nanoseconds taken by the last evaluation of this node, including its children.
+//
+- (uint64_t)profileTime
+{
+	return profileTime;
+}
+
+//
+// profileLabel
+//
+// Describes the node in a profile: its class and (abbreviated) expression text.
+//
+- (NSString *)profileLabel
+{
+	NSString *text = [self getExpressionString];
+	
+	if ([text length] > EX_profile_label_length)
+		text = [[text substringToIndex:EX_profile_label_length - 3] stringByAppendingString:@"..."];
+	
+	return [NSString stringWithFormat:@"%@ %@", NSStringFromClass([self class]), text];
+}
+
+//
+// appendProfileLineTo
+//
+// One line of a profile report for this node, indented by depth.
+//
+- (void)appendProfileLineTo:(NSMutableString *)report depth:(int)depth
+{
+	NSString *label = [[@"" stringByPaddingToLength:depth * 2 withString:@" " startingAtIndex:0] stringByAppendingString:[self profileLabel]];
+	
+	// Field widths don't apply to %@, so pad the label by hand
+	label = [label stringByPaddingToLength:MAX([label length], 60) withString:@" " startingAtIndex:0];
+	
+	if (profileEvaluation != EX_profile_evaluation)
+		[report appendFormat:@"%@ (cached)\n", label];
+	else
+		[report appendFormat:@"%@ %10.3f ms %10.3f ms self %10llu calls %10llu self\n", label,
+			profileTime / 1.0e6, profileSelfTime / 1.0e6, profileKernelCalls, profileSelfKernelCalls];
+}
+
+//
+// appendProfileTo
+//
+// Appends this node and (indented below it) its children to a profile report.
+//
+- (void)appendProfileTo:(NSMutableString *)report depth:(int)depth
+{
+	[self appendProfileLineTo:report depth:depth];
+	
+	for (Expression *node in [self profileChildren])
+	{
+		[node appendProfileTo:report depth:depth + 1];
+	}
+}
+
+//
+// collectProfiledOperations
+//
+// Adds the operation nodes (BinaryOp, PreOp, PostOp) at and below this node that were
+// calculated in the latest evaluation.
+//
+- (void)collectProfiledOperations:(NSMutableArray *)operations
+{
+	if (profileEvaluation == EX_profile_evaluation &&
+		([self isKindOfClass:[BinaryOp class]] || [self isKindOfClass:[PreOp class]] || [self isKindOfClass:[PostOp class]]))
+	{
+		[operations addObject:self];
+	}
+	
+	for (Expression *node in [self profileChildren])
+	{
+		[node collectProfiledOperations:operations];
+	}
+}
+
+//
+// profileReport
+//
+// The cost of the latest evaluation below this node: the operations, heaviest (by
+// their own time) first, then the whole tree annotated.
+//
+- (NSString *)profileReport
+{
+	NSMutableString	*report = [NSMutableString string];
+	NSMutableArray	*operations = [NSMutableArray array];
+	
+	[self collectProfiledOperations:operations];
+	[operations sortUsingComparator:^NSComparisonResult(Expression *first, Expression *second) {
+		if (first->profileSelfTime != second->profileSelfTime)
+			return (first->profileSelfTime > second->profileSelfTime) ? NSOrderedAscending : NSOrderedDescending;
+		return NSOrderedSame;
+	}];
+	
+	[report appendString:@"Operations, heaviest first:\n"];
+	for (Expression *node in operations)
+	{
+		[node appendProfileLineTo:report depth:1];
+	}
+	
+	[report appendString:@"\nTree:\n"];
+	[self appendProfileTo:report depth:1];
+	
+	return report;
+}
+
 //
 // getExpressionString
 //
@@ -432,6 +932,91 @@
 	return resultString;
 }
 
+//
+// getDisplayValue
+//
+// The value to display. With adaptive precision on, only the displayed digits need to
+// be right, so the tree is evaluated at the length limit plus some guard digits. If no
+// node used a series (see digitsOfValueUsingSeries) that value is already at full
+// precision and is used as it is. Otherwise it is evaluated again with twice as many
+// guard digits, reusing every subtree that came out at full precision, and if both
+// round to the same displayed digits the second is used. If not the guard digits keep
+// doubling until two evaluations agree or full precision is reached (Ziv's strategy).
+// Two agreeing evaluations are a heuristic rather than an error bound: the guard digits
+// make a disagreement that both evaluations share unlikely, not impossible. Nodes
+// remember the precision their values were calculated at, so getValue still gives a
+// full precision result afterwards.
+//
+- (BigCFloat*)getDisplayValue
+{
+	BigCFloat		*result;
+	NSString		*digits;
+	NSString		*previousDigits = nil;
+	unsigned int	lengthLimit;
+	unsigned int	fullDigits;
+	unsigned int	guardDigits;
+	
+	if (child == nil || manager == nil || ![manager getAdaptivePrecisionFromPref])
+		return [self getValue];
+	
+	// Nothing to gain over a value that is already at full precision
+	if (valueValid == YES && valueDigits == 0)
+		return value;
+	
+	lengthLimit = [manager getLengthLimit];
+	fullDigits = (unsigned int)[[BigFloat bigFloatWithInt:0 radix:[manager getRadix]] precisionDigits];
+	for (guardDigits = EX_guard_digits; lengthLimit + guardDigits < fullDigits; guardDigits *= 2)
+	{
+		[BigFloat setWorkingDigits:lengthLimit + guardDigits];
+		result = [self getValue];
+		[BigFloat setWorkingDigits:0];
+		
+		if (valueDigits == 0)
+			return result;
+		
+		digits = [self displayedDigitsOf:result];
+		if ([digits isEqualToString:previousDigits])
+			return result;
+		
+		previousDigits = digits;
+	}
+	
+	return [self getValue];
+}
+
+//
+// displayedDigitsOf
+//
+// The mantissa and exponent strings (real and imaginary) that Value would display for
+// the number with the manager's current settings.
+//
+- (NSString*)displayedDigitsOf:(BigCFloat*)number
+{
+	NSString	*mantissa;
+	NSString	*exponent;
+	NSString	*imaginary;
+	NSString	*imExponent;
+	
+	if ([number radix] != [manager getRadix])
+	{
+		number = (BigCFloat*)[number duplicate];
+		[number convertToRadix:[manager getRadix]];
+	}
+	
+	[number
+		limitedString:[manager getLengthLimit]
+		fixedPlaces:[manager getFixedPlaces]
+		fillLimit:[manager getFillLimit]
+		complement:[manager getComplement]
+		mantissa:&mantissa
+		exponent:&exponent
+		imaginaryMantissa:&imaginary
+		imaginaryExponent:&imExponent
+	];
+	
+	return [NSString stringWithFormat:@"%@e%@ %@e%@", mantissa, exponent, imaginary, imExponent];
+}
+
 //
 // getValuePathWithLevel
 //
@@ -439,7 +1024,7 @@
 //
 - (NSBezierPath*)getValuePathWithLevel:(int)level
 {
-	Value *result = [[Value alloc] initWithParent:nil value:[self getValue] andManager:manager];
+	Value *result = [[Value alloc] initWithParent:nil value:[self getDisplayValue] andManager:manager];
 	NSBezierPath *resultPath = [result pathAtLevel:level];
 	
 	// There are situations where Value (while drawing the BigFloat) will correct precision errors
@@ -482,7 +1067,7 @@
 //
 - (Expression*)nodeContainingPoint:(NSPoint)point
 {
-	if (isBoundsValid == NO)
+	if (![self updateDisplayBounds])
 	{
 		return self;
 	}
@@ -529,38 +1114,139 @@
 //
 // pathAtLevel
 //
-// Draws the node and its children into a bezier path.
+// Flattens the node and its children into a single bezier path. The display draws the
+// retained tree directly (see draw) so this is only needed where a standalone path is
+// wanted (the history and the result value).
 //
 - (NSBezierPath*)pathAtLevel:(int)level
 {
-	NSBezierPath		*copy;
+	NSBezierPath *path = [NSBezierPath bezierPath];
+	
+	[self naturalBoundsAtLevel:level];
+	[self appendPathTo:path withTransform:[NSAffineTransform transform]];
+	
+	return path;
+}
+
+//
+// naturalBoundsAtLevel
+//
+// Lays out this node (if it isn't already laid out at this level) and returns its bounds.
+// Each node retains its own symbols in expressionPath and the placement of its children,
+// so only nodes that have been invalidated since the last layout are recomposed. Their
+// unchanged siblings are positioned by transform without touching their geometry.
+//
+- (NSRect)naturalBoundsAtLevel:(int)level
+{
+	layoutLevel = level;
 	
-	if (pathValidAt != level)
+	// A node is only recomposed if it changed itself or one of its children changed size.
+	// A child that was edited but kept its size is laid out without disturbing this node.
+	if (pathValidAt != level || (!isChildLayoutValid && [self updateChildLayout]))
 	{
-		expressionPath = [NSBezierPath bezierPath];
-		
-		// Append the child's path if it exists.
-		if (child != nil)
-		{
-			[expressionPath appendBezierPath:[child pathAtLevel:level]];
-		}
+		[self composePathAtLevel:level];
+		composedChild = child;
 		
 		// Record that the path has been properly updated since the last invalidation
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSZeroRect;
-		if (![expressionPath isEmpty])
-			childNaturalBounds = [expressionPath bounds];
-		else
-			childNaturalBounds = NSZeroRect;
 		pathValidAt = level;
 	}
+	isChildLayoutValid = YES;
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
+	return naturalBounds;
+}
+
+//
+// updateChildLayout
+//
+// Lays out any children that have changed since this node was composed. Returns YES if
+// this node needs recomposing as a result.
+//
+- (BOOL)updateChildLayout
+{
+	return [self updateLayoutOfNode:child composedAs:composedChild];
+}
+
+//
+// updateLayoutOfNode
+//
+// Lays out the node at the level it was last laid out at and reports whether its natural
+// bounds differ from those this node was composed with. A different node in the slot (or
+// one that has never been laid out) always counts as a change.
+//
+- (BOOL)updateLayoutOfNode:(Expression*)node composedAs:(Expression*)composedNode
+{
+	NSRect	oldBounds;
+	
+	if (node != composedNode)
+		return YES;
+	if (node == nil)
+		return NO;
+	if (node->layoutLevel < 0)
+		return YES;
+	
+	oldBounds = node->naturalBounds;
+	
+	return !NSEqualRects(oldBounds, [node naturalBoundsAtLevel:node->layoutLevel]);
+}
+
+//
+// composePathAtLevel
+//
+// Builds the symbols drawn by this node (not including the children) and the placement
+// of each child. Default behaviour is to draw nothing and place the child untransformed.
+// This method should only be called from naturalBoundsAtLevel.
+//
+- (void)composePathAtLevel:(int)level
+{
+	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = [NSAffineTransform transform];
+	
+	if (child != nil)
+		childNaturalBounds = [child naturalBoundsAtLevel:level];
+	else
+		childNaturalBounds = NSZeroRect;
 	
-	return copy;
+	naturalBounds = childNaturalBounds;
+}
+
+//
+// appendPathTo
+//
+// Appends the symbols of this node and its children to the path, mapped through the
+// transform.
+//
+- (void)appendPathTo:(NSBezierPath*)path withTransform:(NSAffineTransform*)transform
+{
+	if (![expressionPath isEmpty])
+		[path appendBezierPath:[transform transformBezierPath:expressionPath]];
+	
+	if (child != nil && childPlacement != nil)
+	{
+		NSAffineTransform *childTransform = [childPlacement copy];
+		
+		[childTransform appendTransform:transform];
+		[child appendPathTo:path withTransform:childTransform];
+	}
+}
+
+//
+// draw
+//
+// Fills this node's symbols in the current graphics context and then draws the children
+// with their placement concatenated onto the context's transform.
+//
+- (void)draw
+{
+	if (![expressionPath isEmpty])
+		[expressionPath fill];
+	
+	if (child != nil && childPlacement != nil)
+	{
+		[NSGraphicsContext saveGraphicsState];
+		[childPlacement concat];
+		[child draw];
+		[NSGraphicsContext restoreGraphicsState];
+	}
 }
 
 //
@@ -604,42 +1290,76 @@
 // we can know exactly where we were displayed. This is important for hit testing (we
 // can't determine what the user clicked on unless we know where we were drawn).
 //
+// Only the head of the tree receives its bounds. Every other node derives its display
+// bounds from its parent when they are asked for (see updateDisplayBounds) so that
+// nodes whose bounds are never queried cost nothing after a relayout.
+//
 - (void)receiveBounds:(NSRect)bounds
 {
-	NSBezierPath			*childPath = [NSBezierPath bezierPathWithRect:childNaturalBounds];
-	NSAffineTransform	*childTransform = [NSAffineTransform	transform];
-	
 	displayBounds = bounds;
+	isBoundsValid = YES;
 	
-	if (child != nil)
+	displayGeneration++;
+	boundsValidAt = displayGeneration;
+}
+
+//
+// updateDisplayBounds
+//
+// Brings displayBounds up to date with the last bounds received by the head of the tree
+// and returns whether they are valid. Results are cached until the next layout change
+// or receiveBounds anywhere, so a top-down walk only computes each node once.
+//
+- (BOOL)updateDisplayBounds
+{
+	if (parent == nil)
+		return isBoundsValid;
+	
+	if (boundsValidAt != displayGeneration)
 	{
-		if (!NSIsEmptyRect(naturalBounds))
-		{
-			[childTransform
-				translateXBy:displayBounds.origin.x
-				yBy:displayBounds.origin.y
-			];
-			[childTransform
-				scaleXBy:displayBounds.size.width / naturalBounds.size.width
-				yBy:displayBounds.size.height / naturalBounds.size.height
-			];
-			[childTransform
-				translateXBy:-naturalBounds.origin.x
-				yBy:-naturalBounds.origin.y
-			];
-			[childPath transformUsingAffineTransform:childTransform];
-
-			childDisplayBounds = [childPath bounds];
-		}
-		else
-		{
-			childDisplayBounds = bounds;
-		}
-		
-		[child receiveBounds:childDisplayBounds];
+		isBoundsValid = [parent updateDisplayBounds];
+		if (isBoundsValid)
+			displayBounds = [parent displayBoundsOfChild:self];
+		boundsValidAt = displayGeneration;
 	}
 	
-	isBoundsValid = YES;
+	return isBoundsValid;
+}
+
+//
+// displayBoundsOfChild
+//
+// Returns where the given child was displayed. Only valid after updateDisplayBounds.
+//
+- (NSRect)displayBoundsOfChild:(Expression*)node
+{
+	return [self displayRectForNaturalRect:childNaturalBounds];
+}
+
+//
+// displayRectForNaturalRect
+//
+// Maps a rectangle in this node's natural coordinates to display coordinates using the
+// same scale and offset that mapped naturalBounds to displayBounds.
+//
+- (NSRect)displayRectForNaturalRect:(NSRect)rect
+{
+	double	xScale;
+	double	yScale;
+	
+	if (NSIsEmptyRect(naturalBounds))
+		return displayBounds;
+	
+	xScale = displayBounds.size.width / naturalBounds.size.width;
+	yScale = displayBounds.size.height / naturalBounds.size.height;
+	
+	return NSMakeRect
+	(
+		displayBounds.origin.x + (rect.origin.x - naturalBounds.origin.x) * xScale,
+		displayBounds.origin.y + (rect.origin.y - naturalBounds.origin.y) * yScale,
+		rect.size.width * xScale,
+		rect.size.height * yScale
+	);
 }
 
 //
@@ -760,8 +1480,7 @@
 	
 	// Here we do a partial "valueChanged" notification. We don't actually want to
 	// propagate a change through the tree -- just to refresh the display
-	pathValidAt = -1;
-	isBoundsValid = NO;
+	[self layoutChanged];
 }
 
 //
@@ -794,14 +1513,49 @@
 //
 - (void)valueChanged
 {
+	Expression	*node;
+	
 	// Mark ourselves as needing a new display path and layout rectangle
-	valueValid = NO;
+	[self layoutChanged];
+	
+	// The value of every node above us depends on ours but their layout only changes if
+	// our size does, which is determined when the tree is next laid out.
+	for (node = self; node != nil; node = node->parent)
+	{
+		node->valueValid = NO;
+		node->exactValid = NO;
+	}
+}
+
+//
+// layoutChanged
+//
+// Flags this node as needing to be recomposed and tells the nodes above it that a
+// descendant needs laying out.
+//
+- (void)layoutChanged
+{
 	pathValidAt = -1;
 	isBoundsValid = NO;
+	displayGeneration++;
+	
+	if (parent != nil)
+		[parent descendantLayoutChanged];
+}
+
+//
+// descendantLayoutChanged
+//
+// A node below this one needs to be laid out. This node keeps its own composition until
+// the layout finds that a child's size has actually changed.
+//
+- (void)descendantLayoutChanged
+{
+	isChildLayoutValid = NO;
+	isBoundsValid = NO;
 	
-	// Propagate the change through to the parent
 	if (parent != nil)
-		[parent valueChanged];
+		[parent descendantLayoutChanged];
 }
 
 //
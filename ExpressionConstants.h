@@ -0,0 +1,301 @@
+// ##############################################################
+//  ExpressionConstants.h
+//  Magic Number Machine
+//
+//  Generated by Tools/make_constants.py. Do not edit.
+// ##############################################################
+
+//
+// About ExpressionConstants
+//
+// The physical constants of ExpressionSymbols, packed in the compact encoding with
+// no user point, by ConstType. π and i aren't in the table.
+//
+
+static const uint8_t MNM_packed_BohrRadius[] =
+{
+	0x02, 0x0A, 0x2D, 0x00, 0x04, 0x30, 0x17, 0x28, 0x1C, 0x65, 0x0B, 0x05, 0x00
+};
+
+static const uint8_t MNM_packed_StructureConstant[] =
+{
+	0x02, 0x0A, 0x1D, 0x00, 0x04, 0xE2, 0x1D, 0x85, 0x14, 0x9D, 0x0B, 0x07, 0x00
+};
+
+static const uint8_t MNM_packed_StandardAtmosphere[] =
+{
+	0x02, 0x0A, 0x00, 0x00, 0x02, 0x2D, 0x05, 0x0A, 0x00
+};
+
+static const uint8_t MNM_packed_WienDisplacement[] =
+{
+	0x02, 0x0A, 0x17, 0x00, 0x03, 0x67, 0x21, 0x30, 0x26, 0x1C, 0x00
+};
+
+static const uint8_t MNM_packed_RadiationConstant1[] =
+{
+	0x02, 0x0A, 0x33, 0x00, 0x03, 0x1B, 0x07, 0xEB, 0x06, 0x76, 0x01
+};
+
+static const uint8_t MNM_packed_RadiationConstant2[] =
+{
+	0x02, 0x0A, 0x15, 0x00, 0x03, 0x69, 0x14, 0x25, 0x0F, 0x0E, 0x00
+};
+
+static const uint8_t MNM_packed_SpeedOfLight[] =
+{
+	0x02, 0x0A, 0x00, 0x00, 0x03, 0x9A, 0x09, 0xFB, 0x26, 0x02, 0x00
+};
+
+static const uint8_t MNM_packed_HartreeEnergy[] =
+{
+	0x02, 0x0A, 0x37, 0x00, 0x03, 0xCE, 0x24, 0x0F, 0x26, 0xB3, 0x01
+};
+
+static const uint8_t MNM_packed_ElementaryCharge[] =
+{
+	0x02, 0x0A, 0x3B, 0x00, 0x03, 0x24, 0x22, 0xE4, 0x06, 0x42, 0x06
+};
+
+static const uint8_t MNM_packed_VacuumPermittivity[] =
+{
+	0x02, 0x0A, 0x47, 0x00, 0x07, 0xA3, 0x19, 0xBD, 0x13, 0x3A, 0x0F, 0xC4, 0x1D, 0x4D, 0x22, 0x5D,
+	0x21, 0x08, 0x00
+};
+
+static const uint8_t MNM_packed_ElectronVolt[] =
+{
+	0x02, 0x0A, 0x3B, 0x00, 0x03, 0x24, 0x22, 0xE4, 0x06, 0x42, 0x06
+};
+
+static const uint8_t MNM_packed_FaradayConstant[] =
+{
+	0x02, 0x0A, 0x0B, 0x00, 0x03, 0xC4, 0x26, 0x55, 0x21, 0xC4, 0x03
+};
+
+static const uint8_t MNM_packed_ElectronGFactor[] =
+{
+	0x03, 0x0A, 0x1D, 0x00, 0x04, 0xA7, 0x08, 0xB4, 0x01, 0x79, 0x0C, 0xD2, 0x07
+};
+
+static const uint8_t MNM_packed_MuonGFactor[] =
+{
+	0x03, 0x0A, 0x17, 0x00, 0x04, 0x84, 0x05, 0x70, 0x0C, 0x17, 0x00, 0x02, 0x00
+};
+
+static const uint8_t MNM_packed_GravitationalAcceleration[] =
+{
+	0x02, 0x0A, 0x09, 0x00, 0x02, 0x99, 0x02, 0x62, 0x00
+};
+
+static const uint8_t MNM_packed_GravitationalConstant[] =
+{
+	0x02, 0x0A, 0x23, 0x00, 0x02, 0x33, 0x0B, 0x12, 0x1A
+};
+
+static const uint8_t MNM_packed_QuantumConductance[] =
+{
+	0x02, 0x0A, 0x21, 0x00, 0x04, 0xC5, 0x01, 0xD2, 0x23, 0x38, 0x1D, 0x07, 0x00
+};
+
+static const uint8_t MNM_packed_PlanckConstant[] =
+{
+	0x02, 0x0A, 0x57, 0x00, 0x03, 0xA1, 0x25, 0xB4, 0x17, 0x96, 0x02
+};
+
+static const uint8_t MNM_packed_PlanckConstantPi[] =
+{
+	0x02, 0x0A, 0x59, 0x00, 0x03, 0x25, 0x0B, 0x54, 0x16, 0x1E, 0x04
+};
+
+static const uint8_t MNM_packed_BoltmannConstant[] =
+{
+	0x02, 0x0A, 0x3F, 0x00, 0x03, 0xA8, 0x01, 0x81, 0x1F, 0x0D, 0x00
+};
+
+static const uint8_t MNM_packed_PlanckLength[] =
+{
+	0x02, 0x0A, 0x55, 0x00, 0x03, 0xA1, 0x14, 0x12, 0x18, 0x01, 0x00
+};
+
+static const uint8_t MNM_packed_ElectronComptonWavelengthPi[] =
+{
+	0x02, 0x0A, 0x31, 0x00, 0x04, 0x41, 0x17, 0x30, 0x24, 0xA7, 0x21, 0x03, 0x00
+};
+
+static const uint8_t MNM_packed_NeutronComptonWavelength[] =
+{
+	0x02, 0x0A, 0x35, 0x00, 0x04, 0x00, 0x14, 0x81, 0x23, 0x7B, 0x0C, 0x01, 0x00
+};
+
+static const uint8_t MNM_packed_ProtonComptonWavelength[] =
+{
+	0x02, 0x0A, 0x35, 0x00, 0x04, 0x0B, 0x12, 0xD8, 0x03, 0x8E, 0x0C, 0x01, 0x00
+};
+
+static const uint8_t MNM_packed_ElectronComptonWavelength[] =
+{
+	0x02, 0x0A, 0x2F, 0x00, 0x04, 0x6D, 0x1D, 0xFD, 0x03, 0xA7, 0x10, 0x02, 0x00
+};
+
+static const uint8_t MNM_packed_DeuteronMass[] =
+{
+	0x02, 0x0A, 0x49, 0x00, 0x03, 0xE1, 0x07, 0xFF, 0x0D, 0x4E, 0x01
+};
+
+static const uint8_t MNM_packed_ElectronMass[] =
+{
+	0x02, 0x0A, 0x51, 0x00, 0x03, 0x09, 0x06, 0xA6, 0x24, 0x8E, 0x03
+};
+
+static const uint8_t MNM_packed_NeutronMass[] =
+{
+	0x02, 0x0A, 0x43, 0x00, 0x02, 0x46, 0x24, 0x8A, 0x06
+};
+
+static const uint8_t MNM_packed_PlanckMass[] =
+{
+	0x02, 0x0A, 0x1D, 0x00, 0x02, 0x3B, 0x11, 0x80, 0x08
+};
+
+static const uint8_t MNM_packed_ProtonMass[] =
+{
+	0x02, 0x0A, 0x4B, 0x00, 0x03, 0xC7, 0x0E, 0x48, 0x18, 0x88, 0x06
+};
+
+static const uint8_t MNM_packed_AtomicMassConstant[] =
+{
+	0x02, 0x0A, 0x4B, 0x00, 0x03, 0x5B, 0x20, 0x0B, 0x15, 0x7C, 0x06
+};
+
+static const uint8_t MNM_packed_VacuumMagneticPermittivity[] =
+{
+	0x02, 0x0A, 0x3B, 0x00, 0x07, 0xC1, 0x13, 0x42, 0x25, 0xD4, 0x23, 0x9B, 0x05, 0x7A, 0x0E, 0x06,
+	0x0A, 0x01, 0x00
+};
+
+static const uint8_t MNM_packed_BohrMagneton[] =
+{
+	0x02, 0x0A, 0x43, 0x00, 0x03, 0xF3, 0x05, 0xA9, 0x0F, 0x9F, 0x03
+};
+
+static const uint8_t MNM_packed_DeuteronMagneticMoment[] =
+{
+	0x02, 0x0A, 0x49, 0x00, 0x03, 0x6F, 0x19, 0xDE, 0x02, 0xB1, 0x01
+};
+
+static const uint8_t MNM_packed_NuclearMagneton[] =
+{
+	0x02, 0x0A, 0x49, 0x00, 0x03, 0x6D, 0x09, 0x0F, 0x03, 0xF9, 0x01
+};
+
+static const uint8_t MNM_packed_LoschmidtConstant[] =
+{
+	0x02, 0x0A, 0x20, 0x00, 0x03, 0x17, 0x1D, 0xE5, 0x21, 0x1A, 0x00
+};
+
+static const uint8_t MNM_packed_AvagadroConstant[] =
+{
+	0x02, 0x0A, 0x1A, 0x00, 0x03, 0xFA, 0x1E, 0x5D, 0x08, 0x5A, 0x02
+};
+
+static const uint8_t MNM_packed_MagneticFluxQuantum[] =
+{
+	0x02, 0x0A, 0x33, 0x00, 0x03, 0x60, 0x1A, 0x90, 0x20, 0x13, 0x08
+};
+
+static const uint8_t MNM_packed_ClassicalElectronRadius[] =
+{
+	0x02, 0x0A, 0x35, 0x00, 0x04, 0xF2, 0x24, 0xBC, 0x0F, 0xF3, 0x1F, 0x02, 0x00
+};
+
+static const uint8_t MNM_packed_QuantizedHallResistance[] =
+{
+	0x02, 0x0A, 0x07, 0x00, 0x03, 0x7F, 0x1F, 0xB4, 0x16, 0x02, 0x00
+};
+
+static const uint8_t MNM_packed_MolarGasConstant[] =
+{
+	0x02, 0x0A, 0x0F, 0x00, 0x03, 0x2F, 0x1C, 0x48, 0x0C, 0x08, 0x00
+};
+
+static const uint8_t MNM_packed_RydbergConstant[] =
+{
+	0x02, 0x0A, 0x0F, 0x00, 0x04, 0xD5, 0x0A, 0x35, 0x16, 0x93, 0x0E, 0x49, 0x04
+};
+
+static const uint8_t MNM_packed_ElectronThomsonCrossSection[] =
+{
+	0x02, 0x0A, 0x4F, 0x00, 0x03, 0xC3, 0x16, 0xE9, 0x11, 0xFC, 0x19
+};
+
+static const uint8_t MNM_packed_StefanBoltzmannConstant[] =
+{
+	0x02, 0x0A, 0x1F, 0x00, 0x03, 0x28, 0x00, 0x30, 0x1A, 0x05, 0x00
+};
+
+static const uint8_t MNM_packed_PlanckTime[] =
+{
+	0x02, 0x0A, 0x65, 0x00, 0x02, 0x7B, 0x09, 0x0F, 0x15
+};
+
+static const uint8_t MNM_packed_PlanckTemperature[] =
+{
+	0x02, 0x0A, 0x34, 0x00, 0x02, 0x81, 0x1A, 0x8D, 0x00
+};
+
+static const uint8_t MNM_packed_MolarVolume[] =
+{
+	0x02, 0x0A, 0x15, 0x00, 0x03, 0xA7, 0x25, 0x2B, 0x10, 0x16, 0x00
+};
+
+static const BFPackedNumber MNM_packed_constants[MolarVolume + 1] =
+{
+	[BohrRadius] = {MNM_packed_BohrRadius, sizeof(MNM_packed_BohrRadius)},
+	[StructureConstant] = {MNM_packed_StructureConstant, sizeof(MNM_packed_StructureConstant)},
+	[StandardAtmosphere] = {MNM_packed_StandardAtmosphere, sizeof(MNM_packed_StandardAtmosphere)},
+	[WienDisplacement] = {MNM_packed_WienDisplacement, sizeof(MNM_packed_WienDisplacement)},
+	[RadiationConstant1] = {MNM_packed_RadiationConstant1, sizeof(MNM_packed_RadiationConstant1)},
+	[RadiationConstant2] = {MNM_packed_RadiationConstant2, sizeof(MNM_packed_RadiationConstant2)},
+	[SpeedOfLight] = {MNM_packed_SpeedOfLight, sizeof(MNM_packed_SpeedOfLight)},
+	[HartreeEnergy] = {MNM_packed_HartreeEnergy, sizeof(MNM_packed_HartreeEnergy)},
+	[ElementaryCharge] = {MNM_packed_ElementaryCharge, sizeof(MNM_packed_ElementaryCharge)},
+	[VacuumPermittivity] = {MNM_packed_VacuumPermittivity, sizeof(MNM_packed_VacuumPermittivity)},
+	[ElectronVolt] = {MNM_packed_ElectronVolt, sizeof(MNM_packed_ElectronVolt)},
+	[FaradayConstant] = {MNM_packed_FaradayConstant, sizeof(MNM_packed_FaradayConstant)},
+	[ElectronGFactor] = {MNM_packed_ElectronGFactor, sizeof(MNM_packed_ElectronGFactor)},
+	[MuonGFactor] = {MNM_packed_MuonGFactor, sizeof(MNM_packed_MuonGFactor)},
+	[GravitationalAcceleration] = {MNM_packed_GravitationalAcceleration, sizeof(MNM_packed_GravitationalAcceleration)},
+	[GravitationalConstant] = {MNM_packed_GravitationalConstant, sizeof(MNM_packed_GravitationalConstant)},
+	[QuantumConductance] = {MNM_packed_QuantumConductance, sizeof(MNM_packed_QuantumConductance)},
+	[PlanckConstant] = {MNM_packed_PlanckConstant, sizeof(MNM_packed_PlanckConstant)},
+	[PlanckConstantPi] = {MNM_packed_PlanckConstantPi, sizeof(MNM_packed_PlanckConstantPi)},
+	[BoltmannConstant] = {MNM_packed_BoltmannConstant, sizeof(MNM_packed_BoltmannConstant)},
+	[PlanckLength] = {MNM_packed_PlanckLength, sizeof(MNM_packed_PlanckLength)},
+	[ElectronComptonWavelengthPi] = {MNM_packed_ElectronComptonWavelengthPi, sizeof(MNM_packed_ElectronComptonWavelengthPi)},
+	[NeutronComptonWavelength] = {MNM_packed_NeutronComptonWavelength, sizeof(MNM_packed_NeutronComptonWavelength)},
+	[ProtonComptonWavelength] = {MNM_packed_ProtonComptonWavelength, sizeof(MNM_packed_ProtonComptonWavelength)},
+	[ElectronComptonWavelength] = {MNM_packed_ElectronComptonWavelength, sizeof(MNM_packed_ElectronComptonWavelength)},
+	[DeuteronMass] = {MNM_packed_DeuteronMass, sizeof(MNM_packed_DeuteronMass)},
+	[ElectronMass] = {MNM_packed_ElectronMass, sizeof(MNM_packed_ElectronMass)},
+	[NeutronMass] = {MNM_packed_NeutronMass, sizeof(MNM_packed_NeutronMass)},
+	[PlanckMass] = {MNM_packed_PlanckMass, sizeof(MNM_packed_PlanckMass)},
+	[ProtonMass] = {MNM_packed_ProtonMass, sizeof(MNM_packed_ProtonMass)},
+	[AtomicMassConstant] = {MNM_packed_AtomicMassConstant, sizeof(MNM_packed_AtomicMassConstant)},
+	[VacuumMagneticPermittivity] = {MNM_packed_VacuumMagneticPermittivity, sizeof(MNM_packed_VacuumMagneticPermittivity)},
+	[BohrMagneton] = {MNM_packed_BohrMagneton, sizeof(MNM_packed_BohrMagneton)},
+	[DeuteronMagneticMoment] = {MNM_packed_DeuteronMagneticMoment, sizeof(MNM_packed_DeuteronMagneticMoment)},
+	[NuclearMagneton] = {MNM_packed_NuclearMagneton, sizeof(MNM_packed_NuclearMagneton)},
+	[LoschmidtConstant] = {MNM_packed_LoschmidtConstant, sizeof(MNM_packed_LoschmidtConstant)},
+	[AvagadroConstant] = {MNM_packed_AvagadroConstant, sizeof(MNM_packed_AvagadroConstant)},
+	[MagneticFluxQuantum] = {MNM_packed_MagneticFluxQuantum, sizeof(MNM_packed_MagneticFluxQuantum)},
+	[ClassicalElectronRadius] = {MNM_packed_ClassicalElectronRadius, sizeof(MNM_packed_ClassicalElectronRadius)},
+	[QuantizedHallResistance] = {MNM_packed_QuantizedHallResistance, sizeof(MNM_packed_QuantizedHallResistance)},
+	[MolarGasConstant] = {MNM_packed_MolarGasConstant, sizeof(MNM_packed_MolarGasConstant)},
+	[RydbergConstant] = {MNM_packed_RydbergConstant, sizeof(MNM_packed_RydbergConstant)},
+	[ElectronThomsonCrossSection] = {MNM_packed_ElectronThomsonCrossSection, sizeof(MNM_packed_ElectronThomsonCrossSection)},
+	[StefanBoltzmannConstant] = {MNM_packed_StefanBoltzmannConstant, sizeof(MNM_packed_StefanBoltzmannConstant)},
+	[PlanckTime] = {MNM_packed_PlanckTime, sizeof(MNM_packed_PlanckTime)},
+	[PlanckTemperature] = {MNM_packed_PlanckTemperature, sizeof(MNM_packed_PlanckTemperature)},
+	[MolarVolume] = {MNM_packed_MolarVolume, sizeof(MNM_packed_MolarVolume)}
+};
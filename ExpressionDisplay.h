@@ -21,7 +21,8 @@
 @interface ExpressionDisplay : NSView
 {
 	IBOutlet DataManager	*dataManager;
-	NSBezierPath				*expressionPath;
+	NSAffineTransform			*expressionTransform;
+	NSRect						expressionRect;
 	NSBezierPath				*resultPath;
 	NSBezierPath				*caretPath;
 	
@@ -31,7 +32,6 @@
 
 - (void)drawRect:(NSRect)rect;
 - (void)expressionChanged;
-@property (NS_NONATOMIC_IOSONLY, readonly, copy) NSBezierPath *expressionPathFlipped;
 - (void)mouseDown:(NSEvent*)theEvent;
 - (void)setFrame:(NSRect)frameRect;
 @property (NS_NONATOMIC_IOSONLY, readonly, copy) NSData *pdfData;
@@ -40,7 +40,8 @@
 	self = [super initWithFrame:frame];
 	if (self)
 	{
-		expressionPath = [NSBezierPath bezierPath];
+		expressionTransform = [NSAffineTransform transform];
+		expressionRect = NSZeroRect;
 		resultPath = [NSBezierPath bezierPath];
 		
 		caretPath = [NSBezierPath bezierPath];
@@ -71,8 +72,8 @@ NSBezierPath* GetResultPath(Expression* expression)
 	// Get the result value
 	valuePath = [expression getValuePathWithLevel:0];
 	
-	// Get the equals sign
-	resultPath = [ExpressionSymbols equalsPath];
+	// Get the equals sign (copied since the symbol path is shared)
+	resultPath = [[ExpressionSymbols equalsPath] copy];
 	resultBounds = [resultPath bounds];
 	
 	// Move the result into place (after the equals sign) 
@@ -116,17 +117,20 @@ NSBezierPath* GetResultPath(Expression* expression)
 		return;
 	}
 	
-	if (![expressionPath isEmpty])
+	if (!NSIsEmptyRect(expressionRect))
 	{
 		[[NSColor textColor] set];
-		[expressionPath fill];
+		[NSGraphicsContext saveGraphicsState];
+		[expressionTransform concat];
+		[[dataManager getCurrentExpression] draw];
+		[NSGraphicsContext restoreGraphicsState];
 	}
 	if (![resultPath isEmpty])
 	{
 		[[NSColor textColor] set];
 		[resultPath fill];
 	}
-	else if (![expressionPath isEmpty])
+	else if (!NSIsEmptyRect(expressionRect))
 	{
 		[[NSColor labelColor] set];
 		[caretPath stroke];
@@ -149,8 +153,8 @@ NSBezierPath* GetResultPath(Expression* expression)
 	double		availableHeight = frameRect.size.height - 10.0;
 	
 	// Ensure that the old area is updated
-	if (![expressionPath isEmpty])
-		[self setNeedsDisplayInRect:[expressionPath bounds]];
+	if (!NSIsEmptyRect(expressionRect))
+		[self setNeedsDisplayInRect:expressionRect];
 	if (![resultPath isEmpty])
 		[self setNeedsDisplayInRect:[resultPath bounds]];
 	[self setNeedsDisplayInRect:[caretPath bounds]];
@@ -176,17 +180,19 @@ NSBezierPath* GetResultPath(Expression* expression)
 		resultPath = [NSBezierPath bezierPath];
 	}
 
-	// Get the bezier path for the expression
-	expressionPath = [displayExpression pathAtLevel:0];
+	// Lay out the expression. Only the nodes changed since the last layout are recomposed;
+	// the whole tree is then positioned by a single transform.
+	expressionRect = [displayExpression naturalBoundsAtLevel:0];
+	expressionTransform = [NSAffineTransform transform];
 	
 	frameRect.size = [[self enclosingScrollView] contentSize];
 
-	if (![expressionPath isEmpty])
+	if (!NSIsEmptyRect(expressionRect))
 	{
 		NSAffineTransform	*transform = [NSAffineTransform transform];
 		double	scale = (frameRect.size.height / DEFAULT_HEIGHT); // 104.0 is the default height
 
-		expressionBounds = [expressionPath bounds];
+		expressionBounds = expressionRect;
 		
 		// Limit the amount that things can scale up.
 		if (scale > availableHeight / expressionBounds.size.height)
@@ -194,8 +200,8 @@ NSBezierPath* GetResultPath(Expression* expression)
 		
 		// Adjust the scale
 		[transform scaleBy:scale];
-		[expressionPath transformUsingAffineTransform:transform];
-		expressionBounds = [expressionPath bounds];
+		[self transformExpressionUsing:transform];
+		expressionBounds = expressionRect;
 	}
 	
 	// Determine the required width of this view and adjust appropriately
@@ -210,8 +216,8 @@ NSBezierPath* GetResultPath(Expression* expression)
 	// place the input caret.
 	[self setFrame:frameRect];
 	
-	if (![expressionPath isEmpty])
-		expressionBounds = [expressionPath bounds];
+	if (!NSIsEmptyRect(expressionRect))
+		expressionBounds = expressionRect;
 	if (![resultPath isEmpty])
 		resultBounds = [resultPath bounds];
 
@@ -225,7 +231,7 @@ NSBezierPath* GetResultPath(Expression* expression)
 	[self setNeedsDisplayInRect:resultBounds];
 	[self setNeedsDisplayInRect:[caretPath bounds]];
 
-	if ([dataManager getEqualsPressed] || ![expressionPath isEmpty])
+	if ([dataManager getEqualsPressed] || !NSIsEmptyRect(expressionRect))
 	{
 		NSRect	scrollTarget;
 		NSSize	visibleSize = [[self enclosingScrollView] contentSize];
@@ -263,34 +269,15 @@ NSBezierPath* GetResultPath(Expression* expression)
 }
 
 //
-// expressionPathFlipped
+// transformExpressionUsing
 //
-// Returns the expression path flipped vertically for display in the history view which
-// has its origin in a different place.
+// Moves the displayed expression by appending to its transform. The expression's geometry
+// itself is never modified; it is mapped through expressionTransform when drawn.
 //
-- (NSBezierPath*)expressionPathFlipped
+- (void)transformExpressionUsing:(NSAffineTransform*)transform
 {
-	NSBezierPath 		*path;
-	NSAffineTransform	*transform;
-	NSSize				visibleSize = [[self enclosingScrollView] contentSize];
-	
-	path = [NSBezierPath bezierPath];
-	transform = [NSAffineTransform transform];
-	
-	if (![expressionPath isEmpty])
-	{
-		NSRect	bounds = [expressionPath bounds];
-		
-		[path appendBezierPath:expressionPath];
-		[transform scaleXBy:DEFAULT_HEIGHT / visibleSize.height yBy:-DEFAULT_HEIGHT / visibleSize.height];
-		[transform
-			translateXBy:-bounds.origin.x
-			yBy:-bounds.size.height - bounds.origin.y
-		];
-		[path transformUsingAffineTransform:transform];
-	}
-	
-	return path;
+	[expressionTransform appendTransform:transform];
+	expressionRect = [Expression rect:expressionRect transformedBy:transform];
 }
 
 //
@@ -300,11 +287,11 @@ NSBezierPath* GetResultPath(Expression* expression)
 //
 - (NSData *)pdfData
 {
-	if (![expressionPath isEmpty])
+	if (!NSIsEmptyRect(expressionRect))
 	{
 		NSBezierPath *savedCaret = caretPath;
 		caretPath = nil;
-		NSData *result = [self dataWithPDFInsideRect:NSInsetRect([expressionPath bounds], -5, -5)];
+		NSData *result = [self dataWithPDFInsideRect:NSInsetRect(expressionRect, -5, -5)];
 		caretPath = savedCaret;
 		return result;
 	}
@@ -353,7 +340,7 @@ NSBezierPath* GetResultPath(Expression* expression)
 	}
 	
 	// Centre the expression horizontally and vertically in the gap above the result and draw it
-	if (![expressionPath isEmpty])
+	if (!NSIsEmptyRect(expressionRect))
 	{
 		NSAffineTransform *transform = [NSAffineTransform transform];
 		double	xTranslate;
@@ -363,7 +350,7 @@ NSBezierPath* GetResultPath(Expression* expression)
 		NSPoint	oldCaretPoint;
 		NSPoint	newCaretPoint;
 
-		expressionBounds = [expressionPath bounds];
+		expressionBounds = expressionRect;
 		
 		// Limit the amount that things can scale up.
 		if (scale > (frameRect.size.height - 10.0 - resultBounds.size.height) / expressionBounds.size.height)
@@ -375,8 +362,8 @@ NSBezierPath* GetResultPath(Expression* expression)
 			
 			// Adjust the scale
 			[transform scaleBy:scale];
-			[expressionPath transformUsingAffineTransform:transform];
-			expressionBounds = [expressionPath bounds];
+			[self transformExpressionUsing:transform];
+			expressionBounds = expressionRect;
 
 			tempRect = frameRect;
 			tempRect.size = [[self enclosingScrollView] contentSize];
@@ -392,11 +379,11 @@ NSBezierPath* GetResultPath(Expression* expression)
 			xTranslate = (frameRect.size.width - expressionBounds.size.width) / 2.0 - expressionBounds.origin.x;
 			yTranslate = (frameRect.size.height - expressionBounds.size.height - resultBounds.size.height - resultBounds.origin.y - 10.0) / 2.0 + (resultBounds.size.height + resultBounds.origin.y) - expressionBounds.origin.y + 5.0;
 			[transform translateXBy:xTranslate yBy:yTranslate];
-			[expressionPath transformUsingAffineTransform:transform];
+			[self transformExpressionUsing:transform];
 		}
 	
 		// Tell the current expression where it has been placed
-		expressionBounds = [expressionPath bounds];
+		expressionBounds = expressionRect;
 		[[dataManager getCurrentExpression] receiveBounds:expressionBounds];
 
 		oldCaretPoint = [caretPath currentPoint];
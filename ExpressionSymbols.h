@@ -13,7 +13,8 @@
 //
 // About ExpressionSymbols
 //
-// A single instance class that maintains the bezier paths for most drawable symbols
+// A single instance class that maintains the bezier paths for most drawable symbols.
+// The returned paths are cached and shared, so callers must never modify them in place.
 //
 
 //
@@ -108,6 +109,8 @@ typedef NS_ENUM(NSInteger, ConstType) {
 + (NSBezierPath *)xnorPath;
 + (NSBezierPath *)notPath;
 + (NSBezierPath *)rndPath;
++ (NSBezierPath *)primePath;
++ (NSBezierPath *)lpfPath;
 + (NSBezierPath *)logPath;
 + (NSBezierPath *)sub2Path;
 + (NSBezierPath *)lnPath;
@@ -122,6 +125,8 @@ typedef NS_ENUM(NSInteger, ConstType) {
 + (NSBezierPath *)modPath;
 + (NSBezierPath *)nprPath;
 + (NSBezierPath *)ncrPath;
++ (NSBezierPath *)gcdPath;
++ (NSBezierPath *)lcmPath;
 + (NSBezierPath *)leftBracketPath;
 + (NSBezierPath *)rightBracketPath;
 + (NSBezierPath *)dotPath;
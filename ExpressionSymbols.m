@@ -7,6 +7,7 @@
 // ##############################################################
 
 #import "ExpressionSymbols.h"
+#import "ExpressionConstants.h"
 
 //
 // About ExpressionSymbols
@@ -21,7 +22,8 @@ static NSArray *constantsDataRows = nil;
 //
 // initialize
 //
-// Called once at program startup. Creates all the symbols.
+// Called once at program startup. Creates the symbol cache; the constants wait for
+// their first use.
 //
 + (void)initialize
 {
@@ -29,65 +31,90 @@ static NSArray *constantsDataRows = nil;
 	
 	// Create the array for holding the symbols
 	symbols = [NSMutableDictionary dictionary];
+}
 
-	//
-	// Constant values were updated from NIST to the known accuracies as of January 2008.
-	// A few constant names were changed to make them unique and avoid confusion with
-	// other constants since these names are used in the equations.
-	//
-	// Update by Michael Griebling
-	constantsDataRows =
-	@[
-	  @[@"a_0",	  @"	Bohr radius (m)",							[BigCFloat bigFloatWithString:@"0.5291772085936e-10" radix:10]],
-	  @[@"α",	  @"	Fine structure constant",					[BigCFloat bigFloatWithString:@"7.297352537650e-3" radix:10]],
-	  @[@"atm",	  @"	Standard atmosphere (Pa)",					[BigCFloat bigFloatWithInt:101325 radix:10]],
-	  @[@"b",	  @"	Wien displacement law constant (m K)",		[BigCFloat bigFloatWithString:@"2.897768551e-3" radix:10]],
-	  @[@"c_1",	  @"	First radiation constant (W m²)",			[BigCFloat bigFloatWithString:@"3.7417711819e-16" radix:10]],
-	  @[@"c_2",	  @"	Second radiation constant (m K)",			[BigCFloat bigFloatWithString:@"1.438775225e-2" radix:10]],
-	  @[@"c",	  @"	Speed of light in vacuum (m s⁻¹)",			[BigCFloat bigFloatWithInt:299792458 radix:10]],
-	  @[@"E_h",	  @"	Hartree energy (J)",						[BigCFloat bigFloatWithString:@"4.3597439422e-18" radix:10]],
-	  @[@"e_c",	  @"	Elementary charge (C)",						[BigCFloat bigFloatWithString:@"1.60217648740e-19" radix:10]],
-	  @[@"ε_0",	  @"	Permittivity of vacuum (F m⁻¹)",			[BigCFloat bigFloatWithString:@"8.854187817620389850536563e-12" radix:10]],
-	  @[@"eV",	  @"	Electron volt (J)",							[BigCFloat bigFloatWithString:@"1.60217648740e-19" radix:10]],
-	  @[@"F",	  @"	Faraday constant (C mol⁻¹)",				[BigCFloat bigFloatWithString:@"96485.339924" radix:10]],
-	  @[@"g_e",	  @"	Electron g-factor",							[BigCFloat bigFloatWithString:@"-2.002319304362215" radix:10]],
-	  @[@"g_µ",	  @"	Muon g-factor",								[BigCFloat bigFloatWithString:@"-2.002331841412" radix:10]],
-	  @[@"g_n",	  @"	Standard acceleration of gravity (m s⁻²)",	[BigCFloat bigFloatWithString:@"9.80665" radix:10]],
-	  @[@"G",	  @"	Gravitational constant (m³ kg⁻¹ s⁻²)",		[BigCFloat bigFloatWithString:@"6.6742867e-11" radix:10]],
-	  @[@"G_0",	  @"	Conductance quantum (s)",					[BigCFloat bigFloatWithString:@"7.748091700453e-5" radix:10]],
-	  @[@"h",	  @"	Planck constant (J s)",						[BigCFloat bigFloatWithString:@"6.6260689633e-34" radix:10]],
-	  @[@"ħ",	  @"	Planck constant/2π (J s)",					[BigCFloat bigFloatWithString:@"1.05457162853e-34" radix:10]],
-	  @[@"i",	  @"	square-root of -1",							[BigCFloat i]],
-	  @[@"k",	  @"	Boltzmann constant (J K⁻¹)",				[BigCFloat bigFloatWithString:@"1.380650424e-23" radix:10]],
-	  @[@"l_p",	  @"	Planck length (m)",							[BigCFloat bigFloatWithString:@"1.61625281e-35" radix:10]],
-	  @[@"ƛ_C",	  @"	Electron Compton wavelength/2π (m)",		[BigCFloat bigFloatWithString:@"3.861592645953e-13" radix:10]],
-	  @[@"λ_C,n", @"	Neutron Compton wavelength (m)",			[BigCFloat bigFloatWithString:@"1.319590895120e-15" radix:10]],
-	  @[@"λ_C,p", @"	Proton Compton wavelength (m)",				[BigCFloat bigFloatWithString:@"1.321409844619e-15" radix:10]],
-	  @[@"λ_C",	  @"	Electron Compton wavelength (m)",			[BigCFloat bigFloatWithString:@"2.426310217533e-12" radix:10]],
-	  @[@"m_d",	  @"	Deuteron mass (kg)",						[BigCFloat bigFloatWithString:@"3.3435832017e-27" radix:10]],
-	  @[@"m_e",	  @"	Electron mass (Kg)",						[BigCFloat bigFloatWithString:@"9.1093821545e-31" radix:10]],
-	  @[@"m_n",	  @"	Neutron mass (kg)",							[BigCFloat bigFloatWithString:@"1.6749286e-27" radix:10]],
-	  @[@"m_P",	  @"	Planck mass (kg)",							[BigCFloat bigFloatWithString:@"2.1764411e-08" radix:10]],
-	  @[@"m_p",	  @"	Proton mass (kg)",							[BigCFloat bigFloatWithString:@"1.67262163783e-27" radix:10]],
-	  @[@"m_u",	  @"	Atomic mass constant (kg)",					[BigCFloat bigFloatWithString:@"1.66053878283e-27" radix:10]],
-	  @[@"µ_0",	  @"	Magnetic Permittivity of vacuum (N A⁻²)",	[BigCFloat bigFloatWithString:@"12.56637061435917295385057e-7" radix:10]],
-	  @[@"µ_B",	  @"	Bohr magneton (J T⁻¹)",						[BigCFloat bigFloatWithString:@"9.2740091523e-24" radix:10]],
-	  @[@"µ_d",	  @"	Deuteron magnetic moment (J T⁻¹)",			[BigCFloat bigFloatWithString:@"4.3307346511e-27" radix:10]],
-	  @[@"µ_N",	  @"	Nuclear magneton (J T⁻¹)",					[BigCFloat bigFloatWithString:@"5.0507832413e-27" radix:10]],
-	  @[@"n_0",	  @"	Loschmidt constant (m⁻³)",					[BigCFloat bigFloatWithString:@"2.686777447e+25" radix:10]],
-	  @[@"N_A",	  @"	Avagadro constant (mol⁻¹)",					[BigCFloat bigFloatWithString:@"6.0221417930e+23" radix:10]],
-	  @[@"φ_0",	  @"	Magnetic flux quantum (Wb)",				[BigCFloat bigFloatWithString:@"2.06783366752e-15" radix:10]],
-	  @[@"π",	  @"	Pi",										[BigCFloat piWithRadix:10]],
-	  @[@"r_e",	  @"	Electron classical radius (m)",				[BigCFloat bigFloatWithString:@"2.817940289458e-15" radix:10]],
-	  @[@"R_H",	  @"	Quantized Hall resistance (Ω)",				[BigCFloat bigFloatWithString:@"25812.8063" radix:10]],
-	  @[@"R",	  @"	Molar gas constant (J mol⁻¹ K⁻¹)",			[BigCFloat bigFloatWithString:@"8.31447215" radix:10]],
-	  @[@"R_∞",	  @"	Rydberg constant (m⁻¹)",					[BigCFloat bigFloatWithString:@"10973731.56852773" radix:10]],
-	  @[@"σ_e",	  @"	Electron Thomson cross section (m²)",		[BigCFloat bigFloatWithString:@"6.65245855827e-29" radix:10]],
-	  @[@"σ",	  @"	Stefan-Boltzmann const. (W m⁻² K⁻⁴)",		[BigCFloat bigFloatWithString:@"5.67040040e-08" radix:10]],
-	  @[@"t_p",	  @"	Planck time (s)",							[BigCFloat bigFloatWithString:@"5.3912427e-44" radix:10]],
-	  @[@"T_P",	  @"	Planck temperature (K)",					[BigCFloat bigFloatWithString:@"1.416785e32" radix:10]],
-	  @[@"V_m",	  @"	Molar vol. (ideal gas at STP) (m³ mol⁻¹)",	[BigCFloat bigFloatWithString:@"22.41399639e-3" radix:10]]
-	];
+//
+// MNM_PackedConstant
+//
+// A physical constant from the table generated into ExpressionConstants.h.
+//
+static BigCFloat *
+MNM_PackedConstant(ConstType constant)
+{
+	return [BigCFloat bigFloatWithReal:[BigFloat bigFloatWithPackedNumber:MNM_packed_constants[constant]] imaginary:[BigFloat bigFloatWithInt:0 radix:10]];
+}
+
+//
+// constantsDataRows
+//
+// The constants table, made on first use. The values are packed ahead of time by
+// Tools/make_constants.py so nothing is parsed or calculated here.
+//
++ (NSArray *)constantsDataRows
+{
+	static dispatch_once_t once;
+	
+	dispatch_once(&once, ^{
+		//
+		// Constant values were updated from NIST to the known accuracies as of January 2008.
+		// A few constant names were changed to make them unique and avoid confusion with
+		// other constants since these names are used in the equations.
+		//
+		// Update by Michael Griebling
+		constantsDataRows =
+		@[
+		  @[@"a_0",	  @"	Bohr radius (m)",							MNM_PackedConstant(BohrRadius)],
+		  @[@"α",	  @"	Fine structure constant",					MNM_PackedConstant(StructureConstant)],
+		  @[@"atm",	  @"	Standard atmosphere (Pa)",					MNM_PackedConstant(StandardAtmosphere)],
+		  @[@"b",	  @"	Wien displacement law constant (m K)",		MNM_PackedConstant(WienDisplacement)],
+		  @[@"c_1",	  @"	First radiation constant (W m²)",			MNM_PackedConstant(RadiationConstant1)],
+		  @[@"c_2",	  @"	Second radiation constant (m K)",			MNM_PackedConstant(RadiationConstant2)],
+		  @[@"c",	  @"	Speed of light in vacuum (m s⁻¹)",			MNM_PackedConstant(SpeedOfLight)],
+		  @[@"E_h",	  @"	Hartree energy (J)",						MNM_PackedConstant(HartreeEnergy)],
+		  @[@"e_c",	  @"	Elementary charge (C)",						MNM_PackedConstant(ElementaryCharge)],
+		  @[@"ε_0",	  @"	Permittivity of vacuum (F m⁻¹)",			MNM_PackedConstant(VacuumPermittivity)],
+		  @[@"eV",	  @"	Electron volt (J)",							MNM_PackedConstant(ElectronVolt)],
+		  @[@"F",	  @"	Faraday constant (C mol⁻¹)",				MNM_PackedConstant(FaradayConstant)],
+		  @[@"g_e",	  @"	Electron g-factor",							MNM_PackedConstant(ElectronGFactor)],
+		  @[@"g_µ",	  @"	Muon g-factor",								MNM_PackedConstant(MuonGFactor)],
+		  @[@"g_n",	  @"	Standard acceleration of gravity (m s⁻²)",	MNM_PackedConstant(GravitationalAcceleration)],
+		  @[@"G",	  @"	Gravitational constant (m³ kg⁻¹ s⁻²)",		MNM_PackedConstant(GravitationalConstant)],
+		  @[@"G_0",	  @"	Conductance quantum (s)",					MNM_PackedConstant(QuantumConductance)],
+		  @[@"h",	  @"	Planck constant (J s)",						MNM_PackedConstant(PlanckConstant)],
+		  @[@"ħ",	  @"	Planck constant/2π (J s)",					MNM_PackedConstant(PlanckConstantPi)],
+		  @[@"i",	  @"	square-root of -1",							[BigCFloat i]],
+		  @[@"k",	  @"	Boltzmann constant (J K⁻¹)",				MNM_PackedConstant(BoltmannConstant)],
+		  @[@"l_p",	  @"	Planck length (m)",							MNM_PackedConstant(PlanckLength)],
+		  @[@"ƛ_C",	  @"	Electron Compton wavelength/2π (m)",		MNM_PackedConstant(ElectronComptonWavelengthPi)],
+		  @[@"λ_C,n", @"	Neutron Compton wavelength (m)",			MNM_PackedConstant(NeutronComptonWavelength)],
+		  @[@"λ_C,p", @"	Proton Compton wavelength (m)",				MNM_PackedConstant(ProtonComptonWavelength)],
+		  @[@"λ_C",	  @"	Electron Compton wavelength (m)",			MNM_PackedConstant(ElectronComptonWavelength)],
+		  @[@"m_d",	  @"	Deuteron mass (kg)",						MNM_PackedConstant(DeuteronMass)],
+		  @[@"m_e",	  @"	Electron mass (Kg)",						MNM_PackedConstant(ElectronMass)],
+		  @[@"m_n",	  @"	Neutron mass (kg)",							MNM_PackedConstant(NeutronMass)],
+		  @[@"m_P",	  @"	Planck mass (kg)",							MNM_PackedConstant(PlanckMass)],
+		  @[@"m_p",	  @"	Proton mass (kg)",							MNM_PackedConstant(ProtonMass)],
+		  @[@"m_u",	  @"	Atomic mass constant (kg)",					MNM_PackedConstant(AtomicMassConstant)],
+		  @[@"µ_0",	  @"	Magnetic Permittivity of vacuum (N A⁻²)",	MNM_PackedConstant(VacuumMagneticPermittivity)],
+		  @[@"µ_B",	  @"	Bohr magneton (J T⁻¹)",						MNM_PackedConstant(BohrMagneton)],
+		  @[@"µ_d",	  @"	Deuteron magnetic moment (J T⁻¹)",			MNM_PackedConstant(DeuteronMagneticMoment)],
+		  @[@"µ_N",	  @"	Nuclear magneton (J T⁻¹)",					MNM_PackedConstant(NuclearMagneton)],
+		  @[@"n_0",	  @"	Loschmidt constant (m⁻³)",					MNM_PackedConstant(LoschmidtConstant)],
+		  @[@"N_A",	  @"	Avagadro constant (mol⁻¹)",					MNM_PackedConstant(AvagadroConstant)],
+		  @[@"φ_0",	  @"	Magnetic flux quantum (Wb)",				MNM_PackedConstant(MagneticFluxQuantum)],
+		  @[@"π",	  @"	Pi",										[BigCFloat piWithRadix:10]],
+		  @[@"r_e",	  @"	Electron classical radius (m)",				MNM_PackedConstant(ClassicalElectronRadius)],
+		  @[@"R_H",	  @"	Quantized Hall resistance (Ω)",				MNM_PackedConstant(QuantizedHallResistance)],
+		  @[@"R",	  @"	Molar gas constant (J mol⁻¹ K⁻¹)",			MNM_PackedConstant(MolarGasConstant)],
+		  @[@"R_∞",	  @"	Rydberg constant (m⁻¹)",					MNM_PackedConstant(RydbergConstant)],
+		  @[@"σ_e",	  @"	Electron Thomson cross section (m²)",		MNM_PackedConstant(ElectronThomsonCrossSection)],
+		  @[@"σ",	  @"	Stefan-Boltzmann const. (W m⁻² K⁻⁴)",		MNM_PackedConstant(StefanBoltzmannConstant)],
+		  @[@"t_p",	  @"	Planck time (s)",							MNM_PackedConstant(PlanckTime)],
+		  @[@"T_P",	  @"	Planck temperature (K)",					MNM_PackedConstant(PlanckTemperature)],
+		  @[@"V_m",	  @"	Molar vol. (ideal gas at STP) (m³ mol⁻¹)",	MNM_PackedConstant(MolarVolume)]
+		];
+	});
+	return constantsDataRows;
 }
 
 //
@@ -127,15 +154,15 @@ static NSArray *constantsDataRows = nil;
 }
 
 + (BigCFloat *)getValueForConstant:(enum ConstType)constant {
-	return constantsDataRows[constant][2];
+	return [ExpressionSymbols constantsDataRows][constant][2];
 }
 
 + (NSString *)getNameForConstant:(enum ConstType)constant {
-	return constantsDataRows[constant][0];
+	return [ExpressionSymbols constantsDataRows][constant][0];
 }
 
 + (NSArray *)getConstants {
-	return constantsDataRows;
+	return [ExpressionSymbols constantsDataRows];
 }
 
 + (NSFont *)getDisplayFontWithSize:(CGFloat)size {
@@ -180,8 +207,13 @@ static NSArray *constantsDataRows = nil;
 	return path;
 }
 
+//
+// getSymbolForString:withSuperscript:
+//
+// Returns the cached glyph path for the string. The path is shared by every caller so it
+// must not be modified -- append it to another path or use transformBezierPath: instead.
+//
 + (NSBezierPath *)getSymbolForString:(NSString *)string withSuperscript:(NSInteger)superscript {
-	NSBezierPath *copy = [NSBezierPath bezierPath];
 	NSBezierPath *symbol;
 	NSString *index = [NSString stringWithFormat:@"%@-%ld", string, superscript]; // distinguish between sub- and super-script
 	if (![symbols valueForKey:index]) {
@@ -190,8 +222,7 @@ static NSArray *constantsDataRows = nil;
 	} else {
 		symbol = symbols[index];
 	}
-	[copy appendBezierPath:symbol];
-	return copy;
+	return symbol;
 }
 
 + (NSBezierPath *)getSymbolForString:(NSString *)string {
@@ -392,6 +423,26 @@ static NSArray *constantsDataRows = nil;
 	return [ExpressionSymbols getSymbolForString:@"Int"];
 }
 
+//
+// primePath
+//
+// Returns the relevant bezier path.
+//
++ (NSBezierPath *)primePath
+{
+	return [ExpressionSymbols getSymbolForString:@"prime"];
+}
+
+//
+// lpfPath
+//
+// Returns the relevant bezier path.
+//
++ (NSBezierPath *)lpfPath
+{
+	return [ExpressionSymbols getSymbolForString:@"lpf"];
+}
+
 //
 // logPath
 //
@@ -440,10 +491,7 @@ static NSArray *constantsDataRows = nil;
 + (NSBezierPath *)nRootPath:(NSUInteger)n
 {
 	NSString *root = [NSString stringWithFormat:@"%lu", (unsigned long)n];
-    // NSBezierPath *path = [NSBezierPath init]; // [ExpressionSymbols sqrtPath];
-    NSBezierPath *path = [ExpressionSymbols makeSymbolForString:root usingSuperscript:10 withOffset:0];
-    // [path appendBezierPath:rootn];
-	return path;
+	return [ExpressionSymbols getSymbolForString:root withSuperscript:10];
 }
 
 //
@@ -536,6 +584,26 @@ static NSArray *constantsDataRows = nil;
 	return [ExpressionSymbols getSymbolForString:@"nCr"];
 }
 
+//
+// gcdPath
+//
+// Returns the relevant bezier path.
+//
++ (NSBezierPath *)gcdPath
+{
+	return [ExpressionSymbols getSymbolForString:@"gcd"];
+}
+
+//
+// lcmPath
+//
+// Returns the relevant bezier path.
+//
++ (NSBezierPath *)lcmPath
+{
+	return [ExpressionSymbols getSymbolForString:@"lcm"];
+}
+
 //
 // leftBracketPath
 //
@@ -11,12 +11,15 @@
 @interface History : NSObject <NSCoding>
 
 - (instancetype)init;
+- (instancetype)initWithLogAtURL:(NSURL *)logURL;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
 - (void)clear;
 
-- (void)addItem: (NSData *)data withBezierPath:(NSBezierPath*)path;
-- (NSArray *)getItemAtIndex: (NSInteger)index;
+- (BOOL)addItem: (NSData *)data searchText:(NSString *)text value:(double)value;
+- (BOOL)synchronize;
+- (NSData *)getItemAtIndex: (NSInteger)index;
 - (NSInteger)count;
+- (NSIndexSet *)itemsMatching:(NSString *)query;
 
 @end
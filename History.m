@@ -7,13 +7,46 @@
 //
 
 #import "History.h"
+#import "HistoryIndex.h"
+#import "Expression.h"
 
 //
 // Wrapper to support writing out of the history data
 //
+// When created with a log URL the history is backed by an append-only file: an 8 byte
+// header ("MNMH" and a version) followed by one record per item. A record is a 32 bit
+// payload length then the payload, which is the 32 bit length of the encoded expression,
+// the encoded expression and the search fields: "MNMS", the 32 bit length of the search
+// text, the search text (UTF-8) and the result as a 64 bit double (all little endian).
+// Logs written by earlier versions have no search fields, and some have an archived bezier
+// path after the expression instead; it is skipped. Rows are drawn from the expression
+// when the table shows them (see DrawerManager historyPathForData:).
+//
+// The search index (see HistoryIndex) is built from the search fields the first time the
+// history is searched, without decoding any expressions, and is then added to as items
+// are added.
+//
+// A second file alongside the log holds the 64 bit offset of each record so that startup
+// does not have to walk the log. At startup the log is memory mapped and rows are only
+// read when the table first asks for them. Adding an item appends one record and
+// one offset; nothing already written is rewritten.
+//
+
+static const char HistoryLogMagic[4] = {'M', 'N', 'M', 'H'};
+static const uint32_t HistoryLogVersion = 1;
+static const char HistorySearchMagic[4] = {'M', 'N', 'M', 'S'};
+static const NSUInteger HistoryLogHeaderSize = 8;
 
 @implementation History {
-	NSMutableArray *array;
+	NSMutableArray *array;			// encoded expressions, NSNull until a logged row is first read
+	NSData *mappedLog;				// the log as found at startup
+	NSMutableData *offsets;			// record offsets into mappedLog (host order)
+	NSURL *logURL;
+	NSURL *indexURL;
+	NSFileHandle *logHandle;
+	NSFileHandle *indexHandle;
+	HistoryIndex *searchIndex;					// nil until the first search
+	NSMutableDictionary *pendingSearchFields;	// row -> @[text, value] added before the first search
 }
 
 - (instancetype)init {
@@ -24,15 +57,270 @@
 	return self;
 }
 
-- (void)addItem: (NSData *)data withBezierPath:(NSBezierPath*)path {
-	NSArray *item = @[data, path, @(self.count+1)];
-	[array addObject:item];
+- (instancetype)initWithLogAtURL:(NSURL *)url {
+	self = [self init];
+	if (self) {
+		logURL = url;
+		indexURL = [[url URLByDeletingPathExtension] URLByAppendingPathExtension:@"index"];
+		[self openLog];
+	}
+	return self;
+}
+
+//
+// Reads the 32 bit little endian value at offset in data
+//
+static uint32_t
+HistoryReadLength(NSData *data, NSUInteger offset) {
+	uint32_t value;
+	[data getBytes:&value range:NSMakeRange(offset, sizeof(value))];
+	return NSSwapLittleIntToHost(value);
 }
 
-- (NSArray *)getItemAtIndex: (NSInteger)index {
-	if (index > self.count) {
+//
+// Returns the offset just past the record at offset, or 0 if the record is incomplete
+//
+static NSUInteger
+HistoryRecordEnd(NSData *log, NSUInteger offset) {
+	if (offset + sizeof(uint32_t) > log.length) return 0;
+	NSUInteger end = offset + sizeof(uint32_t) + HistoryReadLength(log, offset);
+	return (end <= log.length) ? end : 0;
+}
+
+//
+// Maps the existing log and loads (or rebuilds) its offset index. A record left
+// half-written by a crash is cut off.
+//
+- (void)openLog {
+	NSData *log = [NSData dataWithContentsOfURL:logURL options:NSDataReadingMappedIfSafe error:nil];
+	if (log.length < HistoryLogHeaderSize || memcmp(log.bytes, HistoryLogMagic, sizeof(HistoryLogMagic)) != 0 ||
+		HistoryReadLength(log, sizeof(HistoryLogMagic)) != HistoryLogVersion) {
+		[self resetLog];
+		return;
+	}
+
+	// Trust the saved index only if each record starts where the one before it ends and
+	// the last one ends exactly at the end of the log
+	NSUInteger logEnd = HistoryLogHeaderSize;
+	NSData *index = [NSData dataWithContentsOfURL:indexURL];
+	NSUInteger count = index.length / sizeof(uint64_t);
+	BOOL indexValid = (index.length % sizeof(uint64_t)) == 0;
+	offsets = [NSMutableData dataWithLength:count * sizeof(uint64_t)];
+	uint64_t *offsetArray = offsets.mutableBytes;
+	const uint64_t *savedArray = index.bytes;
+	for (NSUInteger i = 0; i < count && indexValid; i++) {
+		offsetArray[i] = NSSwapLittleLongLongToHost(savedArray[i]);
+		indexValid = offsetArray[i] == logEnd;
+		if (indexValid) logEnd = HistoryRecordEnd(log, (NSUInteger)offsetArray[i]);
+	}
+	indexValid = indexValid && logEnd == log.length;
+
+	if (!indexValid) {
+		// Walk the record lengths to rebuild the index
+		offsets = [NSMutableData data];
+		logEnd = HistoryLogHeaderSize;
+		NSUInteger next;
+		while ((next = HistoryRecordEnd(log, logEnd)) != 0) {
+			uint64_t offset = logEnd;
+			[offsets appendBytes:&offset length:sizeof(offset)];
+			logEnd = next;
+		}
+		count = offsets.length / sizeof(uint64_t);
+	}
+
+	mappedLog = log;
+	array = [NSMutableArray arrayWithCapacity:count];
+	for (NSUInteger i = 0; i < count; i++) {
+		[array addObject:[NSNull null]];
+	}
+
+	logHandle = [NSFileHandle fileHandleForWritingToURL:logURL error:nil];
+	[logHandle truncateFileAtOffset:logEnd];
+
+	if (indexValid) {
+		indexHandle = [NSFileHandle fileHandleForWritingToURL:indexURL error:nil];
+		[indexHandle seekToEndOfFile];
+	} else {
+		NSMutableData *indexData = [NSMutableData dataWithCapacity:offsets.length];
+		const uint64_t *rebuilt = offsets.bytes;
+		for (NSUInteger i = 0; i < count; i++) {
+			uint64_t offset = NSSwapHostLongLongToLittle(rebuilt[i]);
+			[indexData appendBytes:&offset length:sizeof(offset)];
+		}
+		[indexData writeToURL:indexURL atomically:YES];
+		indexHandle = [NSFileHandle fileHandleForWritingToURL:indexURL error:nil];
+		[indexHandle seekToEndOfFile];
+	}
+}
+
+//
+// Starts a new, empty log and index
+//
+- (void)resetLog {
+	NSMutableData *header = [NSMutableData dataWithBytes:HistoryLogMagic length:sizeof(HistoryLogMagic)];
+	uint32_t version = NSSwapHostIntToLittle(HistoryLogVersion);
+	[header appendBytes:&version length:sizeof(version)];
+
+	mappedLog = nil;
+	offsets = [NSMutableData data];
+	[array removeAllObjects];
+
+	[logHandle closeFile];
+	[indexHandle closeFile];
+	[header writeToURL:logURL atomically:YES];
+	[[NSData data] writeToURL:indexURL atomically:YES];
+	logHandle = [NSFileHandle fileHandleForWritingToURL:logURL error:nil];
+	[logHandle seekToEndOfFile];
+	indexHandle = [NSFileHandle fileHandleForWritingToURL:indexURL error:nil];
+}
+
+//
+// Appends one record to the log and its offset to the index. Returns NO if they couldn't
+// be written (always YES for a history without a log).
+//
+- (BOOL)appendRecordForData:(NSData *)data searchText:(NSString *)text value:(double)value {
+	if (!logURL) return YES;
+	if (!logHandle || !indexHandle) return NO;
+
+	NSData *textData = [text dataUsingEncoding:NSUTF8StringEncoding];
+	uint32_t dataLength = NSSwapHostIntToLittle((uint32_t)data.length);
+	uint32_t textLength = NSSwapHostIntToLittle((uint32_t)textData.length);
+	uint64_t valueBits;
+	memcpy(&valueBits, &value, sizeof(valueBits));
+	valueBits = NSSwapHostLongLongToLittle(valueBits);
+	NSUInteger payloadSize = sizeof(dataLength) + data.length + sizeof(HistorySearchMagic) + sizeof(textLength) + textData.length + sizeof(valueBits);
+	uint32_t payloadLength = NSSwapHostIntToLittle((uint32_t)payloadSize);
+	NSMutableData *record = [NSMutableData dataWithCapacity:sizeof(payloadLength) + payloadSize];
+	[record appendBytes:&payloadLength length:sizeof(payloadLength)];
+	[record appendBytes:&dataLength length:sizeof(dataLength)];
+	[record appendData:data];
+	[record appendBytes:HistorySearchMagic length:sizeof(HistorySearchMagic)];
+	[record appendBytes:&textLength length:sizeof(textLength)];
+	[record appendData:textData];
+	[record appendBytes:&valueBits length:sizeof(valueBits)];
+
+	unsigned long long position;
+	if (![logHandle getOffset:&position error:nil]) return NO;
+	uint64_t offset = NSSwapHostLongLongToLittle(position);
+	return [logHandle writeData:record error:nil] &&
+		[indexHandle writeData:[NSData dataWithBytes:&offset length:sizeof(offset)] error:nil];
+}
+
+//
+// Flushes the log and index to disk. Returns NO if that failed (always YES for a history
+// without a log).
+//
+- (BOOL)synchronize {
+	if (!logURL) return YES;
+	return [logHandle synchronizeAndReturnError:nil] && [indexHandle synchronizeAndReturnError:nil];
+}
+
+//
+// Reads the expression of a row of the mapped log. A row whose record doesn't fit in the
+// log (the log was changed behind our back) reads as empty.
+//
+- (NSData *)decodeItemAtIndex:(NSInteger)index {
+	NSUInteger offset = (NSUInteger)((const uint64_t *)offsets.bytes)[index];
+	NSUInteger payloadEnd = HistoryRecordEnd(mappedLog, offset);
+	offset += sizeof(uint32_t);
+	if (offset + sizeof(uint32_t) > payloadEnd) {
+		return [NSData data];
+	}
+
+	NSUInteger dataLength = HistoryReadLength(mappedLog, offset);
+	offset += sizeof(uint32_t);
+	if (offset + dataLength > payloadEnd) {
+		return [NSData data];
+	}
+
+	return [mappedLog subdataWithRange:NSMakeRange(offset, dataLength)];
+}
+
+//
+// Reads the search fields of a row of the mapped log. Returns NO for rows logged by
+// earlier versions, which don't have them.
+//
+- (BOOL)readSearchText:(NSString **)text value:(double *)value atIndex:(NSInteger)index {
+	NSUInteger offset = (NSUInteger)((const uint64_t *)offsets.bytes)[index];
+	NSUInteger payloadEnd = HistoryRecordEnd(mappedLog, offset);
+	offset += sizeof(uint32_t);
+	if (offset + sizeof(uint32_t) > payloadEnd) {
+		return NO;
+	}
+
+	offset += sizeof(uint32_t) + HistoryReadLength(mappedLog, offset);
+	if (offset + sizeof(HistorySearchMagic) + sizeof(uint32_t) > payloadEnd ||
+		memcmp((const char *)mappedLog.bytes + offset, HistorySearchMagic, sizeof(HistorySearchMagic)) != 0) {
+		return NO;
+	}
+
+	offset += sizeof(HistorySearchMagic);
+	NSUInteger textLength = HistoryReadLength(mappedLog, offset);
+	offset += sizeof(uint32_t);
+	if (offset + textLength + sizeof(uint64_t) > payloadEnd) {
+		return NO;
+	}
+
+	uint64_t valueBits;
+	[mappedLog getBytes:&valueBits range:NSMakeRange(offset + textLength, sizeof(valueBits))];
+	valueBits = NSSwapLittleLongLongToHost(valueBits);
+	memcpy(value, &valueBits, sizeof(*value));
+	*text = [[NSString alloc] initWithBytes:(const char *)mappedLog.bytes + offset length:textLength encoding:NSUTF8StringEncoding];
+	return *text != nil;
+}
+
+//
+// Adds an item. The search text (usually the expression and its result as text) and the
+// result's value are what the history search looks at. Returns NO if the item couldn't
+// be written to the log; it is still in the history until the application quits.
+//
+- (BOOL)addItem: (NSData *)data searchText:(NSString *)text value:(double)value {
+	NSInteger row = self.count;
+	[array addObject:data];
+	BOOL written = [self appendRecordForData:data searchText:text value:value];
+
+	if (searchIndex) {
+		[searchIndex addText:text value:value forRow:row];
+	} else {
+		if (!pendingSearchFields) pendingSearchFields = [NSMutableDictionary dictionary];
+		pendingSearchFields[@(row)] = @[text, @(value)];
+	}
+	return written;
+}
+
+//
+// Returns the rows matching a search query (see HistoryIndex). The index is built the
+// first time, mostly from the search fields in the log.
+//
+- (NSIndexSet *)itemsMatching:(NSString *)query {
+	if (!searchIndex) {
+		NSInteger loggedCount = (mappedLog != nil) ? (NSInteger)(offsets.length / sizeof(uint64_t)) : 0;
+		searchIndex = [[HistoryIndex alloc] init];
+		[searchIndex beginBuilding];
+		for (NSInteger i = 0; i < self.count; i++) {
+			NSArray *fields = pendingSearchFields[@(i)];
+			NSString *text = fields[0];
+			double value = [fields[1] doubleValue];
+			if (!fields && (i >= loggedCount || ![self readSearchText:&text value:&value atIndex:i])) {
+				// Items from earlier versions only have their expression
+				text = [[Expression expressionWithData:[self getItemAtIndex:i]] getExpressionString];
+				value = NAN;
+			}
+			[searchIndex addText:text ? text : @"" value:value forRow:i];
+		}
+		[searchIndex endBuilding];
+		pendingSearchFields = nil;
+	}
+	return [searchIndex rowsMatching:query];
+}
+
+- (NSData *)getItemAtIndex: (NSInteger)index {
+	if (index < 0 || index >= self.count) {
 		return nil;
 	}
+	if (array[index] == [NSNull null]) {
+		array[index] = [self decodeItemAtIndex:index];
+	}
 	return array[index];
 }
 
@@ -46,13 +334,10 @@
 		NSInteger size = [decoder decodeIntegerForKey:@"historyArray.size"];
 		array = [NSMutableArray arrayWithCapacity:size];
 		for (int i=0; i<size; i++) {
-			NSMutableArray *item = [NSMutableArray array];
+			// Archives from older versions also have an "NSBezier[%d]" path; it isn't needed
 			id object = [decoder decodeObjectForKey:[NSString stringWithFormat:@"NSData[%d]", i]];
 			if (object) {
-				[item addObject:object];
-				[item addObject:[decoder decodeObjectForKey:[NSString stringWithFormat:@"NSBezier[%d]", i]]];
-				[item addObject:[decoder decodeObjectForKey:[NSString stringWithFormat:@"Index[%d]", i]]];
-				[array addObject:item];
+				[array addObject:object];
 			}
 			//size--;
 		}
@@ -61,18 +346,21 @@
 }
 
 - (void)encodeWithCoder:(NSCoder *)encoder {
-	[encoder encodeInteger:array.count forKey:@"historyArray.size"];
-	int i = 0;
-	for (NSArray *item in array) {
-		[encoder encodeObject:item[0] forKey:[NSString stringWithFormat:@"NSData[%d]", i]];		// NSData
-		[encoder encodeObject:item[1] forKey:[NSString stringWithFormat:@"NSBezier[%d]", i]];	// NSBezier path
-		[encoder encodeObject:item[2] forKey:[NSString stringWithFormat:@"Index[%d]", i]];		// index of item
-		i++;
+	[encoder encodeInteger:self.count forKey:@"historyArray.size"];
+	for (int i = 0; i < self.count; i++) {
+		[encoder encodeObject:[self getItemAtIndex:i] forKey:[NSString stringWithFormat:@"NSData[%d]", i]];	// NSData
+		[encoder encodeObject:@(i+1) forKey:[NSString stringWithFormat:@"Index[%d]", i]];					// index of item
 	}
 }
 
 - (void)clear {
-	array = [NSMutableArray array];
+	[searchIndex reset];
+	pendingSearchFields = nil;
+	if (logURL) {
+		[self resetLog];
+	} else {
+		array = [NSMutableArray array];
+	}
 }
 
 @end
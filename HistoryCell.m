@@ -14,7 +14,8 @@
 /// The history table contains history cells. The history cells display expressions.
 /// This custom cell allows them to do so.
 ///
-/// There is only one cell for the entire table and it gets reused.
+/// There is only one cell for the entire table and it gets reused. Its object value is
+/// the laid out expression and the row number (see DrawerManager historyPathForData:).
 ///
 @implementation HistoryCell
 
@@ -33,7 +34,7 @@
 	
 	[super drawInteriorWithFrame:cellFrame inView:controlView];
 	
-	[path appendBezierPath:contents[1]];
+	[path appendBezierPath:contents[0]];
 	contentBounds = [path bounds];
 	
 	if (cellFrame.size.width / contentBounds.size.width < 1.0)
@@ -61,7 +62,7 @@
     
     // Draws the small history number
     NSDictionary *attributes = [NSDictionary dictionaryWithObject:NSColor.labelColor forKey:NSForegroundColorAttributeName];
-	numberString = [NSString stringWithFormat:@"%d.", [contents[2] intValue]];
+	numberString = [NSString stringWithFormat:@"%d.", [contents[1] intValue]];
     [numberString drawAtPoint:NSMakePoint(cellFrame.origin.x + 2.0, cellFrame.origin.y) withAttributes:attributes];
 	
     // Draws the separator line
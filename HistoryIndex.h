@@ -0,0 +1,30 @@
+//
+//  HistoryIndex.h
+//  Magic Number Machine
+//
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// An index over the history for the search field. Each row is indexed by the tokens of
+// its text (numbers, names, constants and operators) and by its result. Rows are added
+// one at a time as the history grows, so nothing is ever rebuilt.
+//
+// A query is a list of terms separated by spaces and a row must match all of them. A
+// term is either a range on the result ("=2", ">10", "<=0.5" or "1..100") or a token,
+// which matches any token of the row starting with it, ignoring case.
+//
+// To index many rows at once, add them between beginBuilding and endBuilding: they are
+// sorted once at the end instead of inserted one at a time. Don't search in between.
+//
+@interface HistoryIndex : NSObject
+
+- (instancetype)init;
+- (void)addText:(NSString *)text value:(double)value forRow:(NSInteger)row;
+- (void)beginBuilding;
+- (void)endBuilding;
+- (void)reset;
+- (NSIndexSet *)rowsMatching:(NSString *)query;
+
+@end
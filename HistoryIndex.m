@@ -0,0 +1,271 @@
+//
+//  HistoryIndex.m
+//  Magic Number Machine
+//
+//
+
+#import "HistoryIndex.h"
+#include <math.h>
+
+//
+// The distinct tokens are kept sorted so every token starting with a given prefix is in
+// one run, found by binary search, and each token has the set of rows using it. Results
+// are kept sorted by value so a range is also found by binary search. Adding a row
+// inserts into both in place, except while building (see beginBuilding), when rows are
+// appended and everything is sorted once at the end.
+//
+
+typedef struct {
+	double value;
+	NSInteger row;
+} HistoryIndexValue;
+
+@implementation HistoryIndex {
+	NSMutableArray *tokens;				// distinct tokens, sorted
+	NSMutableDictionary *postings;		// token -> NSMutableIndexSet of rows
+	NSMutableData *values;				// HistoryIndexValues sorted by value (rows without a result left out)
+	BOOL building;						// tokens and values are unsorted until endBuilding
+}
+
+- (instancetype)init {
+	self = [super init];
+	if (self) {
+		tokens = [NSMutableArray array];
+		postings = [NSMutableDictionary dictionary];
+		values = [NSMutableData data];
+	}
+	return self;
+}
+
+//
+// Orders tokens for the sorted token list
+//
+static NSComparisonResult
+HistoryIndexCompareTokens(NSString *a, NSString *b) {
+	return [a compare:b options:NSLiteralSearch];
+}
+
+//
+// Splits text into lower case tokens: runs of letters, digits, ".", "," and "_" (so that
+// numbers and constant names stay whole) and every other character on its own
+//
+static NSArray *
+HistoryIndexTokens(NSString *text) {
+	static NSCharacterSet *wordCharacters;
+	static dispatch_once_t once;
+	dispatch_once(&once, ^{
+		NSMutableCharacterSet *characters = [NSMutableCharacterSet alphanumericCharacterSet];
+		[characters addCharactersInString:@"._,"];
+		wordCharacters = [characters copy];
+	});
+
+	NSCharacterSet *spaces = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+	NSMutableArray *result = [NSMutableArray array];
+	NSString *lower = [text lowercaseString];
+	NSUInteger length = lower.length;
+	NSUInteger i = 0;
+	while (i < length) {
+		unichar c = [lower characterAtIndex:i];
+		NSRange range = [lower rangeOfComposedCharacterSequenceAtIndex:i];
+		if ([wordCharacters characterIsMember:c]) {
+			NSUInteger end = i;
+			while (end < length && [wordCharacters characterIsMember:[lower characterAtIndex:end]]) end++;
+			range = NSMakeRange(i, end - i);
+		}
+		if (![spaces characterIsMember:c]) {
+			[result addObject:[lower substringWithRange:range]];
+		}
+		i = NSMaxRange(range);
+	}
+	return result;
+}
+
+//
+// Orders results by value, then by row as incremental adding leaves them
+//
+static int
+HistoryIndexCompareValues(const void *a, const void *b) {
+	const HistoryIndexValue *first = a;
+	const HistoryIndexValue *second = b;
+	if (first->value != second->value) return (first->value < second->value) ? -1 : 1;
+	if (first->row != second->row) return (first->row < second->row) ? -1 : 1;
+	return 0;
+}
+
+//
+// The position of the first result at or above value (above it unless orEqual)
+//
+static NSUInteger
+HistoryIndexValueBound(NSData *values, double value, BOOL orEqual) {
+	const HistoryIndexValue *entries = values.bytes;
+	NSUInteger low = 0;
+	NSUInteger high = values.length / sizeof(HistoryIndexValue);
+	while (low < high) {
+		NSUInteger middle = low + (high - low) / 2;
+		if (entries[middle].value < value || (!orEqual && entries[middle].value == value)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+//
+// Reads a whole string as a number
+//
+static BOOL
+HistoryIndexScanNumber(NSString *string, double *number) {
+	NSScanner *scanner = [NSScanner scannerWithString:string];
+	return [scanner scanDouble:number] && [scanner isAtEnd];
+}
+
+//
+// Reads a range term ("=x", ">x", ">=x", "<x", "<=x" or "x..y"). Returns NO if the term
+// isn't one.
+//
+static BOOL
+HistoryIndexParseRange(NSString *term, double *low, BOOL *lowIncluded, double *high, BOOL *highIncluded) {
+	*low = -INFINITY;
+	*high = INFINITY;
+	*lowIncluded = YES;
+	*highIncluded = YES;
+
+	NSRange dots = [term rangeOfString:@".."];
+	if (dots.location != NSNotFound) {
+		return HistoryIndexScanNumber([term substringToIndex:dots.location], low) &&
+			HistoryIndexScanNumber([term substringFromIndex:NSMaxRange(dots)], high);
+	}
+	if ([term hasPrefix:@">="]) return HistoryIndexScanNumber([term substringFromIndex:2], low);
+	if ([term hasPrefix:@"<="]) return HistoryIndexScanNumber([term substringFromIndex:2], high);
+	if ([term hasPrefix:@">"]) {
+		*lowIncluded = NO;
+		return HistoryIndexScanNumber([term substringFromIndex:1], low);
+	}
+	if ([term hasPrefix:@"<"]) {
+		*highIncluded = NO;
+		return HistoryIndexScanNumber([term substringFromIndex:1], high);
+	}
+	if ([term hasPrefix:@"="] && HistoryIndexScanNumber([term substringFromIndex:1], low)) {
+		*high = *low;
+		return YES;
+	}
+	return NO;
+}
+
+//
+// Removes the rows not in other
+//
+static void
+HistoryIndexIntersect(NSMutableIndexSet *rows, NSIndexSet *other) {
+	[rows removeIndexes:[rows indexesPassingTest:^BOOL(NSUInteger row, BOOL *stop) {
+		return ![other containsIndex:row];
+	}]];
+}
+
+- (void)addText:(NSString *)text value:(double)value forRow:(NSInteger)row {
+	for (NSString *token in HistoryIndexTokens(text)) {
+		NSMutableIndexSet *rows = postings[token];
+		if (rows == nil) {
+			rows = [NSMutableIndexSet indexSet];
+			postings[token] = rows;
+			if (building) {
+				[tokens addObject:token];
+			} else {
+				NSUInteger position = [tokens indexOfObject:token inSortedRange:NSMakeRange(0, tokens.count)
+					options:NSBinarySearchingInsertionIndex usingComparator:^(id a, id b) {
+					return HistoryIndexCompareTokens(a, b);
+				}];
+				[tokens insertObject:token atIndex:position];
+			}
+		}
+		[rows addIndex:row];
+	}
+
+	if (!isnan(value)) {
+		HistoryIndexValue entry = {value, row};
+		if (building) {
+			[values appendBytes:&entry length:sizeof(entry)];
+		} else {
+			NSUInteger position = HistoryIndexValueBound(values, value, NO);
+			[values replaceBytesInRange:NSMakeRange(position * sizeof(entry), 0) withBytes:&entry length:sizeof(entry)];
+		}
+	}
+}
+
+- (void)beginBuilding {
+	building = YES;
+}
+
+- (void)endBuilding {
+	if (!building) return;
+	building = NO;
+	[tokens sortUsingComparator:^(id a, id b) {
+		return HistoryIndexCompareTokens(a, b);
+	}];
+	qsort(values.mutableBytes, values.length / sizeof(HistoryIndexValue), sizeof(HistoryIndexValue), HistoryIndexCompareValues);
+}
+
+- (void)reset {
+	[tokens removeAllObjects];
+	[postings removeAllObjects];
+	[values setLength:0];
+}
+
+//
+// Rows with a token starting with prefix
+//
+- (NSIndexSet *)rowsWithTokenPrefix:(NSString *)prefix {
+	NSMutableIndexSet *rows = [NSMutableIndexSet indexSet];
+	NSUInteger position = [tokens indexOfObject:prefix inSortedRange:NSMakeRange(0, tokens.count)
+		options:NSBinarySearchingFirstEqual | NSBinarySearchingInsertionIndex usingComparator:^(id a, id b) {
+		return HistoryIndexCompareTokens(a, b);
+	}];
+	for (; position < tokens.count && [tokens[position] hasPrefix:prefix]; position++) {
+		[rows addIndexes:postings[tokens[position]]];
+	}
+	return rows;
+}
+
+//
+// Rows with a result in the range
+//
+- (NSIndexSet *)rowsWithValueFrom:(double)low included:(BOOL)lowIncluded to:(double)high included:(BOOL)highIncluded {
+	NSMutableIndexSet *rows = [NSMutableIndexSet indexSet];
+	const HistoryIndexValue *entries = values.bytes;
+	NSUInteger end = HistoryIndexValueBound(values, high, !highIncluded);
+	for (NSUInteger i = HistoryIndexValueBound(values, low, lowIncluded); i < end; i++) {
+		[rows addIndex:entries[i].row];
+	}
+	return rows;
+}
+
+- (NSIndexSet *)rowsMatching:(NSString *)query {
+	NSMutableIndexSet *result = nil;
+	for (NSString *term in [query componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]]) {
+		if (term.length == 0) continue;
+
+		double low, high;
+		BOOL lowIncluded, highIncluded;
+		NSMutableArray *matches = [NSMutableArray array];
+		if (HistoryIndexParseRange(term, &low, &lowIncluded, &high, &highIncluded)) {
+			[matches addObject:[self rowsWithValueFrom:low included:lowIncluded to:high included:highIncluded]];
+		} else {
+			for (NSString *token in HistoryIndexTokens(term)) {
+				[matches addObject:[self rowsWithTokenPrefix:token]];
+			}
+		}
+
+		for (NSIndexSet *rows in matches) {
+			if (result == nil) {
+				result = [rows mutableCopy];
+			} else {
+				HistoryIndexIntersect(result, rows);
+			}
+		}
+		if (result != nil && result.count == 0) break;
+	}
+	return result ? result : [NSIndexSet indexSet];
+}
+
+@end
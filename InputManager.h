@@ -82,8 +82,11 @@
 - (IBAction)precisionPressed:(id)sender;
 - (IBAction)preferences:(id)sender;
 - (IBAction)preOpPressed:(id)sender;
+- (IBAction)resetStatistics:(id)sender;
 - (void)setDefaultsForThousands:(BOOL)thousands fractions:(BOOL)fractions digits:(int)digits significant:(int)significant fixed:(int)fixed display:(int)display;
 - (IBAction)shiftPressed:(id)sender;
+- (IBAction)showExpressionProfile:(id)sender;
+- (IBAction)showStatistics:(id)sender;
 - (IBAction)trigModePressed:(id)sender;
 - (IBAction)userPointPressed:(id)sender;
 - (IBAction)valuePressed:(id)sender;
@@ -93,6 +96,8 @@
 
 @property (NS_NONATOMIC_IOSONLY, readonly) BOOL acceptsFirstResponder;
 - (void)applicationDidFinishLaunching:(NSNotification *)aNotification;
+- (void)installDebugMenu;
+- (void)showReport:(NSString *)report title:(NSString *)title;
 - (void)setControlsForRadix:(short)radix;
 @property (NS_NONATOMIC_IOSONLY, readonly, strong) id window;
 @end
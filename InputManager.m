@@ -12,6 +12,7 @@
 #import "DataManager.h"
 #import "OpEnumerations.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "Value.h"
 // #import "SYFlatButton.h"
 
@@ -162,6 +163,24 @@
 	[NSApp stopModal];
 }
 
+//
+// resultStringOf
+//
+// The result of an expression as text for the clipboard. An exact integer result is
+// written out with every digit rather than rounded to the display's length.
+//
+- (NSString*)resultStringOf:(Expression*)expression
+{
+	BigInteger	*exact = [expression getExactValue];
+	Value		*result;
+	
+	if (exact != nil && ([dataManager getComplement] == 0 || ![exact isNegative]))
+		return [exact stringWithRadix:[dataManager getRadix]];
+	
+	result = [[Value alloc] initWithParent:nil value:[expression getValue] andManager:dataManager];
+	return [result getExpressionString];
+}
+
 //
 // copy
 //
@@ -175,7 +194,7 @@
 	NSString		*stringValue;
 
 	expression = [[dataManager getCurrentExpression] child];
-	data = [NSKeyedArchiver archivedDataWithRootObject:expression requiringSecureCoding:NO error:nil];
+	data = [expression encodedData];
 	
 	pasteBoard = [NSPasteboard generalPasteboard];
 	[pasteBoard declareTypes:@[@"MNMExpression", @"NSStringPboardType"] owner:self];
@@ -184,8 +203,7 @@
 	stringValue = [expression getExpressionString];
 	
 	if ([dataManager getEqualsPressed]) {
-		Value *result = [[Value alloc] initWithParent:nil value:[expression getValue] andManager:dataManager];
-		stringValue = [[stringValue stringByAppendingString:@" = "] stringByAppendingString:[result getExpressionString]];
+		stringValue = [[stringValue stringByAppendingString:@" = "] stringByAppendingString:[self resultStringOf:expression]];
 	}
 	
 	[pasteBoard setString:stringValue forType:@"NSStringPboardType"];
@@ -202,17 +220,15 @@
 	BigCFloat		*value;
 	NSData			*data;
 	NSString		*stringValue;
-	Value			*result;
 
 	value = [[dataManager getCurrentExpression] getValue];
-	data = [NSKeyedArchiver archivedDataWithRootObject:value requiringSecureCoding:NO error:nil];
+	data = [value encodedData];
 	
 	pasteBoard = [NSPasteboard generalPasteboard];
 	[pasteBoard declareTypes:@[@"BigCFloat", @"NSStringPboardType"] owner:self];
 	[pasteBoard setData:data forType:@"BigCFloat"];
 	
-	result = [[Value alloc] initWithParent:nil value:value andManager:dataManager];
-	stringValue = [result getExpressionString];
+	stringValue = [self resultStringOf:[dataManager getCurrentExpression]];
 	[pasteBoard setString:stringValue forType:@"NSStringPboardType"];
 }
 
@@ -333,14 +349,9 @@
 	if ([pasteBoardTypes containsObject:@"MNMExpression"])
 	{
 		pasteData = [pasteBoard dataForType:@"MNMExpression"];
-		if (pasteData != nil)
+		Expression *pasteExpression = (pasteData != nil) ? [Expression expressionWithData:pasteData] : nil;
+		if (pasteExpression != nil)
 		{
-			Expression	*pasteExpression;
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-            pasteExpression = [NSKeyedUnarchiver unarchiveObjectWithData:pasteData];
-#pragma GCC diagnostic pop
-//			pasteExpression = [NSKeyedUnarchiver unarchivedObjectOfClass:Expression.class fromData:pasteData error:nil];
 			[dataManager ensureInputWithValue:NO];
 			inputPoint = [dataManager getInputPoint];
 //			[inputPoint bracketPressed];						// Mike: why do we need brackets?
@@ -353,14 +364,9 @@
 	else if([pasteBoardTypes containsObject:@"BigCFloat"])
 	{
 		pasteData = [pasteBoard dataForType:@"BigCFloat"];
-		if(pasteData != nil)
+		BigCFloat *pasteValue = (pasteData != nil) ? [BigCFloat bigFloatWithData:pasteData] : nil;
+		if (pasteValue != nil)
 		{
-			BigCFloat		*pasteValue;
-//			pasteValue = [NSKeyedUnarchiver unarchivedObjectOfClass:BigCFloat.class fromData:pasteData error:nil];
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-            pasteValue = [NSKeyedUnarchiver unarchiveObjectWithData:pasteData];
-#pragma GCC diagnostic pop
 			[dataManager ensureInputWithValue:NO];
 			inputPoint = [dataManager getInputPoint];
 			[inputPoint valueInserted:pasteValue];
@@ -683,6 +689,7 @@
 - (void)applicationDidFinishLaunching:(NSNotification *)aNotification
 {
 	[dataManager setStartupState];
+	[self installDebugMenu];
 }
 - (void)applicationWillTerminate:(NSNotification *)aNotification
 {
@@ -693,6 +700,94 @@
 	[mainWindow makeKeyAndOrderFront:self];
 }
 
+//
+// installDebugMenu
+//
+// Adds a Debug menu for the numeric statistics to debug builds, or to any build with
+// BF_statistics defined to 1 when the MNMShowDebugMenu default is set. Without the
+// statistics compiled in (the default for release builds) there is nothing to show,
+// so there is no menu.
+//
+- (void)installDebugMenu
+{
+#if BF_statistics
+	NSMenu		*menu;
+	NSMenuItem	*item;
+	
+#ifndef DEBUG
+	if (![[NSUserDefaults standardUserDefaults] boolForKey:@"MNMShowDebugMenu"])
+		return;
+#endif
+	
+	menu = [[NSMenu alloc] initWithTitle:@"Debug"];
+	[[menu addItemWithTitle:@"Show Numeric Statistics" action:@selector(showStatistics:) keyEquivalent:@""] setTarget:self];
+	[[menu addItemWithTitle:@"Reset Numeric Statistics" action:@selector(resetStatistics:) keyEquivalent:@""] setTarget:self];
+	[menu addItem:[NSMenuItem separatorItem]];
+	[[menu addItemWithTitle:@"Show Expression Profile" action:@selector(showExpressionProfile:) keyEquivalent:@""] setTarget:self];
+	
+	item = [[NSMenuItem alloc] initWithTitle:@"Debug" action:nil keyEquivalent:@""];
+	[item setSubmenu:menu];
+	[[NSApp mainMenu] insertItem:item atIndex:MAX(0, [[NSApp mainMenu] numberOfItems] - 1)];
+#endif
+}
+
+//
+// resetStatistics
+//
+// Invoked from the debug menu. Zeroes the numeric statistics and the cache counters.
+//
+- (IBAction)resetStatistics:(id)sender
+{
+	[BigFloat resetStatistics];
+	[BigFloat clearCache];
+}
+
+//
+// showExpressionProfile
+//
+// Invoked from the debug menu. Shows where the time went in the last calculation of
+// the current expression.
+//
+- (IBAction)showExpressionProfile:(id)sender
+{
+	[self showReport:[[dataManager getCurrentExpression] profileReport] title:@"Profile of the last calculation"];
+}
+
+//
+// showReport
+//
+// Shows a report from the debug menu in a scrolling, fixed pitch alert (and writes it
+// to the console, where it can be copied).
+//
+- (void)showReport:(NSString *)report title:(NSString *)title
+{
+	NSAlert			*alert = [[NSAlert alloc] init];
+	NSScrollView	*scrollView = [[NSScrollView alloc] initWithFrame:NSMakeRect(0, 0, 720, 320)];
+	NSTextView		*textView = [[NSTextView alloc] initWithFrame:[scrollView bounds]];
+	
+	NSLog(@"%@\n%@", title, report);
+	
+	[textView setEditable:NO];
+	[textView setFont:[NSFont userFixedPitchFontOfSize:11.0]];
+	[textView setString:report];
+	[scrollView setHasVerticalScroller:YES];
+	[scrollView setDocumentView:textView];
+	
+	[alert setMessageText:title];
+	[alert setAccessoryView:scrollView];
+	[alert runModal];
+}
+
+//
+// showStatistics
+//
+// Invoked from the debug menu. Shows the numeric statistics report.
+//
+- (IBAction)showStatistics:(id)sender
+{
+	[self showReport:[BigFloat statisticsReport] title:@"Numeric statistics since the last reset"];
+}
+
 - (void)enable:(NSButton *)b enable:(BOOL) enable {
     [b setEnabled: enable];
     // b.titleNormalColor = enable ? NSColor.labelColor : NSColor.grayColor;
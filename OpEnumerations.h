@@ -40,6 +40,8 @@ enum
 	rootOp = 30,
 	twoOp = 31,
 	log2Op = 32,
+	primeOp = 33,
+	factorOp = 34,
 	modOp = 37,			// '%'
 	multiplyOp = 42,	// '*'
 	plusOp = 43,		// '+'
@@ -52,6 +54,8 @@ enum
     norOp = 100,
     xnorOp = 101,
 	ncrOp = 99,			// 'c'
+	gcdOp = 103,		// 'g'
+	lcmOp = 108,		// 'l'
 	orOp = 111,			// 'o'
 	nprOp = 112,		// 'p'
 	xorOp = 120			// 'x'
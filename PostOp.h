@@ -27,9 +27,12 @@
 	child:(Expression*)newChild andOp:(int)newOp ;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
+- (void)appendEncodingTo:(NSMutableData *)data;
 @property (NS_NONATOMIC_IOSONLY, getter=getValue, readonly, strong) BigCFloat *value;
+- (BigInteger*)calculateExactValue;
 - (void)appendOpToPath:(NSBezierPath*)path atLevel:(int)level;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (void)composePathAtLevel:(int)level;
 
 @end
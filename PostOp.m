@@ -9,6 +9,7 @@
 #import "PostOp.h"
 #import "ExpressionSymbols.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "DataManager.h"
 #import "OpEnumerations.h"
 
@@ -75,6 +76,33 @@
 	[coder encodeInt:op forKey:@"MEOp"];
 }
 
+//
+// initWithEncoding
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		op = (int)BF_DecodeSigned(decoder);
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	[super appendEncodingTo:data];
+	
+	BF_EncodeSigned(data, op);
+}
+
 //
 // appendOpToPath
 //
@@ -103,13 +131,17 @@
 			break;
 	}
 	
+	if (opPath == nil)
+		return;
+	
+	// The symbol paths are shared so they are transformed into a new path
 	if (level >= 2)
 	{
 		NSAffineTransform	*transform = [NSAffineTransform transform];
 		double				scale = [Expression scaleWithLevel:level];
 
 		[transform scaleBy:scale];
-		[opPath transformUsingAffineTransform:transform];
+		opPath = [transform transformBezierPath:opPath];
 	}
 	
 	[path appendBezierPath:opPath];
@@ -149,13 +181,23 @@
 //
 // getValue
 //
-// Calculates the result for this node depending on the operation.
+// Calculates the result for this node depending on the operation (exactly when the
+// child is an integer and the operation keeps it one).
 //
 - (BigCFloat*)getValue
 {
-	if (valueValid == NO)
+	BigInteger *exact;
+	
+	if (![self isValueCurrent])
 	{
-		if (child != nil)
+		EXProfile profile = [self beginProfile];
+		
+		exact = [self getExactValue];
+		if (exact != nil)
+		{
+			value = [BigCFloat bigFloatWithBigInteger:exact radix:[manager getRadix]];
+		}
+		else if (child != nil)
 		{
 			value = (BigCFloat*)[[child getValue] duplicate];
 			
@@ -182,60 +224,66 @@
 			
 		}
 		valueValid = YES;
+		
+		// A complex factorial is calculated by series, so it only has the working precision
+		valueDigits = (exact != nil) ? 0 : [self digitsOfValueUsingSeries:(op == factorialOp && child != nil && [[child getValue] hasImaginary])];
+		
+		[self endProfile:profile];
 	}
 	
 	return value;
 }
 
 //
-// pathAtLevel
+// calculateExactValue
 //
-// Returns a bezier path containing the display representation of this node (just the child
-// path with the postOp path after it).
+// The exact result of squaring, cubing or the factorial of an integer child.
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (BigInteger*)calculateExactValue
 {
-	NSBezierPath		*copy;
+	BigInteger *integer = [child getExactValue];
 	
-	if (pathValidAt != level)
+	switch (op)
 	{
-		NSBezierPath *childPath = [NSBezierPath bezierPath];
+		case squaredOp:
+			return [integer raiseToIntPower:2];
+		case cubedOp:
+			return [integer raiseToIntPower:3];
+		case factorialOp:
+			return [integer factorial];
+		default:
+			return nil;
+	}
+}
 
-		expressionPath = [NSBezierPath bezierPath];
+//
+// composePathAtLevel
+//
+// Lays out this node: the child with the postOp symbol after it.
+//
+- (void)composePathAtLevel:(int)level
+{
+	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = [NSAffineTransform transform];
+	childNaturalBounds = NSZeroRect;
 
-		[self appendOpToPath:expressionPath atLevel:level];
+	[self appendOpToPath:expressionPath atLevel:level];
+	
+	if (child != nil)
+	{
+		NSAffineTransform *transform = [NSAffineTransform transform];
+		NSRect				boundsRect;
 		
-		if (child != nil)
-		{
-			NSAffineTransform *transform = [NSAffineTransform transform];
-			NSRect				boundsRect;
-			
-			childPath = [child pathAtLevel:level];
-			boundsRect = [childPath bounds];
+		boundsRect = [child naturalBoundsAtLevel:level];
 
-			// Transform the op to the right of the child's value
-			[transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
-			[expressionPath transformUsingAffineTransform:transform];
-			
-			// Prepend the child
-			[expressionPath appendBezierPath:childPath];
-		}
+		// Transform the op to the right of the child's value
+		[transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
+		[expressionPath transformUsingAffineTransform:transform];
 		
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSZeroRect;
-		if (![childPath isEmpty])
-			childNaturalBounds = [childPath bounds];
-		else
-			childNaturalBounds = NSZeroRect;
-		pathValidAt = level;
+		childNaturalBounds = boundsRect;
 	}
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
-	
-	return copy;
+	naturalBounds = NSUnionRect([Expression boundsOfPath:expressionPath], childNaturalBounds);
 }
 
 //
@@ -26,10 +26,13 @@
 	andOp:(int)newOp;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
+- (void)appendEncodingTo:(NSMutableData *)data;
 - (void)appendOpToPath:(NSBezierPath*)path atLevel:(int)level;
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
 @property (NS_NONATOMIC_IOSONLY, getter=getValue, readonly, strong) BigCFloat *value;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (BigInteger*)calculateExactValue;
+- (void)composePathAtLevel:(int)level;
 - (void)postOpPressed:(int)op;
 - (void)replaceChild:(Expression*)oldChild withBinOp:(int)newOp;
 
@@ -9,6 +9,7 @@
 #import "PreOp.h"
 #import "ExpressionSymbols.h"
 #import "BigCFloat.h"
+#import "BigInteger.h"
 #import "DataManager.h"
 #import "OpEnumerations.h"
 
@@ -64,6 +65,33 @@
 	[coder encodeInt:op forKey:@"MEOp"];
 }
 
+//
+// initWithEncoding
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		op = (int)BF_DecodeSigned(decoder);
+	}
+	return self;
+}
+
+//
+// appendEncodingTo
+//
+// Part of the compact encoding. Required for copy and paste.
+//
+- (void)appendEncodingTo:(NSMutableData *)data
+{
+	[super appendEncodingTo:data];
+	
+	BF_EncodeSigned(data, op);
+}
+
 //
 // Adds inverse to the workingPath argument -- Mike (why was this never factored before?)
 //
@@ -74,8 +102,7 @@
 	workingBounds = [workingPath bounds];
 	workingTransform = [NSAffineTransform transform];
 	[workingTransform translateXBy:workingBounds.origin.x + workingBounds.size.width yBy:0];
-	opPath = [ExpressionSymbols inversePath];
-	[opPath transformUsingAffineTransform:workingTransform];
+	opPath = [workingTransform transformBezierPath:[ExpressionSymbols inversePath]];
 	[opPath appendBezierPath:workingPath];
 	return opPath;
 }
@@ -90,8 +117,7 @@
 	workingBounds = [workingPath bounds];
 	workingTransform = [NSAffineTransform transform];
 	[workingTransform translateXBy:workingBounds.origin.x + workingBounds.size.width yBy:0];
-	opPath = [ExpressionSymbols hypPath];
-	[opPath transformUsingAffineTransform:workingTransform];
+	opPath = [workingTransform transformBezierPath:[ExpressionSymbols hypPath]];
 	[opPath appendBezierPath:workingPath];
 	return opPath;
 }
@@ -106,8 +132,7 @@
 	workingBounds = [workingPath bounds];
 	workingTransform = [NSAffineTransform transform];
 	[workingTransform translateXBy:workingBounds.origin.x + workingBounds.size.width yBy:0];
-	opPath = [ExpressionSymbols sub2Path];
-	[opPath transformUsingAffineTransform:workingTransform];
+	opPath = [workingTransform transformBezierPath:[ExpressionSymbols sub2Path]];
 	[opPath appendBezierPath:workingPath];
 	return opPath;
 }
@@ -208,18 +233,28 @@
 		case eOp:
 			opPath = [ExpressionSymbols ePath];
 			break;
+		case primeOp:
+			opPath = [ExpressionSymbols primePath];
+			break;
+		case factorOp:
+			opPath = [ExpressionSymbols lpfPath];
+			break;
 		default:
 			opPath = nil;
 			break;
 	}
 	
+	if (opPath == nil)
+		return;
+	
+	// The symbol paths are shared so they are transformed into a new path
 	if (level >= 2)
 	{
 		NSAffineTransform	*transform = [NSAffineTransform transform];
 		double				scale = [Expression scaleWithLevel:level];
 
 		[transform scaleBy:scale];
-		[opPath transformUsingAffineTransform:transform];
+		opPath = [transform transformBezierPath:opPath];
 	}
 	
 	[path appendBezierPath:opPath];
@@ -336,6 +371,12 @@
 		case eOp:
 			resultString = [resultString stringByAppendingString:@"e^"];
 			break;
+		case primeOp:
+			resultString = [resultString stringByAppendingString:@"prime"];
+			break;
+		case factorOp:
+			resultString = [resultString stringByAppendingString:@"lpf"];
+			break;
 	}
 
 	if (child != nil)
@@ -344,18 +385,68 @@
 	return resultString;
 }
 
+//
+// PreOpIntegerFunction
+//
+// primeOp and factorOp of an integer: 1 if it is (very probably) prime and 0 otherwise,
+// or its smallest prime factor. Both are nil (an invalid result) for a non-integer or
+// one above BI_number_theory_bits, which would take too long.
+//
+static BigInteger *
+PreOpIntegerFunction(int op, BigInteger *integer)
+{
+	if (integer == nil || [integer bitLength] > BI_number_theory_bits)
+		return nil;
+	if (op == primeOp)
+		return [integer isProbablePrime] ? [BigInteger one] : [BigInteger zero];
+	return [integer smallestPrimeFactor];
+}
+
+//
+// PreOpUsesSeries
+//
+// Whether the function is calculated by a series or Newton iteration, which only
+// converges to the working precision. The magnitude of a complex number is a root.
+//
+static BOOL
+PreOpUsesSeries(int op)
+{
+	switch (op)
+	{
+		case reOp:
+		case imOp:
+		case notOp:
+		case rndOp:
+		case sigmaOp:
+		case primeOp:
+		case factorOp:
+			return NO;
+		default:
+			return YES;
+	}
+}
+
 //
 // getValue
 //
-// Calculates the value of the node. It is just the pre-op function applied to the child.
+// Calculates the value of the node. It is just the pre-op function applied to the child
+// (done exactly when the child is an integer and the function keeps it one).
 //
 - (BigCFloat*)getValue
 {
 	BigCFloat	*temp;
+	BigInteger	*exact;
 	
-	if (valueValid == NO)
+	if (![self isValueCurrent])
 	{
-		if (child != nil)
+		EXProfile profile = [self beginProfile];
+		
+		exact = [self getExactValue];
+		if (exact != nil)
+		{
+			value = [BigCFloat bigFloatWithBigInteger:exact radix:[manager getRadix]];
+		}
+		else if (child != nil)
 		{
 			value = (BigCFloat*)[[child getValue] duplicate];
 			
@@ -446,113 +537,131 @@
 				case eOp:
 					[value powerOfE];
 					break;
+				case primeOp:
+				case factorOp:
+					// an exact child only gets here if the function already failed on it
+					if ([child getExactValue] != nil)
+						value = [BigCFloat bigFloatWithBigInteger:nil radix:[manager getRadix]];
+					else
+						value = [BigCFloat bigFloatWithBigInteger:PreOpIntegerFunction(op, [value bigIntegerValue]) radix:[manager getRadix]];
+					break;
 				default:
 					break;
 			}
 	
 		}
 		valueValid = YES;
+		valueDigits = (exact != nil) ? 0 : [self digitsOfValueUsingSeries:PreOpUsesSeries(op)];
+		
+		[self endProfile:profile];
 	}
 	
 	return value;
 }
 
 //
-// pathAtLevel
+// calculateExactValue
 //
-// Returns the visual representation of this node as a bezier path. Pretty basic
-// except for e^x and 10^x which have to raise the exponent a little.
+// The exact result for the functions that take an integer to an integer.
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (BigInteger*)calculateExactValue
 {
-	NSBezierPath *copy;
-	double		 scale = [Expression scaleWithLevel:level];
+	BigInteger *integer = [child getExactValue];
 	
-	if (pathValidAt != level)
+	if (integer == nil)
+		return nil;
+	
+	switch (op)
 	{
-		NSBezierPath *childPath = [NSBezierPath bezierPath];
-        NSBezierPath *cubeDigit = [ExpressionSymbols nRootPath:3];
+		case absOp:
+			return [integer absoluteValue];
+		case reOp:
+		case rndOp:
+			return integer;
+		case imOp:
+			return [BigInteger zero];
+		case primeOp:
+		case factorOp:
+			return PreOpIntegerFunction(op, integer);
+		default:
+			return nil;
+	}
+}
 
-		expressionPath = [NSBezierPath bezierPath];
+//
+// composePathAtLevel
+//
+// Lays out this node: the preOp symbol with the child placed after it. Pretty basic
+// except for e^x and 10^x which have to raise the exponent a little.
+//
+- (void)composePathAtLevel:(int)level
+{
+	double		 scale = [Expression scaleWithLevel:level];
+	
+	expressionPath = [NSBezierPath bezierPath];
+	childPlacement = [NSAffineTransform transform];
+	childNaturalBounds = NSZeroRect;
 
-		[self appendOpToPath:expressionPath atLevel:level];
+	[self appendOpToPath:expressionPath atLevel:level];
+	
+	if (child != nil)
+	{
+		NSAffineTransform *transform;
+		NSRect			  boundsRect = [Expression boundsOfPath:expressionPath];
+		NSRect			  childBounds;
 		
-		if (child != nil)
+		if (op == eOp || op == tenOp || op == twoOp)
 		{
-			NSAffineTransform *transform;
-			NSRect			  boundsRect = [expressionPath bounds];
-			
-			if (op == eOp || op == tenOp || op == twoOp)
-			{
-				transform = [NSAffineTransform transform];
-				if (level == 0)
-					childPath = [child pathAtLevel:level + 2];
-				else
-					childPath = [child pathAtLevel:level + 1];
-				[transform translateXBy:0 * scale yBy:scale * 11];
-				[childPath transformUsingAffineTransform:transform];
-			}
+			if (level == 0)
+				childBounds = [child naturalBoundsAtLevel:level + 2];
 			else
-			{
-				childPath = [child pathAtLevel:level];
-			}
+				childBounds = [child naturalBoundsAtLevel:level + 1];
+			[childPlacement translateXBy:0 * scale yBy:scale * 11];
+		}
+		else
+		{
+			childBounds = [child naturalBoundsAtLevel:level];
+		}
+	
+		transform = [NSAffineTransform transform];
+		[transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
+		[childPlacement appendTransform:transform];
+		childNaturalBounds = [Expression rect:childBounds transformedBy:childPlacement];
 		
+		if (op == sqrtOp || op == cbrtOp)
+		{
+			NSBezierPath *overLine = [NSBezierPath bezierPath];
+			
 			transform = [NSAffineTransform transform];
-			[transform translateXBy:boundsRect.origin.x + boundsRect.size.width yBy:0];
-			[childPath transformUsingAffineTransform:transform];
+			[transform translateXBy:0.0 yBy:childNaturalBounds.origin.y - 0.8 * boundsRect.origin.y];
+			[transform
+				scaleXBy:1.0
+				yBy:(childNaturalBounds.size.height / boundsRect.size.height) * 1.25
+			];
+			[expressionPath transformUsingAffineTransform:transform];
+			boundsRect = [expressionPath bounds];
 			
-			if (op == sqrtOp || op == cbrtOp)
-			{
-				NSBezierPath *overLine = [NSBezierPath bezierPath];
-				NSRect		 childBounds = [childPath bounds];
-				
-                // expressionPath = 
-				transform = [NSAffineTransform transform];
-				[transform translateXBy:0.0 yBy:childBounds.origin.y - 0.8 * boundsRect.origin.y];
-				[transform
-					scaleXBy:1.0
-					yBy:(childBounds.size.height / boundsRect.size.height) * 1.25
-				];
-				[expressionPath transformUsingAffineTransform:transform];
-				boundsRect = [expressionPath bounds];
-				
-				[overLine moveToPoint:
-					NSMakePoint
-					(
-						boundsRect.origin.x + boundsRect.size.width,
-						boundsRect.origin.y + boundsRect.size.height
-					)
-				];
-				[overLine relativeLineToPoint:
-					NSMakePoint(childBounds.size.width + 5.0, 0)
-				];
-				[overLine relativeLineToPoint:NSMakePoint(-0.5, -1.5)];
-				[overLine relativeLineToPoint:
-					NSMakePoint(-(childBounds.size.width + 5.0), 0)
-				];
-				[overLine closePath];
-				[expressionPath appendBezierPath:overLine];
-				
-			}
-			[expressionPath appendBezierPath:childPath];
+			[overLine moveToPoint:
+				NSMakePoint
+				(
+					boundsRect.origin.x + boundsRect.size.width,
+					boundsRect.origin.y + boundsRect.size.height
+				)
+			];
+			[overLine relativeLineToPoint:
+				NSMakePoint(childNaturalBounds.size.width + 5.0, 0)
+			];
+			[overLine relativeLineToPoint:NSMakePoint(-0.5, -1.5)];
+			[overLine relativeLineToPoint:
+				NSMakePoint(-(childNaturalBounds.size.width + 5.0), 0)
+			];
+			[overLine closePath];
+			[expressionPath appendBezierPath:overLine];
 		}
-        if (op == cbrtOp) [expressionPath appendBezierPath:cubeDigit];
-		
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		if (![childPath isEmpty])
-			childNaturalBounds = [childPath bounds];
-		else
-			childNaturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		pathValidAt = level;
 	}
+	if (op == cbrtOp) [expressionPath appendBezierPath:[ExpressionSymbols nRootPath:3]];
 	
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
-	
-	return copy;
+	naturalBounds = NSUnionRect([Expression boundsOfPath:expressionPath], childNaturalBounds);
 }
 
 //
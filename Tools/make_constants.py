@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+# ##############################################################
+#  make_constants.py
+#  Magic Number Machine
+#
+#  Generates the packed constant tables.
+# ##############################################################
+
+#
+# About make_constants
+#
+# Writes BigFloatConstants.h (π, e, ln 2 and ln 10 in radices 2, 8, 10 and 16) and
+# ExpressionConstants.h (the physical constants of ExpressionSymbols) so that none of
+# them has to be parsed or calculated when the program starts. Each value is packed
+# in BigFloat's compact encoding with no user point, exactly as appendEncodingTo:
+# would write it for a number with BF_num_values limbs; the mathematical constants
+# are correctly rounded to that many limbs. Run it from the project folder after
+# changing a constant or BF_packed_num_values:
+#
+#	python3 Tools/make_constants.py
+#
+
+import math
+from decimal import Decimal, getcontext, ROUND_HALF_EVEN
+
+# Limbs the values are generated for (BF_num_values in BigFloat.h)
+BF_packed_num_values = 16
+
+# Radices with packed mathematical constants
+BF_packed_radices = [2, 8, 10, 16]
+
+# The physical constants, by their ConstType in ExpressionSymbols.h (NIST, January 2008).
+# Pi and RootOfMinusOne aren't packed here.
+MNM_physical_constants = [
+	("BohrRadius",					"0.5291772085936e-10"),
+	("StructureConstant",			"7.297352537650e-3"),
+	("StandardAtmosphere",			"101325"),
+	("WienDisplacement",			"2.897768551e-3"),
+	("RadiationConstant1",			"3.7417711819e-16"),
+	("RadiationConstant2",			"1.438775225e-2"),
+	("SpeedOfLight",				"299792458"),
+	("HartreeEnergy",				"4.3597439422e-18"),
+	("ElementaryCharge",			"1.60217648740e-19"),
+	("VacuumPermittivity",			"8.854187817620389850536563e-12"),
+	("ElectronVolt",				"1.60217648740e-19"),
+	("FaradayConstant",				"96485.339924"),
+	("ElectronGFactor",				"-2.002319304362215"),
+	("MuonGFactor",					"-2.002331841412"),
+	("GravitationalAcceleration",	"9.80665"),
+	("GravitationalConstant",		"6.6742867e-11"),
+	("QuantumConductance",			"7.748091700453e-5"),
+	("PlanckConstant",				"6.6260689633e-34"),
+	("PlanckConstantPi",			"1.05457162853e-34"),
+	("BoltmannConstant",			"1.380650424e-23"),
+	("PlanckLength",				"1.61625281e-35"),
+	("ElectronComptonWavelengthPi",	"3.861592645953e-13"),
+	("NeutronComptonWavelength",	"1.319590895120e-15"),
+	("ProtonComptonWavelength",		"1.321409844619e-15"),
+	("ElectronComptonWavelength",	"2.426310217533e-12"),
+	("DeuteronMass",				"3.3435832017e-27"),
+	("ElectronMass",				"9.1093821545e-31"),
+	("NeutronMass",					"1.6749286e-27"),
+	("PlanckMass",					"2.1764411e-08"),
+	("ProtonMass",					"1.67262163783e-27"),
+	("AtomicMassConstant",			"1.66053878283e-27"),
+	("VacuumMagneticPermittivity",	"12.56637061435917295385057e-7"),
+	("BohrMagneton",				"9.2740091523e-24"),
+	("DeuteronMagneticMoment",		"4.3307346511e-27"),
+	("NuclearMagneton",				"5.0507832413e-27"),
+	("LoschmidtConstant",			"2.686777447e+25"),
+	("AvagadroConstant",			"6.0221417930e+23"),
+	("MagneticFluxQuantum",			"2.06783366752e-15"),
+	("ClassicalElectronRadius",		"2.817940289458e-15"),
+	("QuantizedHallResistance",		"25812.8063"),
+	("MolarGasConstant",			"8.31447215"),
+	("RydbergConstant",				"10973731.56852773"),
+	("ElectronThomsonCrossSection",	"6.65245855827e-29"),
+	("StefanBoltzmannConstant",		"5.67040040e-08"),
+	("PlanckTime",					"5.3912427e-44"),
+	("PlanckTemperature",			"1.416785e32"),
+	("MolarVolume",					"22.41399639e-3"),
+]
+
+#
+# The digits per limb and the limb limit of a radix, as setElements works them out
+#
+def limb_format(radix):
+	precision = int(math.log(0xFFFF + 1) / math.log(radix))
+	return precision, radix ** precision
+
+#
+# The compact encoding of sign * mantissa * radix^exponent (see appendEncodingTo:)
+#
+def encode(negative, mantissa, exponent, radix):
+	precision, limit = limb_format(radix)
+	limbs = []
+	while mantissa:
+		limbs.append(mantissa % limit)
+		mantissa //= limit
+	assert len(limbs) <= BF_packed_num_values
+
+	def unsigned(number):
+		data = []
+		while True:
+			data.append((number & 0x7F) | (0x80 if number > 0x7F else 0))
+			number >>= 7
+			if number == 0:
+				return data
+
+	data = [(1 if negative else 0) | 2, radix]
+	data += unsigned((exponent << 1) ^ (exponent >> 63))
+	data += unsigned(0)
+	data += unsigned(len(limbs))
+	for limb in limbs:
+		data += [limb & 0xFF, limb >> 8]
+	return data
+
+#
+# A positive real rounded to nearest (even) to the full width in radix
+#
+def encode_real(value, radix):
+	precision, limit = limb_format(radix)
+	digits = precision * BF_packed_num_values
+	exponent = 0
+	while value >= radix:
+		value /= radix
+		exponent += 1
+	while value < 1:
+		value *= radix
+		exponent -= 1
+	scaled = value * Decimal(radix) ** (digits - 1)
+	mantissa = int(scaled.to_integral_value(rounding=ROUND_HALF_EVEN))
+	exponent -= digits - 1
+	if mantissa >= radix ** digits:
+		mantissa = (mantissa + radix // 2) // radix
+		exponent += 1
+	return encode(False, mantissa, exponent, radix)
+
+#
+# An exact decimal string, as bigFloatWithString:radix:10 reads it
+#
+def encode_decimal(text):
+	sign, digits, exponent = Decimal(text).as_tuple()
+	mantissa = int("".join(str(digit) for digit in digits))
+	return encode(sign == 1, mantissa, exponent, 10)
+
+#
+# π by Machin's formula, in fixed point with the given number of decimal guard digits
+#
+def machin_pi(digits):
+	scale = 10 ** digits
+
+	def arctan_inverse(x):
+		total = term = scale // x
+		n = 1
+		while term:
+			term //= x * x
+			n += 2
+			total += term // n if (n // 2) % 2 == 0 else -(term // n)
+		return total
+
+	return Decimal(4 * (4 * arctan_inverse(5) - arctan_inverse(239))) / Decimal(scale)
+
+def c_array(name, data):
+	lines = ["static const uint8_t %s[] =" % name, "{"]
+	for start in range(0, len(data), 16):
+		lines.append("\t" + ", ".join("0x%02X" % byte for byte in data[start:start + 16]) + ",")
+	lines[-1] = lines[-1].rstrip(",")
+	lines.append("};")
+	return "\n".join(lines)
+
+def header(name, about):
+	return "\n".join([
+		"// ##############################################################",
+		"//  %s" % name,
+		"//  Magic Number Machine",
+		"//",
+		"//  Generated by Tools/make_constants.py. Do not edit.",
+		"// ##############################################################",
+		"",
+		"//",
+		"// About %s" % name[:-2],
+		"//",
+	] + ["// " + line if line else "//" for line in about] + ["//", ""])
+
+def write_math_constants():
+	getcontext().prec = 200
+	constants = [
+		("pi", "BF_constant_pi", machin_pi(220)),
+		("e", "BF_constant_e", Decimal(1).exp()),
+		("ln2", "BF_constant_ln2", Decimal(2).ln()),
+		("ln10", "BF_constant_ln10", Decimal(10).ln()),
+	]
+	out = [header("BigFloatConstants.h", [
+		"π, e, ln 2 and ln 10 for the common radices, correctly rounded to",
+		"BF_packed_num_values limbs and packed in the compact encoding with no user point",
+		"(see Packed Constants in BigFloat.m).",
+	])]
+	out.append("#define BF_packed_num_values\t\t%d\n" % BF_packed_num_values)
+	for name, _, value in constants:
+		for radix in BF_packed_radices:
+			out.append(c_array("BF_packed_%s_%d" % (name, radix), encode_real(value, radix)))
+			out.append("")
+	out.append("// By constant and radix; radices without a packed value are left empty")
+	out.append("static const BFPackedNumber BF_packed_constants[BF_constant_count][37] =")
+	out.append("{")
+	rows = []
+	for name, identifier, _ in constants:
+		entries = ", ".join("[%d] = {BF_packed_%s_%d, sizeof(BF_packed_%s_%d)}" % (radix, name, radix, name, radix) for radix in BF_packed_radices)
+		rows.append("\t[%s] = {%s}" % (identifier, entries))
+	out.append(",\n".join(rows))
+	out.append("};")
+	open("BigFloatConstants.h", "w").write("\n".join(out) + "\n")
+
+def write_physical_constants():
+	out = [header("ExpressionConstants.h", [
+		"The physical constants of ExpressionSymbols, packed in the compact encoding with",
+		"no user point, by ConstType. π and i aren't in the table.",
+	])]
+	for identifier, text in MNM_physical_constants:
+		out.append(c_array("MNM_packed_%s" % identifier, encode_decimal(text)))
+		out.append("")
+	out.append("static const BFPackedNumber MNM_packed_constants[MolarVolume + 1] =")
+	out.append("{")
+	out.append(",\n".join("\t[%s] = {MNM_packed_%s, sizeof(MNM_packed_%s)}" % (identifier, identifier, identifier) for identifier, _ in MNM_physical_constants))
+	out.append("};")
+	open("ExpressionConstants.h", "w").write("\n".join(out) + "\n")
+
+write_math_constants()
+write_physical_constants()
@@ -67,6 +67,7 @@
 {
 	NSPoint	caretPoint;
 	
+	[self updateDisplayBounds];
 	NSAssert(isBoundsValid == YES, @"Display bounds requested before being received.\n");
 	
 	caretPoint = displayBounds.origin;
@@ -76,6 +77,26 @@
 	return caretPoint;
 }
 
+//
+// getValue
+//
+// Evaluating the whole tree starts a new profile. Once calculated, the manager is told
+// so it can log the evaluation if it was slow.
+//
+- (BigCFloat*)getValue
+{
+	BigCFloat *result;
+	
+	if ([self isValueCurrent] || child == nil)
+		return [super getValue];
+	
+	[Expression beginProfiledEvaluation];
+	result = [super getValue];
+	[manager expressionEvaluated:self];
+	
+	return result;
+}
+
 //
 // postOpPressed
 //
@@ -40,6 +40,7 @@
 - (instancetype)initWithParent:(Expression*)newParent value:(BigCFloat*)newValue andManager:(DataManager*)newManager;
 - (instancetype)initWithCoder:(NSCoder *)coder;
 - (void)encodeWithCoder:(NSCoder *)coder;
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent;
 - (void)appendDigit:(int)digit;
 - (void)clear;
 - (void)deleteDigit;
@@ -47,7 +48,7 @@
 @property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
 - (void)generateValuePath;
 //@property (NS_NONATOMIC_IOSONLY, getter=getExpressionString, readonly, copy) NSString *expressionString;
-- (NSBezierPath*)pathAtLevel:(int)level;
+- (void)composePathAtLevel:(int)level;
 - (void)userPointPressed;
 - (NSString *)insertThousands:(NSString *)mantissa;
 
@@ -107,6 +107,28 @@
 	[super encodeWithCoder:coder];
 }
 
+//
+// initWithEncoding
+//
+// The value itself is read by Constant; the entry state is rebuilt from it.
+//
+- (instancetype)initWithEncoding:(BFDecoder *)decoder parent:(Expression*)newParent
+{
+	self = [super initWithEncoding:decoder parent:newParent];
+	if (self)
+	{
+		userPointState = -1;
+		imaginaryPointState = -1;
+		postPoint = 0;
+		postImaginaryPoint = 0;
+		hasExponent = NO;
+		hasImaginary = NO;
+		hasImaginaryExponent = NO;
+		usesComplement = -1;	// force reprocessing of above variables
+	}
+	return self;
+}
+
 //
 // appendDigit
 //
@@ -857,42 +879,27 @@
 }
 
 //
-// pathAtLevel
+// composePathAtLevel
 //
-// Returns the bezierPath representation of this value. generateValuePath does most
-// of the work. This method really just scales the result and sets the bounds.
+// Lays out this value. generateValuePath does most of the work. This method really
+// just scales the result and sets the bounds.
 //
-- (NSBezierPath*)pathAtLevel:(int)level
+- (void)composePathAtLevel:(int)level
 {
 	NSAffineTransform	*transform;
-	NSBezierPath			*copy;
 	double				scale = [Expression scaleWithLevel:level];
 	
-	// Generate the path if required
-	if (pathValidAt != level)
+	[self generateValuePath];
+
+	if (level >= 2)
 	{
-		[self generateValuePath];
-	
-		if (level >= 2)
-		{
-			transform = [NSAffineTransform transform];
-			[transform scaleBy:scale];
-			[expressionPath transformUsingAffineTransform:transform];
-		}
-	
-		// Record that the path has been properly updated since the last invalidation
-		if (![expressionPath isEmpty])
-			naturalBounds = [expressionPath bounds];
-		else
-			naturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		childNaturalBounds = NSMakeRect(0.0, 0.0, 0.0, 0.0);
-		pathValidAt = level;
+		transform = [NSAffineTransform transform];
+		[transform scaleBy:scale];
+		[expressionPath transformUsingAffineTransform:transform];
 	}
 
-	copy = [NSBezierPath bezierPath];
-	[copy appendBezierPath:expressionPath];
-	
-	return copy;
+	naturalBounds = [Expression boundsOfPath:expressionPath];
+	childNaturalBounds = NSZeroRect;
 }
 
 //